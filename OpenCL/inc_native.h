@@ -0,0 +1,63 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef _INC_NATIVE_H
+#define _INC_NATIVE_H
+
+// This file is force-included (-include) by the native backend in front of every
+// kernel source file. It turns the OpenCL C kernels into plain C99 code which is
+// compiled by the host C compiler into a shared object and executed on the host CPU.
+// Defining _CPU_OPENCL_EMU_H switches inc_vendor.h into IS_NATIVE mode.
+
+#define _CPU_OPENCL_EMU_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t  uchar;
+typedef uint16_t ushort;
+typedef uint32_t uint;
+typedef uint64_t ulong;
+
+// gpu_memset() writes a uint4 per work-item, IS_NATIVE branch in shared.cl expects a scalar
+
+typedef uint32_t uint4;
+
+// the host sets the work-item id of the calling worker thread before each kernel invocation
+
+static __thread size_t hc_native_gid;
+
+__attribute__ ((visibility ("default"))) size_t *hc_native_gid_ptr (void)
+{
+  return &hc_native_gid;
+}
+
+static inline size_t get_global_id  (const uint dimindx __attribute__ ((unused))) { return hc_native_gid; }
+static inline size_t get_local_id   (const uint dimindx __attribute__ ((unused))) { return 0; }
+static inline size_t get_local_size (const uint dimindx __attribute__ ((unused))) { return 1; }
+
+static inline uint32_t rotl32 (const uint32_t a, const int n) { return (a << n) | (a >> ((32 - n) & 31)); }
+static inline uint32_t rotr32 (const uint32_t a, const int n) { return (a >> n) | (a << ((32 - n) & 31)); }
+static inline uint64_t rotl64 (const uint64_t a, const int n) { return (a << n) | (a >> ((64 - n) & 63)); }
+static inline uint64_t rotr64 (const uint64_t a, const int n) { return (a >> n) | (a << ((64 - n) & 63)); }
+
+static inline uint32_t rotl32_S (const uint32_t a, const int n) { return rotl32 (a, n); }
+static inline uint32_t rotr32_S (const uint32_t a, const int n) { return rotr32 (a, n); }
+static inline uint64_t rotl64_S (const uint64_t a, const int n) { return rotl64 (a, n); }
+static inline uint64_t rotr64_S (const uint64_t a, const int n) { return rotr64 (a, n); }
+
+static inline uint16_t byte_swap_16 (const uint16_t n) { return __builtin_bswap16 (n); }
+static inline uint32_t byte_swap_32 (const uint32_t n) { return __builtin_bswap32 (n); }
+static inline uint64_t byte_swap_64 (const uint64_t n) { return __builtin_bswap64 (n); }
+
+// work-items of the same launch run concurrently on different host threads
+
+static inline uint32_t hc_atomic_dec (volatile uint32_t *p)                      { return __atomic_fetch_sub (p, 1,   __ATOMIC_SEQ_CST); }
+static inline uint32_t hc_atomic_inc (volatile uint32_t *p)                      { return __atomic_fetch_add (p, 1,   __ATOMIC_SEQ_CST); }
+static inline uint32_t hc_atomic_or  (volatile uint32_t *p, volatile const uint32_t val) { return __atomic_fetch_or  (p, val, __ATOMIC_SEQ_CST); }
+
+#endif // _INC_NATIVE_H
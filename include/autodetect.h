@@ -0,0 +1,22 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef _AUTODETECT_H
+#define _AUTODETECT_H
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#define AUTODETECT_INDEX_FILENAME "hashcat.autodetect"
+#define AUTODETECT_INDEX_VERSION  (0x6863617574640000 | 0x01)
+
+int  autodetect_index_init    (hashcat_ctx_t *hashcat_ctx, autodetect_index_t *autodetect_index);
+void autodetect_index_destroy (autodetect_index_t *autodetect_index);
+void autodetect_index_select  (hashcat_ctx_t *hashcat_ctx, const autodetect_index_t *autodetect_index, bool *selected);
+
+#endif // _AUTODETECT_H
@@ -131,6 +131,11 @@ int run_opencl_kernel_utf8toutf16le (hashcat_ctx_t *hashcat_ctx, hc_device_param
 int run_opencl_kernel_memset  (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_mem buf, const u32 value, const u64 size);
 int run_opencl_kernel_bzero   (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_mem buf, const u64 size);
 
+int run_native_kernel_atinit  (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u64 num);
+int run_native_kernel_utf8toutf16le (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u64 num);
+int run_native_kernel_memset  (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u32 value, const u64 size);
+int run_native_kernel_bzero   (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u64 size);
+
 int run_kernel                (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 kern_run, const u64 pws_pos, const u64 num, const u32 event_update, const u32 iteration);
 int run_kernel_mp             (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 kern_run, const u64 num);
 int run_kernel_tm             (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param);
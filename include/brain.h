@@ -45,10 +45,16 @@ static const int BRAIN_SERVER_TIMER               = 5 * 60;
 static const int BRAIN_SERVER_SESSIONS_MAX        = 64;
 static const int BRAIN_SERVER_ATTACKS_MAX         = 64 * 1024;
 static const int BRAIN_SERVER_CLIENTS_MAX         = 256;
-static const int BRAIN_SERVER_REALLOC_HASH_SIZE   = 1024 * 1024;
 static const int BRAIN_SERVER_REALLOC_ATTACK_SIZE = 1024;
+static const int BRAIN_SERVER_HASH_RUNS_MAX       = 32;
+static const int BRAIN_SERVER_HASH_RUNS_RATIO     = 2;
+static const int BRAIN_SERVER_HASH_BLOOM_BITS     = 10; // per hash, rounded up to the next power of 2
+static const int BRAIN_SERVER_HASH_BLOOM_K        = 4;
+static const int BRAIN_SERVER_HASH_DUMP_CHUNK     = 64 * 1024;
+static const int BRAIN_SERVER_JOURNAL_TIMER       = 1;  // seconds between two fsync of the journals
+static const int BRAIN_SERVER_REALLOC_JOURNAL     = 64 * 1024;
 static const int BRAIN_HASH_SIZE                  = 2 * sizeof (u32);
-static const int BRAIN_LINK_VERSION_CUR           = 1;
+static const int BRAIN_LINK_VERSION_CUR           = 2; // 2 = sorted, rice coded lookups and bit packed rejects
 static const int BRAIN_LINK_VERSION_MIN           = 1;
 static const int BRAIN_LINK_CHUNK_SIZE            = 4 * 1024;
 static const int BRAIN_LINK_CANDIDATES_MAX        = 128 * 1024 * 256; // units * threads * accel
@@ -96,6 +102,19 @@ typedef struct brain_server_hash_short
 
 } brain_server_hash_short_t;
 
+// a sorted and immutable part of the long term memory, its bloom filter saves the binary search for most of the misses
+
+typedef struct brain_server_hash_run
+{
+  brain_server_hash_long_t *long_buf;
+
+  i64 long_cnt;
+
+  u64 *bloom_buf;
+  u64  bloom_mask;
+
+} brain_server_hash_run_t;
+
 typedef struct brain_server_hash_unique
 {
   u32 hash[2];
@@ -120,10 +139,20 @@ typedef struct brain_server_db_attack
 
   int ab;
 
+  // finished ranges which are not in the journal yet, guarded by mux_ag
+
+  brain_server_attack_long_t *jnl_buf;
+
+  i64 jnl_alloc;
+  i64 jnl_cnt;
+
+  int jnl_fd;
+
   hc_thread_mutex_t mux_ar;
   hc_thread_mutex_t mux_ag;
+  hc_thread_mutex_t mux_af; // journal file, lock before mux_ag
 
-  bool write_attacks;
+  bool write_attacks; // finished ranges which are not in the snapshot yet
 
 } brain_server_db_attack_t;
 
@@ -131,17 +160,32 @@ typedef struct brain_server_db_hash
 {
   u32 brain_session;
 
-  brain_server_hash_long_t *long_buf;
+  // oldest run first, commits append a new run, brain_server_db_hash_compact () merges them
 
-  i64 long_alloc;
-  i64 long_cnt;
+  brain_server_hash_run_t *run_buf;
+
+  int run_cnt;
+
+  i64 long_cnt; // sum of all runs, duplicates between runs are dropped on merge
 
   int hb;
 
+  // committed hashes which are not in the journal yet, guarded by mux_hj
+
+  brain_server_hash_long_t *jnl_buf;
+
+  i64 jnl_alloc;
+  i64 jnl_cnt;
+
+  int jnl_fd;
+
   hc_thread_mutex_t mux_hr;
   hc_thread_mutex_t mux_hg;
+  hc_thread_mutex_t mux_hc; // only one merge at a time, lock before mux_hg
+  hc_thread_mutex_t mux_hf; // journal file, lock after mux_hc and before mux_hj
+  hc_thread_mutex_t mux_hj;
 
-  bool write_hashes;
+  bool write_hashes; // runs which are not in the snapshot yet
 
 } brain_server_db_hash_t;
 
@@ -177,6 +221,15 @@ typedef struct brain_server_dumper_options
 
 } brain_server_dumper_options_t;
 
+typedef struct brain_client_lookup_options
+{
+  hc_device_param_t  *device_param;
+  const status_ctx_t *status_ctx;
+
+  bool rc;
+
+} brain_client_lookup_options_t;
+
 typedef struct brain_server_client_options
 {
   brain_server_dbs_t *brain_server_dbs;
@@ -211,24 +264,36 @@ bool  brain_client_commit               (hc_device_param_t *device_param, const
 bool  brain_client_lookup               (hc_device_param_t *device_param, const status_ctx_t *status_ctx);
 bool  brain_client_connect              (hc_device_param_t *device_param, const status_ctx_t *status_ctx, const char *host, const int port, const char *password, u32 brain_session, u32 brain_attack, i64 passwords_max, u64 *highest);
 void  brain_client_disconnect           (hc_device_param_t *device_param);
+void  brain_client_swap                 (hc_device_param_t *device_param);
+void *brain_client_handle_lookup        (void *p);
 void  brain_client_generate_hash        (u64 *hash, const char *line_buf, const size_t line_len);
+void  brain_client_sort_hashes          (u64 *sort_buf, u32 *pos_buf, const u32 *hash_buf, const u64 hash_cnt);
+
+void  brain_pack_bits                   (u8 *out_buf, size_t *out_len, u64 *acc, int *acc_bits, const u64 val, const int cnt);
+int   brain_pack_hashes_k               (const u64 hash_max, const u64 hash_cnt);
+size_t brain_pack_hashes                (u8 *out_buf, const u64 *hash_buf, const u64 hash_cnt, const int k);
+bool  brain_unpack_hashes               (u32 *out_buf, const u8 *in_buf, const size_t in_len, const int hash_cnt, const int k);
 
 int   brain_server                      (const char *listen_host, const int listen_port, const char *brain_password, const char *brain_session_whitelist, const u32 brain_server_timer);
 bool  brain_server_read_hash_dumps      (brain_server_dbs_t *brain_server_dbs, const char *path);
 bool  brain_server_write_hash_dumps     (brain_server_dbs_t *brain_server_dbs, const char *path);
-bool  brain_server_read_hash_dump       (brain_server_db_hash_t *brain_server_db_hash, const char *file);
-bool  brain_server_write_hash_dump      (brain_server_db_hash_t *brain_server_db_hash, const char *file);
+bool  brain_server_read_hash_dump       (brain_server_db_hash_t *brain_server_db_hash, const char *file, const bool journal);
+bool  brain_server_write_hash_dump      (brain_server_db_hash_t *brain_server_db_hash, const char *path);
+bool  brain_server_write_hash_journal   (brain_server_db_hash_t *brain_server_db_hash, const char *path);
 bool  brain_server_read_attack_dumps    (brain_server_dbs_t *brain_server_dbs, const char *path);
 bool  brain_server_write_attack_dumps   (brain_server_dbs_t *brain_server_dbs, const char *path);
 bool  brain_server_read_attack_dump     (brain_server_db_attack_t *brain_server_db_attack, const char *file);
-bool  brain_server_write_attack_dump    (brain_server_db_attack_t *brain_server_db_attack, const char *file);
+bool  brain_server_write_attack_dump    (brain_server_db_attack_t *brain_server_db_attack, const char *path);
+bool  brain_server_write_attack_journal (brain_server_db_attack_t *brain_server_db_attack, const char *path);
+bool  brain_server_journal_append       (int *fd, const char *file, const void *buf, const size_t len);
+bool  brain_server_journal_rotate       (int *fd, const char *file, const char *file_old, const size_t record_size);
+bool  brain_server_sync                 (const int fd);
 int   brain_server_get_client_idx       (brain_server_dbs_t *brain_server_dbs);
 
 u64   brain_server_highest_attack       (const brain_server_db_attack_t *buf);
-u64   brain_server_highest_attack_long  (const brain_server_attack_long_t  *buf, const i64 cnt, const u64 start);
-u64   brain_server_highest_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 start);
-u64   brain_server_find_attack_long     (const brain_server_attack_long_t  *buf, const i64 cnt, const u64 offset, const u64 length);
-u64   brain_server_find_attack_short    (const brain_server_attack_short_t *buf, const i64 cnt, const u64 offset, const u64 length);
+u64   brain_server_cover_attack         (const brain_server_db_attack_t *buf, const u64 start, const u64 end);
+i64   brain_server_find_attack_long     (const brain_server_attack_long_t  *buf, const i64 cnt, const u64 offset);
+i64   brain_server_find_attack_short    (const brain_server_attack_short_t *buf, const i64 cnt, const u64 offset);
 i64   brain_server_find_hash_long       (const u32 *search, const brain_server_hash_long_t  *buf, const i64 cnt);
 i64   brain_server_find_hash_short      (const u32 *search, const brain_server_hash_short_t *buf, const i64 cnt);
 int   brain_server_sort_db_hash         (const void *v1, const void *v2);
@@ -242,11 +307,23 @@ int   brain_server_sort_hash_unique     (const void *v1, const void *v2);
 void  brain_server_handle_signal        (int signo);
 void *brain_server_handle_client        (void *p);
 void *brain_server_handle_dumps         (void *p);
+void *brain_server_handle_journals      (void *p);
 void  brain_server_db_hash_init         (brain_server_db_hash_t *brain_server_db_hash, const u32 brain_session);
-bool  brain_server_db_hash_realloc      (brain_server_db_hash_t *brain_server_db_hash, const i64 new_long_cnt);
+bool  brain_server_db_hash_add_run      (brain_server_db_hash_t *brain_server_db_hash, brain_server_hash_long_t *long_buf, const i64 long_cnt);
+bool  brain_server_db_hash_compact      (brain_server_db_hash_t *brain_server_db_hash, const bool force);
+bool  brain_server_db_hash_find         (const brain_server_db_hash_t *brain_server_db_hash, const u32 *search);
+bool  brain_server_db_hash_journal      (brain_server_db_hash_t *brain_server_db_hash, const brain_server_hash_short_t *short_buf, const i64 short_cnt);
 void  brain_server_db_hash_free         (brain_server_db_hash_t *brain_server_db_hash);
+bool  brain_server_hash_run_init        (brain_server_hash_run_t *brain_server_hash_run, brain_server_hash_long_t *long_buf, const i64 long_cnt);
+bool  brain_server_hash_run_test        (const brain_server_hash_run_t *brain_server_hash_run, const u32 *search);
+void  brain_server_hash_run_free        (brain_server_hash_run_t *brain_server_hash_run);
+i64   brain_server_hash_run_merge       (brain_server_hash_long_t *out_buf, const brain_server_hash_long_t *buf1, const i64 cnt1, const brain_server_hash_long_t *buf2, const i64 cnt2);
 void  brain_server_db_attack_init       (brain_server_db_attack_t *brain_server_db_attack, const u32 brain_attack);
 bool  brain_server_db_attack_realloc    (brain_server_db_attack_t *brain_server_db_attack, const i64 new_long_cnt, const i64 new_short_cnt);
+bool  brain_server_db_attack_add_long   (brain_server_db_attack_t *brain_server_db_attack, const u64 offset, const u64 length);
+bool  brain_server_db_attack_add_short  (brain_server_db_attack_t *brain_server_db_attack, const u64 offset, const u64 length, const int client_idx);
+i64   brain_server_db_attack_release    (brain_server_db_attack_t *brain_server_db_attack, const int client_idx, const bool commit);
+bool  brain_server_db_attack_journal    (brain_server_db_attack_t *brain_server_db_attack, const u64 offset, const u64 length);
 void  brain_server_db_attack_free       (brain_server_db_attack_t *brain_server_db_attack);
 
 #endif // _BRAIN_H
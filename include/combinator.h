@@ -9,7 +9,12 @@
 #include <stdio.h>
 #include <errno.h>
 
+#define COMBS_CACHE_SIZE_MAX (512 * 1024 * 1024)
+
 int  combinator_ctx_init    (hashcat_ctx_t *hashcat_ctx);
 void combinator_ctx_destroy (hashcat_ctx_t *hashcat_ctx);
 
+int  combs_cache_update     (hashcat_ctx_t *hashcat_ctx);
+void combs_cache_destroy    (hashcat_ctx_t *hashcat_ctx);
+
 #endif // _COMBINATOR_H
@@ -0,0 +1,19 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef _CRACKSINK_H
+#define _CRACKSINK_H
+
+#include <stdio.h>
+
+int  cracksink_init    (hashcat_ctx_t *hashcat_ctx);
+void cracksink_destroy (hashcat_ctx_t *hashcat_ctx);
+void cracksink_push    (hashcat_ctx_t *hashcat_ctx, const cracksink_target_t target, const u8 *buf, const size_t len);
+void cracksink_commit  (hashcat_ctx_t *hashcat_ctx);
+void cracksink_flush   (hashcat_ctx_t *hashcat_ctx);
+
+HC_API_CALL void *thread_cracksink (void *p);
+
+#endif // _CRACKSINK_H
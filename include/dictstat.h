@@ -20,6 +20,10 @@
 #define DICTSTAT_FILENAME "hashcat.dictstat2"
 #define DICTSTAT_VERSION  (0x6863646963743200 | 0x02)
 
+#define DICTIDX_FILENAME  "hashcat.dictidx"
+#define DICTIDX_VERSION   (0x6863646964780000 | 0x02)
+#define DICTIDX_STEP      65536
+
 int sort_by_dictstat (const void *s1, const void *s2);
 
 int  dictstat_init    (hashcat_ctx_t *hashcat_ctx);
@@ -29,4 +33,7 @@ int  dictstat_write   (hashcat_ctx_t *hashcat_ctx);
 u64  dictstat_find    (hashcat_ctx_t *hashcat_ctx, dictstat_t *d);
 void dictstat_append  (hashcat_ctx_t *hashcat_ctx, dictstat_t *d);
 
+const dictidx_t *dictidx_find   (hashcat_ctx_t *hashcat_ctx, const dictstat_t *d);
+void             dictidx_append (hashcat_ctx_t *hashcat_ctx, const dictstat_t *d, dictidx_entry_t *entries, const u64 cnt);
+
 #endif // _DICTSTAT_H
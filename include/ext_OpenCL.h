@@ -17,6 +17,12 @@
 #include <CL/cl.h>
 #endif
 
+// ICD loader extras, cl_ext.h is not included
+
+#ifndef CL_PLATFORM_NOT_FOUND_KHR
+#define CL_PLATFORM_NOT_FOUND_KHR                   -1001
+#endif
+
 // NVIDIA extras
 
 #define CL_DEVICE_COMPUTE_CAPABILITY_MAJOR_NV       0x4000
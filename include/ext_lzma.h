@@ -8,14 +8,52 @@
 
 #include <LzmaDec.h>
 #include <Lzma2Dec.h>
+#include <Xz.h>
 
 #include "minizip/ioapi.h"
 #include "minizip/unzip.h"
 
+#define XZ_MAGIC     "\xfd\x37\x7a\x58\x5a\x00"
+#define XZ_MAGIC_LEN 6
+
+#define XZ_BUFSIZ    (1 << 18)
+
+// streaming xz decoder state behind HCFILE, reads the compressed data from pfp
+
+typedef struct xzfile
+{
+  FILE       *pfp;
+
+  ISzAlloc    alloc;
+  CXzUnpacker unpacker;
+
+  Byte       *inbuf;
+  size_t      inpos;
+  size_t      inlen;
+
+  Byte       *outbuf;
+  size_t      outpos;
+  size_t      outlen;
+
+  uint64_t    offset; // uncompressed
+  bool        eof;
+  bool        err;
+
+} xzfile_t;
+
 int hc_lzma1_decompress (const unsigned char *in, SizeT *in_len, unsigned char *out, SizeT *out_len, const char *props);
 int hc_lzma2_decompress (const unsigned char *in, SizeT *in_len, unsigned char *out, SizeT *out_len, const char *props);
 
 void *hc_lzma_alloc (MAYBE_UNUSED ISzAllocPtr p, size_t size);
 void  hc_lzma_free  (MAYBE_UNUSED ISzAllocPtr p, void *address);
 
+void      hc_xz_init   ();
+xzfile_t *hc_xz_open   (FILE *pfp);
+void      hc_xz_close  (xzfile_t *xfp);
+size_t    hc_xz_read   (xzfile_t *xfp, void *buf, size_t len);
+int       hc_xz_getc   (xzfile_t *xfp);
+bool      hc_xz_eof    (xzfile_t *xfp);
+void      hc_xz_rewind (xzfile_t *xfp);
+int       hc_xz_seek   (xzfile_t *xfp, const uint64_t offset);
+
 #endif // _EXT_LZMA_H
@@ -11,6 +11,13 @@
 #include <errno.h>
 #include <inttypes.h>
 
+// BGZF (bgzip, samtools), gzip members of at most 64k carrying their own size in the extra field
+
+#define BGZF_HDR_LEN       18
+#define BGZF_BLOCK_SIZE    65536
+#define BGZF_THREADS_MAX   16
+#define BGZF_BATCH_BLOCKS  8 // per thread
+
 #if defined (__CYGWIN__)
 int    _wopen       (const char *path, int oflag, ...);
 #endif
@@ -26,12 +33,16 @@ off_t  hc_ftell       (HCFILE *fp);
 int    hc_fgetc       (HCFILE *fp);
 int    hc_fileno      (HCFILE *fp);
 int    hc_feof        (HCFILE *fp);
+int    hc_ferror      (HCFILE *fp);
 void   hc_fflush      (HCFILE *fp);
 void   hc_fclose      (HCFILE *fp);
 int    hc_fputc       (int c, HCFILE *fp);
 char  *hc_fgets       (char *buf, int len, HCFILE *fp);
 size_t hc_fwrite      (const void *ptr, size_t size, size_t nmemb, HCFILE *fp);
 size_t hc_fread       (void *ptr, size_t size, size_t nmemb, HCFILE *fp);
+bool   hc_fmmap       (HCFILE *fp);
+size_t hc_fmmap_next  (HCFILE *fp, const size_t len, char **ptr);
+void   hc_fmmap_release (HCFILE *fp, const u64 beg, const u64 end);
 
 size_t fgetl        (HCFILE *fp, char *line_buf, const size_t line_sz);
 u64    count_lines  (HCFILE *fp);
@@ -18,4 +18,10 @@ void *hcrealloc (void *ptr, const size_t oldsz, const size_t addsz);
 char *hcstrdup  (const char *s);
 void  hcfree    (void *ptr);
 
+void  hcarena_init    (arena_t *arena, const size_t block_size);
+void *hcarena_alloc   (arena_t *arena, const size_t sz);
+char *hcarena_strdup  (arena_t *arena, const char *s);
+char *hcarena_strndup (arena_t *arena, const char *s, const size_t len);
+void  hcarena_destroy (arena_t *arena);
+
 #endif // _MEMORY_H
@@ -20,6 +20,11 @@
 #define SP_MARKOV_CNT (SP_PW_MAX * CHARSIZ * CHARSIZ)
 #define SP_FILESZ     (sizeof (u64) + sizeof (u64) + (sizeof (u64) * SP_ROOT_CNT) + (sizeof (u64) * SP_MARKOV_CNT))
 
+#define SP_CACHE          "hashcat.hcstat2c"
+#define SP_CACHE_VERSION  (0x6863737461746300 | 0x01)
+#define SP_CACHE_HDRSZ    (sizeof (u64) + sizeof (u64))
+#define SP_CACHE_FILESZ   (SP_CACHE_HDRSZ + SP_ROOT_CNT + SP_MARKOV_CNT)
+
 #define INCR_MASKS    1000
 
 u32   mp_get_length (const char *mask, const u32 opts_type);
@@ -0,0 +1,23 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef _NATIVE_H
+#define _NATIVE_H
+
+int  native_init  (hashcat_ctx_t *hashcat_ctx);
+void native_close (hashcat_ctx_t *hashcat_ctx);
+
+int hc_nativeDeviceInit         (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param);
+int hc_nativeCompileProgram     (hashcat_ctx_t *hashcat_ctx, const char *source_file, const char *binary_file, const char *build_options);
+int hc_nativeProgramLoad        (hashcat_ctx_t *hashcat_ctx, hc_native_program_t *program, const char *binary_file);
+int hc_nativeProgramUnload      (hashcat_ctx_t *hashcat_ctx, hc_native_program_t *program);
+int hc_nativeProgramGetFunction (hashcat_ctx_t *hashcat_ctx, hc_native_function_t *function, const hc_native_program_t *program, const char *name);
+int hc_nativeMemAlloc           (hashcat_ctx_t *hashcat_ctx, void **ptr, const size_t size);
+int hc_nativeMemFree            (hashcat_ctx_t *hashcat_ctx, void *ptr);
+int hc_nativePoolCreate         (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param);
+int hc_nativePoolDestroy        (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param);
+int hc_nativeLaunchKernel       (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const hc_native_function_t *function, const native_kernel_args_t kernel_args, void **kernel_params, const u64 gid_max);
+
+#endif // _NATIVE_H
@@ -13,6 +13,10 @@
 
 #define INCR_POT 1000
 
+// potfiles bigger than this are split into chunks which are parsed in parallel
+
+#define POT_CHUNK_SIZE (4 * 1024 * 1024)
+
 int  potfile_init             (hashcat_ctx_t *hashcat_ctx);
 int  potfile_read_open        (hashcat_ctx_t *hashcat_ctx);
 void potfile_read_close       (hashcat_ctx_t *hashcat_ctx);
@@ -25,11 +29,10 @@ int  potfile_handle_show      (hashcat_ctx_t *hashcat_ctx);
 int  potfile_handle_left      (hashcat_ctx_t *hashcat_ctx);
 
 void potfile_update_hash      (hashcat_ctx_t *hashcat_ctx, hash_t *found,  char *line_pw_buf, int line_pw_len);
-void potfile_update_hashes    (hashcat_ctx_t *hashcat_ctx, hash_t *hash_buf, char *line_pw_buf, int line_pw_len, pot_tree_entry_t *tree);
 
-void pot_tree_destroy      (pot_tree_entry_t *tree);
+int  pot_index_init    (hashcat_ctx_t *hashcat_ctx, pot_index_t *pot_index, const bool salt_only);
+void pot_index_destroy (pot_index_t *pot_index);
 
-int  sort_pot_tree_by_hash (const void *v1, const void *v2);
 int  sort_pot_orig_line    (const void *v1, const void *v2);
 
 #endif // _POTFILE_H
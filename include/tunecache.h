@@ -0,0 +1,26 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef _TUNECACHE_H
+#define _TUNECACHE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#define MAX_TUNECACHE 10000
+
+#define TUNECACHE_FILENAME "hashcat.tunecache"
+#define TUNECACHE_VERSION  (0x686374756e630000 | 0x01)
+
+int  tunecache_init    (hashcat_ctx_t *hashcat_ctx);
+void tunecache_destroy (hashcat_ctx_t *hashcat_ctx);
+void tunecache_read    (hashcat_ctx_t *hashcat_ctx);
+int  tunecache_write   (hashcat_ctx_t *hashcat_ctx);
+void tunecache_key     (hashcat_ctx_t *hashcat_ctx, const hc_device_param_t *device_param, u32 key[4]);
+bool tunecache_find    (hashcat_ctx_t *hashcat_ctx, const u32 key[4], tunecache_entry_t *entry);
+void tunecache_update  (hashcat_ctx_t *hashcat_ctx, const tunecache_entry_t *entry);
+
+#endif // _TUNECACHE_H
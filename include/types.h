@@ -638,6 +638,7 @@ typedef enum user_options_defaults
   NONCE_ERROR_CORRECTIONS  = 8,
   BACKEND_IGNORE_CUDA      = false,
   BACKEND_IGNORE_OPENCL    = false,
+  BACKEND_IGNORE_NATIVE    = false,
   BACKEND_INFO             = false,
   BACKEND_VECTOR_WIDTH     = 0,
   OPTIMIZED_KERNEL_ENABLE  = false,
@@ -688,6 +689,7 @@ typedef enum user_options_map
   IDX_BACKEND_DEVICES           = 'd',
   IDX_BACKEND_IGNORE_CUDA       = 0xff01,
   IDX_BACKEND_IGNORE_OPENCL     = 0xff02,
+  IDX_BACKEND_IGNORE_NATIVE     = 0xff4d,
   IDX_BACKEND_INFO              = 'I',
   IDX_BACKEND_VECTOR_WIDTH      = 0xff03,
   IDX_BENCHMARK_ALL             = 0xff04,
@@ -834,6 +836,23 @@ typedef void * hc_dynfunc_t;
  * structs
  */
 
+typedef struct arena_block
+{
+  struct arena_block *next;
+
+  size_t used;
+  size_t size;
+
+} arena_block_t;
+
+typedef struct arena
+{
+  arena_block_t *head;
+
+  size_t block_size;
+
+} arena_t;
+
 typedef struct user
 {
   char *user_name;
@@ -928,7 +947,10 @@ typedef struct hashes
   u32          hashes_cnt;
   hash_t      *hashes_buf;
 
+  bool         lean; // unsalted list without per-hash metadata, digests_buf is the only copy and hashes_buf is NULL
+
   hashinfo_t **hash_info;
+  arena_t      hash_info_arena; // owns all hashinfo_t, user_t, split_t and their strings
 
   u8          *out_buf; // allocates [HCBUFSIZ_LARGE];
   u8          *tmp_buf; // allocates [HCBUFSIZ_LARGE];
@@ -1049,6 +1071,57 @@ typedef struct link_speed
 
 // file handling
 
+typedef struct bgzf_block
+{
+  u8   *cbuf; // deflate data followed by the gzip trailer
+  u32   clen;
+  u8   *ubuf;
+  u32   ulen;
+  bool  err;
+
+} bgzf_block_t;
+
+struct bgzf;
+
+typedef struct bgzf_thread_param
+{
+  struct bgzf *bfp;
+
+  int      tid;
+  z_stream strm;
+
+} bgzf_thread_param_t;
+
+typedef struct bgzf
+{
+  FILE *pfp;
+
+  bgzf_block_t *blocks;
+  int           blocks_cnt;  // batch size
+  int           blocks_used; // decoded blocks in the current batch
+  int           block_cur;
+  u32           block_pos;
+
+  // inflate workers, started once per file and parked in between batches
+
+  hc_thread_t           *threads;
+  bgzf_thread_param_t   *threads_param;
+  int                    threads_cnt;
+
+  hc_thread_semaphore_t  sem_start;
+  hc_thread_semaphore_t  sem_done;
+  hc_thread_mutex_t      mux;
+  int                    block_next; // next block of the current batch to be inflated, guarded by mux
+  bool                   shutdown;
+
+  gzFile gfp; // rest of the stream, from the first member which is not a BGZF block on
+
+  u64  offset; // uncompressed
+  bool eof;
+  bool err;
+
+} bgzf_t;
+
 typedef struct hc_fp
 {
   int         fd;
@@ -1056,9 +1129,19 @@ typedef struct hc_fp
   FILE       *pfp; // plain fp
   gzFile      gfp; //  gzip fp
   unzFile     ufp; //   zip fp
+  xzfile_t   *xfp; //    xz fp
+  bgzf_t     *bfp; //  bgzf fp, gzip made of independent blocks, decoded in parallel
 
   bool        is_gzip;
+  bool        is_bgzf; // implies is_gzip
   bool        is_zip;
+  bool        is_xz;
+  bool        is_mmap;
+
+  char       *mmap_buf; // read-only plain files only, see hc_fmmap()
+  u64         mmap_len;
+  u64         mmap_pos;
+  u64         mmap_seg; // start of the last segment handed out by hc_fmmap_next()
 
   char       *mode;
   const char *path;
@@ -1068,6 +1151,71 @@ typedef struct hc_fp
 #include "ext_cuda.h"
 #include "ext_OpenCL.h"
 
+/**
+ * native backend: kernels compiled by the host C compiler into a shared object
+ */
+
+typedef size_t *(*NATIVE_GID_PTR) (void);
+
+typedef struct hc_native_program
+{
+  hc_dynlib_t     lib;
+
+  NATIVE_GID_PTR  gid_ptr;
+
+} hc_native_program_t;
+
+typedef struct hc_native_function
+{
+  hc_dynfunc_t    kernel;
+
+  NATIVE_GID_PTR  gid_ptr;
+
+} hc_native_function_t;
+
+typedef enum native_kernel_args
+{
+  NATIVE_KERNEL_ARGS_MAIN       = 1,  // KERN_ATTR: 24 buffers, 11 u32, 2 u64
+  NATIVE_KERNEL_ARGS_MEMSET     = 2,  // buffer, u32, u64
+  NATIVE_KERNEL_ARGS_BUF        = 3,  // buffer, u64
+  NATIVE_KERNEL_ARGS_DECOMPRESS = 4,  // 3 buffers, u64
+  NATIVE_KERNEL_ARGS_MP         = 5,  // 3 buffers, u64, 4 u32, u64
+  NATIVE_KERNEL_ARGS_MP_L       = 6,  // 3 buffers, u64, 5 u32, u64
+  NATIVE_KERNEL_ARGS_AMP        = 7,  // 5 buffers, u32, u64
+  NATIVE_KERNEL_ARGS_TM         = 8,  // 2 buffers
+
+} native_kernel_args_t;
+
+typedef union native_arg
+{
+  void *ptr;
+  u32   u32;
+  u64   u64;
+
+} native_arg_t;
+
+typedef struct native_pool
+{
+  hc_thread_t          *threads;
+  int                   threads_cnt;
+
+  hc_thread_semaphore_t sem_start;
+  hc_thread_semaphore_t sem_done;
+
+  // current launch, written by the launching thread only while all workers are parked
+
+  hc_native_function_t  function;
+  native_kernel_args_t  kernel_args;
+  native_arg_t          args[PARAMCNT];
+
+  u64                   gid_max;
+  u64                   gid_chunk;
+  u64                   gid_next;
+
+  bool                  shutdown;
+
+} native_pool_t;
+
 typedef struct hc_device_param
 {
   int     device_id;
@@ -1251,6 +1399,8 @@ typedef struct hc_device_param
   u64  size_brain_link_out;
 
   int           brain_link_client_fd;
+  int           brain_link_client_fd_prev;
+  u64           brain_link_pending;
   link_speed_t  brain_link_recv_speed;
   link_speed_t  brain_link_send_speed;
   bool          brain_link_recv_active;
@@ -1259,11 +1409,19 @@ typedef struct hc_device_param
   u64           brain_link_send_bytes;
   u8           *brain_link_in_buf;
   u32          *brain_link_out_buf;
+  u64          *brain_link_sort_buf;
+  u32          *brain_link_pos_buf;
+  u64          *brain_link_batch_buf;
+  u64          *brain_link_batch_buf_prev;
+  u64           brain_link_batch_cnt;
+  u64           brain_link_batch_cnt_prev;
+  u32           brain_link_version;
   #endif
 
   char     *scratch_buf;
 
   HCFILE    combs_fp;
+  u64       combs_pos; // read position in combinator_ctx->combs_cache
   pw_t     *combs_buf;
 
   void     *hooks_buf;
@@ -1551,6 +1709,79 @@ typedef struct hc_device_param
   cl_mem            opencl_d_st_salts_buf;
   cl_mem            opencl_d_st_esalts_buf;
 
+  // API: native
+
+  bool              is_native;
+
+  native_pool_t    *native_pool;
+
+  hc_native_program_t native_program;
+  hc_native_program_t native_program_shared;
+  hc_native_program_t native_program_mp;
+  hc_native_program_t native_program_amp;
+
+  hc_native_function_t native_function1;
+  hc_native_function_t native_function12;
+  hc_native_function_t native_function2p;
+  hc_native_function_t native_function2;
+  hc_native_function_t native_function2e;
+  hc_native_function_t native_function23;
+  hc_native_function_t native_function3;
+  hc_native_function_t native_function4;
+  hc_native_function_t native_function_init2;
+  hc_native_function_t native_function_loop2p;
+  hc_native_function_t native_function_loop2;
+  hc_native_function_t native_function_mp;
+  hc_native_function_t native_function_mp_l;
+  hc_native_function_t native_function_mp_r;
+  hc_native_function_t native_function_amp;
+  hc_native_function_t native_function_tm;
+  hc_native_function_t native_function_memset;
+  hc_native_function_t native_function_atinit;
+  hc_native_function_t native_function_utf8toutf16le;
+  hc_native_function_t native_function_decompress;
+  hc_native_function_t native_function_aux1;
+  hc_native_function_t native_function_aux2;
+  hc_native_function_t native_function_aux3;
+  hc_native_function_t native_function_aux4;
+
+  void             *native_d_pws_buf;
+  void             *native_d_pws_amp_buf;
+  void             *native_d_pws_comp_buf;
+  void             *native_d_pws_idx;
+  void             *native_d_rules;
+  void             *native_d_rules_c;
+  void             *native_d_combs;
+  void             *native_d_combs_c;
+  void             *native_d_bfs;
+  void             *native_d_bfs_c;
+  void             *native_d_tm_c;
+  void             *native_d_bitmap_s1_a;
+  void             *native_d_bitmap_s1_b;
+  void             *native_d_bitmap_s1_c;
+  void             *native_d_bitmap_s1_d;
+  void             *native_d_bitmap_s2_a;
+  void             *native_d_bitmap_s2_b;
+  void             *native_d_bitmap_s2_c;
+  void             *native_d_bitmap_s2_d;
+  void             *native_d_plain_bufs;
+  void             *native_d_digests_buf;
+  void             *native_d_digests_shown;
+  void             *native_d_salt_bufs;
+  void             *native_d_esalt_bufs;
+  void             *native_d_tmps;
+  void             *native_d_hooks;
+  void             *native_d_result;
+  void             *native_d_extra0_buf;
+  void             *native_d_extra1_buf;
+  void             *native_d_extra2_buf;
+  void             *native_d_extra3_buf;
+  void             *native_d_root_css_buf;
+  void             *native_d_markov_css_buf;
+  void             *native_d_st_digests_buf;
+  void             *native_d_st_salts_buf;
+  void             *native_d_st_esalts_buf;
+
 } hc_device_param_t;
 
 typedef struct backend_ctx
@@ -1571,6 +1802,8 @@ typedef struct backend_ctx
   int                 cuda_devices_active;
   int                 opencl_devices_cnt;
   int                 opencl_devices_active;
+  int                 native_devices_cnt;
+  int                 native_devices_active;
 
   u64                 backend_devices_filter;
 
@@ -1613,6 +1846,14 @@ typedef struct backend_ctx
 
   cl_device_type      opencl_device_types_filter;
 
+  // native
+
+  bool                native;
+
+  char               *native_compiler;
+  char               *native_compiler_version;
+  char               *native_host_chksum;
+
 } backend_ctx_t;
 
 typedef enum kernel_workload
@@ -1695,6 +1936,42 @@ typedef struct aes_context
 
 typedef aes_context_t aes_ctx;
 
+typedef enum cracksink_target
+{
+  CRACKSINK_OUTFILE  = 0,
+  CRACKSINK_POTFILE  = 1,
+  CRACKSINK_LOOPBACK = 2,
+
+  CRACKSINK_TARGETS  = 3,
+
+} cracksink_target_t;
+
+typedef struct cracksink_buf
+{
+  u8     *buf;
+  size_t  len;
+  size_t  avail;
+
+} cracksink_buf_t;
+
+// collects the lines check_hash () produces and writes them from a separate thread, one batch per file at a time
+
+typedef struct cracksink_ctx
+{
+  bool enabled;
+  bool shutdown;
+  bool signaled; // writer thread was woken up for the current pending batch
+
+  cracksink_buf_t pending[CRACKSINK_TARGETS]; // protected by mux_pending
+  cracksink_buf_t writing[CRACKSINK_TARGETS]; // protected by mux_write
+
+  hc_thread_t           thread;
+  hc_thread_mutex_t     mux_pending;
+  hc_thread_mutex_t     mux_write;
+  hc_thread_semaphore_t sem_work;
+
+} cracksink_ctx_t;
+
 typedef struct debugfile_ctx
 {
   HCFILE  fp;
@@ -1719,6 +1996,22 @@ typedef struct dictstat
 
 } dictstat_t;
 
+typedef struct dictidx_entry
+{
+  u64 word; // accepted word number
+  u64 off;  // byte offset of the line it was read from
+
+} dictidx_entry_t;
+
+typedef struct dictidx
+{
+  dictstat_t d; // same key as the hashcat.dictstat2 entry
+
+  dictidx_entry_t *entries; // sorted, at most DICTIDX_STEP words apart
+  u64              cnt;
+
+} dictidx_t;
+
 typedef struct hashdump
 {
   int version;
@@ -1741,6 +2034,11 @@ typedef struct dictstat_ctx
   size_t cnt;
   #endif
 
+  char *idx_filename;
+
+  dictidx_t *idx_base;
+  u32        idx_cnt;
+
 } dictstat_ctx_t;
 
 typedef struct loopback_ctx
@@ -1794,31 +2092,44 @@ typedef struct potfile_ctx
 
 } potfile_ctx_t;
 
-// this is a linked list structure of all the hashes with the same "key" (hash or hash + salt)
+// open addressing (linear probing) index over hashes_buf, used to match the potfile entries
+// there could be multiple entries for each identical hash+salt combination
+// (e.g. same hashes, but different user names with --show and --username... we want to update all of them!)
+// they all end up in the same probe sequence, so a lookup simply continues until it hits a free slot
 
-typedef struct pot_hash_node
+typedef struct pot_index
 {
-  hash_t *hash_buf;
+  u32 *slots; // position in hashes_buf + 1, 0 marks a free slot
+  u32 *keys;  // hash of the key stored in the slot, saves most of the full compares
+  u32  mask;
 
-  struct pot_hash_node *next;
+  bool salt_only; // key is the raw salt only, pre-filter for module_potfile_custom_check ()
 
-} pot_hash_node_t;
+} pot_index_t;
 
-// Attention: this is only used when --show and --username are used together
-// there could be multiple entries for each identical hash+salt combination
-// (e.g. same hashes, but different user names... we want to print all of them!)
-// that is why we use a linked list here
+// a potfile line which cracks a hash, the plain still lives in the line buffer or the mapped potfile
 
-typedef struct pot_tree_entry
+typedef struct pot_match
 {
-  pot_hash_node_t *nodes; // head of the linked list (under the field "hash_buf" it contains the sorting keys)
+  hash_t     *hash;       // NULL in lean mode, see hashes_t
+  u32         digest_pos; // lean mode only
+  const char *pw_buf;
+  u32         pw_len;
 
-  // the hashconfig is required to distinguish between salted and non-salted hashes and to make sure
-  // we compare the correct dgst_pos0...dgst_pos3
+} pot_match_t;
 
-  hashconfig_t *hashconfig;
+// newline aligned part of the mapped potfile, the matches are applied in file order once all chunks are parsed
 
-} pot_tree_entry_t;
+typedef struct pot_chunk
+{
+  u64 beg;
+  u64 end;
+
+  pot_match_t *matches;
+  u64          matches_cnt;
+  u64          matches_avail;
+
+} pot_chunk_t;
 
 typedef struct pot_orig_line_entry
 {
@@ -1916,11 +2227,46 @@ typedef struct tuning_db
 
 } tuning_db_t;
 
+typedef struct tunecache_entry
+{
+  u32    key[4];       // md5 over everything the autotune result depends on, see tunecache_key ()
+
+  u32    kernel_accel;
+  u32    kernel_loops;
+
+  double exec_msec;    // measured with kernel_accel and kernel_loops when the entry was stored
+
+} tunecache_entry_t;
+
+typedef struct tunecache_ctx
+{
+  bool enabled;
+  bool dirty;
+
+  char *filename;
+
+  tunecache_entry_t *base;
+  u32                cnt;
+
+  hc_thread_mutex_t  mux;
+
+} tunecache_ctx_t;
+
+typedef struct wl_segment
+{
+  char *buf;
+  u64   avail;
+  u64   cnt;
+  bool  eof;
+
+} wl_segment_t;
+
 typedef struct wl_data
 {
   bool enabled;
 
   char *buf;
+  char *seg; // segment being parsed, either buf or a window into the mmap()'ed wordlist
   u64  incr;
   u64  avail;
   u64  cnt;
@@ -1932,6 +2278,24 @@ typedef struct wl_data
 
   void (*func) (char *, u64, u64 *, u64 *);
 
+  const dictidx_t *idx;
+
+  // asynchronous reader, fills a bounded queue of segments while the current one is parsed
+
+  bool    async_enabled;
+  bool    async_done;
+  bool    async_shutdown;
+
+  HCFILE *async_fp;
+
+  wl_segment_t *async_slots;
+  int           async_slot_rd;
+  int           async_slot_wr;
+
+  hc_thread_t           async_thread;
+  hc_thread_semaphore_t async_sem_filled;
+  hc_thread_semaphore_t async_sem_free;
+
 } wl_data_t;
 
 typedef struct user_options
@@ -1993,6 +2357,7 @@ typedef struct user_options
   bool         markov_disable;
   bool         backend_ignore_cuda;
   bool         backend_ignore_opencl;
+  bool         backend_ignore_native;
   bool         backend_info;
   bool         optimized_kernel_enable;
   bool         outfile_autohex;
@@ -2167,6 +2532,7 @@ typedef struct straight_ctx
 
   u32             kernel_rules_cnt;
   kernel_rule_t  *kernel_rules_buf;
+  kernel_rule_t  *kernel_rules_orig; // as loaded, before canonicalization, only kept for the debug output
 
   char **dicts;
   u32    dicts_pos;
@@ -2177,6 +2543,32 @@ typedef struct straight_ctx
 
 } straight_ctx_t;
 
+// the combs file (right-hand wordlist in -a 1, the wordlist in -a 7) is read once and kept here
+// filtered, rule-applied and encoded, so run_cracker () does not need to parse it again for each salt
+
+typedef struct combs_cache
+{
+  bool  enabled;
+
+  char *filename;
+
+  u8   *buf;
+  u64   buf_len;
+  u64   buf_avail;
+
+  u64  *offs;
+  u32  *lens;
+  u32  *rejects; // lines rejected by -k in front of each entry, NULL if there were none
+  u32   rejects_tail;
+
+  u64   cnt;
+  u64   avail;
+
+  char *oversized_filename; // did not fit into COMBS_CACHE_SIZE_MAX last time, stream it instead of reading it again
+  u64   oversized_size;
+
+} combs_cache_t;
+
 typedef struct combinator_ctx
 {
   bool enabled;
@@ -2187,6 +2579,8 @@ typedef struct combinator_ctx
   u32 combs_mode;
   u64 combs_cnt;
 
+  combs_cache_t combs_cache;
+
 } combinator_ctx_t;
 
 typedef struct mask_ctx
@@ -2201,8 +2595,13 @@ typedef struct mask_ctx
   cs_t  *css_buf;
   u32    css_cnt;
 
-  hcstat_table_t *root_table_buf;
-  hcstat_table_t *markov_table_buf;
+  // keys of each position (and previous key), sorted by frequency, see SP_CACHE
+
+  u8    *root_table_buf;
+  u8    *markov_table_buf;
+
+  u8    *sp_tbl_buf;
+  bool   sp_tbl_mapped;
 
   cs_t  *root_css_buf;
   cs_t  *markov_css_buf;
@@ -2572,6 +2971,7 @@ typedef struct hashcat_ctx
   bitmap_ctx_t          *bitmap_ctx;
   combinator_ctx_t      *combinator_ctx;
   cpt_ctx_t             *cpt_ctx;
+  cracksink_ctx_t       *cracksink_ctx;
   debugfile_ctx_t       *debugfile_ctx;
   dictstat_ctx_t        *dictstat_ctx;
   event_ctx_t           *event_ctx;
@@ -2594,6 +2994,7 @@ typedef struct hashcat_ctx
   status_ctx_t          *status_ctx;
   straight_ctx_t        *straight_ctx;
   tuning_db_t           *tuning_db;
+  tunecache_ctx_t       *tunecache_ctx;
   user_options_extra_t  *user_options_extra;
   user_options_t        *user_options;
   wl_data_t             *wl_data;
@@ -2602,6 +3003,95 @@ typedef struct hashcat_ctx
 
 } hashcat_ctx_t;
 
+#define HASHES_SORT_BUCKETS      0x10000
+#define HASHES_SORT_THREADED_MIN 0x100000
+
+typedef struct hash_key
+{
+  u32 key[4]; // digest words in the order of dgst_pos3 .. dgst_pos0
+  u32 idx;    // position in hashes_buf
+
+} hash_key_t;
+
+typedef struct hashes_sort
+{
+  // either keys, or the packed digests in lean mode
+
+  hash_key_t *keys;
+
+  u8                 *digests;
+  u32                 dgst_size;
+  const hashconfig_t *hashconfig;
+
+  u64 *buckets; // start of each bucket, plus the end
+  u32  word;    // key word and shift the buckets are taken from
+  u32  shift;
+
+} hashes_sort_t;
+
+typedef struct hashes_sort_thread_param
+{
+  hashes_sort_t *sort;
+
+  u32 bucket_beg;
+  u32 bucket_end;
+
+} hashes_sort_thread_param_t;
+
+#define HASHLIST_PARSE_LINES  0x10000
+#define HASHLIST_PARSE_BUFSIZ (32 * 1024 * 1024)
+
+typedef struct hashlist_parse_line
+{
+  char *line_buf;
+  int   line_len;
+  u32   line_num;
+
+  char *hash_buf;
+  int   hash_len;
+  char *user_buf;
+  int   user_len;
+
+  u32   hashes_pos;    // first of the slots in hashes_buf reserved for this line
+  int   hashes_parsed; // leading slots which decoded fine
+  int   parser_status; // of the first slot which did not
+  int   split_origin;
+  bool  fmt_error;
+
+} hashlist_parse_line_t;
+
+struct hashlist_parse_batch;
+
+typedef struct hashlist_parse_thread_param
+{
+  hashcat_ctx_t *hashcat_ctx;
+
+  struct hashlist_parse_batch *batch;
+
+  int tid;
+
+} hashlist_parse_thread_param_t;
+
+typedef struct hashlist_parse_batch
+{
+  u32   hashlist_format;
+  u32   slots_per_line;
+
+  char *buf;
+
+  hashlist_parse_line_t *lines;
+  u32                    lines_cnt;
+
+  hash_t                *views; // lean mode only, hash_t views onto digests_buf for the current batch
+  u32                    views_base;
+
+  hc_thread_t                   *threads;
+  hashlist_parse_thread_param_t *threads_param;
+  int                            threads_cnt;
+  int                            threads_used;
+
+} hashlist_parse_batch_t;
+
 typedef struct thread_param
 {
   u32 tid;
@@ -2610,6 +3100,58 @@ typedef struct thread_param
 
 } thread_param_t;
 
+typedef struct wl_count
+{
+  u64 beg; // byte range within the wordlist, starts and ends on a line boundary
+  u64 end;
+
+  u64 words;
+  u64 cnt2;
+
+  dictidx_entry_t *idx;
+  u64              idx_cnt;
+  u64              idx_avail;
+
+} wl_count_t;
+
+typedef struct wl_count_thread_param
+{
+  int tid;
+  int tsz;
+
+  hashcat_ctx_t *hashcat_ctx;
+
+  HCFILE *fp;
+
+  wl_count_t *chunks;
+  u32         chunks_cnt;
+
+  bool idx_build;
+
+  iconv_t iconv_ctx;
+  char   *iconv_tmp;
+
+} wl_count_thread_param_t;
+
+typedef struct pot_thread_param
+{
+  int tid;
+  int tsz;
+
+  hashcat_ctx_t     *hashcat_ctx;
+  const pot_index_t *pot_index;
+
+  pot_chunk_t *chunks;
+  u32          chunks_cnt;
+
+  // per-thread scratch, the module decoders write into them
+
+  hash_t  hash_buf;
+  void   *tmps;
+  char   *line_buf;
+
+} pot_thread_param_t;
+
 typedef struct hook_thread_param
 {
   int tid;
@@ -2653,6 +3195,65 @@ typedef struct token
 
 } token_t;
 
+typedef struct token_trace
+{
+  const u8 *input_buf;
+  int       input_len;
+
+  int       calls;
+
+  token_t   token;
+
+} token_trace_t;
+
+#define AUTODETECT_CLASSES_MAX    8
+#define AUTODETECT_SIGNATURE_LEN  32
+
+typedef enum autodetect_entry_flags
+{
+  AUTODETECT_ENTRY_SKIP    = 1 << 0, // module never takes part in autodetect
+  AUTODETECT_ENTRY_ANY     = 1 << 1, // no constraints known, always test the module
+  AUTODETECT_ENTRY_BOUNDED = 1 << 2, // len_max is valid
+
+} autodetect_entry_flags_t;
+
+typedef struct autodetect_entry
+{
+  u32 hash_mode;
+  u32 flags;
+  u32 separator;
+
+  u32 len_min;
+  u32 len_max;
+
+  // number of separators, some modules pick the separator character depending on the input so only their count is known
+
+  u32 separators_min;
+
+  // fixed-length tokens at a fixed offset and the character class they have to pass
+
+  u32 classes_cnt;
+  u32 classes_pos[AUTODETECT_CLASSES_MAX];
+  u32 classes_len[AUTODETECT_CLASSES_MAX];
+  u32 classes_attr[AUTODETECT_CLASSES_MAX];
+
+  // signature token at a fixed offset
+
+  u32 signature_pos;
+  u32 signature_len;
+  u32 signatures_cnt;
+  u8  signatures_buf[MAX_SIGNATURES][AUTODETECT_SIGNATURE_LEN];
+
+} autodetect_entry_t;
+
+typedef struct autodetect_index
+{
+  autodetect_entry_t *entries;
+
+  u32 entries_cnt;
+
+} autodetect_index_t;
+
 /**
  * hash category is relevant in usage.c (--help screen)
  */
@@ -9,6 +9,10 @@
 #include <time.h>
 #include <inttypes.h>
 
+// segments the reader thread may prepare ahead of the parser, each one is segment_size big
+
+#define WL_ASYNC_SLOTS 3
+
 size_t convert_from_hex (hashcat_ctx_t *hashcat_ctx, char *line_buf, const size_t line_len);
 
 void pw_pre_add  (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len, const u8 *base_buf, const int base_len, const int rule_idx);
@@ -26,4 +30,11 @@ int  count_words     (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfi
 int  wl_data_init    (hashcat_ctx_t *hashcat_ctx);
 void wl_data_destroy (hashcat_ctx_t *hashcat_ctx);
 
+bool wl_data_eof         (hashcat_ctx_t *hashcat_ctx, HCFILE *fp);
+bool wl_data_error       (hashcat_ctx_t *hashcat_ctx, HCFILE *fp);
+int  wl_data_async_start (hashcat_ctx_t *hashcat_ctx, HCFILE *fp);
+void wl_data_async_stop  (hashcat_ctx_t *hashcat_ctx);
+void wl_data_index_load  (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile);
+u64  wl_data_seek        (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const u64 cur, const u64 end);
+
 #endif // _WORDLIST_H
@@ -0,0 +1,710 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "bitops.h"
+#include "convert.h"
+#include "shared.h"
+#include "folder.h"
+#include "locking.h"
+#include "dynloader.h"
+#include "interface.h"
+#include "filehandling.h"
+#include "autodetect.h"
+
+typedef void (*INPUT_TOKENIZER_TRACE) (token_trace_t *);
+
+static const u32 AUTODETECT_CLASS_ATTR = TOKEN_ATTR_VERIFY_DIGIT
+                                       | TOKEN_ATTR_VERIFY_FLOAT
+                                       | TOKEN_ATTR_VERIFY_HEX
+                                       | TOKEN_ATTR_VERIFY_BASE64A
+                                       | TOKEN_ATTR_VERIFY_BASE64B
+                                       | TOKEN_ATTR_VERIFY_BASE64C;
+
+static u64 autodetect_fnv (u64 hash, const u8 *buf, const size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    hash ^= buf[i];
+    hash *= 0x100000001b3;
+  }
+
+  return hash;
+}
+
+static u64 autodetect_index_key (hashcat_ctx_t *hashcat_ctx)
+{
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+  const user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  // any module added, removed or rebuilt invalidates the index
+  // the sum keeps the key independent of the order readdir () returns the files in
+
+  char *modules_dir;
+
+  hc_asprintf (&modules_dir, "%s/modules", folder_config->shared_dir);
+
+  char **files = scan_directory (modules_dir);
+
+  u64 key = 0;
+
+  for (int i = 0; files[i] != NULL; i++)
+  {
+    struct stat st;
+
+    if (stat (files[i], &st) == 0)
+    {
+      const u64 size  = (u64) st.st_size;
+      const u64 mtime = (u64) st.st_mtime;
+
+      u64 hash = 0xcbf29ce484222325;
+
+      hash = autodetect_fnv (hash, (const u8 *) files[i], strlen (files[i]));
+      hash = autodetect_fnv (hash, (const u8 *) &size,  sizeof (size));
+      hash = autodetect_fnv (hash, (const u8 *) &mtime, sizeof (mtime));
+
+      key += hash;
+    }
+
+    hcfree (files[i]);
+  }
+
+  hcfree (files);
+
+  hcfree (modules_dir);
+
+  // the separator is an input to the modules
+
+  const u64 separator = (u64) (u8) user_options->separator;
+
+  key = autodetect_fnv (key, (const u8 *) &separator, sizeof (separator));
+
+  return key;
+}
+
+static void autodetect_entry_signatures (autodetect_entry_t *entry, const token_t *token, const u32 pos, const int len)
+{
+  if (len > AUTODETECT_SIGNATURE_LEN) return;
+
+  if ((token->signatures_cnt < 1) || (token->signatures_cnt > MAX_SIGNATURES)) return;
+
+  for (int i = 0; i < token->signatures_cnt; i++)
+  {
+    if (token->signatures_buf[i] == NULL) return;
+  }
+
+  // same comparison as the tokenizer, a shorter signature is zero padded to the token length
+
+  for (int i = 0; i < token->signatures_cnt; i++)
+  {
+    const char *signature = token->signatures_buf[i];
+
+    memcpy (entry->signatures_buf[i], signature, strnlen (signature, len));
+  }
+
+  entry->signature_pos  = pos;
+  entry->signature_len  = len;
+  entry->signatures_cnt = token->signatures_cnt;
+}
+
+static bool autodetect_is_separator (const u8 c)
+{
+  if ((c >= '0') && (c <= '9')) return false;
+  if ((c >= 'a') && (c <= 'z')) return false;
+  if ((c >= 'A') && (c <= 'Z')) return false;
+
+  return true;
+}
+
+static u32 autodetect_separators (const u8 *buf, const u32 len)
+{
+  u32 cnt = 0;
+
+  for (u32 i = 0; i < len; i++)
+  {
+    if (autodetect_is_separator (buf[i]) == true) cnt++;
+  }
+
+  return cnt;
+}
+
+static void autodetect_entry_layout (autodetect_entry_t *entry, const token_t *token)
+{
+  // derive the constraints every input has to meet before input_tokenizer () accepts it with this layout
+
+  if ((token->token_cnt < 1) || (token->token_cnt > MAX_TOKENS)) return;
+
+  bool fixed_pos = true;
+  bool bounded   = true;
+
+  u64 pos     = 0;
+  u64 len_min = 0;
+  u64 len_max = 0;
+
+  for (int token_idx = 0; token_idx < token->token_cnt; token_idx++)
+  {
+    const int attr = token->attr[token_idx];
+
+    if (attr & TOKEN_ATTR_FIXED_LENGTH)
+    {
+      const int len = token->len[token_idx];
+
+      if (len < 0) return;
+
+      if (fixed_pos == true)
+      {
+        const u32 class_attr = attr & AUTODETECT_CLASS_ATTR;
+
+        if ((class_attr != 0) && (entry->classes_cnt < AUTODETECT_CLASSES_MAX))
+        {
+          entry->classes_pos[entry->classes_cnt]  = pos;
+          entry->classes_len[entry->classes_cnt]  = len;
+          entry->classes_attr[entry->classes_cnt] = class_attr;
+
+          entry->classes_cnt++;
+        }
+
+        if ((attr & TOKEN_ATTR_VERIFY_SIGNATURE) && (entry->signatures_cnt == 0))
+        {
+          autodetect_entry_signatures (entry, token, pos, len);
+        }
+      }
+
+      pos     += len;
+      len_min += len;
+      len_max += len;
+    }
+    else
+    {
+      // the token ends at a separator, so everything after it moves
+
+      fixed_pos = false;
+
+      if (attr & TOKEN_ATTR_VERIFY_LENGTH)
+      {
+        len_min += MAX (token->len_min[token_idx], 0);
+        len_max += MAX (token->len_max[token_idx], 0);
+      }
+      else
+      {
+        bounded = false;
+      }
+
+      if (attr & TOKEN_ATTR_OPTIONAL_ROUNDS) bounded = false;
+
+      if (token_idx < (token->token_cnt - 1))
+      {
+        len_min += 1;
+        len_max += 1;
+
+        if (autodetect_is_separator ((u8) token->sep[token_idx]) == true) entry->separators_min++;
+      }
+    }
+  }
+
+  if (len_min > 0xffffffff) return;
+  if (len_max > 0xffffffff) bounded = false;
+
+  entry->len_min = len_min;
+  entry->len_max = (bounded == true) ? len_max : 0;
+
+  entry->flags &= ~AUTODETECT_ENTRY_ANY;
+
+  if (bounded == true) entry->flags |= AUTODETECT_ENTRY_BOUNDED;
+}
+
+static int autodetect_decode_traced (hashcat_ctx_t *hashcat_ctx, INPUT_TOKENIZER_TRACE tokenizer_trace, const char *line_buf, const int line_len, token_trace_t *trace)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const module_ctx_t *module_ctx = hashcat_ctx->module_ctx;
+
+  void   *digest    =            hccalloc (1, hashconfig->dgst_size);
+  salt_t *salt      = (salt_t *) hccalloc (1, sizeof (salt_t));
+  void   *esalt     = NULL;
+  void   *hook_salt = NULL;
+
+  if (hashconfig->esalt_size > 0)
+  {
+    esalt = hccalloc (1, hashconfig->esalt_size);
+  }
+
+  if (hashconfig->hook_salt_size > 0)
+  {
+    hook_salt = hccalloc (1, hashconfig->hook_salt_size);
+  }
+
+  hashinfo_t *hash_info = (hashinfo_t *) hcmalloc (sizeof (hashinfo_t));
+
+  hash_info->user     = (user_t *)  hcmalloc (sizeof (user_t));
+  hash_info->orighash = (char *)    hcmalloc (256);
+  hash_info->split    = (split_t *) hcmalloc (sizeof (split_t));
+
+  memset (trace, 0, sizeof (token_trace_t));
+
+  tokenizer_trace (trace);
+
+  const int parser_status = module_ctx->module_hash_decode (hashconfig, digest, salt, esalt, hook_salt, hash_info, line_buf, line_len);
+
+  tokenizer_trace (NULL);
+
+  hcfree (hash_info->user);
+  hcfree (hash_info->orighash);
+  hcfree (hash_info->split);
+  hcfree (hash_info);
+
+  hcfree (digest);
+  hcfree (salt);
+  hcfree (esalt);
+  hcfree (hook_salt);
+
+  return parser_status;
+}
+
+static void autodetect_entry_trace (hashcat_ctx_t *hashcat_ctx, autodetect_entry_t *entry)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const module_ctx_t *module_ctx = hashcat_ctx->module_ctx;
+
+  entry->separator = (u8) hashconfig->separator;
+
+  if (hashconfig->opts_type & OPTS_TYPE_AUTODETECT_DISABLE)
+  {
+    entry->flags = AUTODETECT_ENTRY_SKIP;
+
+    return;
+  }
+
+  // binary hashfiles are not parsed by the tokenizer
+
+  if (hashconfig->opts_type & OPTS_TYPE_BINARY_HASHFILE) return;
+
+  if (hashconfig->st_hash == NULL) return;
+
+  INPUT_TOKENIZER_TRACE tokenizer_trace = (INPUT_TOKENIZER_TRACE) hc_dlsym (module_ctx->module_handle, "input_tokenizer_trace");
+
+  if (tokenizer_trace == NULL) return;
+
+  const int st_len = (int) strlen (hashconfig->st_hash);
+
+  if (st_len >= HCBUFSIZ_LARGE) return;
+
+  // some parsers read a bit beyond a malformed hash, give them the same room as a line read from a hashfile
+
+  char *st_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+
+  memcpy (st_buf, hashconfig->st_hash, st_len);
+
+  token_trace_t *trace = (token_trace_t *) hcmalloc (sizeof (token_trace_t));
+
+  // a module calling the tokenizer more than once may fall back to another layout if the first one does not match
+  // a truncated self-test hash makes the first layout fail, so such a module shows itself by calling the tokenizer again
+
+  bool fallback = true;
+
+  if (st_len > 1)
+  {
+    autodetect_decode_traced (hashcat_ctx, tokenizer_trace, st_buf, st_len - 1, trace);
+
+    fallback = (trace->calls > 1);
+  }
+
+  if (fallback == false)
+  {
+    // parse the self-test hash and record the layout the module hands over to the tokenizer
+
+    const int parser_status = autodetect_decode_traced (hashcat_ctx, tokenizer_trace, st_buf, st_len, trace);
+
+    // only trust layouts which are applied to the whole hash, not to some part the module extracted itself
+
+    if ((parser_status == PARSER_OK) && (trace->calls == 1) && (trace->input_buf == (const u8 *) st_buf) && (trace->input_len == st_len))
+    {
+      autodetect_entry_layout (entry, &trace->token);
+    }
+  }
+
+  hcfree (trace);
+  hcfree (st_buf);
+}
+
+static void autodetect_index_build (hashcat_ctx_t *hashcat_ctx, autodetect_index_t *autodetect_index)
+{
+  folder_config_t *folder_config = hashcat_ctx->folder_config;
+  user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  char *modulefile = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  u32 entries_avail = 0;
+
+  for (int i = 0; i < MODULE_HASH_MODES_MAXIMUM; i++)
+  {
+    module_filename (folder_config, i, modulefile, HCBUFSIZ_TINY);
+
+    if (hc_path_exist (modulefile) == false) continue;
+
+    if (autodetect_index->entries_cnt == entries_avail)
+    {
+      autodetect_index->entries = (autodetect_entry_t *) hcrealloc (autodetect_index->entries, entries_avail * sizeof (autodetect_entry_t), 256 * sizeof (autodetect_entry_t));
+
+      entries_avail += 256;
+    }
+
+    autodetect_entry_t *entry = autodetect_index->entries + autodetect_index->entries_cnt;
+
+    memset (entry, 0, sizeof (autodetect_entry_t));
+
+    entry->hash_mode = i;
+    entry->flags     = AUTODETECT_ENTRY_ANY;
+    entry->separator = (u8) user_options->separator;
+
+    user_options->hash_mode = i;
+
+    if (hashconfig_init (hashcat_ctx) == 0)
+    {
+      autodetect_entry_trace (hashcat_ctx, entry);
+    }
+
+    hashconfig_destroy (hashcat_ctx);
+
+    autodetect_index->entries_cnt++;
+  }
+
+  hcfree (modulefile);
+}
+
+static bool autodetect_index_read (const char *filename, autodetect_index_t *autodetect_index, const u64 key)
+{
+  HCFILE fp;
+
+  if (hc_fopen (&fp, filename, "rb") == false) return false;
+
+  u64 v;
+  u64 k;
+
+  const size_t nread1 = hc_fread (&v, sizeof (u64), 1, &fp);
+  const size_t nread2 = hc_fread (&k, sizeof (u64), 1, &fp);
+
+  v = byte_swap_64 (v);
+  k = byte_swap_64 (k);
+
+  if ((nread1 != 1) || (nread2 != 1) || (v != AUTODETECT_INDEX_VERSION) || (k != key))
+  {
+    hc_fclose (&fp);
+
+    return false;
+  }
+
+  u32 entries_avail = 0;
+
+  while (autodetect_index->entries_cnt < (u32) MODULE_HASH_MODES_MAXIMUM)
+  {
+    if (autodetect_index->entries_cnt == entries_avail)
+    {
+      autodetect_index->entries = (autodetect_entry_t *) hcrealloc (autodetect_index->entries, entries_avail * sizeof (autodetect_entry_t), 256 * sizeof (autodetect_entry_t));
+
+      entries_avail += 256;
+    }
+
+    autodetect_entry_t *entry = autodetect_index->entries + autodetect_index->entries_cnt;
+
+    if (hc_fread (entry, sizeof (autodetect_entry_t), 1, &fp) != 1) break;
+
+    if ((entry->signatures_cnt > MAX_SIGNATURES) || (entry->signature_len > AUTODETECT_SIGNATURE_LEN)
+     || (entry->classes_cnt > AUTODETECT_CLASSES_MAX)
+     || (entry->hash_mode >= (u32) MODULE_HASH_MODES_MAXIMUM))
+    {
+      hc_fclose (&fp);
+
+      autodetect_index->entries_cnt = 0;
+
+      return false;
+    }
+
+    autodetect_index->entries_cnt++;
+  }
+
+  hc_fclose (&fp);
+
+  return (autodetect_index->entries_cnt > 0);
+}
+
+static void autodetect_index_write (const char *filename, const autodetect_index_t *autodetect_index, const u64 key)
+{
+  // not being able to store the index only costs time on the next run
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, filename, "wb") == false) return;
+
+  if (hc_lockfile (&fp) == -1)
+  {
+    hc_fclose (&fp);
+
+    return;
+  }
+
+  u64 v = AUTODETECT_INDEX_VERSION;
+  u64 k = key;
+
+  v = byte_swap_64 (v);
+  k = byte_swap_64 (k);
+
+  hc_fwrite (&v, sizeof (u64), 1, &fp);
+  hc_fwrite (&k, sizeof (u64), 1, &fp);
+
+  hc_fwrite (autodetect_index->entries, sizeof (autodetect_entry_t), autodetect_index->entries_cnt, &fp);
+
+  hc_unlockfile (&fp);
+
+  hc_fclose (&fp);
+}
+
+int autodetect_index_init (hashcat_ctx_t *hashcat_ctx, autodetect_index_t *autodetect_index)
+{
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+
+  memset (autodetect_index, 0, sizeof (autodetect_index_t));
+
+  const u64 key = autodetect_index_key (hashcat_ctx);
+
+  char *filename;
+
+  hc_asprintf (&filename, "%s/%s", folder_config->cache_dir, AUTODETECT_INDEX_FILENAME);
+
+  if (autodetect_index_read (filename, autodetect_index, key) == false)
+  {
+    autodetect_index_destroy (autodetect_index);
+
+    autodetect_index_build (hashcat_ctx, autodetect_index);
+
+    autodetect_index_write (filename, autodetect_index, key);
+  }
+
+  hcfree (filename);
+
+  if (autodetect_index->entries_cnt == 0) return -1;
+
+  return 0;
+}
+
+void autodetect_index_destroy (autodetect_index_t *autodetect_index)
+{
+  hcfree (autodetect_index->entries);
+
+  memset (autodetect_index, 0, sizeof (autodetect_index_t));
+}
+
+static bool autodetect_entry_match (const autodetect_entry_t *entry, const u8 *buf, const u32 len, const u32 separators)
+{
+  if (len < entry->len_min) return false;
+
+  if (entry->flags & AUTODETECT_ENTRY_BOUNDED)
+  {
+    if (len > entry->len_max) return false;
+  }
+
+  if (separators < entry->separators_min) return false;
+
+  if (entry->signatures_cnt > 0)
+  {
+    if (((u64) entry->signature_pos + entry->signature_len) > len) return false;
+
+    bool matched = false;
+
+    for (u32 i = 0; i < entry->signatures_cnt; i++)
+    {
+      if (memcmp (buf + entry->signature_pos, entry->signatures_buf[i], entry->signature_len) == 0) matched = true;
+    }
+
+    if (matched == false) return false;
+  }
+
+  for (u32 i = 0; i < entry->classes_cnt; i++)
+  {
+    const u32 pos  = entry->classes_pos[i];
+    const u32 size = entry->classes_len[i];
+    const u32 attr = entry->classes_attr[i];
+
+    if (((u64) pos + size) > len) return false;
+
+    const u8 *ptr = buf + pos;
+
+    if ((attr & TOKEN_ATTR_VERIFY_DIGIT)   && (is_valid_digit_string   (ptr, size) == false)) return false;
+    if ((attr & TOKEN_ATTR_VERIFY_FLOAT)   && (is_valid_float_string   (ptr, size) == false)) return false;
+    if ((attr & TOKEN_ATTR_VERIFY_HEX)     && (is_valid_hex_string     (ptr, size) == false)) return false;
+    if ((attr & TOKEN_ATTR_VERIFY_BASE64A) && (is_valid_base64a_string (ptr, size) == false)) return false;
+    if ((attr & TOKEN_ATTR_VERIFY_BASE64B) && (is_valid_base64b_string (ptr, size) == false)) return false;
+    if ((attr & TOKEN_ATTR_VERIFY_BASE64C) && (is_valid_base64c_string (ptr, size) == false)) return false;
+  }
+
+  return true;
+}
+
+static u32 autodetect_index_select_line (hashcat_ctx_t *hashcat_ctx, const autodetect_index_t *autodetect_index, bool *selected, const u8 *line_buf, const u32 line_len)
+{
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  // the hash can be the whole line, the part after the username or one of the columns of the pwdump, passwd and shadow formats
+  // the hashlist format is detected per module, so simply test all of them
+
+  const u8 *cand_buf[4];
+  u32       cand_len[4];
+
+  u32 cand_cnt = 0;
+
+  cand_buf[cand_cnt] = line_buf;
+  cand_len[cand_cnt] = line_len;
+
+  cand_cnt++;
+
+  u32 colons = 0;
+
+  for (u32 i = 0; i < line_len; i++)
+  {
+    if (line_buf[i] == ':') colons++;
+  }
+
+  if ((colons == 6) || (colons == 8))
+  {
+    u32 column = 0;
+    u32 start  = 0;
+
+    for (u32 i = 0; i <= line_len; i++)
+    {
+      if ((i < line_len) && (line_buf[i] != ':')) continue;
+
+      if ((column >= 1) && (column <= 3) && (i > start))
+      {
+        cand_buf[cand_cnt] = line_buf + start;
+        cand_len[cand_cnt] = i - start;
+
+        cand_cnt++;
+      }
+
+      column++;
+
+      start = i + 1;
+    }
+  }
+
+  u32 cand_separators[4];
+
+  for (u32 i = 0; i < cand_cnt; i++)
+  {
+    cand_separators[i] = autodetect_separators (cand_buf[i], cand_len[i]);
+  }
+
+  u32 user_sep = 0x100;
+
+  const u8 *user_buf = NULL;
+  u32       user_len = 0;
+  u32       user_separators = 0;
+
+  u32 selected_cnt = 0;
+
+  for (u32 i = 0; i < autodetect_index->entries_cnt; i++)
+  {
+    const autodetect_entry_t *entry = autodetect_index->entries + i;
+
+    if (selected[entry->hash_mode] == true) continue;
+
+    if (entry->flags & AUTODETECT_ENTRY_SKIP) continue;
+
+    bool match = false;
+
+    for (u32 j = 0; j < cand_cnt; j++)
+    {
+      if (autodetect_entry_match (entry, cand_buf[j], cand_len[j], cand_separators[j]) == false) continue;
+
+      match = true;
+
+      break;
+    }
+
+    if ((match == false) && (user_options->username == true))
+    {
+      if (entry->separator != user_sep)
+      {
+        user_sep = entry->separator;
+
+        const u8 *sep_pos = (const u8 *) memchr (line_buf, (int) user_sep, line_len);
+
+        user_buf = (sep_pos == NULL) ? NULL : sep_pos + 1;
+        user_len = (sep_pos == NULL) ? 0    : line_len - (u32) (user_buf - line_buf);
+
+        user_separators = (sep_pos == NULL) ? 0 : autodetect_separators (user_buf, user_len);
+      }
+
+      if ((user_buf != NULL) && (user_len > 0))
+      {
+        match = autodetect_entry_match (entry, user_buf, user_len, user_separators);
+      }
+    }
+
+    if (match == false) continue;
+
+    selected[entry->hash_mode] = true;
+
+    selected_cnt++;
+  }
+
+  return selected_cnt;
+}
+
+void autodetect_index_select (hashcat_ctx_t *hashcat_ctx, const autodetect_index_t *autodetect_index, bool *selected)
+{
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+
+  // selected[] is indexed by hash-mode and has MODULE_HASH_MODES_MAXIMUM elements
+
+  u32 remaining = 0;
+
+  for (u32 i = 0; i < autodetect_index->entries_cnt; i++)
+  {
+    const autodetect_entry_t *entry = autodetect_index->entries + i;
+
+    if (entry->flags & AUTODETECT_ENTRY_SKIP) continue;
+
+    if (entry->flags & AUTODETECT_ENTRY_ANY)
+    {
+      selected[entry->hash_mode] = true;
+
+      continue;
+    }
+
+    remaining++;
+  }
+
+  const char *hc_hash = user_options_extra->hc_hash;
+
+  if (hc_path_exist (hc_hash) == false)
+  {
+    autodetect_index_select_line (hashcat_ctx, autodetect_index, selected, (const u8 *) hc_hash, (u32) strlen (hc_hash));
+
+    return;
+  }
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, hc_hash, "rb") == false) return;
+
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+
+  while (!hc_feof (&fp))
+  {
+    if (remaining == 0) break;
+
+    const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_LARGE);
+
+    if (line_len == 0) continue;
+
+    remaining -= autodetect_index_select_line (hashcat_ctx, autodetect_index, selected, (const u8 *) line_buf, (u32) line_len);
+  }
+
+  hcfree (line_buf);
+
+  hc_fclose (&fp);
+}
@@ -8,6 +8,7 @@
 #include "event.h"
 #include "backend.h"
 #include "status.h"
+#include "tunecache.h"
 #include "autotune.h"
 
 static double try_run (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 kernel_accel, const u32 kernel_loops)
@@ -109,15 +110,190 @@ static double try_run_preferred (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *
 }
 */
 
+// searches kernel-accel and kernel-loops so that a kernel run stays below target_msec
+
+static int autotune_search (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, u32 *kernel_accel_out, u32 *kernel_loops_out)
+{
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  const double target_msec = backend_ctx->target_msec;
+
+  const u32 kernel_accel_min = device_param->kernel_accel_min;
+  const u32 kernel_accel_max = device_param->kernel_accel_max;
+
+  const u32 kernel_loops_min = device_param->kernel_loops_min;
+  const u32 kernel_loops_max = device_param->kernel_loops_max;
+
+  u32 kernel_accel = kernel_accel_min;
+  u32 kernel_loops = kernel_loops_min;
+
+  // reuse the result of an earlier session for the same device, hash-mode, kernel and search space
+  // as long as a quick validation run still matches the runtime measured back then
+
+  tunecache_entry_t tunecache_entry;
+
+  memset (&tunecache_entry, 0, sizeof (tunecache_entry_t));
+
+  tunecache_key (hashcat_ctx, device_param, tunecache_entry.key);
+
+  tunecache_entry_t cached;
+
+  if (tunecache_find (hashcat_ctx, tunecache_entry.key, &cached) == true)
+  {
+    if ((cached.kernel_accel >= kernel_accel_min) && (cached.kernel_accel <= kernel_accel_max)
+     && (cached.kernel_loops >= kernel_loops_min) && (cached.kernel_loops <= kernel_loops_max))
+    {
+      try_run (hashcat_ctx, device_param, cached.kernel_accel, cached.kernel_loops);
+
+      const double exec_msec = try_run (hashcat_ctx, device_param, cached.kernel_accel, cached.kernel_loops);
+
+      if ((exec_msec > (cached.exec_msec * 0.5)) && (exec_msec < (cached.exec_msec * 1.5)))
+      {
+        *kernel_accel_out = cached.kernel_accel;
+        *kernel_loops_out = cached.kernel_loops;
+
+        return 0;
+      }
+    }
+  }
+
+  // Do a pre-autotune test run to find out if kernel runtime is above some TDR limit
+
+  u32 kernel_loops_max_reduced = kernel_loops_max;
+
+  if (true)
+  {
+    double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_min, kernel_loops_min);
+
+    if (exec_msec > 2000)
+    {
+      event_log_error (hashcat_ctx, "Kernel minimum runtime larger than default TDR");
+
+      return -1;
+    }
+
+    exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_min, kernel_loops_min);
+
+    const u32 mm = kernel_loops_max / kernel_loops_min;
+
+    if ((exec_msec * mm) > target_msec)
+    {
+      const u32 loops_valid = (const u32) (target_msec / exec_msec);
+
+      kernel_loops_max_reduced = kernel_loops_min * loops_valid;
+    }
+  }
+
+  // first find out highest kernel-loops that stays below target_msec
+
+  if (kernel_loops_min < kernel_loops_max)
+  {
+    for (kernel_loops = kernel_loops_max; kernel_loops > kernel_loops_min; kernel_loops >>= 1)
+    {
+      if (kernel_loops > kernel_loops_max_reduced) continue;
+
+      double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_min, kernel_loops);
+
+      if (exec_msec < target_msec) break;
+    }
+  }
+
+  // now the same for kernel-accel but with the new kernel-loops from previous loop set
+
+  #define STEPS_CNT 16
+
+  if (kernel_accel_min < kernel_accel_max)
+  {
+    for (int i = 0; i < STEPS_CNT; i++)
+    {
+      const u32 kernel_accel_try = 1U << i;
+
+      if (kernel_accel_try < kernel_accel_min) continue;
+      if (kernel_accel_try > kernel_accel_max) break;
+
+      double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_try, kernel_loops);
+
+      if (exec_msec > target_msec) break;
+
+      kernel_accel = kernel_accel_try;
+    }
+  }
+
+  // now find the middle balance between kernel_accel and kernel_loops
+  // while respecting allowed ranges at the same time
+
+  if (kernel_accel < kernel_loops)
+  {
+    const u32 kernel_accel_orig = kernel_accel;
+    const u32 kernel_loops_orig = kernel_loops;
+
+    double exec_msec_prev = try_run (hashcat_ctx, device_param, kernel_accel, kernel_loops);
+
+    for (int i = 1; i < STEPS_CNT; i++)
+    {
+      const u32 kernel_accel_try = kernel_accel_orig * (1U << i);
+      const u32 kernel_loops_try = kernel_loops_orig / (1U << i);
+
+      if (kernel_accel_try < kernel_accel_min) continue;
+      if (kernel_accel_try > kernel_accel_max) break;
+
+      if (kernel_loops_try > kernel_loops_max) continue;
+      if (kernel_loops_try < kernel_loops_min) break;
+
+      // do a real test
+
+      const double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_try, kernel_loops_try);
+
+      if (exec_msec_prev < exec_msec) break;
+
+      exec_msec_prev = exec_msec;
+
+      // so far, so good! save
+
+      kernel_accel = kernel_accel_try;
+      kernel_loops = kernel_loops_try;
+
+      // too much if the next test is true
+
+      if (kernel_loops_try < kernel_accel_try) break;
+    }
+  }
+
+  double exec_msec_pre_final = try_run (hashcat_ctx, device_param, kernel_accel, kernel_loops);
+
+  const u32 exec_left = (const u32) (target_msec / exec_msec_pre_final);
+
+  const u32 accel_left = kernel_accel_max / kernel_accel;
+
+  const u32 exec_accel_min = MIN (exec_left, accel_left); // we want that to be int
+
+  if (exec_accel_min >= 1)
+  {
+    // this is safe to not overflow kernel_accel_max because of accel_left
+
+    kernel_accel *= exec_accel_min;
+  }
+
+  // remember the result together with its runtime for the next session
+
+  tunecache_entry.kernel_accel = kernel_accel;
+  tunecache_entry.kernel_loops = kernel_loops;
+  tunecache_entry.exec_msec    = try_run (hashcat_ctx, device_param, kernel_accel, kernel_loops);
+
+  tunecache_update (hashcat_ctx, &tunecache_entry);
+
+  *kernel_accel_out = kernel_accel;
+  *kernel_loops_out = kernel_loops;
+
+  return 0;
+}
+
 static int autotune (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   const hashconfig_t    *hashconfig   = hashcat_ctx->hashconfig;
-  const backend_ctx_t   *backend_ctx  = hashcat_ctx->backend_ctx;
   const straight_ctx_t  *straight_ctx = hashcat_ctx->straight_ctx;
   const user_options_t  *user_options = hashcat_ctx->user_options;
 
-  const double target_msec = backend_ctx->target_msec;
-
   const u32 kernel_accel_min = device_param->kernel_accel_min;
   const u32 kernel_accel_max = device_param->kernel_accel_max;
 
@@ -174,6 +350,11 @@ static int autotune (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       if (CL_rc == -1) return -1;
     }
 
+    if (device_param->is_native == true)
+    {
+      if (run_native_kernel_atinit (hashcat_ctx, device_param, device_param->native_d_pws_buf, kernel_power_max) == -1) return -1;
+    }
+
     if (user_options->slow_candidates == true)
     {
     }
@@ -196,126 +377,16 @@ static int autotune (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
 
             if (CL_rc == -1) return -1;
           }
-        }
-      }
-    }
 
-    // Do a pre-autotune test run to find out if kernel runtime is above some TDR limit
-
-    u32 kernel_loops_max_reduced = kernel_loops_max;
-
-    if (true)
-    {
-      double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_min, kernel_loops_min);
-
-      if (exec_msec > 2000)
-      {
-        event_log_error (hashcat_ctx, "Kernel minimum runtime larger than default TDR");
-
-        return -1;
-      }
-
-      exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_min, kernel_loops_min);
-
-      const u32 mm = kernel_loops_max / kernel_loops_min;
-
-      if ((exec_msec * mm) > target_msec)
-      {
-        const u32 loops_valid = (const u32) (target_msec / exec_msec);
-
-        kernel_loops_max_reduced = kernel_loops_min * loops_valid;
-      }
-    }
-
-    // first find out highest kernel-loops that stays below target_msec
-
-    if (kernel_loops_min < kernel_loops_max)
-    {
-      for (kernel_loops = kernel_loops_max; kernel_loops > kernel_loops_min; kernel_loops >>= 1)
-      {
-        if (kernel_loops > kernel_loops_max_reduced) continue;
-
-        double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_min, kernel_loops);
-
-        if (exec_msec < target_msec) break;
-      }
-    }
-
-    // now the same for kernel-accel but with the new kernel-loops from previous loop set
-
-    #define STEPS_CNT 16
-
-    if (kernel_accel_min < kernel_accel_max)
-    {
-      for (int i = 0; i < STEPS_CNT; i++)
-      {
-        const u32 kernel_accel_try = 1U << i;
-
-        if (kernel_accel_try < kernel_accel_min) continue;
-        if (kernel_accel_try > kernel_accel_max) break;
-
-        double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_try, kernel_loops);
-
-        if (exec_msec > target_msec) break;
-
-        kernel_accel = kernel_accel_try;
-      }
-    }
-
-    // now find the middle balance between kernel_accel and kernel_loops
-    // while respecting allowed ranges at the same time
-
-    if (kernel_accel < kernel_loops)
-    {
-      const u32 kernel_accel_orig = kernel_accel;
-      const u32 kernel_loops_orig = kernel_loops;
-
-      double exec_msec_prev = try_run (hashcat_ctx, device_param, kernel_accel, kernel_loops);
-
-      for (int i = 1; i < STEPS_CNT; i++)
-      {
-        const u32 kernel_accel_try = kernel_accel_orig * (1U << i);
-        const u32 kernel_loops_try = kernel_loops_orig / (1U << i);
-
-        if (kernel_accel_try < kernel_accel_min) continue;
-        if (kernel_accel_try > kernel_accel_max) break;
-
-        if (kernel_loops_try > kernel_loops_max) continue;
-        if (kernel_loops_try < kernel_loops_min) break;
-
-        // do a real test
-
-        const double exec_msec = try_run (hashcat_ctx, device_param, kernel_accel_try, kernel_loops_try);
-
-        if (exec_msec_prev < exec_msec) break;
-
-        exec_msec_prev = exec_msec;
-
-        // so far, so good! save
-
-        kernel_accel = kernel_accel_try;
-        kernel_loops = kernel_loops_try;
-
-        // too much if the next test is true
-
-        if (kernel_loops_try < kernel_accel_try) break;
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_rules_c, device_param->native_d_rules, MIN (kernel_loops_max, KERNEL_RULES) * sizeof (kernel_rule_t));
+          }
+        }
       }
     }
 
-    double exec_msec_pre_final = try_run (hashcat_ctx, device_param, kernel_accel, kernel_loops);
-
-    const u32 exec_left = (const u32) (target_msec / exec_msec_pre_final);
-
-    const u32 accel_left = kernel_accel_max / kernel_accel;
-
-    const u32 exec_accel_min = MIN (exec_left, accel_left); // we want that to be int
-
-    if (exec_accel_min >= 1)
-    {
-      // this is safe to not overflow kernel_accel_max because of accel_left
-
-      kernel_accel *= exec_accel_min;
-    }
+    if (autotune_search (hashcat_ctx, device_param, &kernel_accel, &kernel_loops) == -1) return -1;
 
     // start finding best thread count is easier.
     // it's either the preferred or the maximum thread count
@@ -404,6 +475,14 @@ static int autotune (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     if (CL_rc == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    if (run_native_kernel_memset (hashcat_ctx, device_param, device_param->native_d_pws_buf,       0, device_param->size_pws)     == -1) return -1;
+    if (run_native_kernel_memset (hashcat_ctx, device_param, device_param->native_d_plain_bufs,    0, device_param->size_plains)  == -1) return -1;
+    if (run_native_kernel_memset (hashcat_ctx, device_param, device_param->native_d_digests_shown, 0, device_param->size_shown)   == -1) return -1;
+    if (run_native_kernel_memset (hashcat_ctx, device_param, device_param->native_d_result,        0, device_param->size_results) == -1) return -1;
+  }
+
   // reset timer
 
   device_param->exec_pos = 0;
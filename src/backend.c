@@ -23,6 +23,7 @@
 #include "event.h"
 #include "dynloader.h"
 #include "backend.h"
+#include "native.h"
 #include "terminal.h"
 
 #if defined (__linux__)
@@ -55,6 +56,10 @@ static bool is_same_device (const hc_device_param_t *src, const hc_device_param_
 
   if ((src->is_cuda == true) && (dst->is_cuda == true)) return false;
 
+  // The native backend runs on the host CPU next to any OpenCL CPU runtime, it's never an alias
+
+  if ((src->is_native == true) || (dst->is_native == true)) return false;
+
   // But OpenCL can have aliases
 
   if ((src->is_opencl == true) && (dst->is_opencl == true))
@@ -143,6 +148,7 @@ static bool is_same_device_type (const hc_device_param_t *src, const hc_device_p
 
   if (src->is_cuda   != dst->is_cuda)   return false;
   if (src->is_opencl != dst->is_opencl) return false;
+  if (src->is_native != dst->is_native) return false;
 
   if (strcmp (src->device_name, dst->device_name) != 0) return false;
 
@@ -2394,6 +2400,10 @@ int hc_clGetPlatformIDs (hashcat_ctx_t *hashcat_ctx, cl_uint num_entries, cl_pla
 
   if (CL_err != CL_SUCCESS)
   {
+    // an ICD loader without any platform installed is the normal case on CPU-only hosts, the native backend takes over
+
+    if ((CL_err == CL_PLATFORM_NOT_FOUND_KHR) && (backend_ctx->native == true)) return -1;
+
     event_log_error (hashcat_ctx, "clGetPlatformIDs(): %s", val2cstr_cl (CL_err));
 
     return -1;
@@ -2910,6 +2920,11 @@ int gidd_to_pw_t (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, c
     if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_TRUE, gidd * sizeof (pw_idx_t), sizeof (pw_idx_t), &pw_idx, 0, NULL, NULL) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    memcpy (&pw_idx, (const pw_idx_t *) device_param->native_d_pws_idx + gidd, sizeof (pw_idx_t));
+  }
+
   const u32 off = pw_idx.off;
   const u32 cnt = pw_idx.cnt;
   const u32 len = pw_idx.len;
@@ -2934,6 +2949,14 @@ int gidd_to_pw_t (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, c
     }
   }
 
+  if (device_param->is_native == true)
+  {
+    if (cnt > 0)
+    {
+      memcpy (pw->i, (const u32 *) device_param->native_d_pws_comp_buf + off, cnt * sizeof (u32));
+    }
+  }
+
   for (u32 i = cnt; i < 64; i++)
   {
     pw->i[i] = 0;
@@ -2980,6 +3003,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
             if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tm_c, size_tm) == -1) return -1;
           }
 
+          if (device_param->is_native == true)
+          {
+            if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_tm_c, size_tm) == -1) return -1;
+          }
+
           if (run_kernel_tm (hashcat_ctx, device_param) == -1) return -1;
 
           if (device_param->is_cuda == true)
@@ -2991,6 +3019,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
           {
             if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tm_c, device_param->opencl_d_bfs_c, 0, 0, size_tm, 0, NULL, NULL) == -1) return -1;
           }
+
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_bfs_c, device_param->native_d_tm_c, size_tm);
+          }
         }
       }
     }
@@ -3051,6 +3084,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
         if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_amp_buf, device_param->opencl_d_pws_buf, 0, 0, pws_cnt * sizeof (pw_t), 0, NULL, NULL) == -1) return -1;
       }
 
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->native_d_pws_buf, device_param->native_d_pws_amp_buf, pws_cnt * sizeof (pw_t));
+      }
+
       if (user_options->slow_candidates == true)
       {
       }
@@ -3070,6 +3108,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
         {
           if (run_opencl_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->opencl_d_pws_buf, pws_cnt) == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          if (run_native_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->native_d_pws_buf, pws_cnt) == -1) return -1;
+        }
       }
 
       if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, pws_pos, pws_cnt, false, 0) == -1) return -1;
@@ -3088,6 +3131,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
           if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
         }
 
+        if (device_param->is_native == true)
+        {
+          memcpy (device_param->hooks_buf, device_param->native_d_hooks, pws_cnt * hashconfig->hook_size);
+        }
+
         const int hook_threads = (int) user_options->hook_threads;
 
         hook_thread_param_t *hook_threads_param = (hook_thread_param_t *) hccalloc (hook_threads, sizeof (hook_thread_param_t));
@@ -3136,6 +3184,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
         {
           if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          memcpy (device_param->native_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size);
+        }
       }
     }
 
@@ -3226,6 +3279,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
               if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
             }
 
+            if (device_param->is_native == true)
+            {
+              memcpy (device_param->hooks_buf, device_param->native_d_hooks, pws_cnt * hashconfig->hook_size);
+            }
+
             const int hook_threads = (int) user_options->hook_threads;
 
             hook_thread_param_t *hook_threads_param = (hook_thread_param_t *) hccalloc (hook_threads, sizeof (hook_thread_param_t));
@@ -3274,6 +3332,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
             {
               if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
             }
+
+            if (device_param->is_native == true)
+            {
+              memcpy (device_param->native_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size);
+            }
           }
         }
       }
@@ -3394,6 +3457,11 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
       {
         if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
+      }
     }
   }
 
@@ -3652,6 +3720,48 @@ int run_opencl_kernel_bzero (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *devi
   return run_opencl_kernel_memset (hashcat_ctx, device_param, buf, 0, size);
 }
 
+int run_native_kernel_atinit (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u64 num)
+{
+  device_param->kernel_params_atinit[0]       = (void *) &buf;
+  device_param->kernel_params_atinit_buf64[1] = num;
+
+  return hc_nativeLaunchKernel (hashcat_ctx, device_param, &device_param->native_function_atinit, NATIVE_KERNEL_ARGS_BUF, device_param->kernel_params_atinit, num);
+}
+
+int run_native_kernel_utf8toutf16le (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u64 num)
+{
+  device_param->kernel_params_utf8toutf16le[0]       = (void *) &buf;
+  device_param->kernel_params_utf8toutf16le_buf64[1] = num;
+
+  return hc_nativeLaunchKernel (hashcat_ctx, device_param, &device_param->native_function_utf8toutf16le, NATIVE_KERNEL_ARGS_BUF, device_param->kernel_params_utf8toutf16le, num);
+}
+
+int run_native_kernel_memset (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED hc_device_param_t *device_param, void *buf, const u32 value, const u64 size)
+{
+  // native device memory is host memory, no need to go through gpu_memset
+
+  if (value == 0)
+  {
+    memset (buf, 0, size);
+
+    return 0;
+  }
+
+  u8 *ptr = (u8 *) buf;
+
+  for (u64 i = 0; i < size; i += 4)
+  {
+    memcpy (ptr + i, &value, MIN (size - i, 4));
+  }
+
+  return 0;
+}
+
+int run_native_kernel_bzero (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, void *buf, const u64 size)
+{
+  return run_native_kernel_memset (hashcat_ctx, device_param, buf, 0, size);
+}
+
 int run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 kern_run, const u64 pws_pos, const u64 num, const u32 event_update, const u32 iteration)
 {
   const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
@@ -4027,6 +4137,56 @@ int run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, con
     if (hc_clFinish (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    hc_native_function_t *native_function = NULL;
+
+    switch (kern_run)
+    {
+      case KERN_RUN_1:      native_function = &device_param->native_function1;       break;
+      case KERN_RUN_12:     native_function = &device_param->native_function12;      break;
+      case KERN_RUN_2P:     native_function = &device_param->native_function2p;     break;
+      case KERN_RUN_2:      native_function = &device_param->native_function2;       break;
+      case KERN_RUN_2E:     native_function = &device_param->native_function2e;      break;
+      case KERN_RUN_23:     native_function = &device_param->native_function23;      break;
+      case KERN_RUN_3:      native_function = &device_param->native_function3;       break;
+      case KERN_RUN_4:      native_function = &device_param->native_function4;       break;
+      case KERN_RUN_INIT2:  native_function = &device_param->native_function_init2;  break;
+      case KERN_RUN_LOOP2P: native_function = &device_param->native_function_loop2p; break;
+      case KERN_RUN_LOOP2:  native_function = &device_param->native_function_loop2;  break;
+      case KERN_RUN_AUX1:   native_function = &device_param->native_function_aux1;   break;
+      case KERN_RUN_AUX2:   native_function = &device_param->native_function_aux2;   break;
+      case KERN_RUN_AUX3:   native_function = &device_param->native_function_aux3;   break;
+      case KERN_RUN_AUX4:   native_function = &device_param->native_function_aux4;   break;
+    }
+
+    // vector_width is always 1 on the native backend, so there's no SIMD adjustment of num_elements
+
+    hc_timer_t timer;
+
+    hc_timer_set (&timer);
+
+    if (hc_nativeLaunchKernel (hashcat_ctx, device_param, native_function, NATIVE_KERNEL_ARGS_MAIN, device_param->kernel_params, num_elements) == -1) return -1;
+
+    const double exec_ms = hc_timer_get (timer);
+
+    if (event_update)
+    {
+      u32 exec_pos = device_param->exec_pos;
+
+      device_param->exec_msec[exec_pos] = exec_ms;
+
+      exec_pos++;
+
+      if (exec_pos == EXEC_CACHE)
+      {
+        exec_pos = 0;
+      }
+
+      device_param->exec_pos = exec_pos;
+    }
+  }
+
   return 0;
 }
 
@@ -4125,6 +4285,33 @@ int run_kernel_mp (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
     if (hc_clFinish (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    hc_native_function_t *native_function = NULL;
+
+    native_kernel_args_t native_kernel_args = NATIVE_KERNEL_ARGS_MP;
+
+    void **native_args = NULL;
+
+    switch (kern_run)
+    {
+      case KERN_RUN_MP:   native_function    = &device_param->native_function_mp;
+                          native_kernel_args = NATIVE_KERNEL_ARGS_MP;
+                          native_args        = device_param->kernel_params_mp;
+                          break;
+      case KERN_RUN_MP_R: native_function    = &device_param->native_function_mp_r;
+                          native_kernel_args = NATIVE_KERNEL_ARGS_MP;
+                          native_args        = device_param->kernel_params_mp_r;
+                          break;
+      case KERN_RUN_MP_L: native_function    = &device_param->native_function_mp_l;
+                          native_kernel_args = NATIVE_KERNEL_ARGS_MP_L;
+                          native_args        = device_param->kernel_params_mp_l;
+                          break;
+    }
+
+    if (hc_nativeLaunchKernel (hashcat_ctx, device_param, native_function, native_kernel_args, native_args, num_elements) == -1) return -1;
+  }
+
   return 0;
 }
 
@@ -4157,6 +4344,11 @@ int run_kernel_tm (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
     if (hc_clFinish (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    if (hc_nativeLaunchKernel (hashcat_ctx, device_param, &device_param->native_function_tm, NATIVE_KERNEL_ARGS_TM, device_param->kernel_params_tm, num_elements) == -1) return -1;
+  }
+
   return 0;
 }
 
@@ -4197,6 +4389,11 @@ int run_kernel_amp (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
     if (hc_clFinish (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    if (hc_nativeLaunchKernel (hashcat_ctx, device_param, &device_param->native_function_amp, NATIVE_KERNEL_ARGS_AMP, device_param->kernel_params_amp, num_elements) == -1) return -1;
+  }
+
   return 0;
 }
 
@@ -4237,6 +4434,11 @@ int run_kernel_decompress (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device
     if (hc_clFinish (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    if (hc_nativeLaunchKernel (hashcat_ctx, device_param, &device_param->native_function_decompress, NATIVE_KERNEL_ARGS_DECOMPRESS, device_param->kernel_params_decompress, num_elements) == -1) return -1;
+  }
+
   return 0;
 }
 
@@ -4291,6 +4493,20 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
       }
     }
 
+    if (device_param->is_native == true)
+    {
+      memcpy (device_param->native_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t));
+
+      const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
+
+      const u32 off = pw_idx->off;
+
+      if (off)
+      {
+        memcpy (device_param->native_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32));
+      }
+    }
+
     if (run_kernel_decompress (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
   }
   else
@@ -4325,6 +4541,20 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
         }
       }
 
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->native_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t));
+
+        const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
+
+        const u32 off = pw_idx->off;
+
+        if (off)
+        {
+          memcpy (device_param->native_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32));
+        }
+      }
+
       if (run_kernel_decompress (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
     }
     else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
@@ -4393,6 +4623,20 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
           }
         }
 
+        if (device_param->is_native == true)
+        {
+          memcpy (device_param->native_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t));
+
+          const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
+
+          const u32 off = pw_idx->off;
+
+          if (off)
+          {
+            memcpy (device_param->native_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32));
+          }
+        }
+
         if (run_kernel_decompress (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
       }
       else
@@ -4427,6 +4671,20 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
             }
           }
 
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t));
+
+            const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
+
+            const u32 off = pw_idx->off;
+
+            if (off)
+            {
+              memcpy (device_param->native_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32));
+            }
+          }
+
           if (run_kernel_decompress (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
         }
         else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
@@ -4459,6 +4717,20 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
             }
           }
 
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t));
+
+            const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
+
+            const u32 off = pw_idx->off;
+
+            if (off)
+            {
+              memcpy (device_param->native_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32));
+            }
+          }
+
           if (run_kernel_decompress (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
         }
         else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
@@ -4484,6 +4756,75 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
   return 0;
 }
 
+static u32 combs_cache_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 salt_pos, const u64 pws_cnt, const u32 innerloop_left, const bool add_padding)
+{
+  const combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+  const hashconfig_t     *hashconfig     = hashcat_ctx->hashconfig;
+  status_ctx_t           *status_ctx     = hashcat_ctx->status_ctx;
+
+  const combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  // entries are already filtered, rule-applied, encoded and uppercased, see combs_cache_update ()
+
+  u32 i = 0;
+
+  while (i < innerloop_left)
+  {
+    if (device_param->combs_pos >= combs_cache->cnt)
+    {
+      // lines rejected behind the last entry are seen once per pass, just like reaching EOF
+
+      if (device_param->combs_pos == combs_cache->cnt)
+      {
+        status_ctx->words_progress_rejected[salt_pos] += pws_cnt * combs_cache->rejects_tail;
+
+        device_param->combs_pos++;
+      }
+
+      break;
+    }
+
+    const u64 combs_idx = device_param->combs_pos++;
+
+    if (combs_cache->rejects != NULL)
+    {
+      status_ctx->words_progress_rejected[salt_pos] += pws_cnt * combs_cache->rejects[combs_idx];
+    }
+
+    const u32 line_len = combs_cache->lens[combs_idx];
+
+    u8 *ptr = (u8 *) device_param->combs_buf[i].i;
+
+    memcpy (ptr, combs_cache->buf + combs_cache->offs[combs_idx], line_len);
+
+    memset (ptr + line_len, 0, PW_MAX - line_len);
+
+    if (add_padding == true)
+    {
+      if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
+      {
+        ptr[line_len] = 0x80;
+      }
+
+      if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
+      {
+        ptr[line_len] = 0x06;
+      }
+
+      if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
+      {
+        ptr[line_len] = 0x01;
+      }
+    }
+
+    device_param->combs_buf[i].pw_len = line_len;
+
+    i++;
+  }
+
+  return i;
+}
+
 int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_pos, const u64 pws_cnt)
 {
   combinator_ctx_t      *combinator_ctx     = hashcat_ctx->combinator_ctx;
@@ -4588,7 +4929,14 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
     {
       if ((user_options->attack_mode == ATTACK_MODE_COMBI) || (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2)))
       {
-        hc_rewind (combs_fp);
+        if (combinator_ctx->combs_cache.enabled == true)
+        {
+          device_param->combs_pos = 0;
+        }
+        else
+        {
+          hc_rewind (combs_fp);
+        }
       }
     }
 
@@ -4672,6 +5020,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
           {
             if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_rules, device_param->opencl_d_rules_c, innerloop_pos * sizeof (kernel_rule_t), 0, innerloop_left * sizeof (kernel_rule_t), 0, NULL, NULL) == -1) return -1;
           }
+
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_rules_c, (const u8 *) device_param->native_d_rules + (innerloop_pos * sizeof (kernel_rule_t)), innerloop_left * sizeof (kernel_rule_t));
+          }
         }
         else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
         {
@@ -4683,97 +5036,104 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
 
               u32 i = 0;
 
-              while (i < innerloop_left)
+              if (combinator_ctx->combs_cache.enabled == true)
+              {
+                i = combs_cache_copy (hashcat_ctx, device_param, salt_pos, pws_cnt, innerloop_left, (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT));
+              }
+              else
               {
-                if (hc_feof (combs_fp)) break;
+                while (i < innerloop_left)
+                {
+                  if (hc_feof (combs_fp)) break;
 
-                size_t line_len = fgetl (combs_fp, line_buf, HCBUFSIZ_LARGE);
+                  size_t line_len = fgetl (combs_fp, line_buf, HCBUFSIZ_LARGE);
 
-                line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
+                  line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
 
-                if (line_len > PW_MAX) continue;
+                  if (line_len > PW_MAX) continue;
 
-                char *line_buf_new = line_buf;
+                  char *line_buf_new = line_buf;
 
-                char rule_buf_out[RP_PASSWORD_SIZE];
+                  char rule_buf_out[RP_PASSWORD_SIZE];
 
-                if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
-                {
-                  if (line_len >= RP_PASSWORD_SIZE) continue;
+                  if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
+                  {
+                    if (line_len >= RP_PASSWORD_SIZE) continue;
 
-                  memset (rule_buf_out, 0, sizeof (rule_buf_out));
+                    memset (rule_buf_out, 0, sizeof (rule_buf_out));
 
-                  const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
+                    const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
 
-                  if (rule_len_out < 0)
-                  {
-                    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+                    if (rule_len_out < 0)
                     {
-                      for (u32 association_salt_pos = 0; association_salt_pos < pws_cnt; association_salt_pos++)
+                      if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
                       {
-                        status_ctx->words_progress_rejected[association_salt_pos] += 1;
+                        for (u32 association_salt_pos = 0; association_salt_pos < pws_cnt; association_salt_pos++)
+                        {
+                          status_ctx->words_progress_rejected[association_salt_pos] += 1;
+                        }
+                      }
+                      else
+                      {
+                        status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
                       }
-                    }
-                    else
-                    {
-                      status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
-                    }
-
-                    continue;
-                  }
 
-                  line_len = rule_len_out;
+                      continue;
+                    }
 
-                  line_buf_new = rule_buf_out;
-                }
+                    line_len = rule_len_out;
 
-                // do the on-the-fly encoding
+                    line_buf_new = rule_buf_out;
+                  }
 
-                if (iconv_enabled == true)
-                {
-                  char  *iconv_ptr = iconv_tmp;
-                  size_t iconv_sz  = HCBUFSIZ_TINY;
+                  // do the on-the-fly encoding
 
-                  if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
+                  if (iconv_enabled == true)
+                  {
+                    char  *iconv_ptr = iconv_tmp;
+                    size_t iconv_sz  = HCBUFSIZ_TINY;
 
-                  line_buf_new = iconv_tmp;
-                  line_len     = HCBUFSIZ_TINY - iconv_sz;
-                }
+                    if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
 
-                line_len = MIN (line_len, PW_MAX);
+                    line_buf_new = iconv_tmp;
+                    line_len     = HCBUFSIZ_TINY - iconv_sz;
+                  }
 
-                u8 *ptr = (u8 *) device_param->combs_buf[i].i;
+                  line_len = MIN (line_len, PW_MAX);
 
-                memcpy (ptr, line_buf_new, line_len);
+                  u8 *ptr = (u8 *) device_param->combs_buf[i].i;
 
-                memset (ptr + line_len, 0, PW_MAX - line_len);
+                  memcpy (ptr, line_buf_new, line_len);
 
-                if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
-                {
-                  uppercase (ptr, line_len);
-                }
+                  memset (ptr + line_len, 0, PW_MAX - line_len);
 
-                if (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT)
-                {
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
+                  if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
                   {
-                    ptr[line_len] = 0x80;
+                    uppercase (ptr, line_len);
                   }
 
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
+                  if (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT)
                   {
-                    ptr[line_len] = 0x06;
-                  }
+                    if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
+                    {
+                      ptr[line_len] = 0x80;
+                    }
 
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
-                  {
-                    ptr[line_len] = 0x01;
+                    if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
+                    {
+                      ptr[line_len] = 0x06;
+                    }
+
+                    if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
+                    {
+                      ptr[line_len] = 0x01;
+                    }
                   }
-                }
 
-                device_param->combs_buf[i].pw_len = (u32) line_len;
+                  device_param->combs_buf[i].pw_len = (u32) line_len;
 
-                i++;
+                  i++;
+                }
               }
 
               for (u32 j = i; j < innerloop_left; j++)
@@ -4792,6 +5152,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
               {
                 if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs_c, CL_TRUE, 0, innerloop_left * sizeof (pw_t), device_param->combs_buf, 0, NULL, NULL) == -1) return -1;
               }
+
+              if (device_param->is_native == true)
+              {
+                memcpy (device_param->native_d_combs_c, device_param->combs_buf, innerloop_left * sizeof (pw_t));
+              }
             }
             else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
             {
@@ -4810,6 +5175,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
               {
                 if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs, device_param->opencl_d_combs_c, 0, 0, innerloop_left * sizeof (pw_t), 0, NULL, NULL) == -1) return -1;
               }
+
+              if (device_param->is_native == true)
+              {
+                memcpy (device_param->native_d_combs_c, device_param->native_d_combs, innerloop_left * sizeof (pw_t));
+              }
             }
             else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
             {
@@ -4828,6 +5198,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
               {
                 if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs, device_param->opencl_d_combs_c, 0, 0, innerloop_left * sizeof (pw_t), 0, NULL, NULL) == -1) return -1;
               }
+
+              if (device_param->is_native == true)
+              {
+                memcpy (device_param->native_d_combs_c, device_param->native_d_combs, innerloop_left * sizeof (pw_t));
+              }
             }
           }
           else
@@ -4838,99 +5213,106 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
 
               u32 i = 0;
 
-              while (i < innerloop_left)
+              if (combinator_ctx->combs_cache.enabled == true)
+              {
+                i = combs_cache_copy (hashcat_ctx, device_param, salt_pos, pws_cnt, innerloop_left, false);
+              }
+              else
               {
-                if (hc_feof (combs_fp)) break;
+                while (i < innerloop_left)
+                {
+                  if (hc_feof (combs_fp)) break;
 
-                size_t line_len = fgetl (combs_fp, line_buf, HCBUFSIZ_LARGE);
+                  size_t line_len = fgetl (combs_fp, line_buf, HCBUFSIZ_LARGE);
 
-                line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
+                  line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
 
-                if (line_len > PW_MAX) continue;
+                  if (line_len > PW_MAX) continue;
 
-                char *line_buf_new = line_buf;
+                  char *line_buf_new = line_buf;
 
-                char rule_buf_out[RP_PASSWORD_SIZE];
+                  char rule_buf_out[RP_PASSWORD_SIZE];
 
-                if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
-                {
-                  if (line_len >= RP_PASSWORD_SIZE) continue;
+                  if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
+                  {
+                    if (line_len >= RP_PASSWORD_SIZE) continue;
 
-                  memset (rule_buf_out, 0, sizeof (rule_buf_out));
+                    memset (rule_buf_out, 0, sizeof (rule_buf_out));
 
-                  const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
+                    const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
 
-                  if (rule_len_out < 0)
-                  {
-                    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+                    if (rule_len_out < 0)
                     {
-                      for (u32 association_salt_pos = 0; association_salt_pos < pws_cnt; association_salt_pos++)
+                      if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
                       {
-                        status_ctx->words_progress_rejected[association_salt_pos] += 1;
+                        for (u32 association_salt_pos = 0; association_salt_pos < pws_cnt; association_salt_pos++)
+                        {
+                          status_ctx->words_progress_rejected[association_salt_pos] += 1;
+                        }
+                      }
+                      else
+                      {
+                        status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
                       }
-                    }
-                    else
-                    {
-                      status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
-                    }
-
-                    continue;
-                  }
 
-                  line_len = rule_len_out;
+                      continue;
+                    }
 
-                  line_buf_new = rule_buf_out;
-                }
+                    line_len = rule_len_out;
 
-                // do the on-the-fly encoding
+                    line_buf_new = rule_buf_out;
+                  }
 
-                if (iconv_enabled == true)
-                {
-                  char  *iconv_ptr = iconv_tmp;
-                  size_t iconv_sz  = HCBUFSIZ_TINY;
+                  // do the on-the-fly encoding
 
-                  if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
+                  if (iconv_enabled == true)
+                  {
+                    char  *iconv_ptr = iconv_tmp;
+                    size_t iconv_sz  = HCBUFSIZ_TINY;
 
-                  line_buf_new = iconv_tmp;
-                  line_len     = HCBUFSIZ_TINY - iconv_sz;
-                }
+                    if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
 
-                line_len = MIN (line_len, PW_MAX);
+                    line_buf_new = iconv_tmp;
+                    line_len     = HCBUFSIZ_TINY - iconv_sz;
+                  }
 
-                u8 *ptr = (u8 *) device_param->combs_buf[i].i;
+                  line_len = MIN (line_len, PW_MAX);
 
-                memcpy (ptr, line_buf_new, line_len);
+                  u8 *ptr = (u8 *) device_param->combs_buf[i].i;
 
-                memset (ptr + line_len, 0, PW_MAX - line_len);
+                  memcpy (ptr, line_buf_new, line_len);
 
-                if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
-                {
-                  uppercase (ptr, line_len);
-                }
+                  memset (ptr + line_len, 0, PW_MAX - line_len);
 
-                /*
-                if (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT)
-                {
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
+                  if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
                   {
-                    ptr[line_len] = 0x80;
+                    uppercase (ptr, line_len);
                   }
 
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
+                  /*
+                  if (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT)
                   {
-                    ptr[line_len] = 0x06;
-                  }
+                    if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
+                    {
+                      ptr[line_len] = 0x80;
+                    }
 
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
-                  {
-                    ptr[line_len] = 0x01;
+                    if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
+                    {
+                      ptr[line_len] = 0x06;
+                    }
+
+                    if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
+                    {
+                      ptr[line_len] = 0x01;
+                    }
                   }
-                }
-                */
+                  */
 
-                device_param->combs_buf[i].pw_len = (u32) line_len;
+                  device_param->combs_buf[i].pw_len = (u32) line_len;
 
-                i++;
+                  i++;
+                }
               }
 
               for (u32 j = i; j < innerloop_left; j++)
@@ -4949,6 +5331,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
               {
                 if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs_c, CL_TRUE, 0, innerloop_left * sizeof (pw_t), device_param->combs_buf, 0, NULL, NULL) == -1) return -1;
               }
+
+              if (device_param->is_native == true)
+              {
+                memcpy (device_param->native_d_combs_c, device_param->combs_buf, innerloop_left * sizeof (pw_t));
+              }
             }
             else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
             {
@@ -4967,6 +5354,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
               {
                 if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs, device_param->opencl_d_combs_c, 0, 0, innerloop_left * sizeof (pw_t), 0, NULL, NULL) == -1) return -1;
               }
+
+              if (device_param->is_native == true)
+              {
+                memcpy (device_param->native_d_combs_c, device_param->native_d_combs, innerloop_left * sizeof (pw_t));
+              }
             }
           }
         }
@@ -4987,6 +5379,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
           {
             if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bfs, device_param->opencl_d_bfs_c, 0, 0, innerloop_left * sizeof (bf_t), 0, NULL, NULL) == -1) return -1;
           }
+
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_bfs_c, device_param->native_d_bfs, innerloop_left * sizeof (bf_t));
+          }
         }
       }
 
@@ -5337,6 +5734,16 @@ int backend_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
   backend_ctx->opencl_device_types_filter = opencl_device_types_filter;
 
+  /**
+   * Probe the host C compiler, it's all the native backend needs
+   * done before the other APIs so that they know whether there's a fallback
+   */
+
+  if (user_options->backend_ignore_native == false)
+  {
+    native_init (hashcat_ctx);
+  }
+
   /**
    * CUDA API: init
    */
@@ -5582,7 +5989,7 @@ int backend_ctx_init (hashcat_ctx_t *hashcat_ctx)
    * Final checks
    */
 
-  if ((backend_ctx->cuda == NULL) && (backend_ctx->ocl == NULL))
+  if ((backend_ctx->cuda == NULL) && (backend_ctx->ocl == NULL) && (backend_ctx->native == false))
   {
     event_log_error (hashcat_ctx, "ATTENTION! No OpenCL-compatible or CUDA-compatible platform found.");
 
@@ -5605,6 +6012,10 @@ int backend_ctx_init (hashcat_ctx_t *hashcat_ctx)
     event_log_warning (hashcat_ctx, "  \"CUDA Toolkit\" (9.0 or later)");
     event_log_warning (hashcat_ctx, NULL);
 
+    event_log_warning (hashcat_ctx, "* The native host CPU backend requires a C compiler:");
+    event_log_warning (hashcat_ctx, "  \"cc\" in PATH or set via the CC environment variable");
+    event_log_warning (hashcat_ctx, NULL);
+
     return -1;
   }
 
@@ -5632,9 +6043,10 @@ void backend_ctx_destroy (hashcat_ctx_t *hashcat_ctx)
     hcfree (backend_ctx->opencl_platforms_version);
   }
 
-  nvrtc_close (hashcat_ctx);
-  cuda_close  (hashcat_ctx);
-  ocl_close   (hashcat_ctx);
+  nvrtc_close  (hashcat_ctx);
+  cuda_close   (hashcat_ctx);
+  ocl_close    (hashcat_ctx);
+  native_close (hashcat_ctx);
 
   memset (backend_ctx, 0, sizeof (backend_ctx_t));
 }
@@ -6987,10 +7399,97 @@ int backend_ctx_devices_init (hashcat_ctx_t *hashcat_ctx, const int comptime)
   backend_ctx->opencl_devices_cnt     = opencl_devices_cnt;
   backend_ctx->opencl_devices_active  = opencl_devices_active;
 
+  int native_devices_cnt    = 0;
+  int native_devices_active = 0;
+
+  if ((backend_ctx->native) && (backend_devices_idx < DEVICES_MAX))
+  {
+    /**
+     * Native device: the host CPU itself, kernels are built by the host C compiler
+     */
+
+    const u32 device_id = backend_devices_idx;
+
+    hc_device_param_t *device_param = &devices_param[device_id];
+
+    device_param->device_id = device_id;
+
+    device_param->is_cuda   = false;
+    device_param->is_opencl = false;
+    device_param->is_native = true;
+
+    device_param->use_opencl12 = false;
+    device_param->use_opencl20 = false;
+    device_param->use_opencl21 = false;
+
+    backend_devices_idx++;
+
+    native_devices_cnt++;
+
+    // device_name, device_processors, device_global_mem, device_maxmem_alloc, device_available_mem
+
+    if (hc_nativeDeviceInit (hashcat_ctx, device_param) == -1)
+    {
+      device_param->skipped = true;
+    }
+
+    // work-items are executed one after another by the pool threads, there's no such thing as a workgroup
+
+    device_param->device_maxworkgroup_size  = 1;
+    device_param->device_maxclock_frequency = 0;
+    device_param->device_local_mem_size     = 32768;
+
+    // some attributes have to be hardcoded values because they are used for instance in the build options
+
+    device_param->device_local_mem_type     = CL_GLOBAL;
+    device_param->opencl_device_type        = CL_DEVICE_TYPE_CPU;
+    device_param->opencl_device_vendor_id   = VENDOR_ID_GENERIC;
+    device_param->opencl_platform_vendor_id = VENDOR_ID_GENERIC;
+
+    // or in the cached kernel checksum, a compiler update or another host CPU invalidates the cached shared objects
+
+    device_param->opencl_device_version     = backend_ctx->native_host_chksum;
+    device_param->opencl_driver_version     = backend_ctx->native_compiler_version;
+
+    // or just to make sure they are not NULL
+
+    device_param->opencl_device_vendor      = "";
+    device_param->opencl_device_c_version   = "";
+
+    // there's no other process to wait for
+
+    device_param->spin_damp = 0;
+
+    // skipped
+    // the CPU is also the host, so unless selected explicitly with -d it's used only as a fallback if no other device is left
+
+    if ((backend_ctx->backend_devices_filter & (1ULL << device_id)) == 0)
+    {
+      device_param->skipped = true;
+    }
+
+    if (backend_ctx->backend_devices_filter == (u64) -1ULL)
+    {
+      if ((cuda_devices_active + opencl_devices_active) > 0)
+      {
+        device_param->skipped = true;
+      }
+    }
+
+    /**
+     * activate device
+     */
+
+    if (device_param->skipped == false) native_devices_active++;
+  }
+
+  backend_ctx->native_devices_cnt     = native_devices_cnt;
+  backend_ctx->native_devices_active  = native_devices_active;
+
   // all devices combined go into backend_* variables
 
-  backend_ctx->backend_devices_cnt    = cuda_devices_cnt    + opencl_devices_cnt;
-  backend_ctx->backend_devices_active = cuda_devices_active + opencl_devices_active;
+  backend_ctx->backend_devices_cnt    = cuda_devices_cnt    + opencl_devices_cnt    + native_devices_cnt;
+  backend_ctx->backend_devices_active = cuda_devices_active + opencl_devices_active + native_devices_active;
 
   // find duplicate devices
 
@@ -7375,6 +7874,8 @@ void backend_ctx_devices_destroy (hashcat_ctx_t *hashcat_ctx)
   backend_ctx->cuda_devices_active    = 0;
   backend_ctx->opencl_devices_cnt     = 0;
   backend_ctx->opencl_devices_active  = 0;
+  backend_ctx->native_devices_cnt     = 0;
+  backend_ctx->native_devices_active  = 0;
 
   backend_ctx->need_adl    = false;
   backend_ctx->need_nvml   = false;
@@ -7642,6 +8143,31 @@ static int get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx_t *hashcat_ctx,
   return 0;
 }
 
+static int get_native_kernel_wgs (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const hc_native_function_t *function, u32 *result)
+{
+  // a native work-item is a plain function call, there's no workgroup to share local memory with
+
+  *result = 1;
+
+  return 0;
+}
+
+static int get_native_kernel_local_mem_size (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const hc_native_function_t *function, u64 *result)
+{
+  // LOCAL_VK buffers end up on the stack of the worker thread
+
+  *result = 0;
+
+  return 0;
+}
+
+static int get_native_kernel_dynamic_local_mem_size (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const hc_native_function_t *function, u64 *result)
+{
+  *result = 0;
+
+  return 0;
+}
+
 static u32 get_kernel_threads (const hc_device_param_t *device_param)
 {
   // this is an upper limit, a good start, since our strategy is to reduce thread counts only.
@@ -7689,7 +8215,7 @@ static u32 get_kernel_threads (const hc_device_param_t *device_param)
   return kernel_threads;
 }
 
-static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module)
+static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hc_native_program_t *native_program)
 {
   const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
 
@@ -7710,6 +8236,33 @@ static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_p
     cached = false;
   }
 
+  /**
+   * native kernels are shared objects, dlopen() needs them on disk anyway, so the cached file is always written
+   */
+
+  if (device_param->is_native == true)
+  {
+    if (cached == false)
+    {
+      #if defined (DEBUG)
+      const user_options_t *user_options = hashcat_ctx->user_options;
+
+      if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s not found in cache! Building may take a while...", device_param->device_id + 1, filename_from_filepath (cached_file));
+      #endif
+
+      if (hc_nativeCompileProgram (hashcat_ctx, source_file, cached_file, build_options_buf) == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
+
+        return false;
+      }
+    }
+
+    if (hc_nativeProgramLoad (hashcat_ctx, native_program, cached_file) == -1) return false;
+
+    return true;
+  }
+
   /**
    * kernel compile or load
    */
@@ -8237,6 +8790,13 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       vector_width = 1;
     }
 
+    // native kernels are plain C, there are no OpenCL vector datatypes to map u32x to
+
+    if (device_param->is_native == true)
+    {
+      vector_width = 1;
+    }
+
     if (vector_width > 16) vector_width = 16;
 
     device_param->vector_width = vector_width;
@@ -8509,9 +9069,18 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     }
 
     /**
-     * create input buffers on device : calculate size of fixed memory buffers
+     * create worker threads for native devices
      */
 
+    if (device_param->is_native == true)
+    {
+      if (hc_nativePoolCreate (hashcat_ctx, device_param) == -1)
+      {
+        device_param->skipped = true;
+        continue;
+      }
+    }
+
     u64 size_root_css   = SP_PW_MAX *           sizeof (cs_t);
     u64 size_markov_css = SP_PW_MAX * CHARSIZ * sizeof (cs_t);
 
@@ -8776,7 +9345,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
       generate_cached_kernel_shared_filename (folder_config->cache_dir, device_name_chksum_amp_mp, cached_file);
 
-      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "shared_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_shared, &device_param->cuda_module_shared);
+      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "shared_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_shared, &device_param->cuda_module_shared, &device_param->native_program_shared);
 
       if (rc_load_kernel == false)
       {
@@ -8893,6 +9462,57 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
         if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_preferred_wgs_multiple_utf8toutf16le) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        // GPU memset
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_memset, &device_param->native_program_shared, "gpu_memset") == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_memset, &device_param->kernel_wgs_memset) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_memset, &device_param->kernel_dynamic_local_mem_size_memset) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple_memset = 1;
+
+        // GPU autotune init
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_atinit, &device_param->native_program_shared, "gpu_atinit") == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_atinit, &device_param->kernel_dynamic_local_mem_size_atinit) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple_atinit = 1;
+
+        // GPU decompress
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_decompress, &device_param->native_program_shared, "gpu_decompress") == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_decompress, &device_param->kernel_dynamic_local_mem_size_decompress) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple_decompress = 1;
+
+        // GPU utf8 to utf16le conversion
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_utf8toutf16le, &device_param->native_program_shared, "gpu_utf8_to_utf16") == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_utf8toutf16le, &device_param->kernel_dynamic_local_mem_size_utf8toutf16le) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple_utf8toutf16le = 1;
+      }
     }
 
     /**
@@ -8960,7 +9580,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
        * load kernel
        */
 
-      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "main_kernel", source_file, cached_file, build_options_module_buf, cache_disable, &device_param->opencl_program, &device_param->cuda_module);
+      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "main_kernel", source_file, cached_file, build_options_module_buf, cache_disable, &device_param->opencl_program, &device_param->cuda_module, &device_param->native_program);
 
       if (rc_load_kernel == false)
       {
@@ -9006,7 +9626,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
         generate_cached_kernel_mp_filename (hashconfig->opti_type, hashconfig->opts_type, folder_config->cache_dir, device_name_chksum_amp_mp, cached_file);
 
-        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "mp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_mp, &device_param->cuda_module_mp);
+        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "mp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_mp, &device_param->cuda_module_mp, &device_param->native_program_mp);
 
         if (rc_load_kernel == false)
         {
@@ -9055,7 +9675,7 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
         generate_cached_kernel_amp_filename (user_options_extra->attack_kern, folder_config->cache_dir, device_name_chksum_amp_mp, cached_file);
 
-        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "amp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_amp, &device_param->cuda_module_amp);
+        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "amp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_amp, &device_param->cuda_module_amp, &device_param->native_program_amp);
 
         if (rc_load_kernel == false)
         {
@@ -9328,6 +9948,96 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       }
     }
 
+    if (device_param->is_native == true)
+    {
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s1_a,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s1_b,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s1_c,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s1_d,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s2_a,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s2_b,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_plain_bufs,     size_plains)             == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_digests_buf,    size_digests)            == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_digests_shown,  size_shown)              == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_salt_bufs,      size_salts)              == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_result,         size_results)            == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_extra0_buf,     size_extra_buffer / 4)   == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_extra1_buf,     size_extra_buffer / 4)   == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_extra2_buf,     size_extra_buffer / 4)   == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_extra3_buf,     size_extra_buffer / 4)   == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_st_digests_buf, size_st_digests)         == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_st_salts_buf,   size_st_salts)           == -1) return -1;
+
+      memcpy (device_param->native_d_bitmap_s1_a, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s1_b, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s1_c, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s1_d, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s2_a, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s2_b, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s2_c, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_bitmap_s2_d, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size);
+      memcpy (device_param->native_d_digests_buf, hashes->digests_buf,     size_digests);
+      memcpy (device_param->native_d_salt_bufs,   hashes->salts_buf,       size_salts);
+
+      /**
+       * special buffers
+       */
+
+      if (user_options->slow_candidates == true)
+      {
+        if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_rules_c, size_rules_c) == -1) return -1;
+      }
+      else
+      {
+        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+        {
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_rules,   size_rules) == -1) return -1;
+
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_rules_c, size_rules_c) == -1) return -1;
+
+          memcpy (device_param->native_d_rules, straight_ctx->kernel_rules_buf, size_rules);
+        }
+        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+        {
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_combs,          size_combs)      == -1) return -1;
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_combs_c,        size_combs)      == -1) return -1;
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_root_css_buf,   size_root_css)   == -1) return -1;
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_markov_css_buf, size_markov_css) == -1) return -1;
+        }
+        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+        {
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bfs,            size_bfs)        == -1) return -1;
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_root_css_buf,   size_root_css)   == -1) return -1;
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_markov_css_buf, size_markov_css) == -1) return -1;
+
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_bfs_c,        size_bfs)        == -1) return -1;
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_tm_c,         size_tm)         == -1) return -1;
+        }
+      }
+
+      if (size_esalts)
+      {
+        if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_esalt_bufs, size_esalts) == -1) return -1;
+
+        memcpy (device_param->native_d_esalt_bufs, hashes->esalts_buf, size_esalts);
+      }
+
+      if (hashconfig->st_hash != NULL)
+      {
+        memcpy (device_param->native_d_st_digests_buf, hashes->st_digests_buf, size_st_digests);
+        memcpy (device_param->native_d_st_salts_buf,   hashes->st_salts_buf,   size_st_salts);
+
+        if (size_esalts)
+        {
+          if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_st_esalts_buf, size_st_esalts) == -1) return -1;
+
+          memcpy (device_param->native_d_st_esalts_buf, hashes->st_esalts_buf, size_st_esalts);
+        }
+      }
+    }
+
     /**
      * kernel args
      */
@@ -9402,6 +10112,34 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       device_param->kernel_params[23] = &device_param->opencl_d_extra3_buf;
     }
 
+    if (device_param->is_native == true)
+    {
+      device_param->kernel_params[ 0] = NULL; // &device_param->native_d_pws_buf;
+      device_param->kernel_params[ 1] = &device_param->native_d_rules_c;
+      device_param->kernel_params[ 2] = &device_param->native_d_combs_c;
+      device_param->kernel_params[ 3] = &device_param->native_d_bfs_c;
+      device_param->kernel_params[ 4] = NULL; // &device_param->native_d_tmps;
+      device_param->kernel_params[ 5] = NULL; // &device_param->native_d_hooks;
+      device_param->kernel_params[ 6] = &device_param->native_d_bitmap_s1_a;
+      device_param->kernel_params[ 7] = &device_param->native_d_bitmap_s1_b;
+      device_param->kernel_params[ 8] = &device_param->native_d_bitmap_s1_c;
+      device_param->kernel_params[ 9] = &device_param->native_d_bitmap_s1_d;
+      device_param->kernel_params[10] = &device_param->native_d_bitmap_s2_a;
+      device_param->kernel_params[11] = &device_param->native_d_bitmap_s2_b;
+      device_param->kernel_params[12] = &device_param->native_d_bitmap_s2_c;
+      device_param->kernel_params[13] = &device_param->native_d_bitmap_s2_d;
+      device_param->kernel_params[14] = &device_param->native_d_plain_bufs;
+      device_param->kernel_params[15] = &device_param->native_d_digests_buf;
+      device_param->kernel_params[16] = &device_param->native_d_digests_shown;
+      device_param->kernel_params[17] = &device_param->native_d_salt_bufs;
+      device_param->kernel_params[18] = &device_param->native_d_esalt_bufs;
+      device_param->kernel_params[19] = &device_param->native_d_result;
+      device_param->kernel_params[20] = &device_param->native_d_extra0_buf;
+      device_param->kernel_params[21] = &device_param->native_d_extra1_buf;
+      device_param->kernel_params[22] = &device_param->native_d_extra2_buf;
+      device_param->kernel_params[23] = &device_param->native_d_extra3_buf;
+    }
+
     device_param->kernel_params[24] = &device_param->kernel_params_buf32[24];
     device_param->kernel_params[25] = &device_param->kernel_params_buf32[25];
     device_param->kernel_params[26] = &device_param->kernel_params_buf32[26];
@@ -9439,6 +10177,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         {
           device_param->kernel_params_mp[0] = &device_param->opencl_d_combs;
         }
+
+        if (device_param->is_native == true)
+        {
+          device_param->kernel_params_mp[0] = &device_param->native_d_combs;
+        }
       }
       else
       {
@@ -9453,6 +10196,11 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
           {
             device_param->kernel_params_mp[0] = &device_param->opencl_d_combs;
           }
+
+          if (device_param->is_native == true)
+          {
+            device_param->kernel_params_mp[0] = &device_param->native_d_combs;
+          }
         }
         else
         {
@@ -9474,6 +10222,12 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         device_param->kernel_params_mp[2] = &device_param->opencl_d_markov_css_buf;
       }
 
+      if (device_param->is_native == true)
+      {
+        device_param->kernel_params_mp[1] = &device_param->native_d_root_css_buf;
+        device_param->kernel_params_mp[2] = &device_param->native_d_markov_css_buf;
+      }
+
       device_param->kernel_params_mp[3] = &device_param->kernel_params_mp_buf64[3];
       device_param->kernel_params_mp[4] = &device_param->kernel_params_mp_buf32[4];
       device_param->kernel_params_mp[5] = &device_param->kernel_params_mp_buf32[5];
@@ -9504,6 +10258,12 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         device_param->kernel_params_mp_l[2] = &device_param->opencl_d_markov_css_buf;
       }
 
+      if (device_param->is_native == true)
+      {
+        device_param->kernel_params_mp_l[1] = &device_param->native_d_root_css_buf;
+        device_param->kernel_params_mp_l[2] = &device_param->native_d_markov_css_buf;
+      }
+
       device_param->kernel_params_mp_l[3] = &device_param->kernel_params_mp_l_buf64[3];
       device_param->kernel_params_mp_l[4] = &device_param->kernel_params_mp_l_buf32[4];
       device_param->kernel_params_mp_l[5] = &device_param->kernel_params_mp_l_buf32[5];
@@ -9533,6 +10293,13 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         device_param->kernel_params_mp_r[2] = &device_param->opencl_d_markov_css_buf;
       }
 
+      if (device_param->is_native == true)
+      {
+        device_param->kernel_params_mp_r[0] = &device_param->native_d_bfs;
+        device_param->kernel_params_mp_r[1] = &device_param->native_d_root_css_buf;
+        device_param->kernel_params_mp_r[2] = &device_param->native_d_markov_css_buf;
+      }
+
       device_param->kernel_params_mp_r[3] = &device_param->kernel_params_mp_r_buf64[3];
       device_param->kernel_params_mp_r[4] = &device_param->kernel_params_mp_r_buf32[4];
       device_param->kernel_params_mp_r[5] = &device_param->kernel_params_mp_r_buf32[5];
@@ -9561,6 +10328,15 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         device_param->kernel_params_amp[4] = &device_param->opencl_d_bfs_c;
       }
 
+      if (device_param->is_native == true)
+      {
+        device_param->kernel_params_amp[0] = NULL; // &device_param->native_d_pws_buf;
+        device_param->kernel_params_amp[1] = NULL; // &device_param->native_d_pws_amp_buf;
+        device_param->kernel_params_amp[2] = &device_param->native_d_rules_c;
+        device_param->kernel_params_amp[3] = &device_param->native_d_combs_c;
+        device_param->kernel_params_amp[4] = &device_param->native_d_bfs_c;
+      }
+
       device_param->kernel_params_amp[5] = &device_param->kernel_params_amp_buf32[5];
       device_param->kernel_params_amp[6] = &device_param->kernel_params_amp_buf64[6];
 
@@ -9575,6 +10351,12 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         device_param->kernel_params_tm[0] = &device_param->opencl_d_bfs_c;
         device_param->kernel_params_tm[1] = &device_param->opencl_d_tm_c;
       }
+
+      if (device_param->is_native == true)
+      {
+        device_param->kernel_params_tm[0] = &device_param->native_d_bfs_c;
+        device_param->kernel_params_tm[1] = &device_param->native_d_tm_c;
+      }
     }
 
     device_param->kernel_params_memset_buf32[1] = 0; // value
@@ -9614,6 +10396,15 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
                                                         // : &device_param->opencl_d_pws_amp_buf;
     }
 
+    if (device_param->is_native == true)
+    {
+      device_param->kernel_params_decompress[0] = NULL; // &device_param->native_d_pws_idx;
+      device_param->kernel_params_decompress[1] = NULL; // &device_param->native_d_pws_comp_buf;
+      device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                        // ? &device_param->native_d_pws_buf
+                                                        // : &device_param->native_d_pws_amp_buf;
+    }
+
     device_param->kernel_params_decompress[3] = &device_param->kernel_params_decompress_buf64[3];
 
     /**
@@ -10832,20 +11623,573 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       }
     }
 
-    // this is required because inside the kernels there is this:
-    // __local pw_t s_pws[64];
-
-    if ((user_options->attack_mode == ATTACK_MODE_STRAIGHT)
-     || (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
-     || (user_options->slow_candidates == true))
+    if (device_param->is_native == true)
     {
+      char kernel_name[64] = { 0 };
+
       if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
       {
-        if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+        if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
         {
-          // not required
-        }
-        else
+          if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+          {
+            // kernel1
+
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function1, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function1, &device_param->kernel_wgs1) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple1 = 1;
+
+            // kernel2
+
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function2, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function2, &device_param->kernel_wgs2) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple2 = 1;
+
+            // kernel3
+
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function3, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function3, &device_param->kernel_wgs3) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple3 = 1;
+          }
+          else
+          {
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function4, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function4, &device_param->kernel_wgs4) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function4, &device_param->kernel_dynamic_local_mem_size4) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple4 = 1;
+          }
+        }
+        else
+        {
+          if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+          {
+            // kernel1
+
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function1, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function1, &device_param->kernel_wgs1) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple1 = 1;
+
+            // kernel2
+
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function2, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function2, &device_param->kernel_wgs2) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple2 = 1;
+
+            // kernel3
+
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function3, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function3, &device_param->kernel_wgs3) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple3 = 1;
+          }
+          else
+          {
+            snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
+
+            if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function4, &device_param->native_program, kernel_name) == -1) return -1;
+
+            if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function4, &device_param->kernel_wgs4) == -1) return -1;
+
+            if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
+
+            if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function4, &device_param->kernel_dynamic_local_mem_size4) == -1) return -1;
+
+            device_param->kernel_preferred_wgs_multiple4 = 1;
+          }
+        }
+
+        if (user_options->slow_candidates == true)
+        {
+        }
+        else
+        {
+          if (user_options->attack_mode == ATTACK_MODE_BF)
+          {
+            if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+            {
+              snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
+
+              if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_tm, &device_param->native_program, kernel_name) == -1) return -1;
+
+              if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_tm, &device_param->kernel_wgs_tm) == -1) return -1;
+
+              if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
+
+              if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_tm, &device_param->kernel_dynamic_local_mem_size_tm) == -1) return -1;
+
+              device_param->kernel_preferred_wgs_multiple_tm = 1;
+            }
+          }
+        }
+      }
+      else
+      {
+        // kernel1
+
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function1, &device_param->native_program, kernel_name) == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function1, &device_param->kernel_wgs1) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple1 = 1;
+
+        // kernel2
+
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function2, &device_param->native_program, kernel_name) == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function2, &device_param->kernel_wgs2) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple2 = 1;
+
+        // kernel3
+
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
+
+        if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function3, &device_param->native_program, kernel_name) == -1) return -1;
+
+        if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function3, &device_param->kernel_wgs3) == -1) return -1;
+
+        if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+
+        if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
+
+        device_param->kernel_preferred_wgs_multiple3 = 1;
+
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
+        {
+          // kernel2p
+
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function2p, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function2p, &device_param->kernel_wgs2p) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function2p, &device_param->kernel_dynamic_local_mem_size2p) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple2p = 1;
+        }
+
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+        {
+          // kernel2e
+
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function2e, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function2e, &device_param->kernel_wgs2e) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function2e, &device_param->kernel_dynamic_local_mem_size2e) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple2e = 1;
+        }
+
+        // kernel12
+
+        if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function12, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function12, &device_param->kernel_wgs12) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function12, &device_param->kernel_local_mem_size12) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function12, &device_param->kernel_dynamic_local_mem_size12) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple12 = 1;
+        }
+
+        // kernel23
+
+        if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function23, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function23, &device_param->kernel_wgs23) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function23, &device_param->kernel_local_mem_size23) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function23, &device_param->kernel_dynamic_local_mem_size23) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple23 = 1;
+        }
+
+        // init2
+
+        if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_init2, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_init2, &device_param->kernel_wgs_init2) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_init2, &device_param->kernel_dynamic_local_mem_size_init2) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_init2 = 1;
+        }
+
+        // loop2 prepare
+
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_loop2p, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_loop2p, &device_param->kernel_dynamic_local_mem_size_loop2p) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_loop2p = 1;
+        }
+
+        // loop2
+
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_loop2, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_loop2, &device_param->kernel_dynamic_local_mem_size_loop2) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_loop2 = 1;
+        }
+
+        // aux1
+
+        if (hashconfig->opts_type & OPTS_TYPE_AUX1)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_aux1, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_aux1, &device_param->kernel_dynamic_local_mem_size_aux1) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_aux1 = 1;
+        }
+
+        // aux2
+
+        if (hashconfig->opts_type & OPTS_TYPE_AUX2)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_aux2, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_aux2, &device_param->kernel_dynamic_local_mem_size_aux2) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_aux2 = 1;
+        }
+
+        // aux3
+
+        if (hashconfig->opts_type & OPTS_TYPE_AUX3)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_aux3, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_aux3, &device_param->kernel_dynamic_local_mem_size_aux3) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_aux3 = 1;
+        }
+
+        // aux4
+
+        if (hashconfig->opts_type & OPTS_TYPE_AUX4)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_aux4, &device_param->native_program, kernel_name) == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_aux4, &device_param->kernel_dynamic_local_mem_size_aux4) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_aux4 = 1;
+        }
+      }
+
+      // MP start
+
+      if (user_options->slow_candidates == true)
+      {
+      }
+      else
+      {
+        if (user_options->attack_mode == ATTACK_MODE_BF)
+        {
+          // mp_l
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_mp_l, &device_param->native_program_mp, "l_markov") == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_mp_l, &device_param->kernel_dynamic_local_mem_size_mp_l) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_mp_l = 1;
+
+          // mp_r
+
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_mp_r, &device_param->native_program_mp, "r_markov") == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_mp_r, &device_param->kernel_dynamic_local_mem_size_mp_r) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_mp_r = 1;
+        }
+        else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+        {
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_mp, &device_param->native_program_mp, "C_markov") == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_mp, &device_param->kernel_dynamic_local_mem_size_mp) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_mp = 1;
+        }
+        else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+        {
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_mp, &device_param->native_program_mp, "C_markov") == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_mp, &device_param->kernel_dynamic_local_mem_size_mp) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_mp = 1;
+        }
+      }
+
+      if (user_options->slow_candidates == true)
+      {
+      }
+      else
+      {
+        if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+        {
+          // nothing to do
+        }
+        else
+        {
+          if (hc_nativeProgramGetFunction (hashcat_ctx, &device_param->native_function_amp, &device_param->native_program_amp, "amp") == -1) return -1;
+
+          if (get_native_kernel_wgs (hashcat_ctx, &device_param->native_function_amp, &device_param->kernel_wgs_amp) == -1) return -1;
+
+          if (get_native_kernel_local_mem_size (hashcat_ctx, &device_param->native_function_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
+
+          if (get_native_kernel_dynamic_local_mem_size (hashcat_ctx, &device_param->native_function_amp, &device_param->kernel_dynamic_local_mem_size_amp) == -1) return -1;
+
+          device_param->kernel_preferred_wgs_multiple_amp = 1;
+        }
+      }
+
+      // zero some data buffers
+
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_digests_shown, device_param->size_shown)   == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_result,        device_param->size_results) == -1) return -1;
+
+      /**
+       * special buffers
+       */
+
+      if (user_options->slow_candidates == true)
+      {
+        if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_rules_c, size_rules_c) == -1) return -1;
+      }
+      else
+      {
+        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+        {
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_rules_c, size_rules_c) == -1) return -1;
+        }
+        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+        {
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_combs,          size_combs)       == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_combs_c,        size_combs)       == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_root_css_buf,   size_root_css)    == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_markov_css_buf, size_markov_css)  == -1) return -1;
+        }
+        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+        {
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_bfs,            size_bfs)         == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_bfs_c,          size_bfs)         == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_tm_c,           size_tm)          == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_root_css_buf,   size_root_css)    == -1) return -1;
+          if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_markov_css_buf, size_markov_css)  == -1) return -1;
+        }
+      }
+
+      if (user_options->slow_candidates == true)
+      {
+      }
+      else
+      {
+        if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
+        {
+          /**
+           * prepare mp
+           */
+
+          if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+          {
+            device_param->kernel_params_mp_buf32[5] = 0;
+            device_param->kernel_params_mp_buf32[6] = 0;
+            device_param->kernel_params_mp_buf32[7] = 0;
+
+            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
+            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
+            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
+            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
+            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
+          }
+          else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+          {
+            device_param->kernel_params_mp_buf32[5] = 0;
+            device_param->kernel_params_mp_buf32[6] = 0;
+            device_param->kernel_params_mp_buf32[7] = 0;
+          }
+        }
+        else if (user_options->attack_mode == ATTACK_MODE_BF)
+        {
+          /**
+           * prepare mp_r and mp_l
+           */
+
+          device_param->kernel_params_mp_l_buf32[6] = 0;
+          device_param->kernel_params_mp_l_buf32[7] = 0;
+          device_param->kernel_params_mp_l_buf32[8] = 0;
+
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
+        }
+      }
+    }
+
+    // this is required because inside the kernels there is this:
+    // __local pw_t s_pws[64];
+
+    if ((user_options->attack_mode == ATTACK_MODE_STRAIGHT)
+     || (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+     || (user_options->slow_candidates == true))
+    {
+      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+      {
+        if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+        {
+          // not required
+        }
+        else
         {
           device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
         }
@@ -10902,8 +12246,10 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     u64 size_tmps     = 4;
     u64 size_hooks    = 4;
     #ifdef WITH_BRAIN
-    u64 size_brain_link_in  = 4;
-    u64 size_brain_link_out = 4;
+    u64 size_brain_link_in    = 4;
+    u64 size_brain_link_out   = 4;
+    u64 size_brain_link_sort  = 4;
+    u64 size_brain_link_batch = 4;
     #endif
 
     // instead of a thread limit we can also use a memory limit.
@@ -10941,8 +12287,12 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       #ifdef WITH_BRAIN
       // size_brains
 
-      size_brain_link_in  = kernel_power_max * 1;
-      size_brain_link_out = kernel_power_max * 8;
+      // the packed lookups of tiny batches can be a few bytes larger than the raw hashes
+
+      size_brain_link_in    = kernel_power_max * 1;
+      size_brain_link_out   = kernel_power_max * 8 + 8;
+      size_brain_link_sort  = kernel_power_max * (sizeof (u64) + sizeof (u32));
+      size_brain_link_batch = kernel_power_max * sizeof (u64) * 2;
       #endif
 
       if (user_options->slow_candidates == true)
@@ -11025,6 +12375,8 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
         #ifdef WITH_BRAIN
         + size_brain_link_in
         + size_brain_link_out
+        + size_brain_link_sort
+        + size_brain_link_batch
         #endif
         + size_pws_pre
         + size_pws_base;
@@ -11111,6 +12463,23 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_hooks,         device_param->size_hooks)    == -1) return -1;
     }
 
+    if (device_param->is_native == true)
+    {
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_pws_buf,      size_pws)      == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_pws_amp_buf,  size_pws_amp)  == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_pws_comp_buf, size_pws_comp) == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_pws_idx,      size_pws_idx)  == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_tmps,         size_tmps)     == -1) return -1;
+      if (hc_nativeMemAlloc (hashcat_ctx, &device_param->native_d_hooks,        size_hooks)    == -1) return -1;
+
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_pws_buf,       device_param->size_pws)      == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_tmps,          device_param->size_tmps)     == -1) return -1;
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_hooks,         device_param->size_hooks)    == -1) return -1;
+    }
+
     /**
      * main host data
      */
@@ -11144,6 +12513,22 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     u32 *brain_link_out_buf = (u32 *) hcmalloc (size_brain_link_out);
 
     device_param->brain_link_out_buf = brain_link_out_buf;
+
+    u64 *brain_link_sort_buf = (u64 *) hcmalloc (size_brain_link_in * sizeof (u64));
+
+    device_param->brain_link_sort_buf = brain_link_sort_buf;
+
+    u32 *brain_link_pos_buf = (u32 *) hcmalloc (size_brain_link_in * sizeof (u32));
+
+    device_param->brain_link_pos_buf = brain_link_pos_buf;
+
+    u64 *brain_link_batch_buf = (u64 *) hcmalloc (size_brain_link_in * sizeof (u64));
+
+    device_param->brain_link_batch_buf = brain_link_batch_buf;
+
+    u64 *brain_link_batch_buf_prev = (u64 *) hcmalloc (size_brain_link_in * sizeof (u64));
+
+    device_param->brain_link_batch_buf_prev = brain_link_batch_buf_prev;
     #endif
 
     pw_pre_t *pws_pre_buf = (pw_pre_t *) hcmalloc (size_pws_pre);
@@ -11172,6 +12557,13 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       device_param->kernel_params[ 5] = &device_param->opencl_d_hooks;
     }
 
+    if (device_param->is_native == true)
+    {
+      device_param->kernel_params[ 0] = &device_param->native_d_pws_buf;
+      device_param->kernel_params[ 4] = &device_param->native_d_tmps;
+      device_param->kernel_params[ 5] = &device_param->native_d_hooks;
+    }
+
     if (user_options->slow_candidates == true)
     {
     }
@@ -11202,6 +12594,13 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
             if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]) == -1) return -1;
           }
+
+          if (device_param->is_native == true)
+          {
+            device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                              ? &device_param->native_d_pws_buf
+                                              : &device_param->native_d_pws_amp_buf;
+          }
         }
       }
 
@@ -11224,6 +12623,13 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
           if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]) == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                              ? &device_param->native_d_pws_buf
+                                              : &device_param->native_d_pws_amp_buf;
+        }
       }
 
       if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
@@ -11249,6 +12655,12 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
           if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]) == -1) return -1;
           if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]) == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          device_param->kernel_params_amp[0] = &device_param->native_d_pws_buf;
+          device_param->kernel_params_amp[1] = &device_param->native_d_pws_amp_buf;
+        }
       }
     }
 
@@ -11278,6 +12690,15 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
       if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]) == -1) return -1;
     }
 
+    if (device_param->is_native == true)
+    {
+      device_param->kernel_params_decompress[0] = &device_param->native_d_pws_idx;
+      device_param->kernel_params_decompress[1] = &device_param->native_d_pws_comp_buf;
+      device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                ? &device_param->native_d_pws_buf
+                                                : &device_param->native_d_pws_amp_buf;
+    }
+
     hardware_power_all += device_param->hardware_power;
 
     EVENT_DATA (EVENT_BACKEND_DEVICE_INIT_POST, &backend_devices_idx, sizeof (int));
@@ -11317,6 +12738,10 @@ void backend_session_destroy (hashcat_ctx_t *hashcat_ctx)
     #ifdef WITH_BRAIN
     hcfree (device_param->brain_link_in_buf);
     hcfree (device_param->brain_link_out_buf);
+    hcfree (device_param->brain_link_sort_buf);
+    hcfree (device_param->brain_link_pos_buf);
+    hcfree (device_param->brain_link_batch_buf);
+    hcfree (device_param->brain_link_batch_buf_prev);
     #endif
 
     if (device_param->is_cuda == true)
@@ -11581,6 +13006,117 @@ void backend_session_destroy (hashcat_ctx_t *hashcat_ctx)
       device_param->opencl_context             = NULL;
     }
 
+    if (device_param->is_native == true)
+    {
+      // the worker threads must be gone before the shared objects are unloaded
+
+      hc_nativePoolDestroy (hashcat_ctx, device_param);
+
+      if (device_param->native_d_pws_buf)        hc_nativeMemFree (hashcat_ctx, device_param->native_d_pws_buf);
+      if (device_param->native_d_pws_amp_buf)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_pws_amp_buf);
+      if (device_param->native_d_pws_comp_buf)   hc_nativeMemFree (hashcat_ctx, device_param->native_d_pws_comp_buf);
+      if (device_param->native_d_pws_idx)        hc_nativeMemFree (hashcat_ctx, device_param->native_d_pws_idx);
+      if (device_param->native_d_rules)          hc_nativeMemFree (hashcat_ctx, device_param->native_d_rules);
+      if (device_param->native_d_rules_c)        hc_nativeMemFree (hashcat_ctx, device_param->native_d_rules_c);
+      if (device_param->native_d_combs)          hc_nativeMemFree (hashcat_ctx, device_param->native_d_combs);
+      if (device_param->native_d_combs_c)        hc_nativeMemFree (hashcat_ctx, device_param->native_d_combs_c);
+      if (device_param->native_d_bfs)            hc_nativeMemFree (hashcat_ctx, device_param->native_d_bfs);
+      if (device_param->native_d_bfs_c)          hc_nativeMemFree (hashcat_ctx, device_param->native_d_bfs_c);
+      if (device_param->native_d_bitmap_s1_a)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s1_a);
+      if (device_param->native_d_bitmap_s1_b)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s1_b);
+      if (device_param->native_d_bitmap_s1_c)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s1_c);
+      if (device_param->native_d_bitmap_s1_d)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s1_d);
+      if (device_param->native_d_bitmap_s2_a)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s2_a);
+      if (device_param->native_d_bitmap_s2_b)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s2_b);
+      if (device_param->native_d_bitmap_s2_c)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s2_c);
+      if (device_param->native_d_bitmap_s2_d)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_bitmap_s2_d);
+      if (device_param->native_d_plain_bufs)     hc_nativeMemFree (hashcat_ctx, device_param->native_d_plain_bufs);
+      if (device_param->native_d_digests_buf)    hc_nativeMemFree (hashcat_ctx, device_param->native_d_digests_buf);
+      if (device_param->native_d_digests_shown)  hc_nativeMemFree (hashcat_ctx, device_param->native_d_digests_shown);
+      if (device_param->native_d_salt_bufs)      hc_nativeMemFree (hashcat_ctx, device_param->native_d_salt_bufs);
+      if (device_param->native_d_esalt_bufs)     hc_nativeMemFree (hashcat_ctx, device_param->native_d_esalt_bufs);
+      if (device_param->native_d_tmps)           hc_nativeMemFree (hashcat_ctx, device_param->native_d_tmps);
+      if (device_param->native_d_hooks)          hc_nativeMemFree (hashcat_ctx, device_param->native_d_hooks);
+      if (device_param->native_d_result)         hc_nativeMemFree (hashcat_ctx, device_param->native_d_result);
+      if (device_param->native_d_extra0_buf)     hc_nativeMemFree (hashcat_ctx, device_param->native_d_extra0_buf);
+      if (device_param->native_d_extra1_buf)     hc_nativeMemFree (hashcat_ctx, device_param->native_d_extra1_buf);
+      if (device_param->native_d_extra2_buf)     hc_nativeMemFree (hashcat_ctx, device_param->native_d_extra2_buf);
+      if (device_param->native_d_extra3_buf)     hc_nativeMemFree (hashcat_ctx, device_param->native_d_extra3_buf);
+      if (device_param->native_d_root_css_buf)   hc_nativeMemFree (hashcat_ctx, device_param->native_d_root_css_buf);
+      if (device_param->native_d_markov_css_buf) hc_nativeMemFree (hashcat_ctx, device_param->native_d_markov_css_buf);
+      if (device_param->native_d_tm_c)           hc_nativeMemFree (hashcat_ctx, device_param->native_d_tm_c);
+      if (device_param->native_d_st_digests_buf) hc_nativeMemFree (hashcat_ctx, device_param->native_d_st_digests_buf);
+      if (device_param->native_d_st_salts_buf)   hc_nativeMemFree (hashcat_ctx, device_param->native_d_st_salts_buf);
+      if (device_param->native_d_st_esalts_buf)  hc_nativeMemFree (hashcat_ctx, device_param->native_d_st_esalts_buf);
+
+      hc_nativeProgramUnload (hashcat_ctx, &device_param->native_program);
+      hc_nativeProgramUnload (hashcat_ctx, &device_param->native_program_mp);
+      hc_nativeProgramUnload (hashcat_ctx, &device_param->native_program_amp);
+      hc_nativeProgramUnload (hashcat_ctx, &device_param->native_program_shared);
+
+      device_param->native_d_pws_buf        = NULL;
+      device_param->native_d_pws_amp_buf    = NULL;
+      device_param->native_d_pws_comp_buf   = NULL;
+      device_param->native_d_pws_idx        = NULL;
+      device_param->native_d_rules          = NULL;
+      device_param->native_d_rules_c        = NULL;
+      device_param->native_d_combs          = NULL;
+      device_param->native_d_combs_c        = NULL;
+      device_param->native_d_bfs            = NULL;
+      device_param->native_d_bfs_c          = NULL;
+      device_param->native_d_bitmap_s1_a    = NULL;
+      device_param->native_d_bitmap_s1_b    = NULL;
+      device_param->native_d_bitmap_s1_c    = NULL;
+      device_param->native_d_bitmap_s1_d    = NULL;
+      device_param->native_d_bitmap_s2_a    = NULL;
+      device_param->native_d_bitmap_s2_b    = NULL;
+      device_param->native_d_bitmap_s2_c    = NULL;
+      device_param->native_d_bitmap_s2_d    = NULL;
+      device_param->native_d_plain_bufs     = NULL;
+      device_param->native_d_digests_buf    = NULL;
+      device_param->native_d_digests_shown  = NULL;
+      device_param->native_d_salt_bufs      = NULL;
+      device_param->native_d_esalt_bufs     = NULL;
+      device_param->native_d_tmps           = NULL;
+      device_param->native_d_hooks          = NULL;
+      device_param->native_d_result         = NULL;
+      device_param->native_d_extra0_buf     = NULL;
+      device_param->native_d_extra1_buf     = NULL;
+      device_param->native_d_extra2_buf     = NULL;
+      device_param->native_d_extra3_buf     = NULL;
+      device_param->native_d_root_css_buf   = NULL;
+      device_param->native_d_markov_css_buf = NULL;
+      device_param->native_d_tm_c           = NULL;
+      device_param->native_d_st_digests_buf = NULL;
+      device_param->native_d_st_salts_buf   = NULL;
+      device_param->native_d_st_esalts_buf  = NULL;
+
+      memset (&device_param->native_function1,              0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function12,             0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function2p,             0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function2,              0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function2e,             0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function23,             0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function3,              0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function4,              0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_init2,         0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_loop2p,        0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_loop2,         0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_mp,            0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_mp_l,          0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_mp_r,          0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_tm,            0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_amp,           0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_memset,        0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_atinit,        0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_utf8toutf16le, 0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_decompress,    0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_aux1,          0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_aux2,          0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_aux3,          0, sizeof (hc_native_function_t));
+      memset (&device_param->native_function_aux4,          0, sizeof (hc_native_function_t));
+    }
+
     device_param->pws_comp            = NULL;
     device_param->pws_idx             = NULL;
     device_param->pws_pre_buf         = NULL;
@@ -11591,6 +13127,11 @@ void backend_session_destroy (hashcat_ctx_t *hashcat_ctx)
     #ifdef WITH_BRAIN
     device_param->brain_link_in_buf   = NULL;
     device_param->brain_link_out_buf  = NULL;
+    device_param->brain_link_sort_buf = NULL;
+    device_param->brain_link_pos_buf  = NULL;
+
+    device_param->brain_link_batch_buf      = NULL;
+    device_param->brain_link_batch_buf_prev = NULL;
     #endif
   }
 }
@@ -11743,6 +13284,12 @@ int backend_session_update_mp (hashcat_ctx_t *hashcat_ctx)
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_root_css_buf,   CL_TRUE, 0, device_param->size_root_css,   mask_ctx->root_css_buf,   0, NULL, NULL) == -1) return -1;
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_markov_css_buf, CL_TRUE, 0, device_param->size_markov_css, mask_ctx->markov_css_buf, 0, NULL, NULL) == -1) return -1;
     }
+
+    if (device_param->is_native == true)
+    {
+      memcpy (device_param->native_d_root_css_buf,   mask_ctx->root_css_buf,   device_param->size_root_css);
+      memcpy (device_param->native_d_markov_css_buf, mask_ctx->markov_css_buf, device_param->size_markov_css);
+    }
   }
 
   return 0;
@@ -11800,6 +13347,12 @@ int backend_session_update_mp_rl (hashcat_ctx_t *hashcat_ctx, const u32 css_cnt_
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_root_css_buf,   CL_TRUE, 0, device_param->size_root_css,   mask_ctx->root_css_buf,   0, NULL, NULL) == -1) return -1;
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_markov_css_buf, CL_TRUE, 0, device_param->size_markov_css, mask_ctx->markov_css_buf, 0, NULL, NULL) == -1) return -1;
     }
+
+    if (device_param->is_native == true)
+    {
+      memcpy (device_param->native_d_root_css_buf,   mask_ctx->root_css_buf,   device_param->size_root_css);
+      memcpy (device_param->native_d_markov_css_buf, mask_ctx->markov_css_buf, device_param->size_markov_css);
+    }
   }
 
   return 0;
@@ -1048,6 +1048,10 @@ bool brain_client_connect (hc_device_param_t *device_param, const status_ctx_t *
     return false;
   }
 
+  // the server answers with the version both sides speak, servers before version 2 answer 1 for ok
+
+  device_param->brain_link_version = brain_link_version_ok;
+
   u32 challenge = 0;
 
   if (brain_recv (brain_link_client_fd, &challenge, sizeof (challenge), 0, NULL, NULL) == false)
@@ -1139,6 +1143,35 @@ void brain_client_disconnect (hc_device_param_t *device_param)
   device_param->brain_link_client_fd = -1;
 }
 
+void brain_client_swap (hc_device_param_t *device_param)
+{
+  // the second link carries the lookup of the next batch while the previous one still waits for its commit
+
+  const int brain_link_client_fd = device_param->brain_link_client_fd;
+
+  device_param->brain_link_client_fd      = device_param->brain_link_client_fd_prev;
+  device_param->brain_link_client_fd_prev = brain_link_client_fd;
+
+  u64 *brain_link_batch_buf = device_param->brain_link_batch_buf;
+
+  device_param->brain_link_batch_buf      = device_param->brain_link_batch_buf_prev;
+  device_param->brain_link_batch_buf_prev = brain_link_batch_buf;
+
+  const u64 brain_link_batch_cnt = device_param->brain_link_batch_cnt;
+
+  device_param->brain_link_batch_cnt      = device_param->brain_link_batch_cnt_prev;
+  device_param->brain_link_batch_cnt_prev = brain_link_batch_cnt;
+}
+
+void *brain_client_handle_lookup (void *p)
+{
+  brain_client_lookup_options_t *brain_client_lookup_options = (brain_client_lookup_options_t *) p;
+
+  brain_client_lookup_options->rc = brain_client_lookup (brain_client_lookup_options->device_param, brain_client_lookup_options->status_ctx);
+
+  return NULL;
+}
+
 bool brain_client_reserve (hc_device_param_t *device_param, const status_ctx_t *status_ctx, u64 words_off, u64 work, u64 *overlap)
 {
   const int brain_link_client_fd = device_param->brain_link_client_fd;
@@ -1182,352 +1215,1582 @@ bool brain_client_lookup (hc_device_param_t *device_param, const status_ctx_t *s
   char *recvbuf = (char *) device_param->brain_link_in_buf;
   char *sendbuf = (char *) device_param->brain_link_out_buf;
 
-  int in_size  = 0;
-  int out_size = device_param->pws_pre_cnt * BRAIN_HASH_SIZE;
-
   u8 operation = BRAIN_OPERATION_HASH_LOOKUP;
 
-  if (brain_send (brain_link_client_fd, &operation, sizeof (operation), SEND_FLAGS, device_param, status_ctx) == false) return false;
-  if (brain_send (brain_link_client_fd, &out_size,   sizeof (out_size), SEND_FLAGS, device_param, status_ctx) == false) return false;
-  if (brain_send (brain_link_client_fd, sendbuf,              out_size, SEND_FLAGS, device_param, status_ctx) == false) return false;
+  if (device_param->brain_link_version < 2)
+  {
+    int in_size  = 0;
+    int out_size = device_param->pws_pre_cnt * BRAIN_HASH_SIZE;
 
-  if (brain_recv (brain_link_client_fd, &in_size,     sizeof (in_size),          0, device_param, status_ctx) == false) return false;
+    if (brain_send (brain_link_client_fd, &operation, sizeof (operation), SEND_FLAGS, device_param, status_ctx) == false) return false;
+    if (brain_send (brain_link_client_fd, &out_size,   sizeof (out_size), SEND_FLAGS, device_param, status_ctx) == false) return false;
+    if (brain_send (brain_link_client_fd, sendbuf,              out_size, SEND_FLAGS, device_param, status_ctx) == false) return false;
 
-  if (in_size > (int) device_param->size_brain_link_in) return false;
+    if (brain_recv (brain_link_client_fd, &in_size,     sizeof (in_size),          0, device_param, status_ctx) == false) return false;
 
-  if (brain_recv (brain_link_client_fd, recvbuf,      (size_t) in_size,          0, device_param, status_ctx) == false) return false;
+    if (in_size > (int) device_param->size_brain_link_in) return false;
 
-  return true;
-}
+    if (brain_recv (brain_link_client_fd, recvbuf,      (size_t) in_size,          0, device_param, status_ctx) == false) return false;
 
-void brain_client_generate_hash (u64 *hash, const char *line_buf, const size_t line_len)
-{
-  const u64 seed = 0;
+    return true;
+  }
 
-  hash[0] = XXH64 (line_buf, line_len, seed);
-}
+  // sorted and unique, the server answers one bit per unique hash and the positions never leave the client
 
-void brain_server_db_hash_init (brain_server_db_hash_t *brain_server_db_hash, const u32 brain_session)
-{
-  brain_server_db_hash->brain_session = brain_session;
+  u64 *sort_buf = device_param->brain_link_sort_buf;
+  u32 *pos_buf  = device_param->brain_link_pos_buf;
 
-  brain_server_db_hash->hb           = 0;
-  brain_server_db_hash->long_cnt     = 0;
-  brain_server_db_hash->long_buf     = NULL;
-  brain_server_db_hash->long_alloc   = 0;
-  brain_server_db_hash->write_hashes = false;
+  const u64 pws_pre_cnt = device_param->pws_pre_cnt;
 
-  hc_thread_mutex_init (brain_server_db_hash->mux_hr);
-  hc_thread_mutex_init (brain_server_db_hash->mux_hg);
-}
+  brain_client_sort_hashes (sort_buf, pos_buf, device_param->brain_link_out_buf, pws_pre_cnt);
 
-bool brain_server_db_hash_realloc (brain_server_db_hash_t *brain_server_db_hash, const i64 new_long_cnt)
-{
-  if ((brain_server_db_hash->long_cnt + new_long_cnt) > brain_server_db_hash->long_alloc)
+  // duplicates after the first one are rejects like on the server
+
+  for (u64 idx = 0; idx < pws_pre_cnt; idx++)
   {
-    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_long_cnt, (const u64) BRAIN_SERVER_REALLOC_HASH_SIZE) * BRAIN_SERVER_REALLOC_HASH_SIZE;
+    recvbuf[pos_buf[idx]] = ((idx > 0) && (sort_buf[idx] == sort_buf[idx - 1])) ? 1 : 0;
+  }
 
-    brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) hcrealloc (brain_server_db_hash->long_buf, brain_server_db_hash->long_alloc * sizeof (brain_server_hash_long_t), realloc_size_total * sizeof (brain_server_hash_long_t));
+  // the batch on the other link is not committed yet, so the server can not know about its hashes
+  // they are rejected here and never sent, otherwise they would pile up in the short-term memory of this link
 
-    if (long_buf == NULL) return false;
+  const u64 *batch_buf_prev = device_param->brain_link_batch_buf_prev;
+
+  for (u64 batch_idx = 0; batch_idx < device_param->brain_link_batch_cnt_prev; batch_idx++)
+  {
+    const u64 hash = batch_buf_prev[batch_idx];
+
+    u64 l = 0;
+    u64 r = pws_pre_cnt;
+
+    while (l < r)
+    {
+      const u64 m = l + ((r - l) / 2);
 
-    brain_server_db_hash->long_buf    = long_buf;
-    brain_server_db_hash->long_alloc += realloc_size_total;
+      if (sort_buf[m] < hash) l = m + 1; else r = m;
+    }
+
+    if ((l < pws_pre_cnt) && (sort_buf[l] == hash)) recvbuf[pos_buf[l]] = 1;
   }
 
-  return true;
-}
+  int hashes_cnt = 0;
 
-void brain_server_db_hash_free (brain_server_db_hash_t *brain_server_db_hash)
-{
-  hc_thread_mutex_delete (brain_server_db_hash->mux_hg);
-  hc_thread_mutex_delete (brain_server_db_hash->mux_hr);
+  for (u64 idx = 0; idx < pws_pre_cnt; idx++)
+  {
+    if (recvbuf[pos_buf[idx]] == 1) continue;
 
-  hcfree (brain_server_db_hash->long_buf);
+    sort_buf[hashes_cnt] = sort_buf[idx];
+    pos_buf[hashes_cnt]  = pos_buf[idx];
 
-  brain_server_db_hash->hb            = 0;
-  brain_server_db_hash->long_cnt      = 0;
-  brain_server_db_hash->long_buf      = NULL;
-  brain_server_db_hash->long_alloc    = 0;
-  brain_server_db_hash->write_hashes  = false;
-  brain_server_db_hash->brain_session = 0;
-}
+    hashes_cnt++;
+  }
 
-void brain_server_db_attack_init (brain_server_db_attack_t *brain_server_db_attack, const u32 brain_attack)
-{
-  brain_server_db_attack->brain_attack = brain_attack;
+  if (hashes_cnt == 0) return true;
 
-  brain_server_db_attack->ab            = 0;
-  brain_server_db_attack->short_cnt     = 0;
-  brain_server_db_attack->short_buf     = NULL;
-  brain_server_db_attack->short_alloc   = 0;
-  brain_server_db_attack->long_cnt      = 0;
-  brain_server_db_attack->long_buf      = NULL;
-  brain_server_db_attack->long_alloc    = 0;
-  brain_server_db_attack->write_attacks = false;
+  int pack_k = brain_pack_hashes_k (sort_buf[hashes_cnt - 1], hashes_cnt);
 
-  hc_thread_mutex_init (brain_server_db_attack->mux_ar);
-  hc_thread_mutex_init (brain_server_db_attack->mux_ag);
-}
+  // the raw hashes are in sort_buf now, the packed ones go where they were
 
-bool brain_server_db_attack_realloc (brain_server_db_attack_t *brain_server_db_attack, const i64 new_long_cnt, const i64 new_short_cnt)
-{
-  if ((brain_server_db_attack->long_cnt + new_long_cnt) > brain_server_db_attack->long_alloc)
-  {
-    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_long_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+  int in_size  = 0;
+  int out_size = (int) brain_pack_hashes ((u8 *) sendbuf, sort_buf, hashes_cnt, pack_k);
 
-    brain_server_attack_long_t *long_buf = (brain_server_attack_long_t *) hcrealloc (brain_server_db_attack->long_buf, brain_server_db_attack->long_alloc * sizeof (brain_server_attack_long_t), realloc_size_total * sizeof (brain_server_attack_long_t));
+  if (brain_send (brain_link_client_fd, &operation,   sizeof (operation),  SEND_FLAGS, device_param, status_ctx) == false) return false;
+  if (brain_send (brain_link_client_fd, &hashes_cnt,  sizeof (hashes_cnt), SEND_FLAGS, device_param, status_ctx) == false) return false;
+  if (brain_send (brain_link_client_fd, &pack_k,      sizeof (pack_k),     SEND_FLAGS, device_param, status_ctx) == false) return false;
+  if (brain_send (brain_link_client_fd, &out_size,    sizeof (out_size),   SEND_FLAGS, device_param, status_ctx) == false) return false;
+  if (brain_send (brain_link_client_fd, sendbuf,               out_size,   SEND_FLAGS, device_param, status_ctx) == false) return false;
 
-    if (long_buf == NULL) return false;
+  if (brain_recv (brain_link_client_fd, &in_size,     sizeof (in_size),             0, device_param, status_ctx) == false) return false;
 
-    brain_server_db_attack->long_buf    = long_buf;
-    brain_server_db_attack->long_alloc += realloc_size_total;
-  }
+  if (in_size != ((hashes_cnt + 7) / 8)) return false;
 
-  if ((brain_server_db_attack->short_cnt + new_short_cnt) > brain_server_db_attack->short_alloc)
+  if (brain_recv (brain_link_client_fd, sendbuf,      (size_t) in_size,             0, device_param, status_ctx) == false) return false;
+
+  // back to one byte per candidate in the original order
+  // the accepted ones are what the next batch on the other link has to be checked against
+
+  const u8 *bits = (const u8 *) sendbuf;
+
+  u64 *batch_buf = device_param->brain_link_batch_buf;
+
+  for (int hash_idx = 0; hash_idx < hashes_cnt; hash_idx++)
   {
-    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_short_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+    const u8 reject = (bits[hash_idx / 8] >> (hash_idx % 8)) & 1;
 
-    brain_server_attack_short_t *short_buf = (brain_server_attack_short_t *) hcrealloc (brain_server_db_attack->short_buf, brain_server_db_attack->short_alloc * sizeof (brain_server_attack_short_t), realloc_size_total * sizeof (brain_server_attack_short_t));
+    recvbuf[pos_buf[hash_idx]] = reject;
 
-    if (short_buf == NULL) return false;
+    if (reject == 1) continue;
 
-    brain_server_db_attack->short_buf    = short_buf;
-    brain_server_db_attack->short_alloc += realloc_size_total;
+    if (device_param->brain_link_batch_cnt == device_param->size_brain_link_in) continue;
+
+    batch_buf[device_param->brain_link_batch_cnt++] = sort_buf[hash_idx];
   }
 
   return true;
 }
 
-void brain_server_db_attack_free (brain_server_db_attack_t *brain_server_db_attack)
+void brain_client_generate_hash (u64 *hash, const char *line_buf, const size_t line_len)
 {
-  hc_thread_mutex_delete (brain_server_db_attack->mux_ag);
-  hc_thread_mutex_delete (brain_server_db_attack->mux_ar);
-
-  hcfree (brain_server_db_attack->long_buf);
-  hcfree (brain_server_db_attack->short_buf);
+  const u64 seed = 0;
 
-  brain_server_db_attack->ab            = 0;
-  brain_server_db_attack->long_cnt      = 0;
-  brain_server_db_attack->long_buf      = NULL;
-  brain_server_db_attack->long_alloc    = 0;
-  brain_server_db_attack->short_cnt     = 0;
-  brain_server_db_attack->short_buf     = NULL;
-  brain_server_db_attack->short_alloc   = 0;
-  brain_server_db_attack->brain_attack  = 0;
-  brain_server_db_attack->write_attacks = false;
+  hash[0] = XXH64 (line_buf, line_len, seed);
 }
 
-u64 brain_server_highest_attack (const brain_server_db_attack_t *buf)
+void brain_client_sort_hashes (u64 *sort_buf, u32 *pos_buf, const u32 *hash_buf, const u64 hash_cnt)
 {
-  const brain_server_attack_long_t  *long_buf  = buf->long_buf;
-  const brain_server_attack_short_t *short_buf = buf->short_buf;
+  // the hashes are uniform, scattered by their top bits they are nearly sorted and the insertion sort only fixes the few in each bucket
+  // equal hashes keep their order, the first one of a group is the one with the lowest position
 
-  const u64 long_cnt  = buf->long_cnt;
-  const u64 short_cnt = buf->short_cnt;
+  int bucket_bits = 1;
 
-  u64 highest_long  = brain_server_highest_attack_long  (long_buf,  long_cnt,  0);
-  u64 highest_short = brain_server_highest_attack_short (short_buf, short_cnt, 0);
+  while ((bucket_bits < 20) && ((1ULL << (bucket_bits + 2)) < hash_cnt)) bucket_bits++;
 
-  u64 highest = MAX (highest_long, highest_short);
+  const int bucket_shift = 64 - bucket_bits;
 
-  highest_long  = brain_server_highest_attack_long  (long_buf,  long_cnt,  highest);
-  highest_short = brain_server_highest_attack_short (short_buf, short_cnt, highest);
+  u64 *bucket_buf = (u64 *) hccalloc ((1ULL << bucket_bits) + 1, sizeof (u64));
 
-  highest = MAX (highest_long, highest_short);
-
-  return highest;
-}
+  for (u64 hash_idx = 0; hash_idx < hash_cnt; hash_idx++)
+  {
+    const u64 hash = ((u64) hash_buf[(hash_idx * 2) + 1] << 32) | hash_buf[(hash_idx * 2) + 0];
 
-u64 brain_server_highest_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 start)
-{
-  u64 highest = start;
+    bucket_buf[(hash >> bucket_shift) + 1]++;
+  }
 
-  for (i64 idx = 0; idx < cnt; idx++)
+  for (u64 bucket_idx = 1; bucket_idx <= (1ULL << bucket_bits); bucket_idx++)
   {
-    const u64 offset = buf[idx].offset;
-    const u64 length = buf[idx].length;
+    bucket_buf[bucket_idx] += bucket_buf[bucket_idx - 1];
+  }
 
-    if (offset > highest) break;
+  for (u64 hash_idx = 0; hash_idx < hash_cnt; hash_idx++)
+  {
+    const u64 hash = ((u64) hash_buf[(hash_idx * 2) + 1] << 32) | hash_buf[(hash_idx * 2) + 0];
 
-    const u64 next = offset + length;
+    const u64 dst = bucket_buf[hash >> bucket_shift]++;
 
-    highest = MAX (highest, next);
+    sort_buf[dst] = hash;
+    pos_buf[dst]  = (u32) hash_idx;
   }
 
-  return highest;
+  hcfree (bucket_buf);
+
+  for (u64 hash_idx = 1; hash_idx < hash_cnt; hash_idx++)
+  {
+    const u64 hash = sort_buf[hash_idx];
+    const u32 pos  = pos_buf[hash_idx];
+
+    u64 dst = hash_idx;
+
+    while ((dst > 0) && (sort_buf[dst - 1] > hash))
+    {
+      sort_buf[dst] = sort_buf[dst - 1];
+      pos_buf[dst]  = pos_buf[dst - 1];
+
+      dst--;
+    }
+
+    sort_buf[dst] = hash;
+    pos_buf[dst]  = pos;
+  }
 }
 
-u64 brain_server_highest_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 start)
+void brain_pack_bits (u8 *out_buf, size_t *out_len, u64 *acc, int *acc_bits, const u64 val, const int cnt)
 {
-  u64 highest = start;
+  // cnt <= 32, less than 8 bits are left in acc after each call
 
-  for (i64 idx = 0; idx < cnt; idx++)
-  {
-    const u64 offset = buf[idx].offset;
-    const u64 length = buf[idx].length;
+  *acc |= val << *acc_bits;
+
+  *acc_bits += cnt;
 
-    if (offset > highest) break;
+  while (*acc_bits >= 8)
+  {
+    out_buf[(*out_len)++] = (u8) *acc;
 
-    const u64 next = offset + length;
+    *acc >>= 8;
 
-    highest = MAX (highest, next);
+    *acc_bits -= 8;
   }
+}
+
+int brain_pack_hashes_k (const u64 hash_max, const u64 hash_cnt)
+{
+  // rice parameter, the mean gap of uniform hashes rounded down to a power of 2
 
-  return highest;
+  const u64 mean = (hash_cnt) ? hash_max / hash_cnt : 0;
+
+  int k = 0;
+
+  while ((k < 63) && ((mean >> (k + 1)) != 0)) k++;
+
+  return k;
 }
 
-u64 brain_server_find_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 offset, const u64 length)
+size_t brain_pack_hashes (u8 *out_buf, const u64 *hash_buf, const u64 hash_cnt, const int k)
 {
-  const u64 end = offset + length;
+  // sorted input, duplicates are skipped
+  // each gap to the previous hash is rice coded, the quotient in unary followed by the k low bits
+  // with k from brain_pack_hashes_k () all unary parts together are less than 2 bits per hash
 
-  u64 overlap = 0;
+  size_t out_len = 0;
 
-  for (i64 idx = 0; idx < cnt; idx++)
+  u64 acc = 0;
+
+  int acc_bits = 0;
+
+  u64 prev = 0;
+
+  for (u64 hash_idx = 0; hash_idx < hash_cnt; hash_idx++)
   {
-    const u64 element_length = buf[idx].length;
+    const u64 hash = hash_buf[hash_idx];
 
-    if (element_length == 0) continue;
+    if ((hash_idx > 0) && (hash == prev)) continue;
 
-    const u64 element_start = buf[idx].offset;
-    const u64 element_end   = element_start + element_length;
+    const u64 delta = hash - prev;
 
-    const u64 start = offset + overlap;
+    prev = hash;
 
-    if (element_start > start) break; // we can't ever do it since this list is sorted
+    u64 q = delta >> k;
 
-    if (element_end > start)
+    while (q >= 32)
     {
-      const u64 limited_end = MIN (end, element_end);
+      brain_pack_bits (out_buf, &out_len, &acc, &acc_bits, 0xffffffff, 32);
+
+      q -= 32;
+    }
+
+    brain_pack_bits (out_buf, &out_len, &acc, &acc_bits, (1ULL << q) - 1, (int) q + 1);
 
-      overlap += limited_end - start;
+    const u64 r = (k == 0) ? 0 : delta & (0xffffffffffffffffULL >> (64 - k));
 
-      if (overlap == length) break;
+    if (k > 32)
+    {
+      brain_pack_bits (out_buf, &out_len, &acc, &acc_bits, r & 0xffffffff, 32);
+      brain_pack_bits (out_buf, &out_len, &acc, &acc_bits, r >> 32, k - 32);
+    }
+    else
+    {
+      brain_pack_bits (out_buf, &out_len, &acc, &acc_bits, r, k);
     }
   }
 
-  return overlap;
+  if (acc_bits) out_buf[out_len++] = (u8) acc;
+
+  return out_len;
 }
 
-u64 brain_server_find_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 offset, const u64 length)
+bool brain_unpack_hashes (u32 *out_buf, const u8 *in_buf, const size_t in_len, const int hash_cnt, const int k)
 {
-  const u64 end = offset + length;
+  // the input comes from the network, anything which is not strictly increasing or runs past the end is rejected
 
-  u64 overlap = 0;
+  size_t in_pos = 0;
 
-  for (i64 idx = 0; idx < cnt; idx++)
+  u64 acc = 0;
+
+  int acc_bits = 0;
+
+  u64 prev = 0;
+
+  for (int hash_idx = 0; hash_idx < hash_cnt; hash_idx++)
   {
-    const u64 element_length = buf[idx].length;
+    u64 q = 0;
+
+    while (true)
+    {
+      if (acc_bits == 0)
+      {
+        if (in_pos == in_len) return false;
+
+        acc = in_buf[in_pos++];
+
+        acc_bits = 8;
+      }
+
+      const u64 bit = acc & 1;
+
+      acc >>= 1;
+
+      acc_bits--;
 
-    if (element_length == 0) continue;
+      if (bit == 0) break;
 
-    const u64 element_start = buf[idx].offset;
-    const u64 element_end   = element_start + element_length;
+      q++;
+    }
 
-    const u64 start = offset + overlap;
+    u64 r = 0;
 
-    if (element_start > start) break; // we can't ever do it since this list is sorted
+    int r_bits = 0;
 
-    if (element_end > start)
+    while (r_bits < k)
     {
-      const u64 limited_end = MIN (end, element_end);
+      if (acc_bits == 0)
+      {
+        if (in_pos == in_len) return false;
+
+        acc = in_buf[in_pos++];
+
+        acc_bits = 8;
+      }
+
+      const int take = MIN (k - r_bits, acc_bits);
+
+      r |= (acc & ((1ULL << take) - 1)) << r_bits;
+
+      acc >>= take;
 
-      overlap += limited_end - start;
+      acc_bits -= take;
 
-      if (overlap == length) break;
+      r_bits += take;
     }
+
+    if ((k > 0) && ((q >> (64 - k)) != 0)) return false;
+
+    const u64 delta = (q << k) | r;
+
+    if ((hash_idx > 0) && (delta == 0)) return false;
+
+    const u64 hash = prev + delta;
+
+    if (hash < prev) return false;
+
+    out_buf[(hash_idx * 2) + 0] = (u32) (hash >>  0);
+    out_buf[(hash_idx * 2) + 1] = (u32) (hash >> 32);
+
+    prev = hash;
   }
 
-  return overlap;
+  return true;
 }
 
-int brain_server_sort_db_hash (const void *v1, const void *v2)
+void brain_server_db_hash_init (brain_server_db_hash_t *brain_server_db_hash, const u32 brain_session)
 {
-  const brain_server_db_hash_t *d1 = (const brain_server_db_hash_t *) v1;
-  const brain_server_db_hash_t *d2 = (const brain_server_db_hash_t *) v2;
+  brain_server_db_hash->brain_session = brain_session;
 
-  if (d1->brain_session > d2->brain_session) return  1;
-  if (d1->brain_session < d2->brain_session) return -1;
+  brain_server_db_hash->hb           = 0;
+  brain_server_db_hash->run_buf      = (brain_server_hash_run_t *) hccalloc (BRAIN_SERVER_HASH_RUNS_MAX, sizeof (brain_server_hash_run_t));
+  brain_server_db_hash->run_cnt      = 0;
+  brain_server_db_hash->long_cnt     = 0;
+  brain_server_db_hash->jnl_buf      = NULL;
+  brain_server_db_hash->jnl_alloc    = 0;
+  brain_server_db_hash->jnl_cnt      = 0;
+  brain_server_db_hash->jnl_fd       = -1;
+  brain_server_db_hash->write_hashes = false;
 
-  return 0;
+  hc_thread_mutex_init (brain_server_db_hash->mux_hr);
+  hc_thread_mutex_init (brain_server_db_hash->mux_hg);
+  hc_thread_mutex_init (brain_server_db_hash->mux_hc);
+  hc_thread_mutex_init (brain_server_db_hash->mux_hf);
+  hc_thread_mutex_init (brain_server_db_hash->mux_hj);
 }
 
-int brain_server_sort_db_attack (const void *v1, const void *v2)
+bool brain_server_hash_run_init (brain_server_hash_run_t *brain_server_hash_run, brain_server_hash_long_t *long_buf, const i64 long_cnt)
 {
-  const brain_server_db_attack_t *d1 = (const brain_server_db_attack_t *) v1;
-  const brain_server_db_attack_t *d2 = (const brain_server_db_attack_t *) v2;
+  u64 bloom_bits = 64;
 
-  if (d1->brain_attack > d2->brain_attack) return  1;
-  if (d1->brain_attack < d2->brain_attack) return -1;
+  while (bloom_bits < (u64) long_cnt * BRAIN_SERVER_HASH_BLOOM_BITS) bloom_bits *= 2;
 
-  return 0;
-}
+  u64 *bloom_buf = (u64 *) hccalloc (bloom_bits / 64, sizeof (u64));
 
-int brain_server_sort_hash (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  if (bloom_buf == NULL) return false;
 
-  if (d1[1] > d2[1]) return  1;
-  if (d1[1] < d2[1]) return -1;
-  if (d1[0] > d2[0]) return  1;
-  if (d1[0] < d2[0]) return -1;
+  const u64 bloom_mask = bloom_bits - 1;
 
-  return 0;
-}
+  for (i64 idx = 0; idx < long_cnt; idx++)
+  {
+    const u32 *hash = long_buf[idx].hash;
 
-int brain_server_sort_attack_long (const void *v1, const void *v2)
-{
-  const brain_server_attack_long_t *d1 = (const brain_server_attack_long_t *) v1;
-  const brain_server_attack_long_t *d2 = (const brain_server_attack_long_t *) v2;
+    // the hashes are XXH64 already, two halves are enough for double hashing
 
-  if (d1->offset > d2->offset) return  1;
-  if (d1->offset < d2->offset) return -1;
+    const u64 h1 = hash[0];
+    const u64 h2 = hash[1] | 1;
 
-  return 0;
-}
+    for (int k = 0; k < BRAIN_SERVER_HASH_BLOOM_K; k++)
+    {
+      const u64 bit = (h1 + (k * h2)) & bloom_mask;
 
-int brain_server_sort_attack_short (const void *v1, const void *v2)
-{
-  const brain_server_attack_short_t *d1 = (const brain_server_attack_short_t *) v1;
-  const brain_server_attack_short_t *d2 = (const brain_server_attack_short_t *) v2;
+      bloom_buf[bit / 64] |= 1ULL << (bit % 64);
+    }
+  }
 
-  if (d1->offset > d2->offset) return  1;
-  if (d1->offset < d2->offset) return -1;
+  brain_server_hash_run->long_buf   = long_buf;
+  brain_server_hash_run->long_cnt   = long_cnt;
+  brain_server_hash_run->bloom_buf  = bloom_buf;
+  brain_server_hash_run->bloom_mask = bloom_mask;
 
-  return 0;
+  return true;
 }
 
-int brain_server_sort_hash_long (const void *v1, const void *v2)
+bool brain_server_hash_run_test (const brain_server_hash_run_t *brain_server_hash_run, const u32 *search)
 {
-  const brain_server_hash_long_t *d1 = (const brain_server_hash_long_t *) v1;
-  const brain_server_hash_long_t *d2 = (const brain_server_hash_long_t *) v2;
+  const u64 h1 = search[0];
+  const u64 h2 = search[1] | 1;
 
-  return brain_server_sort_hash (d1->hash, d2->hash);
-}
+  for (int k = 0; k < BRAIN_SERVER_HASH_BLOOM_K; k++)
+  {
+    const u64 bit = (h1 + (k * h2)) & brain_server_hash_run->bloom_mask;
 
-int brain_server_sort_hash_short (const void *v1, const void *v2)
-{
-  const brain_server_hash_short_t *d1 = (const brain_server_hash_short_t *) v1;
-  const brain_server_hash_short_t *d2 = (const brain_server_hash_short_t *) v2;
+    if ((brain_server_hash_run->bloom_buf[bit / 64] & (1ULL << (bit % 64))) == 0) return false;
+  }
 
-  return brain_server_sort_hash (d1->hash, d2->hash);
+  return true;
 }
 
-int brain_server_sort_hash_unique (const void *v1, const void *v2)
+void brain_server_hash_run_free (brain_server_hash_run_t *brain_server_hash_run)
 {
-  const brain_server_hash_unique_t *d1 = (const brain_server_hash_unique_t *) v1;
-  const brain_server_hash_unique_t *d2 = (const brain_server_hash_unique_t *) v2;
+  hcfree (brain_server_hash_run->long_buf);
+  hcfree (brain_server_hash_run->bloom_buf);
 
-  return brain_server_sort_hash (d1->hash, d2->hash);
+  brain_server_hash_run->long_buf   = NULL;
+  brain_server_hash_run->long_cnt   = 0;
+  brain_server_hash_run->bloom_buf  = NULL;
+  brain_server_hash_run->bloom_mask = 0;
 }
 
-bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+i64 brain_server_hash_run_merge (brain_server_hash_long_t *out_buf, const brain_server_hash_long_t *buf1, const i64 cnt1, const brain_server_hash_long_t *buf2, const i64 cnt2)
 {
-  brain_server_dbs->hash_cnt = 0;
+  // two clients can commit the same hash if their lookups ran at the same time, keep only one of them
 
-  /* temporary disabled due to https://github.com/hashcat/hashcat/issues/2379
-  if (chdir (path) == -1)
+  i64 idx1 = 0;
+  i64 idx2 = 0;
+  i64 cnt  = 0;
+
+  while ((idx1 < cnt1) && (idx2 < cnt2))
+  {
+    const int rc = brain_server_sort_hash_long (buf1 + idx1, buf2 + idx2);
+
+    if (rc < 0)
+    {
+      out_buf[cnt++] = buf1[idx1++];
+    }
+    else if (rc > 0)
+    {
+      out_buf[cnt++] = buf2[idx2++];
+    }
+    else
+    {
+      out_buf[cnt++] = buf1[idx1++];
+
+      idx2++;
+    }
+  }
+
+  while (idx1 < cnt1) out_buf[cnt++] = buf1[idx1++];
+  while (idx2 < cnt2) out_buf[cnt++] = buf2[idx2++];
+
+  return cnt;
+}
+
+bool brain_server_db_hash_compact (brain_server_db_hash_t *brain_server_db_hash, const bool force)
+{
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hc);
+
+  // commits only append, the runs we take here can not change until we swap them under mux_hg
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+
+  const int run_cnt = brain_server_db_hash->run_cnt;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+  if (run_cnt < 2)
+  {
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+    return false;
+  }
+
+  brain_server_hash_run_t *run_buf = brain_server_db_hash->run_buf;
+
+  // size tiered, merge the newest runs as long as the next older run is not much larger than all of them together
+
+  int run_beg = run_cnt - 1;
+
+  i64 sum = run_buf[run_beg].long_cnt;
+
+  while ((run_beg > 0) && (run_buf[run_beg - 1].long_cnt <= (sum * BRAIN_SERVER_HASH_RUNS_RATIO)))
+  {
+    run_beg--;
+
+    sum += run_buf[run_beg].long_cnt;
+  }
+
+  if ((force == true) && (run_beg == (run_cnt - 1))) run_beg = run_cnt - 2;
+
+  if (run_beg == (run_cnt - 1))
+  {
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+    return false;
+  }
+
+  sum = 0;
+
+  for (int run_idx = run_beg; run_idx < run_cnt; run_idx++) sum += run_buf[run_idx].long_cnt;
+
+  hc_timer_t timer_compact;
+
+  hc_timer_set (&timer_compact);
+
+  // the newest run is merged into the next older one and so on, they are sorted by size that way
+
+  brain_server_hash_long_t *long_buf = NULL;
+
+  i64 long_cnt = 0;
+
+  for (int run_idx = run_cnt - 1; run_idx >= run_beg; run_idx--)
+  {
+    const brain_server_hash_run_t *brain_server_hash_run = &run_buf[run_idx];
+
+    brain_server_hash_long_t *out_buf = (brain_server_hash_long_t *) hcmalloc ((long_cnt + brain_server_hash_run->long_cnt) * sizeof (brain_server_hash_long_t));
+
+    if (out_buf == NULL)
+    {
+      hcfree (long_buf);
+
+      hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+      return false;
+    }
+
+    long_cnt = brain_server_hash_run_merge (out_buf, brain_server_hash_run->long_buf, brain_server_hash_run->long_cnt, long_buf, long_cnt);
+
+    hcfree (long_buf);
+
+    long_buf = out_buf;
+  }
+
+  brain_server_hash_run_t brain_server_hash_run;
+
+  if (brain_server_hash_run_init (&brain_server_hash_run, long_buf, long_cnt) == false)
+  {
+    hcfree (long_buf);
+
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+    return false;
+  }
+
+  // swap, runs which were committed in the meantime move down
+
+  brain_server_hash_run_t *old_buf = (brain_server_hash_run_t *) hcmalloc ((run_cnt - run_beg) * sizeof (brain_server_hash_run_t));
+
+  memcpy (old_buf, run_buf + run_beg, (run_cnt - run_beg) * sizeof (brain_server_hash_run_t));
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+
+  const int run_cnt_cur = brain_server_db_hash->run_cnt;
+
+  run_buf[run_beg] = brain_server_hash_run;
+
+  memmove (run_buf + run_beg + 1, run_buf + run_cnt, (run_cnt_cur - run_cnt) * sizeof (brain_server_hash_run_t));
+
+  brain_server_db_hash->run_cnt = run_cnt_cur - (run_cnt - run_beg) + 1;
+
+  brain_server_db_hash->long_cnt -= sum - long_cnt;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+  // nobody can see the old runs anymore, lookups hold mux_hg while they search
+
+  for (int run_idx = 0; run_idx < (run_cnt - run_beg); run_idx++)
+  {
+    brain_server_hash_run_free (&old_buf[run_idx]);
+  }
+
+  hcfree (old_buf);
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+  const double ms = hc_timer_get (timer_compact);
+
+  brain_logging (stdout, 0, "M | %8.2f ms | Session: 0x%08x, Runs: %d, Hashes: %" PRIi64 "\n", ms, brain_server_db_hash->brain_session, run_cnt - run_beg, long_cnt);
+
+  return true;
+}
+
+bool brain_server_db_hash_add_run (brain_server_db_hash_t *brain_server_db_hash, brain_server_hash_long_t *long_buf, const i64 long_cnt)
+{
+  // the bloom filter is built before any lock is taken, publishing the run is all that is left for mux_hg
+
+  brain_server_hash_run_t brain_server_hash_run;
+
+  if (brain_server_hash_run_init (&brain_server_hash_run, long_buf, long_cnt) == false) return false;
+
+  while (true)
+  {
+    hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+
+    if (brain_server_db_hash->run_cnt < BRAIN_SERVER_HASH_RUNS_MAX)
+    {
+      brain_server_db_hash->run_buf[brain_server_db_hash->run_cnt] = brain_server_hash_run;
+
+      brain_server_db_hash->run_cnt++;
+
+      brain_server_db_hash->long_cnt += long_cnt;
+
+      brain_server_db_hash->write_hashes = true;
+
+      hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+      return true;
+    }
+
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+    // compaction can not keep up, do it here, outside of mux_hg
+
+    brain_server_db_hash_compact (brain_server_db_hash, true);
+  }
+}
+
+bool brain_server_db_hash_find (const brain_server_db_hash_t *brain_server_db_hash, const u32 *search)
+{
+  // caller holds mux_hg, newest first as it's the most likely one to have a hash of the current attack
+
+  for (int run_idx = brain_server_db_hash->run_cnt - 1; run_idx >= 0; run_idx--)
+  {
+    const brain_server_hash_run_t *brain_server_hash_run = &brain_server_db_hash->run_buf[run_idx];
+
+    if (brain_server_hash_run_test (brain_server_hash_run, search) == false) continue;
+
+    if (brain_server_find_hash_long (search, brain_server_hash_run->long_buf, brain_server_hash_run->long_cnt) != -1) return true;
+  }
+
+  return false;
+}
+
+bool brain_server_db_hash_journal (brain_server_db_hash_t *brain_server_db_hash, const brain_server_hash_short_t *short_buf, const i64 short_cnt)
+{
+  // called after the run was published, a snapshot which misses the run can not have rotated these hashes away that way
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hj);
+
+  if ((brain_server_db_hash->jnl_cnt + short_cnt) > brain_server_db_hash->jnl_alloc)
+  {
+    const i64 realloc_size_total = (i64) mydivc64 ((const u64) short_cnt, (const u64) BRAIN_SERVER_REALLOC_JOURNAL) * BRAIN_SERVER_REALLOC_JOURNAL;
+
+    brain_server_hash_long_t *jnl_buf = (brain_server_hash_long_t *) hcrealloc (brain_server_db_hash->jnl_buf, brain_server_db_hash->jnl_alloc * sizeof (brain_server_hash_long_t), realloc_size_total * sizeof (brain_server_hash_long_t));
+
+    if (jnl_buf == NULL)
+    {
+      hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+      return false;
+    }
+
+    brain_server_db_hash->jnl_buf    = jnl_buf;
+    brain_server_db_hash->jnl_alloc += realloc_size_total;
+  }
+
+  brain_server_hash_long_t *jnl_buf = brain_server_db_hash->jnl_buf + brain_server_db_hash->jnl_cnt;
+
+  for (i64 idx = 0; idx < short_cnt; idx++)
+  {
+    jnl_buf[idx].hash[0] = short_buf[idx].hash[0];
+    jnl_buf[idx].hash[1] = short_buf[idx].hash[1];
+  }
+
+  brain_server_db_hash->jnl_cnt += short_cnt;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+  return true;
+}
+
+void brain_server_db_hash_free (brain_server_db_hash_t *brain_server_db_hash)
+{
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hj);
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hf);
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hc);
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hg);
+  hc_thread_mutex_delete (brain_server_db_hash->mux_hr);
+
+  for (int run_idx = 0; run_idx < brain_server_db_hash->run_cnt; run_idx++)
+  {
+    brain_server_hash_run_free (&brain_server_db_hash->run_buf[run_idx]);
+  }
+
+  hcfree (brain_server_db_hash->run_buf);
+  hcfree (brain_server_db_hash->jnl_buf);
+
+  if (brain_server_db_hash->jnl_fd != -1) close (brain_server_db_hash->jnl_fd);
+
+  brain_server_db_hash->hb            = 0;
+  brain_server_db_hash->run_buf       = NULL;
+  brain_server_db_hash->jnl_buf       = NULL;
+  brain_server_db_hash->jnl_alloc     = 0;
+  brain_server_db_hash->jnl_cnt       = 0;
+  brain_server_db_hash->jnl_fd        = -1;
+  brain_server_db_hash->run_cnt       = 0;
+  brain_server_db_hash->long_cnt      = 0;
+  brain_server_db_hash->write_hashes  = false;
+  brain_server_db_hash->brain_session = 0;
+}
+
+void brain_server_db_attack_init (brain_server_db_attack_t *brain_server_db_attack, const u32 brain_attack)
+{
+  brain_server_db_attack->brain_attack = brain_attack;
+
+  brain_server_db_attack->ab            = 0;
+  brain_server_db_attack->short_cnt     = 0;
+  brain_server_db_attack->short_buf     = NULL;
+  brain_server_db_attack->short_alloc   = 0;
+  brain_server_db_attack->long_cnt      = 0;
+  brain_server_db_attack->long_buf      = NULL;
+  brain_server_db_attack->long_alloc    = 0;
+  brain_server_db_attack->jnl_buf       = NULL;
+  brain_server_db_attack->jnl_alloc     = 0;
+  brain_server_db_attack->jnl_cnt       = 0;
+  brain_server_db_attack->jnl_fd        = -1;
+  brain_server_db_attack->write_attacks = false;
+
+  hc_thread_mutex_init (brain_server_db_attack->mux_ar);
+  hc_thread_mutex_init (brain_server_db_attack->mux_ag);
+  hc_thread_mutex_init (brain_server_db_attack->mux_af);
+}
+
+bool brain_server_db_attack_realloc (brain_server_db_attack_t *brain_server_db_attack, const i64 new_long_cnt, const i64 new_short_cnt)
+{
+  if ((brain_server_db_attack->long_cnt + new_long_cnt) > brain_server_db_attack->long_alloc)
+  {
+    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_long_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+
+    brain_server_attack_long_t *long_buf = (brain_server_attack_long_t *) hcrealloc (brain_server_db_attack->long_buf, brain_server_db_attack->long_alloc * sizeof (brain_server_attack_long_t), realloc_size_total * sizeof (brain_server_attack_long_t));
+
+    if (long_buf == NULL) return false;
+
+    brain_server_db_attack->long_buf    = long_buf;
+    brain_server_db_attack->long_alloc += realloc_size_total;
+  }
+
+  if ((brain_server_db_attack->short_cnt + new_short_cnt) > brain_server_db_attack->short_alloc)
+  {
+    const i64 realloc_size_total = (i64) mydivc64 ((const u64) new_short_cnt, (const u64) BRAIN_SERVER_REALLOC_ATTACK_SIZE) * BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+
+    brain_server_attack_short_t *short_buf = (brain_server_attack_short_t *) hcrealloc (brain_server_db_attack->short_buf, brain_server_db_attack->short_alloc * sizeof (brain_server_attack_short_t), realloc_size_total * sizeof (brain_server_attack_short_t));
+
+    if (short_buf == NULL) return false;
+
+    brain_server_db_attack->short_buf    = short_buf;
+    brain_server_db_attack->short_alloc += realloc_size_total;
+  }
+
+  return true;
+}
+
+void brain_server_db_attack_free (brain_server_db_attack_t *brain_server_db_attack)
+{
+  hc_thread_mutex_delete (brain_server_db_attack->mux_af);
+  hc_thread_mutex_delete (brain_server_db_attack->mux_ag);
+  hc_thread_mutex_delete (brain_server_db_attack->mux_ar);
+
+  hcfree (brain_server_db_attack->long_buf);
+  hcfree (brain_server_db_attack->short_buf);
+  hcfree (brain_server_db_attack->jnl_buf);
+
+  if (brain_server_db_attack->jnl_fd != -1) close (brain_server_db_attack->jnl_fd);
+
+  brain_server_db_attack->ab            = 0;
+  brain_server_db_attack->jnl_buf       = NULL;
+  brain_server_db_attack->jnl_alloc     = 0;
+  brain_server_db_attack->jnl_cnt       = 0;
+  brain_server_db_attack->jnl_fd        = -1;
+  brain_server_db_attack->long_cnt      = 0;
+  brain_server_db_attack->long_buf      = NULL;
+  brain_server_db_attack->long_alloc    = 0;
+  brain_server_db_attack->short_cnt     = 0;
+  brain_server_db_attack->short_buf     = NULL;
+  brain_server_db_attack->short_alloc   = 0;
+  brain_server_db_attack->brain_attack  = 0;
+  brain_server_db_attack->write_attacks = false;
+}
+
+i64 brain_server_find_attack_long (const brain_server_attack_long_t *buf, const i64 cnt, const u64 offset)
+{
+  // the last range which starts at or before offset, the ranges are sorted and do not overlap
+
+  i64 l = 0;
+  i64 r = cnt;
+
+  while (l < r)
+  {
+    const i64 c = l + ((r - l) >> 1);
+
+    if (buf[c].offset <= offset)
+    {
+      l = c + 1;
+    }
+    else
+    {
+      r = c;
+    }
+  }
+
+  return l - 1;
+}
+
+i64 brain_server_find_attack_short (const brain_server_attack_short_t *buf, const i64 cnt, const u64 offset)
+{
+  i64 l = 0;
+  i64 r = cnt;
+
+  while (l < r)
+  {
+    const i64 c = l + ((r - l) >> 1);
+
+    if (buf[c].offset <= offset)
+    {
+      l = c + 1;
+    }
+    else
+    {
+      r = c;
+    }
+  }
+
+  return l - 1;
+}
+
+u64 brain_server_cover_attack (const brain_server_db_attack_t *buf, const u64 start, const u64 end)
+{
+  // follow the ranges from start as long as either the finished or the reserved ones continue without a gap
+
+  u64 pos = start;
+
+  while (pos < end)
+  {
+    u64 next = pos;
+
+    const i64 long_idx = brain_server_find_attack_long (buf->long_buf, buf->long_cnt, pos);
+
+    if (long_idx != -1) next = MAX (next, buf->long_buf[long_idx].offset + buf->long_buf[long_idx].length);
+
+    const i64 short_idx = brain_server_find_attack_short (buf->short_buf, buf->short_cnt, pos);
+
+    if (short_idx != -1) next = MAX (next, buf->short_buf[short_idx].offset + buf->short_buf[short_idx].length);
+
+    if (next == pos) break;
+
+    pos = next;
+  }
+
+  return MIN (pos, end);
+}
+
+u64 brain_server_highest_attack (const brain_server_db_attack_t *buf)
+{
+  return brain_server_cover_attack (buf, 0, (u64) -1);
+}
+
+bool brain_server_db_attack_add_long (brain_server_db_attack_t *brain_server_db_attack, const u64 offset, const u64 length)
+{
+  if (length == 0) return true;
+
+  if (brain_server_db_attack_realloc (brain_server_db_attack, 1, 0) == false) return false;
+
+  brain_server_attack_long_t *long_buf = brain_server_db_attack->long_buf;
+
+  const i64 long_cnt = brain_server_db_attack->long_cnt;
+
+  // merge with all ranges it overlaps or touches, a mask attack ends up with very few ranges that way
+
+  const i64 idx = brain_server_find_attack_long (long_buf, long_cnt, offset);
+
+  i64 first = idx + 1;
+
+  if ((idx != -1) && ((long_buf[idx].offset + long_buf[idx].length) >= offset)) first = idx;
+
+  u64 beg = offset;
+  u64 end = offset + length;
+
+  i64 last = first;
+
+  while ((last < long_cnt) && (long_buf[last].offset <= end))
+  {
+    beg = MIN (beg, long_buf[last].offset);
+    end = MAX (end, long_buf[last].offset + long_buf[last].length);
+
+    last++;
+  }
+
+  if (last == first)
+  {
+    memmove (long_buf + first + 1, long_buf + first, (long_cnt - first) * sizeof (brain_server_attack_long_t));
+
+    brain_server_db_attack->long_cnt++;
+  }
+  else
+  {
+    memmove (long_buf + first + 1, long_buf + last, (long_cnt - last) * sizeof (brain_server_attack_long_t));
+
+    brain_server_db_attack->long_cnt -= last - first - 1;
+  }
+
+  long_buf[first].offset = beg;
+  long_buf[first].length = end - beg;
+
+  return true;
+}
+
+bool brain_server_db_attack_add_short (brain_server_db_attack_t *brain_server_db_attack, const u64 offset, const u64 length, const int client_idx)
+{
+  // only the parts which are not reserved yet are added, so the reservations never overlap
+
+  const u64 end = offset + length;
+
+  u64 pos = offset;
+
+  while (pos < end)
+  {
+    if (brain_server_db_attack_realloc (brain_server_db_attack, 0, 1) == false) return false;
+
+    brain_server_attack_short_t *short_buf = brain_server_db_attack->short_buf;
+
+    const i64 short_cnt = brain_server_db_attack->short_cnt;
+
+    const i64 idx = brain_server_find_attack_short (short_buf, short_cnt, pos);
+
+    if ((idx != -1) && ((short_buf[idx].offset + short_buf[idx].length) > pos))
+    {
+      pos = short_buf[idx].offset + short_buf[idx].length;
+
+      continue;
+    }
+
+    const u64 gap_end = ((idx + 1) < short_cnt) ? MIN (end, short_buf[idx + 1].offset) : end;
+
+    const bool join_prev = (idx != -1) && (short_buf[idx].client_idx == client_idx) && ((short_buf[idx].offset + short_buf[idx].length) == pos);
+
+    const bool join_next = ((idx + 1) < short_cnt) && (short_buf[idx + 1].client_idx == client_idx) && (short_buf[idx + 1].offset == gap_end);
+
+    if ((join_prev == true) && (join_next == true))
+    {
+      short_buf[idx].length = (short_buf[idx + 1].offset + short_buf[idx + 1].length) - short_buf[idx].offset;
+
+      memmove (short_buf + idx + 1, short_buf + idx + 2, (short_cnt - idx - 2) * sizeof (brain_server_attack_short_t));
+
+      brain_server_db_attack->short_cnt--;
+    }
+    else if (join_prev == true)
+    {
+      short_buf[idx].length += gap_end - pos;
+    }
+    else if (join_next == true)
+    {
+      short_buf[idx + 1].length += short_buf[idx + 1].offset - pos;
+      short_buf[idx + 1].offset  = pos;
+    }
+    else
+    {
+      memmove (short_buf + idx + 2, short_buf + idx + 1, (short_cnt - idx - 1) * sizeof (brain_server_attack_short_t));
+
+      short_buf[idx + 1].offset     = pos;
+      short_buf[idx + 1].length     = gap_end - pos;
+      short_buf[idx + 1].client_idx = client_idx;
+
+      brain_server_db_attack->short_cnt++;
+    }
+
+    pos = gap_end;
+  }
+
+  return true;
+}
+
+i64 brain_server_db_attack_release (brain_server_db_attack_t *brain_server_db_attack, const int client_idx, const bool commit)
+{
+  // removes the reservations of a client, on commit they are moved to the finished ranges and the journal
+
+  brain_server_attack_short_t *short_buf = brain_server_db_attack->short_buf;
+
+  i64 short_cnt = 0;
+  i64 released  = 0;
+
+  for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
+  {
+    if (short_buf[idx].client_idx != client_idx)
+    {
+      short_buf[short_cnt++] = short_buf[idx];
+
+      continue;
+    }
+
+    if (commit == true)
+    {
+      if (brain_server_db_attack_add_long (brain_server_db_attack, short_buf[idx].offset, short_buf[idx].length) == false)
+      {
+        brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+      }
+
+      if (brain_server_db_attack_journal (brain_server_db_attack, short_buf[idx].offset, short_buf[idx].length) == false)
+      {
+        brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+      }
+    }
+
+    released++;
+  }
+
+  brain_server_db_attack->short_cnt = short_cnt;
+
+  return released;
+}
+
+bool brain_server_db_attack_journal (brain_server_db_attack_t *brain_server_db_attack, const u64 offset, const u64 length)
+{
+  // caller holds mux_ag, the journal thread writes the buffer to disk
+
+  if (brain_server_db_attack->jnl_cnt == brain_server_db_attack->jnl_alloc)
+  {
+    brain_server_attack_long_t *jnl_buf = (brain_server_attack_long_t *) hcrealloc (brain_server_db_attack->jnl_buf, brain_server_db_attack->jnl_alloc * sizeof (brain_server_attack_long_t), BRAIN_SERVER_REALLOC_ATTACK_SIZE * sizeof (brain_server_attack_long_t));
+
+    if (jnl_buf == NULL) return false;
+
+    brain_server_db_attack->jnl_buf    = jnl_buf;
+    brain_server_db_attack->jnl_alloc += BRAIN_SERVER_REALLOC_ATTACK_SIZE;
+  }
+
+  brain_server_db_attack->jnl_buf[brain_server_db_attack->jnl_cnt].offset = offset;
+  brain_server_db_attack->jnl_buf[brain_server_db_attack->jnl_cnt].length = length;
+
+  brain_server_db_attack->jnl_cnt++;
+
+  return true;
+}
+
+int brain_server_sort_db_hash (const void *v1, const void *v2)
+{
+  const brain_server_db_hash_t *d1 = (const brain_server_db_hash_t *) v1;
+  const brain_server_db_hash_t *d2 = (const brain_server_db_hash_t *) v2;
+
+  if (d1->brain_session > d2->brain_session) return  1;
+  if (d1->brain_session < d2->brain_session) return -1;
+
+  return 0;
+}
+
+int brain_server_sort_db_attack (const void *v1, const void *v2)
+{
+  const brain_server_db_attack_t *d1 = (const brain_server_db_attack_t *) v1;
+  const brain_server_db_attack_t *d2 = (const brain_server_db_attack_t *) v2;
+
+  if (d1->brain_attack > d2->brain_attack) return  1;
+  if (d1->brain_attack < d2->brain_attack) return -1;
+
+  return 0;
+}
+
+int brain_server_sort_hash (const void *v1, const void *v2)
+{
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  if (d1[1] > d2[1]) return  1;
+  if (d1[1] < d2[1]) return -1;
+  if (d1[0] > d2[0]) return  1;
+  if (d1[0] < d2[0]) return -1;
+
+  return 0;
+}
+
+int brain_server_sort_attack_long (const void *v1, const void *v2)
+{
+  const brain_server_attack_long_t *d1 = (const brain_server_attack_long_t *) v1;
+  const brain_server_attack_long_t *d2 = (const brain_server_attack_long_t *) v2;
+
+  if (d1->offset > d2->offset) return  1;
+  if (d1->offset < d2->offset) return -1;
+
+  return 0;
+}
+
+int brain_server_sort_attack_short (const void *v1, const void *v2)
+{
+  const brain_server_attack_short_t *d1 = (const brain_server_attack_short_t *) v1;
+  const brain_server_attack_short_t *d2 = (const brain_server_attack_short_t *) v2;
+
+  if (d1->offset > d2->offset) return  1;
+  if (d1->offset < d2->offset) return -1;
+
+  return 0;
+}
+
+int brain_server_sort_hash_long (const void *v1, const void *v2)
+{
+  const brain_server_hash_long_t *d1 = (const brain_server_hash_long_t *) v1;
+  const brain_server_hash_long_t *d2 = (const brain_server_hash_long_t *) v2;
+
+  return brain_server_sort_hash (d1->hash, d2->hash);
+}
+
+int brain_server_sort_hash_short (const void *v1, const void *v2)
+{
+  const brain_server_hash_short_t *d1 = (const brain_server_hash_short_t *) v1;
+  const brain_server_hash_short_t *d2 = (const brain_server_hash_short_t *) v2;
+
+  return brain_server_sort_hash (d1->hash, d2->hash);
+}
+
+int brain_server_sort_hash_unique (const void *v1, const void *v2)
+{
+  const brain_server_hash_unique_t *d1 = (const brain_server_hash_unique_t *) v1;
+  const brain_server_hash_unique_t *d2 = (const brain_server_hash_unique_t *) v2;
+
+  return brain_server_sort_hash (d1->hash, d2->hash);
+}
+
+bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+{
+  brain_server_dbs->hash_cnt = 0;
+
+  /* temporary disabled due to https://github.com/hashcat/hashcat/issues/2379
+  if (chdir (path) == -1)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", path, strerror (errno));
+
+    return false;
+  }
+  */
+
+  DIR *dirp = opendir (path);
+
+  if (dirp == NULL)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", path, strerror (errno));
+
+    return false;
+  }
+
+  struct dirent *entry;
+
+  while ((entry = readdir (dirp)) != NULL)
+  {
+    char *file = entry->d_name;
+
+    const size_t len = strlen (file);
+
+    if (len != 19) continue;
+
+    if (file[ 0] != 'b') continue;
+    if (file[ 1] != 'r') continue;
+    if (file[ 2] != 'a') continue;
+    if (file[ 3] != 'i') continue;
+    if (file[ 4] != 'n') continue;
+    if (file[ 5] != '.') continue;
+
+    if (file[14] != '.') continue;
+    if (file[15] != 'l') continue;
+
+    // .ldmp is the snapshot, .ljnl the journal and .ljno a journal of a snapshot which did not finish
+
+    bool journal = false;
+
+    if ((file[16] == 'd') && (file[17] == 'm') && (file[18] == 'p'))
+    {
+      journal = false;
+    }
+    else if ((file[16] == 'j') && (file[17] == 'n') && ((file[18] == 'l') || (file[18] == 'o')))
+    {
+      journal = true;
+    }
+    else
+    {
+      continue;
+    }
+
+    const u32 brain_session = byte_swap_32 (hex_to_u32 ((const u8 *) file + 6));
+
+    brain_server_db_hash_t *brain_server_db_hash = NULL;
+
+    for (int idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
+    {
+      if (brain_server_dbs->hash_buf[idx].brain_session != brain_session) continue;
+
+      brain_server_db_hash = &brain_server_dbs->hash_buf[idx];
+    }
+
+    if (brain_server_db_hash == NULL)
+    {
+      if (brain_server_dbs->hash_cnt >= BRAIN_SERVER_SESSIONS_MAX)
+      {
+        brain_logging (stderr, 0, "%s: too many sessions\n", file);
+
+        continue;
+      }
+
+      brain_server_db_hash = &brain_server_dbs->hash_buf[brain_server_dbs->hash_cnt];
+
+      brain_server_db_hash_init (brain_server_db_hash, brain_session);
+
+      brain_server_dbs->hash_cnt++;
+    }
+
+    brain_server_read_hash_dump (brain_server_db_hash, file, journal);
+  }
+
+  closedir (dirp);
+
+  // the replayed journals go into a new snapshot before any client connects, the journals start empty that way
+
+  for (int idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
+  {
+    brain_server_write_hash_dump (&brain_server_dbs->hash_buf[idx], path);
+  }
+
+  return true;
+}
+
+bool brain_server_write_hash_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+{
+  for (i64 idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
+  {
+    brain_server_db_hash_t *brain_server_db_hash = &brain_server_dbs->hash_buf[idx];
+
+    brain_server_write_hash_dump (brain_server_db_hash, path);
+  }
+
+  return true;
+}
+
+bool brain_server_read_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *file, const bool journal)
+{
+  hc_timer_t timer_dump;
+
+  hc_timer_set (&timer_dump);
+
+  // read from file
+
+  struct stat sb;
+
+  memset (&sb, 0, sizeof (struct stat));
+
+  if (stat (file, &sb) == -1)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+
+    return false;
+  }
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, file, "rb") == false)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+
+    return false;
+  }
+
+  // a crash can cut off the last hash of a journal, it's dropped here
+
+  i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_hash_long_t);
+
+  brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) hcmalloc (MAX (temp_cnt, 1) * sizeof (brain_server_hash_long_t));
+
+  if (long_buf == NULL)
+  {
+    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+    hc_fclose (&fp);
+
+    return false;
+  }
+
+  const size_t nread = hc_fread (long_buf, sizeof (brain_server_hash_long_t), temp_cnt, &fp);
+
+  hc_fclose (&fp);
+
+  if (nread != (size_t) temp_cnt)
+  {
+    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) nread * sizeof (brain_server_hash_long_t));
+
+    hcfree (long_buf);
+
+    return false;
+  }
+
+  // a snapshot is a single sorted run, a journal is in commit order and can have the same hash more than once
+
+  if (journal == true)
+  {
+    qsort (long_buf, temp_cnt, sizeof (brain_server_hash_long_t), brain_server_sort_hash_long);
+
+    i64 long_cnt = 0;
+
+    for (i64 idx = 0; idx < temp_cnt; idx++)
+    {
+      if ((long_cnt > 0) && (brain_server_sort_hash_long (&long_buf[idx], &long_buf[long_cnt - 1]) == 0)) continue;
+
+      long_buf[long_cnt++] = long_buf[idx];
+    }
+
+    temp_cnt = long_cnt;
+  }
+
+  if (temp_cnt == 0)
+  {
+    hcfree (long_buf);
+  }
+  else
+  {
+    const bool write_hashes = brain_server_db_hash->write_hashes;
+
+    if (brain_server_db_hash_add_run (brain_server_db_hash, long_buf, temp_cnt) == false)
+    {
+      brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+      hcfree (long_buf);
+
+      return false;
+    }
+
+    // only the hashes of a journal are missing in the snapshot
+
+    brain_server_db_hash->write_hashes = write_hashes | journal;
+  }
+
+  const double ms = hc_timer_get (timer_dump);
+
+  brain_logging (stdout, 0, "Read %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_hash->brain_session, ms);
+
+  return true;
+}
+
+bool brain_server_write_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *path)
+{
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+
+  const bool write_hashes = brain_server_db_hash->write_hashes;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+  if (write_hashes == false) return true;
+
+  hc_timer_t timer_dump;
+
+  hc_timer_set (&timer_dump);
+
+  char file[256];
+  char file_tmp[256];
+  char file_jnl[256];
+  char file_old[256];
+
+  snprintf (file,     sizeof (file),     "%s/brain.%08x.ldmp", path, brain_server_db_hash->brain_session);
+  snprintf (file_tmp, sizeof (file_tmp), "%s/brain.%08x.ltmp", path, brain_server_db_hash->brain_session);
+  snprintf (file_jnl, sizeof (file_jnl), "%s/brain.%08x.ljnl", path, brain_server_db_hash->brain_session);
+  snprintf (file_old, sizeof (file_old), "%s/brain.%08x.ljno", path, brain_server_db_hash->brain_session);
+
+  // no merge can free a run while it's written
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hc);
+
+  // all hashes in the journal so far are in the runs already, the snapshot makes the rotated journal obsolete
+  // hashes committed from here on go into a new journal, the ones which also make it into the snapshot are merged on recovery
+
+  brain_server_write_hash_journal (brain_server_db_hash, path);
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hf);
+
+  const bool rc_rotate = brain_server_journal_rotate (&brain_server_db_hash->jnl_fd, file_jnl, file_old, sizeof (brain_server_hash_long_t));
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hf);
+
+  if (rc_rotate == false)
+  {
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+    return false;
+  }
+
+  // the runs are immutable, a copy of the list is all that's needed to write them without mux_hg
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+
+  const int run_cnt = brain_server_db_hash->run_cnt;
+
+  brain_server_hash_run_t *run_buf = (brain_server_hash_run_t *) hcmalloc (MAX (run_cnt, 1) * sizeof (brain_server_hash_run_t));
+
+  memcpy (run_buf, brain_server_db_hash->run_buf, run_cnt * sizeof (brain_server_hash_run_t));
+
+  brain_server_db_hash->write_hashes = false;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+  // write to file
+
+  HCFILE fp;
+
+  const bool fp_open = hc_fopen (&fp, file_tmp, "wb");
+
+  bool rc = fp_open;
+
+  if (rc == false)
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file_tmp, strerror (errno));
+  }
+
+  // the runs are merged while writing, the snapshot stays a single sorted array
+
+  i64 *run_pos = (i64 *) hccalloc (MAX (run_cnt, 1), sizeof (i64));
+
+  brain_server_hash_long_t *out_buf = (brain_server_hash_long_t *) hcmalloc (BRAIN_SERVER_HASH_DUMP_CHUNK * sizeof (brain_server_hash_long_t));
+
+  i64 out_cnt   = 0;
+  i64 out_total = 0;
+
+  while (rc == true)
+  {
+    int run_min = -1;
+
+    for (int run_idx = 0; run_idx < run_cnt; run_idx++)
+    {
+      if (run_pos[run_idx] == run_buf[run_idx].long_cnt) continue;
+
+      if (run_min == -1)
+      {
+        run_min = run_idx;
+
+        continue;
+      }
+
+      const brain_server_hash_long_t *cur = &run_buf[run_idx].long_buf[run_pos[run_idx]];
+      const brain_server_hash_long_t *min = &run_buf[run_min].long_buf[run_pos[run_min]];
+
+      const int cmp = brain_server_sort_hash_long (cur, min);
+
+      if (cmp < 0)
+      {
+        run_min = run_idx;
+      }
+      else if (cmp == 0)
+      {
+        run_pos[run_idx]++; // same hash in two runs, not merged yet
+      }
+    }
+
+    if ((run_min == -1) || (out_cnt == BRAIN_SERVER_HASH_DUMP_CHUNK))
+    {
+      const size_t nwrite = hc_fwrite (out_buf, sizeof (brain_server_hash_long_t), out_cnt, &fp);
+
+      if (nwrite != (size_t) out_cnt)
+      {
+        brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", file_tmp, (u64) (out_total + nwrite) * sizeof (brain_server_hash_long_t));
+
+        rc = false;
+      }
+
+      out_total += out_cnt;
+
+      out_cnt = 0;
+    }
+
+    if (run_min == -1) break;
+
+    out_buf[out_cnt++] = run_buf[run_min].long_buf[run_pos[run_min]++];
+  }
+
+  hcfree (out_buf);
+  hcfree (run_pos);
+  hcfree (run_buf);
+
+  if (fp_open == true)
+  {
+    hc_fflush (&fp);
+
+    if ((rc == true) && (brain_server_sync (fp.fd) == false))
+    {
+      brain_logging (stderr, 0, "%s: %s\n", file_tmp, strerror (errno));
+
+      rc = false;
+    }
+
+    hc_fclose (&fp);
+  }
+
+  if ((rc == true) && (rename (file_tmp, file) == -1))
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+
+    rc = false;
+  }
+
+  if (rc == false)
+  {
+    // the rotated journal stays, the next snapshot tries again
+
+    unlink (file_tmp);
+
+    hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
+
+    brain_server_db_hash->write_hashes = true;
+
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+
+    hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+    return false;
+  }
+
+  unlink (file_old);
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hc);
+
+  // stats
+
+  const double ms = hc_timer_get (timer_dump);
+
+  brain_logging (stdout, 0, "Wrote %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) out_total * sizeof (brain_server_hash_long_t), brain_server_db_hash->brain_session, ms);
+
+  return true;
+}
+
+bool brain_server_write_hash_journal (brain_server_db_hash_t *brain_server_db_hash, const char *path)
+{
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hf);
+
+  // swap the buffer, the commits do not wait for the disk
+
+  hc_thread_mutex_lock (brain_server_db_hash->mux_hj);
+
+  brain_server_hash_long_t *jnl_buf = brain_server_db_hash->jnl_buf;
+
+  const i64 jnl_cnt = brain_server_db_hash->jnl_cnt;
+
+  brain_server_db_hash->jnl_buf   = NULL;
+  brain_server_db_hash->jnl_alloc = 0;
+  brain_server_db_hash->jnl_cnt   = 0;
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hj);
+
+  bool rc = true;
+
+  if (jnl_cnt)
+  {
+    hc_timer_t timer_journal;
+
+    hc_timer_set (&timer_journal);
+
+    char file[256];
+
+    snprintf (file, sizeof (file), "%s/brain.%08x.ljnl", path, brain_server_db_hash->brain_session);
+
+    rc = brain_server_journal_append (&brain_server_db_hash->jnl_fd, file, jnl_buf, jnl_cnt * sizeof (brain_server_hash_long_t));
+
+    const double ms = hc_timer_get (timer_journal);
+
+    brain_logging (stdout, 0, "J | %8.2f ms | Session: 0x%08x, Hashes: %" PRIi64 "\n", ms, brain_server_db_hash->brain_session, jnl_cnt);
+  }
+
+  hc_thread_mutex_unlock (brain_server_db_hash->mux_hf);
+
+  hcfree (jnl_buf);
+
+  return rc;
+}
+
+bool brain_server_read_attack_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+{
+  brain_server_dbs->attack_cnt = 0;
+
+  /* temporary disabled due to https://github.com/hashcat/hashcat/issues/2379
+  if (chdir (path) == -1)
   {
     brain_logging (stderr, 0, "%s: %s\n", path, strerror (errno));
 
@@ -1544,7 +2807,7 @@ bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const c
     return false;
   }
 
-  struct dirent *entry;
+  struct dirent *entry = NULL;
 
   while ((entry = readdir (dirp)) != NULL)
   {
@@ -1562,50 +2825,85 @@ bool brain_server_read_hash_dumps (brain_server_dbs_t *brain_server_dbs, const c
     if (file[ 5] != '.') continue;
 
     if (file[14] != '.') continue;
-    if (file[15] != 'l') continue;
-    if (file[16] != 'd') continue;
-    if (file[17] != 'm') continue;
-    if (file[18] != 'p') continue;
+    if (file[15] != 'a') continue;
 
-    const u32 brain_session = byte_swap_32 (hex_to_u32 ((const u8 *) file + 6));
+    // .admp is the snapshot, .ajnl the journal and .ajno a journal of a snapshot which did not finish
 
-    brain_server_db_hash_t *brain_server_db_hash = &brain_server_dbs->hash_buf[brain_server_dbs->hash_cnt];
+    bool journal = false;
 
-    brain_server_db_hash_init (brain_server_db_hash, brain_session);
+    if ((file[16] == 'd') && (file[17] == 'm') && (file[18] == 'p'))
+    {
+      journal = false;
+    }
+    else if ((file[16] == 'j') && (file[17] == 'n') && ((file[18] == 'l') || (file[18] == 'o')))
+    {
+      journal = true;
+    }
+    else
+    {
+      continue;
+    }
 
-    if (brain_server_read_hash_dump (brain_server_db_hash, file) == false) continue;
+    const u32 brain_attack = byte_swap_32 (hex_to_u32 ((const u8 *) file + 6));
 
-    brain_server_dbs->hash_cnt++;
+    brain_server_db_attack_t key_attack;
+
+    key_attack.brain_attack = brain_attack;
+
+    #if defined (_WIN)
+    unsigned int find_attack_cnt = (unsigned int) brain_server_dbs->attack_cnt;
+    #else
+    size_t find_attack_cnt = (size_t) brain_server_dbs->attack_cnt;
+    #endif
+
+    brain_server_db_attack_t *brain_server_db_attack = (brain_server_db_attack_t *) lfind (&key_attack, brain_server_dbs->attack_buf, &find_attack_cnt, sizeof (brain_server_db_attack_t), brain_server_sort_db_attack);
+
+    if (brain_server_db_attack == NULL)
+    {
+      if (brain_server_dbs->attack_cnt >= BRAIN_SERVER_ATTACKS_MAX)
+      {
+        brain_logging (stderr, 0, "%s: too many attacks\n", file);
+
+        continue;
+      }
+
+      brain_server_db_attack = &brain_server_dbs->attack_buf[brain_server_dbs->attack_cnt];
+
+      brain_server_db_attack_init (brain_server_db_attack, brain_attack);
+
+      brain_server_dbs->attack_cnt++;
+    }
+
+    if (brain_server_read_attack_dump (brain_server_db_attack, file) == false) continue;
+
+    if (journal == true) brain_server_db_attack->write_attacks = true;
   }
 
   closedir (dirp);
 
+  // the replayed journals go into a new snapshot before any client connects, the journals start empty that way
+
+  for (int idx = 0; idx < brain_server_dbs->attack_cnt; idx++)
+  {
+    brain_server_write_attack_dump (&brain_server_dbs->attack_buf[idx], path);
+  }
+
   return true;
 }
 
-bool brain_server_write_hash_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+bool brain_server_write_attack_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
 {
-  for (i64 idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
+  for (i64 idx = 0; idx < brain_server_dbs->attack_cnt; idx++)
   {
-    brain_server_db_hash_t *brain_server_db_hash = &brain_server_dbs->hash_buf[idx];
-
-    hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
-
-    char file[100];
-
-    memset (file, 0, sizeof (file));
-
-    snprintf (file, sizeof (file), "%s/brain.%08x.ldmp", path, brain_server_db_hash->brain_session);
-
-    brain_server_write_hash_dump (brain_server_db_hash, file);
+    brain_server_db_attack_t *brain_server_db_attack = &brain_server_dbs->attack_buf[idx];
 
-    hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
+    brain_server_write_attack_dump (brain_server_db_attack, path);
   }
 
   return true;
 }
 
-bool brain_server_read_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *file)
+bool brain_server_read_attack_dump (brain_server_db_attack_t *brain_server_db_attack, const char *file)
 {
   hc_timer_t timer_dump;
 
@@ -1633,291 +2931,352 @@ bool brain_server_read_hash_dump (brain_server_db_hash_t *brain_server_db_hash,
     return false;
   }
 
-  i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_hash_long_t);
+  // a crash can cut off the last range of a journal, it's dropped here
+
+  i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_attack_long_t);
 
-  if (brain_server_db_hash_realloc (brain_server_db_hash, temp_cnt) == false)
+  brain_server_attack_long_t *temp_buf = (brain_server_attack_long_t *) hcmalloc (MAX (temp_cnt, 1) * sizeof (brain_server_attack_long_t));
+
+  if ((temp_buf == NULL) || (brain_server_db_attack_realloc (brain_server_db_attack, temp_cnt, 0) == false))
   {
     brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
 
+    hcfree (temp_buf);
+
     hc_fclose (&fp);
 
     return false;
   }
 
-  const size_t nread = hc_fread (brain_server_db_hash->long_buf, sizeof (brain_server_hash_long_t), temp_cnt, &fp);
+  const size_t nread = hc_fread (temp_buf, sizeof (brain_server_attack_long_t), temp_cnt, &fp);
+
+  hc_fclose (&fp);
 
   if (nread != (size_t) temp_cnt)
   {
-    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) nread * sizeof (brain_server_hash_long_t));
+    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) nread * sizeof (brain_server_attack_long_t));
 
-    hc_fclose (&fp);
+    hcfree (temp_buf);
 
     return false;
   }
 
-  brain_server_db_hash->long_cnt     = temp_cnt;
-  brain_server_db_hash->write_hashes = false;
+  // snapshots are sorted and only append, journals and dumps of older versions are merged with what's there
 
-  hc_fclose (&fp);
+  for (i64 idx = 0; idx < temp_cnt; idx++)
+  {
+    brain_server_db_attack_add_long (brain_server_db_attack, temp_buf[idx].offset, temp_buf[idx].length);
+  }
+
+  hcfree (temp_buf);
 
   const double ms = hc_timer_get (timer_dump);
 
-  brain_logging (stdout, 0, "Read %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_hash->brain_session, ms);
+  brain_logging (stdout, 0, "Read %" PRIu64 " bytes from attack 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_attack->brain_attack, ms);
 
   return true;
 }
 
-bool brain_server_write_hash_dump (brain_server_db_hash_t *brain_server_db_hash, const char *file)
+bool brain_server_write_attack_dump (brain_server_db_attack_t *brain_server_db_attack, const char *path)
 {
-  if (brain_server_db_hash->write_hashes == false) return true;
+  hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
+
+  const bool write_attacks = brain_server_db_attack->write_attacks;
+
+  hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+
+  if (write_attacks == false) return true;
 
   hc_timer_t timer_dump;
 
   hc_timer_set (&timer_dump);
 
-  // write to file
-
-  HCFILE fp;
+  char file[256];
+  char file_tmp[256];
+  char file_jnl[256];
+  char file_old[256];
 
-  if (hc_fopen (&fp, file, "wb") == false)
-  {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+  snprintf (file,     sizeof (file),     "%s/brain.%08x.admp", path, brain_server_db_attack->brain_attack);
+  snprintf (file_tmp, sizeof (file_tmp), "%s/brain.%08x.atmp", path, brain_server_db_attack->brain_attack);
+  snprintf (file_jnl, sizeof (file_jnl), "%s/brain.%08x.ajnl", path, brain_server_db_attack->brain_attack);
+  snprintf (file_old, sizeof (file_old), "%s/brain.%08x.ajno", path, brain_server_db_attack->brain_attack);
 
-    return false;
-  }
+  // same as for the hashes, everything in the rotated journal is in the finished ranges already
 
-  const size_t nwrite = hc_fwrite (brain_server_db_hash->long_buf, sizeof (brain_server_hash_long_t), brain_server_db_hash->long_cnt, &fp);
+  brain_server_write_attack_journal (brain_server_db_attack, path);
 
-  if (nwrite != (size_t) brain_server_db_hash->long_cnt)
-  {
-    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", file, (u64) nwrite * sizeof (brain_server_hash_long_t));
+  hc_thread_mutex_lock (brain_server_db_attack->mux_af);
 
-    hc_fclose (&fp);
+  const bool rc_rotate = brain_server_journal_rotate (&brain_server_db_attack->jnl_fd, file_jnl, file_old, sizeof (brain_server_attack_long_t));
 
-    return false;
-  }
+  hc_thread_mutex_unlock (brain_server_db_attack->mux_af);
 
-  hc_fclose (&fp);
+  if (rc_rotate == false) return false;
 
-  brain_server_db_hash->write_hashes = false;
+  // storing should not include reserved attacks only finished, they are few after the merges, copy them
 
-  // stats
+  hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-  const double ms = hc_timer_get (timer_dump);
+  const i64 long_cnt = brain_server_db_attack->long_cnt;
 
-  struct stat sb;
+  brain_server_attack_long_t *long_buf = (brain_server_attack_long_t *) hcmalloc (MAX (long_cnt, 1) * sizeof (brain_server_attack_long_t));
 
-  memset (&sb, 0, sizeof (struct stat));
+  memcpy (long_buf, brain_server_db_attack->long_buf, long_cnt * sizeof (brain_server_attack_long_t));
 
-  if (stat (file, &sb) == -1)
-  {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+  brain_server_db_attack->write_attacks = false;
 
-    return false;
-  }
+  hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
 
-  brain_logging (stdout, 0, "Wrote %" PRIu64 " bytes from session 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_hash->brain_session, ms);
+  // write to file
 
-  return true;
-}
+  HCFILE fp;
 
-bool brain_server_read_attack_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
-{
-  brain_server_dbs->attack_cnt = 0;
+  bool rc = hc_fopen (&fp, file_tmp, "wb");
 
-  /* temporary disabled due to https://github.com/hashcat/hashcat/issues/2379
-  if (chdir (path) == -1)
+  if (rc == false)
   {
-    brain_logging (stderr, 0, "%s: %s\n", path, strerror (errno));
-
-    return false;
+    brain_logging (stderr, 0, "%s: %s\n", file_tmp, strerror (errno));
   }
-  */
+  else
+  {
+    const size_t nwrite = hc_fwrite (long_buf, sizeof (brain_server_attack_long_t), long_cnt, &fp);
 
-  DIR *dirp = opendir (path);
+    if (nwrite != (size_t) long_cnt)
+    {
+      brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", file_tmp, (u64) nwrite * sizeof (brain_server_attack_long_t));
 
-  if (dirp == NULL)
-  {
-    brain_logging (stderr, 0, "%s: %s\n", path, strerror (errno));
+      rc = false;
+    }
 
-    return false;
-  }
+    hc_fflush (&fp);
 
-  struct dirent *entry = NULL;
+    if ((rc == true) && (brain_server_sync (fp.fd) == false))
+    {
+      brain_logging (stderr, 0, "%s: %s\n", file_tmp, strerror (errno));
 
-  while ((entry = readdir (dirp)) != NULL)
-  {
-    char *file = entry->d_name;
+      rc = false;
+    }
 
-    const size_t len = strlen (file);
+    hc_fclose (&fp);
+  }
 
-    if (len != 19) continue;
+  hcfree (long_buf);
 
-    if (file[ 0] != 'b') continue;
-    if (file[ 1] != 'r') continue;
-    if (file[ 2] != 'a') continue;
-    if (file[ 3] != 'i') continue;
-    if (file[ 4] != 'n') continue;
-    if (file[ 5] != '.') continue;
+  if ((rc == true) && (rename (file_tmp, file) == -1))
+  {
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
 
-    if (file[14] != '.') continue;
-    if (file[15] != 'a') continue;
-    if (file[16] != 'd') continue;
-    if (file[17] != 'm') continue;
-    if (file[18] != 'p') continue;
+    rc = false;
+  }
 
-    const u32 brain_attack = byte_swap_32 (hex_to_u32 ((const u8 *) file + 6));
+  if (rc == false)
+  {
+    // the rotated journal stays, the next snapshot tries again
+
+    unlink (file_tmp);
 
-    brain_server_db_attack_t *brain_server_db_attack = &brain_server_dbs->attack_buf[brain_server_dbs->attack_cnt];
+    hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-    brain_server_db_attack_init (brain_server_db_attack, brain_attack);
+    brain_server_db_attack->write_attacks = true;
 
-    if (brain_server_read_attack_dump (brain_server_db_attack, file) == false) continue;
+    hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
 
-    brain_server_dbs->attack_cnt++;
+    return false;
   }
 
-  closedir (dirp);
+  unlink (file_old);
+
+  // stats
+
+  const double ms = hc_timer_get (timer_dump);
+
+  brain_logging (stdout, 0, "Wrote %" PRIu64 " bytes from attack 0x%08x in %.2f ms\n", (u64) long_cnt * sizeof (brain_server_attack_long_t), brain_server_db_attack->brain_attack, ms);
 
   return true;
 }
 
-bool brain_server_write_attack_dumps (brain_server_dbs_t *brain_server_dbs, const char *path)
+bool brain_server_write_attack_journal (brain_server_db_attack_t *brain_server_db_attack, const char *path)
 {
-  for (i64 idx = 0; idx < brain_server_dbs->attack_cnt; idx++)
+  hc_thread_mutex_lock (brain_server_db_attack->mux_af);
+
+  hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
+
+  brain_server_attack_long_t *jnl_buf = brain_server_db_attack->jnl_buf;
+
+  const i64 jnl_cnt = brain_server_db_attack->jnl_cnt;
+
+  brain_server_db_attack->jnl_buf   = NULL;
+  brain_server_db_attack->jnl_alloc = 0;
+  brain_server_db_attack->jnl_cnt   = 0;
+
+  hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+
+  bool rc = true;
+
+  if (jnl_cnt)
   {
-    brain_server_db_attack_t *brain_server_db_attack = &brain_server_dbs->attack_buf[idx];
+    hc_timer_t timer_journal;
 
-    hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
+    hc_timer_set (&timer_journal);
 
-    char file[100];
+    char file[256];
 
-    memset (file, 0, sizeof (file));
+    snprintf (file, sizeof (file), "%s/brain.%08x.ajnl", path, brain_server_db_attack->brain_attack);
 
-    snprintf (file, sizeof (file), "%s/brain.%08x.admp", path, brain_server_db_attack->brain_attack);
+    rc = brain_server_journal_append (&brain_server_db_attack->jnl_fd, file, jnl_buf, jnl_cnt * sizeof (brain_server_attack_long_t));
 
-    brain_server_write_attack_dump (brain_server_db_attack, file);
+    const double ms = hc_timer_get (timer_journal);
 
-    hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
+    brain_logging (stdout, 0, "J | %8.2f ms | Attack: 0x%08x, Ranges: %" PRIi64 "\n", ms, brain_server_db_attack->brain_attack, jnl_cnt);
   }
 
-  return true;
+  hc_thread_mutex_unlock (brain_server_db_attack->mux_af);
+
+  hcfree (jnl_buf);
+
+  return rc;
 }
 
-bool brain_server_read_attack_dump (brain_server_db_attack_t *brain_server_db_attack, const char *file)
+bool brain_server_sync (const int fd)
 {
-  hc_timer_t timer_dump;
+  #if defined (_WIN)
+  return (_commit (fd) == 0);
+  #else
+  return (fsync (fd) == 0);
+  #endif
+}
 
-  hc_timer_set (&timer_dump);
+bool brain_server_journal_append (int *fd, const char *file, const void *buf, const size_t len)
+{
+  // everything committed since the last call costs a single fsync
 
-  // read from file
+  if (*fd == -1)
+  {
+    int flags = O_WRONLY | O_CREAT | O_APPEND;
 
-  struct stat sb;
+    #if defined (_WIN)
+    flags |= O_BINARY;
+    #endif
 
-  memset (&sb, 0, sizeof (struct stat));
+    *fd = open (file, flags, 0600);
 
-  if (stat (file, &sb) == -1)
-  {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+    if (*fd == -1)
+    {
+      brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
 
-    return false;
+      return false;
+    }
   }
 
-  HCFILE fp;
+  const off_t size = lseek (*fd, 0, SEEK_END);
 
-  if (hc_fopen (&fp, file, "rb") == false)
+  const u8 *ptr = (const u8 *) buf;
+
+  size_t left = len;
+
+  while (left)
   {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+    const ssize_t nwrite = write (*fd, ptr, left);
 
-    return false;
-  }
+    if (nwrite <= 0)
+    {
+      brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
 
-  i64 temp_cnt = (u64) sb.st_size / sizeof (brain_server_attack_long_t);
+      // a torn record would shift all records which follow it
 
-  if (brain_server_db_attack_realloc (brain_server_db_attack, temp_cnt, 0) == false)
-  {
-    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+      if (ftruncate (*fd, size) == -1) brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
 
-    hc_fclose (&fp);
+      return false;
+    }
 
-    return false;
+    ptr  += nwrite;
+    left -= nwrite;
   }
 
-  const size_t nread = hc_fread (brain_server_db_attack->long_buf, sizeof (brain_server_attack_long_t), temp_cnt, &fp);
-
-  if (nread != (size_t) temp_cnt)
+  if (brain_server_sync (*fd) == false)
   {
-    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes read\n", file, (u64) nread * sizeof (brain_server_attack_long_t));
-
-    hc_fclose (&fp);
+    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
 
     return false;
   }
 
-  brain_server_db_attack->long_cnt      = temp_cnt;
-  brain_server_db_attack->write_attacks = false;
-
-  hc_fclose (&fp);
-
-  const double ms = hc_timer_get (timer_dump);
-
-  brain_logging (stdout, 0, "Read %" PRIu64 " bytes from attack 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_attack->brain_attack, ms);
-
   return true;
 }
 
-bool brain_server_write_attack_dump (brain_server_db_attack_t *brain_server_db_attack, const char *file)
+bool brain_server_journal_rotate (int *fd, const char *file, const char *file_old, const size_t record_size)
 {
-  if (brain_server_db_attack->write_attacks == false) return true;
+  if (*fd != -1)
+  {
+    close (*fd);
 
-  hc_timer_t timer_dump;
+    *fd = -1;
+  }
 
-  hc_timer_set (&timer_dump);
+  struct stat sb;
 
-  // write to file
+  memset (&sb, 0, sizeof (struct stat));
 
-  HCFILE fp;
+  if (stat (file, &sb) == -1) return true; // nothing was committed since the last snapshot
 
-  if (hc_fopen (&fp, file, "wb") == false)
+  if (stat (file_old, &sb) == -1)
   {
-    brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
+    if (rename (file, file_old) == -1)
+    {
+      brain_logging (stderr, 0, "%s: %s\n", file_old, strerror (errno));
 
-    return false;
+      return false;
+    }
+
+    return true;
   }
 
-  // storing should not include reserved attacks only finished
+  // the last snapshot did not finish and still needs its rotated journal, this one is appended to it
+  // a torn record at the end of the rotated journal is cut off first, both are read record by record on recovery
 
-  const size_t nwrite = hc_fwrite (brain_server_db_attack->long_buf, sizeof (brain_server_attack_long_t), brain_server_db_attack->long_cnt, &fp);
+  int fd_old = open (file_old, O_WRONLY);
 
-  if (nwrite != (size_t) brain_server_db_attack->long_cnt)
+  if ((fd_old == -1) || (ftruncate (fd_old, sb.st_size - (sb.st_size % record_size)) == -1))
   {
-    brain_logging (stderr, 0, "%s: only %" PRIu64 " bytes written\n", file, (u64) nwrite * sizeof (brain_server_attack_long_t));
+    brain_logging (stderr, 0, "%s: %s\n", file_old, strerror (errno));
 
-    hc_fclose (&fp);
+    if (fd_old != -1) close (fd_old);
 
     return false;
   }
 
-  hc_fclose (&fp);
-
-  brain_server_db_attack->write_attacks = false;
-
-  // stats
-
-  const double ms = hc_timer_get (timer_dump);
+  close (fd_old);
 
-  struct stat sb;
+  fd_old = -1;
 
-  memset (&sb, 0, sizeof (struct stat));
+  HCFILE fp;
 
-  if (stat (file, &sb) == -1)
+  if (hc_fopen (&fp, file, "rb") == false)
   {
     brain_logging (stderr, 0, "%s: %s\n", file, strerror (errno));
 
     return false;
   }
 
-  brain_logging (stdout, 0, "Wrote %" PRIu64 " bytes from attack 0x%08x in %.2f ms\n", (u64) sb.st_size, brain_server_db_attack->brain_attack, ms);
+  u8 *buf = (u8 *) hcmalloc (BRAIN_SERVER_HASH_DUMP_CHUNK * record_size);
+
+  bool rc = true;
+
+  size_t nread = 0;
+
+  while ((rc == true) && ((nread = hc_fread (buf, record_size, BRAIN_SERVER_HASH_DUMP_CHUNK, &fp)) > 0))
+  {
+    rc = brain_server_journal_append (&fd_old, file_old, buf, nread * record_size);
+  }
+
+  hcfree (buf);
+
+  hc_fclose (&fp);
+
+  if (fd_old != -1) close (fd_old);
+
+  if (rc == false) return false;
+
+  unlink (file);
 
   return true;
 }
@@ -1997,14 +3356,27 @@ void *brain_server_handle_dumps (void *p)
 
   u32 brain_server_timer = brain_server_dumper_options->brain_server_timer;
 
-  if (brain_server_timer == 0) return NULL;
-
   u32 i = 0;
 
   while (keep_running == true)
   {
-    if (i == brain_server_timer)
+    // merge the runs the commits have added since the last round, the lookups never wait for this
+
+    for (int idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
+    {
+      brain_server_db_hash_t *brain_server_db_hash = &brain_server_dbs->hash_buf[idx];
+
+      while (brain_server_db_hash_compact (brain_server_db_hash, false) == true) {}
+    }
+
+    if (brain_server_timer == 0)
+    {
+      // no snapshots, the journals grow until the server stops
+    }
+    else if (i == brain_server_timer)
     {
+      // the snapshots rotate the journals, clients are not blocked while they are written
+
       brain_server_write_hash_dumps   (brain_server_dbs, ".");
       brain_server_write_attack_dumps (brain_server_dbs, ".");
 
@@ -2021,6 +3393,32 @@ void *brain_server_handle_dumps (void *p)
   return NULL;
 }
 
+void *brain_server_handle_journals (void *p)
+{
+  brain_server_dumper_options_t *brain_server_dumper_options = (brain_server_dumper_options_t *) p;
+
+  brain_server_dbs_t *brain_server_dbs = brain_server_dumper_options->brain_server_dbs;
+
+  // group commit, one write and one fsync per session and attack for all the commits of the last interval
+
+  while (keep_running == true)
+  {
+    for (int idx = 0; idx < brain_server_dbs->hash_cnt; idx++)
+    {
+      brain_server_write_hash_journal (&brain_server_dbs->hash_buf[idx], ".");
+    }
+
+    for (int idx = 0; idx < brain_server_dbs->attack_cnt; idx++)
+    {
+      brain_server_write_attack_journal (&brain_server_dbs->attack_buf[idx], ".");
+    }
+
+    sleep (BRAIN_SERVER_JOURNAL_TIMER);
+  }
+
+  return NULL;
+}
+
 void *brain_server_handle_client (void *p)
 {
   brain_server_client_options_t *brain_server_client_options = (brain_server_client_options_t *) p;
@@ -2065,7 +3463,9 @@ void *brain_server_handle_client (void *p)
     return NULL;
   }
 
-  u32 brain_link_version_ok = (brain_link_version >= (u32) BRAIN_LINK_VERSION_MIN) ? 1 : 0;
+  // answer with the version both sides speak, clients before version 2 only check for non-zero
+
+  u32 brain_link_version_ok = (brain_link_version >= (u32) BRAIN_LINK_VERSION_MIN) ? MIN (brain_link_version, (u32) BRAIN_LINK_VERSION_CUR) : 0;
 
   if (brain_send (client_fd, &brain_link_version_ok, sizeof (brain_link_version_ok), 0, NULL, NULL) == false)
   {
@@ -2325,7 +3725,7 @@ void *brain_server_handle_client (void *p)
 
   const size_t send_size = passwords_max * sizeof (char);
 
-  u8 *send_buf = (u8  *) hcmalloc (send_size); // we can reduce this to 1/8 if we use bits instead of bytes
+  u8 *send_buf = (u8  *) hcmalloc (send_size); // version 2 packs it to bits in place before sending
 
   if (send_buf == NULL)
   {
@@ -2338,6 +3738,23 @@ void *brain_server_handle_client (void *p)
     return NULL;
   }
 
+  // packed lookups, they are decoded into recv_buf
+
+  const size_t pack_size = (brain_link_version_ok >= 2) ? recv_size + 8 : 1;
+
+  u8 *pack_buf = (u8 *) hcmalloc (pack_size);
+
+  if (pack_buf == NULL)
+  {
+    brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
+
+    brain_server_dbs->client_slots[client_idx] = 0;
+
+    close (client_fd);
+
+    return NULL;
+  }
+
   // temp
 
   brain_server_hash_unique_t *temp_buf = (brain_server_hash_unique_t *) hccalloc (passwords_max, sizeof (brain_server_hash_unique_t));
@@ -2441,8 +3858,11 @@ void *brain_server_handle_client (void *p)
      * and it is safe the client does not send more hashes that max_passwords.
      * The trick here is, since all data at this point is sorted, to merge them in a reverse order.
      * Using the reverse order allows us to reuse the existing memory, we do not need to
-     * have two buffer allocated. This is more important to the long-term memory which is
-     * using the same technique but has an always growing size.
+     * have two buffer allocated.
+     * The long-term memory does not use this technique, as it has an always growing size.
+     * On commit the short-term memory simply becomes a new sorted run of the long-term memory.
+     * The dumper thread merges these runs in the background and each run has a bloom filter,
+     * so a lookup only needs a binary search in the runs which might contain the hash.
      * Basically what we do is that we will use the hashes of the current one of the new hash array
      * and the current one of the short-term memory as a representation of a pure number.
      * We take the larger on (a comparison can always be only smaller or larger, not equal)
@@ -2467,22 +3887,13 @@ void *brain_server_handle_client (void *p)
 
       hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-      u64 overlap = 0;
-
-      overlap += brain_server_find_attack_short (brain_server_db_attack->short_buf, brain_server_db_attack->short_cnt, offset, length);
-      overlap += brain_server_find_attack_long  (brain_server_db_attack->long_buf,  brain_server_db_attack->long_cnt,  offset + overlap, length - overlap);
+      u64 overlap = brain_server_cover_attack (brain_server_db_attack, offset, offset + length) - offset;
 
       if (overlap < length)
       {
-        if (brain_server_db_attack_realloc (brain_server_db_attack, 0, 1) == true)
+        if (brain_server_db_attack_add_short (brain_server_db_attack, offset + overlap, length - overlap, client_idx) == false)
         {
-          brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].offset     = offset + overlap;
-          brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].length     = length - overlap;
-          brain_server_db_attack->short_buf[brain_server_db_attack->short_cnt].client_idx = client_idx;
-
-          brain_server_db_attack->short_cnt++;
-
-          qsort (brain_server_db_attack->short_buf, brain_server_db_attack->short_cnt, sizeof (brain_server_attack_short_t), brain_server_sort_attack_short);
+          brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
         }
       }
 
@@ -2504,33 +3915,7 @@ void *brain_server_handle_client (void *p)
 
       hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-      i64 new_attacks = 0;
-
-      for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
-      {
-        if (brain_server_db_attack->short_buf[idx].client_idx == client_idx)
-        {
-          if (brain_server_db_attack_realloc (brain_server_db_attack, 1, 0) == true)
-          {
-            brain_server_db_attack->long_buf[brain_server_db_attack->long_cnt].offset = brain_server_db_attack->short_buf[idx].offset;
-            brain_server_db_attack->long_buf[brain_server_db_attack->long_cnt].length = brain_server_db_attack->short_buf[idx].length;
-
-            brain_server_db_attack->long_cnt++;
-
-            qsort (brain_server_db_attack->long_buf, brain_server_db_attack->long_cnt, sizeof (brain_server_attack_long_t), brain_server_sort_attack_long);
-          }
-          else
-          {
-            brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
-          }
-
-          brain_server_db_attack->short_buf[idx].offset     = 0;
-          brain_server_db_attack->short_buf[idx].length     = 0;
-          brain_server_db_attack->short_buf[idx].client_idx = 0;
-
-          new_attacks++;
-        }
-      }
+      const i64 new_attacks = brain_server_db_attack_release (brain_server_db_attack, client_idx, true);
 
       brain_server_db_attack->write_attacks = true;
 
@@ -2547,111 +3932,37 @@ void *brain_server_handle_client (void *p)
 
       hc_timer_set (&timer_commit);
 
-      hc_thread_mutex_lock (brain_server_db_hash->mux_hg);
-
-      // long-term memory merge
+      // long-term memory, the short-term memory becomes a new run, it's already sorted and unique
 
       if (brain_server_db_short->short_cnt)
       {
-        if (brain_server_db_hash_realloc (brain_server_db_hash, brain_server_db_short->short_cnt) == true)
+        brain_server_hash_long_t *long_buf = (brain_server_hash_long_t *) hcmalloc (brain_server_db_short->short_cnt * sizeof (brain_server_hash_long_t));
+
+        if (long_buf != NULL)
         {
-          if (brain_server_db_hash->long_cnt == 0)
+          for (i64 idx = 0; idx < brain_server_db_short->short_cnt; idx++)
           {
-            for (i64 idx = 0; idx < brain_server_db_short->short_cnt; idx++)
-            {
-              brain_server_db_hash->long_buf[idx].hash[0] = brain_server_db_short->short_buf[idx].hash[0];
-              brain_server_db_hash->long_buf[idx].hash[1] = brain_server_db_short->short_buf[idx].hash[1];
-            }
-
-            brain_server_db_hash->long_cnt = brain_server_db_short->short_cnt;
+            long_buf[idx].hash[0] = brain_server_db_short->short_buf[idx].hash[0];
+            long_buf[idx].hash[1] = brain_server_db_short->short_buf[idx].hash[1];
           }
-          else
-          {
-            const i64 cnt_total = brain_server_db_hash->long_cnt + brain_server_db_short->short_cnt;
-
-            i64 long_left  = brain_server_db_hash->long_cnt - 1;
-            i64 short_left = brain_server_db_short->short_cnt - 1;
-            i64 long_dupes = 0;
-
-            for (i64 idx = cnt_total - 1; idx >= long_dupes; idx--)
-            {
-              const brain_server_hash_long_t  *long_entry  = &brain_server_db_hash->long_buf[long_left];
-              const brain_server_hash_short_t *short_entry = &brain_server_db_short->short_buf[short_left];
-
-              int rc = 0;
-
-              if ((long_left >= 0) && (short_left >= 0))
-              {
-                rc = brain_server_sort_hash (long_entry->hash, short_entry->hash);
-              }
-              else if (long_left >= 0)
-              {
-                rc = 1;
-              }
-              else if (short_left >= 0)
-              {
-                rc = -1;
-              }
-              else
-              {
-                brain_logging (stderr, client_idx, "unexpected remaining buffers in compare: %" PRIi64 " - %" PRIi64 "\n", long_left, short_left);
-              }
-
-              brain_server_hash_long_t *next = &brain_server_db_hash->long_buf[idx];
-
-              if (rc == -1)
-              {
-                next->hash[0] = short_entry->hash[0];
-                next->hash[1] = short_entry->hash[1];
-
-                short_left--;
-              }
-              else if (rc == 1)
-              {
-                next->hash[0] = long_entry->hash[0];
-                next->hash[1] = long_entry->hash[1];
-
-                long_left--;
-              }
-              else
-              {
-                next->hash[0] = long_entry->hash[0];
-                next->hash[1] = long_entry->hash[1];
-
-                short_left--;
-                long_left--;
-
-                long_dupes++;
-              }
-            }
 
-            if ((long_left != -1) || (short_left != -1))
-            {
-              brain_logging (stderr, client_idx, "unexpected remaining buffers in commit: %" PRIi64 " - %" PRIi64 "\n", long_left, short_left);
-            }
-
-            brain_server_db_hash->long_cnt = cnt_total - long_dupes;
+          if (brain_server_db_hash_add_run (brain_server_db_hash, long_buf, brain_server_db_short->short_cnt) == false)
+          {
+            brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
 
-            if (long_dupes)
-            {
-              for (i64 idx = 0; idx < brain_server_db_hash->long_cnt; idx++)
-              {
-                brain_server_db_hash->long_buf[idx].hash[0] = brain_server_db_hash->long_buf[long_dupes + idx].hash[0];
-                brain_server_db_hash->long_buf[idx].hash[1] = brain_server_db_hash->long_buf[long_dupes + idx].hash[1];
-              }
-            }
+            hcfree (long_buf);
+          }
+          else if (brain_server_db_hash_journal (brain_server_db_hash, brain_server_db_short->short_buf, brain_server_db_short->short_cnt) == false)
+          {
+            brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
           }
         }
         else
         {
           brain_logging (stderr, 0, "%s\n", MSG_ENOMEM);
         }
-
-        brain_server_db_hash->write_hashes = true;
       }
 
-      hc_thread_mutex_unlock (brain_server_db_hash->mux_hg);
-
       if (brain_server_db_short->short_cnt)
       {
         const double ms_hashes = hc_timer_get (timer_commit);
@@ -2663,22 +3974,57 @@ void *brain_server_handle_client (void *p)
     }
     else if (operation == BRAIN_OPERATION_HASH_LOOKUP)
     {
-      int in_size = 0;
+      int hashes_cnt = 0;
 
-      if (brain_recv (client_fd, &in_size, sizeof (in_size), 0, NULL, NULL) == false) break;
+      int in_size = 0;
 
-      if (in_size == 0)
+      if (brain_link_version_ok >= 2)
       {
-        brain_logging (stderr, client_idx, "Zero in_size value\n");
+        int pack_k = 0;
 
-        break;
+        if (brain_recv (client_fd, &hashes_cnt, sizeof (hashes_cnt), 0, NULL, NULL) == false) break;
+        if (brain_recv (client_fd, &pack_k,     sizeof (pack_k),     0, NULL, NULL) == false) break;
+        if (brain_recv (client_fd, &in_size,    sizeof (in_size),    0, NULL, NULL) == false) break;
+
+        if (in_size == 0)
+        {
+          brain_logging (stderr, client_idx, "Zero in_size value\n");
+
+          break;
+        }
+
+        if ((in_size < 0) || (in_size > (int) pack_size)) break;
+
+        if ((hashes_cnt < 0) || (hashes_cnt > passwords_max)) break;
+
+        if ((pack_k < 0) || (pack_k > 63)) break;
+
+        if (brain_recv (client_fd, pack_buf, (size_t) in_size, 0, NULL, NULL) == false) break;
+
+        if (brain_unpack_hashes (recv_buf, pack_buf, (size_t) in_size, hashes_cnt, pack_k) == false)
+        {
+          brain_logging (stderr, client_idx, "Invalid packed hashes\n");
+
+          break;
+        }
       }
+      else
+      {
+        if (brain_recv (client_fd, &in_size, sizeof (in_size), 0, NULL, NULL) == false) break;
+
+        if (in_size == 0)
+        {
+          brain_logging (stderr, client_idx, "Zero in_size value\n");
+
+          break;
+        }
 
-      if (in_size > (int) recv_size) break;
+        if (in_size > (int) recv_size) break;
 
-      if (brain_recv (client_fd, recv_buf, (size_t) in_size, 0, NULL, NULL) == false) break;
+        if (brain_recv (client_fd, recv_buf, (size_t) in_size, 0, NULL, NULL) == false) break;
 
-      const int hashes_cnt = in_size / BRAIN_HASH_SIZE;
+        hashes_cnt = in_size / BRAIN_HASH_SIZE;
+      }
 
       if (hashes_cnt == 0)
       {
@@ -2712,36 +4058,43 @@ void *brain_server_handle_client (void *p)
         send_buf[hash_idx] = 0;
       }
 
-      // unique temp memory
+      // unique temp memory, version 2 clients send them sorted and unique already, the decoder made sure of that
 
       i64 temp_cnt = 0;
 
-      qsort (temp_buf, hashes_cnt, sizeof (brain_server_hash_unique_t), brain_server_sort_hash_unique);
-
-      brain_server_hash_unique_t *prev = temp_buf + temp_cnt;
-
-      for (i64 temp_idx = 1; temp_idx < hashes_cnt; temp_idx++)
+      if (brain_link_version_ok >= 2)
       {
-        brain_server_hash_unique_t *cur = temp_buf + temp_idx;
+        temp_cnt = hashes_cnt;
+      }
+      else
+      {
+        qsort (temp_buf, hashes_cnt, sizeof (brain_server_hash_unique_t), brain_server_sort_hash_unique);
 
-        if ((cur->hash[0] == prev->hash[0]) && (cur->hash[1] == prev->hash[1]))
-        {
-          send_buf[cur->hash_idx] = 1;
-        }
-        else
+        brain_server_hash_unique_t *prev = temp_buf + temp_cnt;
+
+        for (i64 temp_idx = 1; temp_idx < hashes_cnt; temp_idx++)
         {
-          temp_cnt++;
+          brain_server_hash_unique_t *cur = temp_buf + temp_idx;
+
+          if ((cur->hash[0] == prev->hash[0]) && (cur->hash[1] == prev->hash[1]))
+          {
+            send_buf[cur->hash_idx] = 1;
+          }
+          else
+          {
+            temp_cnt++;
 
-          prev = temp_buf + temp_cnt;
+            prev = temp_buf + temp_cnt;
 
-          prev->hash[0] = cur->hash[0];
-          prev->hash[1] = cur->hash[1];
+            prev->hash[0] = cur->hash[0];
+            prev->hash[1] = cur->hash[1];
 
-          prev->hash_idx = cur->hash_idx; // we need this in a later stage
+            prev->hash_idx = cur->hash_idx; // we need this in a later stage
+          }
         }
-      }
 
-      temp_cnt++;
+        temp_cnt++;
+      }
 
       // check if they are in long term memory
 
@@ -2764,9 +4117,7 @@ void *brain_server_handle_client (void *p)
         {
           brain_server_hash_unique_t *cur = &temp_buf[temp_idx];
 
-          const i64 r = brain_server_find_hash_long (cur->hash, brain_server_db_hash->long_buf, brain_server_db_hash->long_cnt);
-
-          if (r != -1)
+          if (brain_server_db_hash_find (brain_server_db_hash, cur->hash) == true)
           {
             send_buf[cur->hash_idx] = 1;
           }
@@ -2927,6 +4278,27 @@ void *brain_server_handle_client (void *p)
 
       int out_size = hashes_cnt;
 
+      if (brain_link_version_ok >= 2)
+      {
+        // one bit per hash, byte idx / 8 is written only after all bytes up to idx have been read
+
+        u8 bits = 0;
+
+        for (int hashes_idx = 0; hashes_idx < hashes_cnt; hashes_idx++)
+        {
+          bits |= send_buf[hashes_idx] << (hashes_idx & 7);
+
+          if (((hashes_idx & 7) == 7) || (hashes_idx == (hashes_cnt - 1)))
+          {
+            send_buf[hashes_idx / 8] = bits;
+
+            bits = 0;
+          }
+        }
+
+        out_size = (hashes_cnt + 7) / 8;
+      }
+
       if (brain_send (client_fd, &out_size, sizeof (out_size), SEND_FLAGS, NULL, NULL) == false) break;
       if (brain_send (client_fd, send_buf,           out_size, SEND_FLAGS, NULL, NULL) == false) break;
     }
@@ -2940,15 +4312,7 @@ void *brain_server_handle_client (void *p)
 
   hc_thread_mutex_lock (brain_server_db_attack->mux_ag);
 
-  for (i64 idx = 0; idx < brain_server_db_attack->short_cnt; idx++)
-  {
-    if (brain_server_db_attack->short_buf[idx].client_idx == client_idx)
-    {
-      brain_server_db_attack->short_buf[idx].offset     = 0;
-      brain_server_db_attack->short_buf[idx].length     = 0;
-      brain_server_db_attack->short_buf[idx].client_idx = 0;
-    }
-  }
+  brain_server_db_attack_release (brain_server_db_attack, client_idx, false);
 
   hc_thread_mutex_unlock (brain_server_db_attack->mux_ag);
 
@@ -2959,6 +4323,7 @@ void *brain_server_handle_client (void *p)
 
   // free local memory
 
+  hcfree (pack_buf);
   hcfree (send_buf);
   hcfree (temp_buf);
   hcfree (recv_buf);
@@ -3249,6 +4614,10 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
 
   hc_thread_create (dump_thr, brain_server_handle_dumps, &brain_server_dumper_options);
 
+  hc_thread_t jnl_thr;
+
+  hc_thread_create (jnl_thr, brain_server_handle_journals, &brain_server_dumper_options);
+
   while (keep_running == true)
   {
     // wait for a client to connect, but not too long
@@ -3308,6 +4677,7 @@ int brain_server (const char *listen_host, const int listen_port, const char *br
   brain_logging (stdout, 0, "Brain server stopping\n");
 
   hc_thread_wait (1, &dump_thr);
+  hc_thread_wait (1, &jnl_thr);
 
   if (brain_server_write_hash_dumps (brain_server_dbs, ".") == false)
   {
@@ -5,8 +5,13 @@
 
 #include "common.h"
 #include "types.h"
+#include "memory.h"
 #include "event.h"
 #include "shared.h"
+#include "convert.h"
+#include "filehandling.h"
+#include "rp.h"
+#include "rp_cpu.h"
 #include "wordlist.h"
 #include "combinator.h"
 
@@ -87,8 +92,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
       if (rc1 == -1)
       {
-        event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile1);
-
         hc_fclose (&fp1);
         hc_fclose (&fp2);
 
@@ -116,8 +119,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
       if (rc2 == -1)
       {
-        event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile2);
-
         return -1;
       }
 
@@ -190,8 +191,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
         if (rc1 == -1)
         {
-          event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile1);
-
           hc_fclose (&fp1);
           hc_fclose (&fp2);
 
@@ -219,8 +218,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
         if (rc2 == -1)
         {
-          event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile2);
-
           return -1;
         }
 
@@ -321,8 +318,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
         if (rc1 == -1)
         {
-          event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile1);
-
           hc_fclose (&fp1);
           hc_fclose (&fp2);
 
@@ -350,8 +345,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
         if (rc2 == -1)
         {
-          event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile2);
-
           return -1;
         }
 
@@ -406,8 +399,6 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
         if (rc == -1)
         {
-          event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile);
-
           return -1;
         }
 
@@ -426,5 +417,257 @@ void combinator_ctx_destroy (hashcat_ctx_t *hashcat_ctx)
 
   if (combinator_ctx->enabled == false) return;
 
+  combs_cache_destroy (hashcat_ctx);
+
   memset (combinator_ctx, 0, sizeof (combinator_ctx_t));
 }
+
+static bool combs_cache_add (combs_cache_t *combs_cache, const u8 *buf, const u32 len, const u32 rejects)
+{
+  // offs, lens and rejects take 16 bytes per entry, the arena takes the candidates themselves
+
+  if (combs_cache->cnt == combs_cache->avail)
+  {
+    const u64 add = MAX (combs_cache->avail, 0x10000);
+
+    if ((combs_cache->buf_avail + ((combs_cache->avail + add) * 16)) > COMBS_CACHE_SIZE_MAX) return false;
+
+    combs_cache->offs = (u64 *) hcrealloc (combs_cache->offs, combs_cache->avail * sizeof (u64), add * sizeof (u64));
+    combs_cache->lens = (u32 *) hcrealloc (combs_cache->lens, combs_cache->avail * sizeof (u32), add * sizeof (u32));
+
+    if (combs_cache->rejects != NULL)
+    {
+      combs_cache->rejects = (u32 *) hcrealloc (combs_cache->rejects, combs_cache->avail * sizeof (u32), add * sizeof (u32));
+    }
+
+    combs_cache->avail += add;
+  }
+
+  if ((combs_cache->buf == NULL) || ((combs_cache->buf_len + len) > combs_cache->buf_avail))
+  {
+    // grow geometrically, but use up what is left of the budget before giving up
+
+    const u64 used = combs_cache->buf_avail + (combs_cache->avail * 16);
+
+    u64 add = MAX (combs_cache->buf_avail, 0x100000);
+
+    if ((used + add) > COMBS_CACHE_SIZE_MAX) add = (used < COMBS_CACHE_SIZE_MAX) ? COMBS_CACHE_SIZE_MAX - used : 0;
+
+    if ((combs_cache->buf_len + len) > (combs_cache->buf_avail + add)) return false;
+
+    combs_cache->buf = (u8 *) hcrealloc (combs_cache->buf, combs_cache->buf_avail, add);
+
+    combs_cache->buf_avail += add;
+  }
+
+  if ((rejects > 0) && (combs_cache->rejects == NULL))
+  {
+    combs_cache->rejects = (u32 *) hccalloc (combs_cache->avail, sizeof (u32));
+  }
+
+  memcpy (combs_cache->buf + combs_cache->buf_len, buf, len);
+
+  combs_cache->offs[combs_cache->cnt] = combs_cache->buf_len;
+  combs_cache->lens[combs_cache->cnt] = len;
+
+  if (combs_cache->rejects != NULL) combs_cache->rejects[combs_cache->cnt] = rejects;
+
+  combs_cache->buf_len += len;
+
+  combs_cache->cnt++;
+
+  return true;
+}
+
+void combs_cache_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+
+  combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  hcfree (combs_cache->filename);
+  hcfree (combs_cache->buf);
+  hcfree (combs_cache->offs);
+  hcfree (combs_cache->lens);
+  hcfree (combs_cache->rejects);
+  hcfree (combs_cache->oversized_filename);
+
+  memset (combs_cache, 0, sizeof (combs_cache_t));
+}
+
+int combs_cache_update (hashcat_ctx_t *hashcat_ctx)
+{
+  combinator_ctx_t     *combinator_ctx     = hashcat_ctx->combinator_ctx;
+  hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  straight_ctx_t       *straight_ctx       = hashcat_ctx->straight_ctx;
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+
+  combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  if (combinator_ctx->enabled == false) return 0;
+
+  if (user_options->slow_candidates == true) return 0;
+
+  // same selection of the combs file as in calc ()
+
+  const char *dictfile = NULL;
+
+  if (user_options->attack_mode == ATTACK_MODE_COMBI)
+  {
+    dictfile = (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT) ? combinator_ctx->dict2 : combinator_ctx->dict1;
+  }
+  else if (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2))
+  {
+    dictfile = straight_ctx->dict;
+  }
+
+  if (dictfile == NULL) return 0;
+
+  if ((combs_cache->filename != NULL) && (strcmp (combs_cache->filename, dictfile) == 0)) return 0;
+
+  struct stat s;
+
+  if (stat (dictfile, &s) == -1)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", dictfile, strerror (errno));
+
+    return -1;
+  }
+
+  if ((combs_cache->oversized_filename != NULL) && (strcmp (combs_cache->oversized_filename, dictfile) == 0) && (combs_cache->oversized_size == (u64) s.st_size)) return 0;
+
+  combs_cache_destroy (hashcat_ctx);
+
+  combs_cache->filename = hcstrdup (dictfile);
+
+  // do the on-the-fly encoding exactly like run_cracker () would
+
+  bool iconv_enabled = false;
+
+  iconv_t iconv_ctx = NULL;
+
+  char *iconv_tmp = NULL;
+
+  if (strcmp (user_options->encoding_from, user_options->encoding_to) != 0)
+  {
+    iconv_enabled = true;
+
+    iconv_ctx = iconv_open (user_options->encoding_to, user_options->encoding_from);
+
+    if (iconv_ctx == (iconv_t) -1) return -1;
+
+    iconv_tmp = (char *) hcmalloc (HCBUFSIZ_TINY);
+  }
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, dictfile, "rb") == false)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", dictfile, strerror (errno));
+
+    if (iconv_enabled == true)
+    {
+      iconv_close (iconv_ctx);
+
+      hcfree (iconv_tmp);
+    }
+
+    return -1;
+  }
+
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+
+  u32 rejects = 0;
+
+  bool fits = true;
+
+  while (!hc_feof (&fp))
+  {
+    size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_LARGE);
+
+    line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
+
+    if (line_len > PW_MAX) continue;
+
+    char *line_buf_new = line_buf;
+
+    char rule_buf_out[RP_PASSWORD_SIZE];
+
+    if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
+    {
+      if (line_len >= RP_PASSWORD_SIZE) continue;
+
+      memset (rule_buf_out, 0, sizeof (rule_buf_out));
+
+      const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
+
+      if (rule_len_out < 0)
+      {
+        rejects++;
+
+        continue;
+      }
+
+      line_len = rule_len_out;
+
+      line_buf_new = rule_buf_out;
+    }
+
+    if (iconv_enabled == true)
+    {
+      char  *iconv_ptr = iconv_tmp;
+      size_t iconv_sz  = HCBUFSIZ_TINY;
+
+      if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
+
+      line_buf_new = iconv_tmp;
+      line_len     = HCBUFSIZ_TINY - iconv_sz;
+    }
+
+    line_len = MIN (line_len, PW_MAX);
+
+    if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
+    {
+      uppercase ((u8 *) line_buf_new, line_len);
+    }
+
+    if (combs_cache_add (combs_cache, (const u8 *) line_buf_new, (u32) line_len, rejects) == false)
+    {
+      fits = false;
+
+      break;
+    }
+
+    rejects = 0;
+  }
+
+  combs_cache->rejects_tail = rejects;
+
+  hcfree (line_buf);
+
+  hc_fclose (&fp);
+
+  if (iconv_enabled == true)
+  {
+    iconv_close (iconv_ctx);
+
+    hcfree (iconv_tmp);
+  }
+
+  // too large for the memory budget, run_cracker () falls back to reading the file for each salt
+
+  if (fits == false)
+  {
+    combs_cache_destroy (hashcat_ctx);
+
+    combs_cache->oversized_filename = hcstrdup (dictfile);
+    combs_cache->oversized_size     = (u64) s.st_size;
+
+    return 0;
+  }
+
+  combs_cache->enabled = true;
+
+  return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "event.h"
+#include "thread.h"
+#include "locking.h"
+#include "filehandling.h"
+#include "cracksink.h"
+
+static void cracksink_write_target (hashcat_ctx_t *hashcat_ctx, const cracksink_target_t target, const u8 *buf, const size_t len)
+{
+  loopback_ctx_t *loopback_ctx = hashcat_ctx->loopback_ctx;
+  outfile_ctx_t  *outfile_ctx  = hashcat_ctx->outfile_ctx;
+  potfile_ctx_t  *potfile_ctx  = hashcat_ctx->potfile_ctx;
+
+  if (target == CRACKSINK_OUTFILE)
+  {
+    // the fp gets opened for each batch so that the user can modify (move) the outfile while hashcat runs
+    // if an error occurs opening the file, send to stdout as fallback
+    // outfile_ctx->fp is not used here, check_hash () relies on it being closed while formatting
+
+    HCFILE fp;
+
+    if (hc_fopen (&fp, outfile_ctx->filename, "ab") == false)
+    {
+      event_log_error (hashcat_ctx, "%s: %s", outfile_ctx->filename, strerror (errno));
+
+      fwrite (buf, len, 1, stdout);
+
+      return;
+    }
+
+    if (hc_lockfile (&fp) == -1)
+    {
+      hc_fclose (&fp);
+
+      event_log_error (hashcat_ctx, "%s: %s", outfile_ctx->filename, strerror (errno));
+
+      fwrite (buf, len, 1, stdout);
+
+      return;
+    }
+
+    hc_fwrite ((void *) buf, len, 1, &fp);
+
+    hc_unlockfile (&fp);
+
+    hc_fclose (&fp);
+  }
+  else if (target == CRACKSINK_POTFILE)
+  {
+    if (potfile_ctx->fp.pfp == NULL) return;
+
+    hc_lockfile (&potfile_ctx->fp);
+
+    hc_fwrite ((void *) buf, len, 1, &potfile_ctx->fp);
+
+    hc_fflush (&potfile_ctx->fp);
+
+    if (hc_unlockfile (&potfile_ctx->fp))
+    {
+      event_log_error (hashcat_ctx, "%s: Failed to unlock file.", potfile_ctx->filename);
+    }
+  }
+  else if (target == CRACKSINK_LOOPBACK)
+  {
+    if (loopback_ctx->fp.pfp == NULL) return;
+
+    hc_lockfile (&loopback_ctx->fp);
+
+    hc_fwrite ((void *) buf, len, 1, &loopback_ctx->fp);
+
+    hc_fflush (&loopback_ctx->fp);
+
+    hc_unlockfile (&loopback_ctx->fp);
+  }
+}
+
+static void cracksink_write_batch (hashcat_ctx_t *hashcat_ctx)
+{
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  // caller holds mux_write, so the writing buffers are ours until we return
+
+  hc_thread_mutex_lock (cracksink_ctx->mux_pending);
+
+  for (int target = 0; target < CRACKSINK_TARGETS; target++)
+  {
+    cracksink_buf_t tmp = cracksink_ctx->writing[target];
+
+    cracksink_ctx->writing[target] = cracksink_ctx->pending[target];
+    cracksink_ctx->pending[target] = tmp;
+  }
+
+  cracksink_ctx->signaled = false;
+
+  hc_thread_mutex_unlock (cracksink_ctx->mux_pending);
+
+  for (int target = 0; target < CRACKSINK_TARGETS; target++)
+  {
+    cracksink_buf_t *writing = &cracksink_ctx->writing[target];
+
+    if (writing->len == 0) continue;
+
+    cracksink_write_target (hashcat_ctx, (cracksink_target_t) target, writing->buf, writing->len);
+
+    writing->len = 0;
+  }
+}
+
+HC_API_CALL void *thread_cracksink (void *p)
+{
+  hashcat_ctx_t *hashcat_ctx = (hashcat_ctx_t *) p;
+
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  while (true)
+  {
+    hc_thread_sem_wait (cracksink_ctx->sem_work);
+
+    hc_thread_mutex_lock (cracksink_ctx->mux_write);
+
+    cracksink_write_batch (hashcat_ctx);
+
+    hc_thread_mutex_unlock (cracksink_ctx->mux_write);
+
+    hc_thread_mutex_lock (cracksink_ctx->mux_pending);
+
+    const bool shutdown = cracksink_ctx->shutdown;
+
+    hc_thread_mutex_unlock (cracksink_ctx->mux_pending);
+
+    if (shutdown == true) break;
+  }
+
+  return NULL;
+}
+
+int cracksink_init (hashcat_ctx_t *hashcat_ctx)
+{
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  memset (cracksink_ctx, 0, sizeof (cracksink_ctx_t));
+
+  hc_thread_mutex_init (cracksink_ctx->mux_pending);
+  hc_thread_mutex_init (cracksink_ctx->mux_write);
+
+  hc_thread_sem_init (cracksink_ctx->sem_work);
+
+  cracksink_ctx->enabled = true;
+
+  hc_thread_create (cracksink_ctx->thread, thread_cracksink, hashcat_ctx);
+
+  return 0;
+}
+
+void cracksink_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  if (cracksink_ctx->enabled == false) return;
+
+  hc_thread_mutex_lock (cracksink_ctx->mux_pending);
+
+  cracksink_ctx->shutdown = true;
+
+  hc_thread_mutex_unlock (cracksink_ctx->mux_pending);
+
+  hc_thread_sem_post (cracksink_ctx->sem_work);
+
+  hc_thread_wait (1, &cracksink_ctx->thread);
+
+  // the thread may have seen the shutdown right after a batch which was committed while it was writing the previous one
+
+  hc_thread_mutex_lock (cracksink_ctx->mux_write);
+
+  cracksink_write_batch (hashcat_ctx);
+
+  hc_thread_mutex_unlock (cracksink_ctx->mux_write);
+
+  hc_thread_sem_close (cracksink_ctx->sem_work);
+
+  hc_thread_mutex_delete (cracksink_ctx->mux_write);
+  hc_thread_mutex_delete (cracksink_ctx->mux_pending);
+
+  for (int target = 0; target < CRACKSINK_TARGETS; target++)
+  {
+    hcfree (cracksink_ctx->pending[target].buf);
+    hcfree (cracksink_ctx->writing[target].buf);
+  }
+
+  memset (cracksink_ctx, 0, sizeof (cracksink_ctx_t));
+}
+
+void cracksink_push (hashcat_ctx_t *hashcat_ctx, const cracksink_target_t target, const u8 *buf, const size_t len)
+{
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  // outside of a cracking session (hashlist loading, potfile parsing) there is no writer thread
+
+  if (cracksink_ctx->enabled == false)
+  {
+    cracksink_write_target (hashcat_ctx, target, buf, len);
+
+    return;
+  }
+
+  hc_thread_mutex_lock (cracksink_ctx->mux_pending);
+
+  cracksink_buf_t *pending = &cracksink_ctx->pending[target];
+
+  if ((pending->len + len) > pending->avail)
+  {
+    const size_t add = MAX (len, HCBUFSIZ_LARGE);
+
+    pending->buf = (u8 *) hcrealloc (pending->buf, pending->avail, add);
+
+    pending->avail += add;
+  }
+
+  memcpy (pending->buf + pending->len, buf, len);
+
+  pending->len += len;
+
+  hc_thread_mutex_unlock (cracksink_ctx->mux_pending);
+}
+
+void cracksink_commit (hashcat_ctx_t *hashcat_ctx)
+{
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  if (cracksink_ctx->enabled == false) return;
+
+  // wake up the writer thread once per batch, no matter how many devices commit to it meanwhile
+
+  bool post = false;
+
+  hc_thread_mutex_lock (cracksink_ctx->mux_pending);
+
+  if (cracksink_ctx->signaled == false)
+  {
+    cracksink_ctx->signaled = true;
+
+    post = true;
+  }
+
+  hc_thread_mutex_unlock (cracksink_ctx->mux_pending);
+
+  if (post == true) hc_thread_sem_post (cracksink_ctx->sem_work);
+}
+
+void cracksink_flush (hashcat_ctx_t *hashcat_ctx)
+{
+  cracksink_ctx_t *cracksink_ctx = hashcat_ctx->cracksink_ctx;
+
+  if (cracksink_ctx->enabled == false) return;
+
+  hc_thread_mutex_lock (cracksink_ctx->mux_write);
+
+  cracksink_write_batch (hashcat_ctx);
+
+  hc_thread_mutex_unlock (cracksink_ctx->mux_write);
+}
@@ -126,6 +126,9 @@ int debugfile_init (hashcat_ctx_t *hashcat_ctx)
   else
   {
     debugfile_ctx->fp.is_gzip = false;
+    debugfile_ctx->fp.is_zip = false;
+    debugfile_ctx->fp.is_xz = false;
+    debugfile_ctx->fp.is_bgzf = false;
     debugfile_ctx->fp.pfp = stdout;
     debugfile_ctx->fp.fd = fileno (stdout);
   }
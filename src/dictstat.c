@@ -48,6 +48,141 @@ int sort_by_dictstat (const void *s1, const void *s2)
   return rc_memcmp;
 }
 
+static void dictidx_read (hashcat_ctx_t *hashcat_ctx)
+{
+  dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, dictstat_ctx->idx_filename, "rb") == false)
+  {
+    // the index is optional, do not error out
+
+    return;
+  }
+
+  u64 v;
+  u64 z;
+
+  const size_t nread1 = hc_fread (&v, sizeof (u64), 1, &fp);
+  const size_t nread2 = hc_fread (&z, sizeof (u64), 1, &fp);
+
+  v = byte_swap_64 (v);
+  z = byte_swap_64 (z);
+
+  if ((nread1 != 1) || (nread2 != 1) || (v != DICTIDX_VERSION) || (z != 0))
+  {
+    event_log_warning (hashcat_ctx, "%s: Invalid or outdated header, ignoring content", dictstat_ctx->idx_filename);
+
+    hc_fclose (&fp);
+
+    return;
+  }
+
+  while (!hc_feof (&fp))
+  {
+    dictidx_t idx;
+
+    if (hc_fread (&idx.d,   sizeof (dictstat_t), 1, &fp) != 1) break;
+    if (hc_fread (&idx.cnt, sizeof (u64),        1, &fp) != 1) break;
+
+    if ((idx.cnt == 0) || (idx.cnt > idx.d.cnt))
+    {
+      event_log_warning (hashcat_ctx, "%s: Invalid content, ignoring remaining entries", dictstat_ctx->idx_filename);
+
+      break;
+    }
+
+    idx.entries = (dictidx_entry_t *) hcmalloc (idx.cnt * sizeof (dictidx_entry_t));
+
+    if (hc_fread (idx.entries, sizeof (dictidx_entry_t), idx.cnt, &fp) != idx.cnt)
+    {
+      hcfree (idx.entries);
+
+      break;
+    }
+
+    bool sorted = true;
+
+    for (u64 i = 1; i < idx.cnt; i++)
+    {
+      if (idx.entries[i].word <= idx.entries[i - 1].word) sorted = false;
+      if (idx.entries[i].off  <= idx.entries[i - 1].off)  sorted = false;
+    }
+
+    if (sorted == false)
+    {
+      event_log_warning (hashcat_ctx, "%s: Invalid content, ignoring remaining entries", dictstat_ctx->idx_filename);
+
+      hcfree (idx.entries);
+
+      break;
+    }
+
+    dictidx_append (hashcat_ctx, &idx.d, idx.entries, idx.cnt);
+
+    if (dictstat_ctx->idx_cnt == MAX_DICTSTAT) break;
+  }
+
+  hc_fclose (&fp);
+}
+
+static int dictidx_write (hashcat_ctx_t *hashcat_ctx)
+{
+  dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+
+  if (dictstat_ctx->idx_cnt == 0) return 0;
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, dictstat_ctx->idx_filename, "wb") == false)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", dictstat_ctx->idx_filename, strerror (errno));
+
+    return -1;
+  }
+
+  if (hc_lockfile (&fp) == -1)
+  {
+    hc_fclose (&fp);
+
+    event_log_error (hashcat_ctx, "%s: %s", dictstat_ctx->idx_filename, strerror (errno));
+
+    return -1;
+  }
+
+  u64 v = DICTIDX_VERSION;
+  u64 z = 0;
+
+  v = byte_swap_64 (v);
+  z = byte_swap_64 (z);
+
+  hc_fwrite (&v, sizeof (u64), 1, &fp);
+  hc_fwrite (&z, sizeof (u64), 1, &fp);
+
+  for (u32 i = 0; i < dictstat_ctx->idx_cnt; i++)
+  {
+    const dictidx_t *idx = dictstat_ctx->idx_base + i;
+
+    hc_fwrite (&idx->d,      sizeof (dictstat_t),      1,        &fp);
+    hc_fwrite (&idx->cnt,    sizeof (u64),             1,        &fp);
+    hc_fwrite (idx->entries, sizeof (dictidx_entry_t), idx->cnt, &fp);
+  }
+
+  if (hc_unlockfile (&fp) == -1)
+  {
+    hc_fclose (&fp);
+
+    event_log_error (hashcat_ctx, "%s: %s", dictstat_ctx->idx_filename, strerror (errno));
+
+    return -1;
+  }
+
+  hc_fclose (&fp);
+
+  return 0;
+}
+
 int dictstat_init (hashcat_ctx_t *hashcat_ctx)
 {
   dictstat_ctx_t  *dictstat_ctx  = hashcat_ctx->dictstat_ctx;
@@ -70,8 +205,11 @@ int dictstat_init (hashcat_ctx_t *hashcat_ctx)
   dictstat_ctx->enabled  = true;
   dictstat_ctx->base     = (dictstat_t *) hccalloc (MAX_DICTSTAT, sizeof (dictstat_t));
   dictstat_ctx->cnt      = 0;
+  dictstat_ctx->idx_base = NULL;
+  dictstat_ctx->idx_cnt  = 0;
 
-  hc_asprintf (&dictstat_ctx->filename, "%s/%s", folder_config->profile_dir, DICTSTAT_FILENAME);
+  hc_asprintf (&dictstat_ctx->filename,     "%s/%s", folder_config->profile_dir, DICTSTAT_FILENAME);
+  hc_asprintf (&dictstat_ctx->idx_filename, "%s/%s", folder_config->profile_dir, DICTIDX_FILENAME);
 
   return 0;
 }
@@ -85,8 +223,15 @@ void dictstat_destroy (hashcat_ctx_t *hashcat_ctx)
 
   if (hashconfig->dictstat_disable == true) return;
 
+  for (u32 i = 0; i < dictstat_ctx->idx_cnt; i++)
+  {
+    hcfree (dictstat_ctx->idx_base[i].entries);
+  }
+
   hcfree (dictstat_ctx->filename);
   hcfree (dictstat_ctx->base);
+  hcfree (dictstat_ctx->idx_filename);
+  hcfree (dictstat_ctx->idx_base);
 
   memset (dictstat_ctx, 0, sizeof (dictstat_ctx_t));
 }
@@ -177,6 +322,8 @@ void dictstat_read (hashcat_ctx_t *hashcat_ctx)
   }
 
   hc_fclose (&fp);
+
+  dictidx_read (hashcat_ctx);
 }
 
 int dictstat_write (hashcat_ctx_t *hashcat_ctx)
@@ -232,7 +379,7 @@ int dictstat_write (hashcat_ctx_t *hashcat_ctx)
 
   hc_fclose (&fp);
 
-  return 0;
+  return dictidx_write (hashcat_ctx);
 }
 
 u64 dictstat_find (hashcat_ctx_t *hashcat_ctx, dictstat_t *d)
@@ -269,3 +416,57 @@ void dictstat_append (hashcat_ctx_t *hashcat_ctx, dictstat_t *d)
 
   lsearch (d, dictstat_ctx->base, &dictstat_ctx->cnt, sizeof (dictstat_t), sort_by_dictstat);
 }
+
+const dictidx_t *dictidx_find (hashcat_ctx_t *hashcat_ctx, const dictstat_t *d)
+{
+  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+
+  if (dictstat_ctx->enabled == false) return NULL;
+
+  if (hashconfig->dictstat_disable == true) return NULL;
+
+  for (u32 i = 0; i < dictstat_ctx->idx_cnt; i++)
+  {
+    const dictidx_t *idx = dictstat_ctx->idx_base + i;
+
+    if (sort_by_dictstat (&idx->d, d) == 0) return idx;
+  }
+
+  return NULL;
+}
+
+void dictidx_append (hashcat_ctx_t *hashcat_ctx, const dictstat_t *d, dictidx_entry_t *entries, const u64 cnt)
+{
+  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  dictstat_ctx_t *dictstat_ctx = hashcat_ctx->dictstat_ctx;
+
+  // takes ownership of entries
+
+  if ((dictstat_ctx->enabled == false) || (hashconfig->dictstat_disable == true) || (dictstat_ctx->idx_cnt == MAX_DICTSTAT))
+  {
+    hcfree (entries);
+
+    return;
+  }
+
+  dictidx_t *idx = (dictidx_t *) dictidx_find (hashcat_ctx, d);
+
+  if (idx == NULL)
+  {
+    dictstat_ctx->idx_base = (dictidx_t *) hcrealloc (dictstat_ctx->idx_base, dictstat_ctx->idx_cnt * sizeof (dictidx_t), sizeof (dictidx_t));
+
+    idx = dictstat_ctx->idx_base + dictstat_ctx->idx_cnt;
+
+    dictstat_ctx->idx_cnt++;
+  }
+  else
+  {
+    hcfree (idx->entries);
+  }
+
+  memcpy (&idx->d, d, sizeof (dictstat_t));
+
+  idx->entries = entries;
+  idx->cnt     = cnt;
+}
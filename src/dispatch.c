@@ -360,6 +360,124 @@ HC_API_CALL void *thread_calc_stdin (void *p)
   return NULL;
 }
 
+#ifdef WITH_BRAIN
+static bool calc_brain_defer (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 words_fin)
+{
+  const user_options_t *user_options = hashcat_ctx->user_options;
+  const status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
+
+  if (user_options->brain_client == false) return false;
+
+  if ((user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES) == 0) return false;
+
+  // duplicates across both links are only filtered on the sorted lookups of link version 2
+
+  if (device_param->brain_link_version < 2) return false;
+
+  if (device_param->pws_cnt == 0) return false;
+
+  if (device_param->speed_only_finish == true) return false;
+
+  if (status_ctx->run_thread_level1 == false) return false;
+
+  if (words_fin == 0) return false;
+
+  // keep the batch in the buffers, it is run while the lookup of the next batch is in flight on the other link
+
+  device_param->brain_link_pending = words_fin;
+
+  brain_client_swap (device_param);
+
+  // the commit of the batch this link carried before is ordered ahead of everything we send on it from now on,
+  // only the other link could see its hashes too early and that one still filters against them
+
+  device_param->brain_link_batch_cnt = 0;
+
+  return true;
+}
+
+static int calc_brain_lookup (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
+
+  const u64 words_fin = device_param->brain_link_pending;
+
+  if (words_fin == 0)
+  {
+    if (brain_client_lookup (device_param, status_ctx) == false)
+    {
+      brain_client_disconnect (device_param);
+    }
+
+    return 0;
+  }
+
+  device_param->brain_link_pending = 0;
+
+  brain_client_lookup_options_t brain_client_lookup_options;
+
+  brain_client_lookup_options.device_param = device_param;
+  brain_client_lookup_options.status_ctx   = status_ctx;
+  brain_client_lookup_options.rc           = false;
+
+  hc_thread_t lookup_thr;
+
+  hc_thread_create (lookup_thr, brain_client_handle_lookup, &brain_client_lookup_options);
+
+  const u64 pws_cnt = device_param->pws_cnt;
+
+  int rc = 0;
+
+  if      (run_copy    (hashcat_ctx, device_param, pws_cnt)     == -1) rc = -1;
+  else if (run_cracker (hashcat_ctx, device_param, -1, pws_cnt) == -1) rc = -1;
+
+  hc_thread_wait (1, &lookup_thr);
+
+  if (brain_client_lookup_options.rc == false)
+  {
+    brain_client_disconnect (device_param);
+  }
+
+  if (rc == -1) return -1;
+
+  if ((status_ctx->devices_status != STATUS_ABORTED)
+   && (status_ctx->devices_status != STATUS_ABORTED_RUNTIME)
+   && (status_ctx->devices_status != STATUS_QUIT)
+   && (status_ctx->devices_status != STATUS_BYPASS)
+   && (status_ctx->devices_status != STATUS_ERROR))
+  {
+    // the deferred batch was looked up on the other link, so that is where it has to be committed
+
+    brain_client_swap (device_param);
+
+    if (brain_client_commit (device_param, status_ctx) == false)
+    {
+      brain_client_disconnect (device_param);
+    }
+
+    brain_client_swap (device_param);
+  }
+
+  device_param->pws_cnt      = 0;
+  device_param->pws_base_cnt = 0;
+
+  memset (device_param->pws_comp,     0, device_param->size_pws_comp);
+  memset (device_param->pws_idx,      0, device_param->size_pws_idx);
+  memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+
+  if (device_param->speed_only_finish == true) return 0;
+
+  if (status_ctx->run_thread_level2 == true)
+  {
+    device_param->words_done = MAX (device_param->words_done, words_fin);
+
+    status_ctx->words_cur = get_highest_words_done (hashcat_ctx);
+  }
+
+  return 0;
+}
+#endif
+
 static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   user_options_t       *user_options       = hashcat_ctx->user_options;
@@ -385,6 +503,11 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
     brain_client_disconnect (device_param);
 
+    device_param->brain_link_client_fd_prev = -1;
+    device_param->brain_link_pending        = 0;
+    device_param->brain_link_batch_cnt      = 0;
+    device_param->brain_link_batch_cnt_prev = 0;
+
     if (user_options->brain_client == true)
     {
       const i64 passwords_max = device_param->hardware_power * device_param->kernel_accel;
@@ -447,15 +570,22 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         return -1;
       }
 
+      hc_fmmap (&extra_info_straight.fp);
+
+      wl_data_index_load (hashcat_ctx_tmp, &extra_info_straight.fp, dictfile);
+
       u64 words_cur = 0;
 
       while (status_ctx->run_thread_level1 == true)
       {
         u64 words_fin = 0;
 
-        memset (device_param->pws_comp,     0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,      0, device_param->size_pws_idx);
-        memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        if (device_param->pws_cnt == 0)
+        {
+          memset (device_param->pws_comp,     0, device_param->size_pws_comp);
+          memset (device_param->pws_idx,      0, device_param->size_pws_idx);
+          memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        }
 
         u64 pre_rejects = -1;
 
@@ -565,9 +695,14 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
-              if (brain_client_lookup (device_param, status_ctx) == false)
+              if (calc_brain_lookup (hashcat_ctx, device_param) == -1)
               {
-                brain_client_disconnect (device_param);
+                hc_fclose (&extra_info_straight.fp);
+
+                hcfree (hashcat_ctx_tmp->wl_data);
+                hcfree (hashcat_ctx_tmp);
+
+                return -1;
               }
             }
 
@@ -632,6 +767,10 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           }
         }
 
+        #ifdef WITH_BRAIN
+        if (calc_brain_defer (hashcat_ctx, device_param, words_fin) == true) continue;
+        #endif
+
         //
         // flush
         //
@@ -765,9 +904,12 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
       {
         u64 words_fin = 0;
 
-        memset (device_param->pws_comp,     0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,      0, device_param->size_pws_idx);
-        memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        if (device_param->pws_cnt == 0)
+        {
+          memset (device_param->pws_comp,     0, device_param->size_pws_comp);
+          memset (device_param->pws_idx,      0, device_param->size_pws_idx);
+          memset (device_param->pws_base_buf, 0, device_param->size_pws_base);
+        }
 
         u64 pre_rejects = -1;
 
@@ -877,9 +1019,15 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
-              if (brain_client_lookup (device_param, status_ctx) == false)
+              if (calc_brain_lookup (hashcat_ctx, device_param) == -1)
               {
-                brain_client_disconnect (device_param);
+                hc_fclose (&extra_info_combi.base_fp);
+                hc_fclose (&extra_info_combi.combs_fp);
+
+                hcfree (hashcat_ctx_tmp->wl_data);
+                hcfree (hashcat_ctx_tmp);
+
+                return -1;
               }
             }
 
@@ -944,6 +1092,10 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           }
         }
 
+        #ifdef WITH_BRAIN
+        if (calc_brain_defer (hashcat_ctx, device_param, words_fin) == true) continue;
+        #endif
+
         //
         // flush
         //
@@ -1031,8 +1183,11 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
       {
         u64 words_fin = 0;
 
-        memset (device_param->pws_comp, 0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,  0, device_param->size_pws_idx);
+        if (device_param->pws_cnt == 0)
+        {
+          memset (device_param->pws_comp, 0, device_param->size_pws_comp);
+          memset (device_param->pws_idx,  0, device_param->size_pws_idx);
+        }
 
         u64 pre_rejects = -1;
 
@@ -1132,9 +1287,9 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
-              if (brain_client_lookup (device_param, status_ctx) == false)
+              if (calc_brain_lookup (hashcat_ctx, device_param) == -1)
               {
-                brain_client_disconnect (device_param);
+                return -1;
               }
             }
 
@@ -1193,6 +1348,10 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           }
         }
 
+        #ifdef WITH_BRAIN
+        if (calc_brain_defer (hashcat_ctx, device_param, words_fin) == true) continue;
+        #endif
+
         //
         // flush
         //
@@ -1242,6 +1401,20 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
     #ifdef WITH_BRAIN
     if (user_options->brain_client == true)
     {
+      if (device_param->brain_link_pending)
+      {
+        // stopped with a batch still deferred, it was never run and must not leak into the next calc
+
+        device_param->brain_link_pending = 0;
+
+        device_param->pws_cnt      = 0;
+        device_param->pws_base_cnt = 0;
+      }
+
+      brain_client_disconnect (device_param);
+
+      brain_client_swap (device_param);
+
       brain_client_disconnect (device_param);
     }
     #endif
@@ -1356,6 +1529,13 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         return -1;
       }
 
+      // the wordlist is read strictly sequentially from here on, map it if possible (zero-copy, kernel read-ahead)
+      // otherwise (compressed, pipes, windows) let a reader thread fetch the next segment meanwhile
+
+      if (hc_fmmap (&fp) == false) wl_data_async_start (hashcat_ctx_tmp, &fp);
+
+      wl_data_index_load (hashcat_ctx_tmp, &fp, dictfile);
+
       u64 words_cur = 0;
 
       while (status_ctx->run_thread_level1 == true)
@@ -1384,6 +1564,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
           char rule_buf_out[RP_PASSWORD_SIZE];
 
+          words_cur = wl_data_seek (hashcat_ctx_tmp, &fp, words_cur, words_off);
+
           for ( ; words_cur < words_off; words_cur++) get_next_word (hashcat_ctx_tmp, &fp, &line_buf, &line_len);
 
           for ( ; words_cur < words_fin; words_cur++)
@@ -1448,6 +1630,24 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
         if (status_ctx->run_thread_level1 == false) break;
 
+        // the word count might be a cached one, do not let a broken file look like a shorter one
+
+        if (wl_data_error (hashcat_ctx_tmp, &fp) == true)
+        {
+          event_log_error (hashcat_ctx, "%s: Read error.", dictfile);
+
+          if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
+
+          wl_data_async_stop (hashcat_ctx_tmp);
+
+          hc_fclose (&fp);
+
+          hcfree (hashcat_ctx_tmp->wl_data);
+          hcfree (hashcat_ctx_tmp);
+
+          return -1;
+        }
+
         if (words_extra_total > 0)
         {
           hc_thread_mutex_lock (status_ctx->mux_counter);
@@ -1479,6 +1679,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
 
+            wl_data_async_stop (hashcat_ctx_tmp);
+
             hc_fclose (&fp);
 
             hcfree (hashcat_ctx_tmp->wl_data);
@@ -1491,6 +1693,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           {
             if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
 
+            wl_data_async_stop (hashcat_ctx_tmp);
+
             hc_fclose (&fp);
 
             hcfree (hashcat_ctx_tmp->wl_data);
@@ -1546,6 +1750,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
       if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
 
+      wl_data_async_stop (hashcat_ctx_tmp);
+
       hc_fclose (&fp);
 
       wl_data_destroy (hashcat_ctx_tmp);
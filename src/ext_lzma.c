@@ -8,6 +8,9 @@
 #include "memory.h"
 #include "ext_lzma.h"
 
+#include <7zCrc.h>
+#include <XzCrc64.h>
+
 void *hc_lzma_alloc (MAYBE_UNUSED ISzAllocPtr p, size_t size)
 {
   return hcmalloc (size);
@@ -41,3 +44,154 @@ int hc_lzma2_decompress (const unsigned char *in, SizeT *in_len, unsigned char *
 
   return Lzma2Decode (out, out_len, in, in_len, (Byte) props[0], LZMA_FINISH_ANY, &status, &hc_lzma_mem_alloc);
 }
+
+static bool hc_xz_fill (xzfile_t *xfp)
+{
+  // decode until there is output, the input is exhausted or something went wrong
+
+  while ((xfp->outpos == xfp->outlen) && (xfp->eof == false) && (xfp->err == false))
+  {
+    if (xfp->inpos == xfp->inlen)
+    {
+      xfp->inpos = 0;
+      xfp->inlen = fread (xfp->inbuf, 1, XZ_BUFSIZ, xfp->pfp);
+    }
+
+    const bool in_done = (xfp->inlen == 0);
+
+    SizeT in_len  = xfp->inlen - xfp->inpos;
+    SizeT out_len = XZ_BUFSIZ;
+
+    ECoderStatus status;
+
+    const SRes res = XzUnpacker_Code (&xfp->unpacker, xfp->outbuf, &out_len, xfp->inbuf + xfp->inpos, &in_len, in_done, CODER_FINISH_ANY, &status);
+
+    xfp->inpos  += in_len;
+    xfp->outpos  = 0;
+    xfp->outlen  = out_len;
+
+    if (res != SZ_OK)
+    {
+      xfp->err = true;
+    }
+    else if ((in_done == true) && (out_len == 0))
+    {
+      // trailing garbage or a truncated stream is treated like the end of the file, same as zlib does
+
+      xfp->eof = true;
+    }
+  }
+
+  return (xfp->outpos < xfp->outlen);
+}
+
+void hc_xz_init ()
+{
+  // the tables are shared by all decoders, so they are generated once before any wordlist is opened
+
+  CrcGenerateTable ();
+  Crc64GenerateTable ();
+}
+
+xzfile_t *hc_xz_open (FILE *pfp)
+{
+  xzfile_t *xfp = (xzfile_t *) hccalloc (1, sizeof (xzfile_t));
+
+  xfp->pfp = pfp;
+
+  xfp->alloc.Alloc = hc_lzma_alloc;
+  xfp->alloc.Free  = hc_lzma_free;
+
+  xfp->inbuf  = (Byte *) hcmalloc (XZ_BUFSIZ);
+  xfp->outbuf = (Byte *) hcmalloc (XZ_BUFSIZ);
+
+  XzUnpacker_Construct (&xfp->unpacker, &xfp->alloc);
+
+  XzUnpacker_Init (&xfp->unpacker);
+
+  return xfp;
+}
+
+void hc_xz_close (xzfile_t *xfp)
+{
+  if (xfp == NULL) return;
+
+  XzUnpacker_Free (&xfp->unpacker);
+
+  hcfree (xfp->inbuf);
+  hcfree (xfp->outbuf);
+
+  fclose (xfp->pfp);
+
+  hcfree (xfp);
+}
+
+size_t hc_xz_read (xzfile_t *xfp, void *buf, size_t len)
+{
+  size_t n = 0;
+
+  while (n < len)
+  {
+    if (hc_xz_fill (xfp) == false) break;
+
+    const size_t avail = MIN (xfp->outlen - xfp->outpos, len - n);
+
+    memcpy ((char *) buf + n, xfp->outbuf + xfp->outpos, avail);
+
+    xfp->outpos += avail;
+
+    n += avail;
+  }
+
+  xfp->offset += n;
+
+  return n;
+}
+
+int hc_xz_getc (xzfile_t *xfp)
+{
+  if (hc_xz_fill (xfp) == false) return EOF;
+
+  xfp->offset++;
+
+  return (int) xfp->outbuf[xfp->outpos++];
+}
+
+bool hc_xz_eof (xzfile_t *xfp)
+{
+  if (xfp->outpos < xfp->outlen) return false;
+
+  return (xfp->eof == true) || (xfp->err == true);
+}
+
+void hc_xz_rewind (xzfile_t *xfp)
+{
+  rewind (xfp->pfp);
+
+  XzUnpacker_Init (&xfp->unpacker);
+
+  xfp->inpos  = 0;
+  xfp->inlen  = 0;
+  xfp->outpos = 0;
+  xfp->outlen = 0;
+  xfp->offset = 0;
+  xfp->eof    = false;
+  xfp->err    = false;
+}
+
+int hc_xz_seek (xzfile_t *xfp, const uint64_t offset)
+{
+  if (offset < xfp->offset) hc_xz_rewind (xfp);
+
+  while (xfp->offset < offset)
+  {
+    if (hc_xz_fill (xfp) == false) return -1;
+
+    const size_t avail = (size_t) MIN (xfp->outlen - xfp->outpos, offset - xfp->offset);
+
+    xfp->outpos += avail;
+    xfp->offset += avail;
+  }
+
+  return 0;
+}
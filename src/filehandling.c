@@ -7,8 +7,13 @@
 #include "types.h"
 #include "memory.h"
 #include "shared.h"
+#include "thread.h"
 #include "filehandling.h"
 
+#if defined (_POSIX)
+#include <sys/mman.h>
+#endif
+
 #if defined (__CYGWIN__)
 // workaround for zlib with cygwin build
 int _wopen (const char *path, int oflag, ...)
@@ -21,6 +26,433 @@ int _wopen (const char *path, int oflag, ...)
 }
 #endif
 
+static bool hc_gz_error (gzFile gfp)
+{
+  // a truncated file is treated like the end of the file, only broken data counts
+
+  int errnum = Z_OK;
+
+  gzerror (gfp, &errnum);
+
+  return (errnum != Z_OK) && (errnum != Z_BUF_ERROR);
+}
+
+static bool hc_bgzf_tail (bgzf_t *bfp, const off_t off)
+{
+  // zlib reads from the current position of the descriptor and continues with any member which follows
+
+  const int fd = dup (fileno (bfp->pfp));
+
+  if (fd == -1) return false;
+
+  if (lseek (fd, off, SEEK_SET) == -1)
+  {
+    close (fd);
+
+    return false;
+  }
+
+  if ((bfp->gfp = gzdopen (fd, "rb")) == NULL)
+  {
+    close (fd);
+
+    return false;
+  }
+
+  return true;
+}
+
+static bool hc_bgzf_read_block (bgzf_t *bfp, bgzf_block_t *block)
+{
+  const off_t off = ftello (bfp->pfp);
+
+  u8 hdr[12];
+
+  const size_t n = fread (hdr, 1, sizeof (hdr), bfp->pfp);
+
+  // trailing garbage is treated like the end of the file, same as zlib does
+
+  if ((n < 2) || (hdr[0] != 0x1f) || (hdr[1] != 0x8b))
+  {
+    bfp->eof = true;
+
+    return false;
+  }
+
+  // FEXTRA only, a name, comment or header crc would sit between the extra field and the deflate data
+
+  u32 xlen = 0;
+
+  if ((n == sizeof (hdr)) && (hdr[2] == 0x08) && ((hdr[3] & 0x1e) == 0x04))
+  {
+    xlen = (u32) hdr[10] | ((u32) hdr[11] << 8);
+
+    if (fread (block->cbuf, 1, xlen, bfp->pfp) != xlen) xlen = 0;
+  }
+
+  u32 bsize = 0;
+
+  for (u32 i = 0; i + 4 <= xlen; i += 4 + ((u32) block->cbuf[i + 2] | ((u32) block->cbuf[i + 3] << 8)))
+  {
+    if ((block->cbuf[i + 0] != 'B') || (block->cbuf[i + 1] != 'C')) continue;
+
+    if ((block->cbuf[i + 2] != 2) || (block->cbuf[i + 3] != 0) || (i + 6 > xlen)) break;
+
+    bsize = ((u32) block->cbuf[i + 4] | ((u32) block->cbuf[i + 5] << 8)) + 1;
+
+    break;
+  }
+
+  // any other gzip member, for instance a regular one appended to the file, hands the rest of the stream over to zlib
+
+  if (bsize == 0)
+  {
+    bfp->eof = true;
+
+    if (hc_bgzf_tail (bfp, off) == false) bfp->err = true;
+
+    return false;
+  }
+
+  if (bsize < sizeof (hdr) + xlen + 8)
+  {
+    bfp->err = true;
+
+    return false;
+  }
+
+  block->clen = bsize - sizeof (hdr) - xlen;
+
+  if (fread (block->cbuf, 1, block->clen, bfp->pfp) != block->clen)
+  {
+    bfp->err = true;
+
+    return false;
+  }
+
+  return true;
+}
+
+static void hc_bgzf_inflate (z_stream *strm, bgzf_block_t *block)
+{
+  block->ulen = 0;
+  block->err  = true;
+
+  const u8 *trailer = block->cbuf + block->clen - 8;
+
+  const u32 crc   = (u32) trailer[0] | ((u32) trailer[1] << 8) | ((u32) trailer[2] << 16) | ((u32) trailer[3] << 24);
+  const u32 isize = (u32) trailer[4] | ((u32) trailer[5] << 8) | ((u32) trailer[6] << 16) | ((u32) trailer[7] << 24);
+
+  if (isize > BGZF_BLOCK_SIZE) return;
+
+  if (inflateReset (strm) != Z_OK) return;
+
+  strm->next_in   = block->cbuf;
+  strm->avail_in  = block->clen - 8;
+  strm->next_out  = block->ubuf;
+  strm->avail_out = BGZF_BLOCK_SIZE;
+
+  if (inflate (strm, Z_FINISH) != Z_STREAM_END) return;
+
+  if (strm->total_out != isize) return;
+
+  if (crc32 (0, block->ubuf, isize) != crc) return;
+
+  block->ulen = isize;
+  block->err  = false;
+}
+
+static void *hc_bgzf_thread (void *p)
+{
+  bgzf_thread_param_t *param = (bgzf_thread_param_t *) p;
+
+  bgzf_t *bfp = param->bfp;
+
+  while (true)
+  {
+    hc_thread_sem_wait (bfp->sem_start);
+
+    if (bfp->shutdown == true) break;
+
+    while (true)
+    {
+      hc_thread_mutex_lock (bfp->mux);
+
+      const int i = bfp->block_next++;
+
+      hc_thread_mutex_unlock (bfp->mux);
+
+      if (i >= bfp->blocks_used) break;
+
+      hc_bgzf_inflate (&param->strm, &bfp->blocks[i]);
+    }
+
+    hc_thread_sem_post (bfp->sem_done);
+  }
+
+  return NULL;
+}
+
+static bool hc_bgzf_fill (bgzf_t *bfp)
+{
+  while (true)
+  {
+    if (bfp->block_cur < bfp->blocks_used)
+    {
+      if (bfp->block_pos < bfp->blocks[bfp->block_cur].ulen) return true;
+
+      bfp->block_cur++;
+      bfp->block_pos = 0;
+
+      continue;
+    }
+
+    if ((bfp->eof == true) || (bfp->err == true)) return false;
+
+    // the blocks of a batch are read sequentially but inflated in parallel
+
+    int cnt = 0;
+
+    while (cnt < bfp->blocks_cnt)
+    {
+      if (hc_bgzf_read_block (bfp, &bfp->blocks[cnt]) == false) break;
+
+      cnt++;
+    }
+
+    bfp->blocks_used = cnt;
+    bfp->block_cur   = 0;
+    bfp->block_pos   = 0;
+    bfp->block_next  = 0;
+
+    // the workers are parked, nothing else touches the batch until all of them report back
+
+    const int threads_used = MIN (bfp->threads_cnt, cnt);
+
+    for (int tid = 0; tid < threads_used; tid++)
+    {
+      hc_thread_sem_post (bfp->sem_start);
+    }
+
+    for (int tid = 0; tid < threads_used; tid++)
+    {
+      hc_thread_sem_wait (bfp->sem_done);
+    }
+
+    // everything in front of a broken block is still handed out, same as zlib does
+
+    for (int i = 0; i < cnt; i++)
+    {
+      if (bfp->blocks[i].err == false) continue;
+
+      bfp->blocks_used = i;
+      bfp->err         = true;
+
+      break;
+    }
+  }
+
+  return false;
+}
+
+static bgzf_t *hc_bgzf_open (FILE *pfp)
+{
+  bgzf_t *bfp = (bgzf_t *) hccalloc (1, sizeof (bgzf_t));
+
+  bfp->pfp = pfp;
+
+  bfp->threads_cnt = MAX (MIN (hc_get_processor_count (), BGZF_THREADS_MAX), 1);
+
+  bfp->threads       = (hc_thread_t *)         hccalloc (bfp->threads_cnt, sizeof (hc_thread_t));
+  bfp->threads_param = (bgzf_thread_param_t *) hccalloc (bfp->threads_cnt, sizeof (bgzf_thread_param_t));
+
+  for (int tid = 0; tid < bfp->threads_cnt; tid++)
+  {
+    bfp->threads_param[tid].bfp = bfp;
+    bfp->threads_param[tid].tid = tid;
+
+    if (inflateInit2 (&bfp->threads_param[tid].strm, -MAX_WBITS) != Z_OK) bfp->err = true;
+  }
+
+  bfp->blocks_cnt = bfp->threads_cnt * BGZF_BATCH_BLOCKS;
+
+  bfp->blocks = (bgzf_block_t *) hccalloc (bfp->blocks_cnt, sizeof (bgzf_block_t));
+
+  for (int i = 0; i < bfp->blocks_cnt; i++)
+  {
+    bfp->blocks[i].cbuf = (u8 *) hcmalloc (BGZF_BLOCK_SIZE);
+    bfp->blocks[i].ubuf = (u8 *) hcmalloc (BGZF_BLOCK_SIZE);
+  }
+
+  hc_thread_sem_init (bfp->sem_start);
+  hc_thread_sem_init (bfp->sem_done);
+
+  hc_thread_mutex_init (bfp->mux);
+
+  bfp->shutdown = false;
+
+  for (int tid = 0; tid < bfp->threads_cnt; tid++)
+  {
+    hc_thread_create (bfp->threads[tid], hc_bgzf_thread, &bfp->threads_param[tid]);
+  }
+
+  return bfp;
+}
+
+static void hc_bgzf_close (bgzf_t *bfp)
+{
+  if (bfp == NULL) return;
+
+  bfp->shutdown = true;
+
+  for (int tid = 0; tid < bfp->threads_cnt; tid++)
+  {
+    hc_thread_sem_post (bfp->sem_start);
+  }
+
+  hc_thread_wait (bfp->threads_cnt, bfp->threads);
+
+  hc_thread_sem_close (bfp->sem_start);
+  hc_thread_sem_close (bfp->sem_done);
+
+  hc_thread_mutex_delete (bfp->mux);
+
+  for (int tid = 0; tid < bfp->threads_cnt; tid++)
+  {
+    inflateEnd (&bfp->threads_param[tid].strm);
+  }
+
+  for (int i = 0; i < bfp->blocks_cnt; i++)
+  {
+    hcfree (bfp->blocks[i].cbuf);
+    hcfree (bfp->blocks[i].ubuf);
+  }
+
+  hcfree (bfp->blocks);
+  hcfree (bfp->threads);
+  hcfree (bfp->threads_param);
+
+  if (bfp->gfp != NULL) gzclose (bfp->gfp);
+
+  fclose (bfp->pfp);
+
+  hcfree (bfp);
+}
+
+static size_t hc_bgzf_read (bgzf_t *bfp, void *buf, size_t len)
+{
+  size_t n = 0;
+
+  while (n < len)
+  {
+    if (hc_bgzf_fill (bfp) == false) break;
+
+    const bgzf_block_t *block = &bfp->blocks[bfp->block_cur];
+
+    const size_t avail = MIN (block->ulen - bfp->block_pos, len - n);
+
+    memcpy ((char *) buf + n, block->ubuf + bfp->block_pos, avail);
+
+    bfp->block_pos += avail;
+
+    n += avail;
+  }
+
+  if ((n < len) && (bfp->gfp != NULL))
+  {
+    n += gzfread ((char *) buf + n, 1, len - n, bfp->gfp);
+  }
+
+  bfp->offset += n;
+
+  return n;
+}
+
+static int hc_bgzf_getc (bgzf_t *bfp)
+{
+  if (hc_bgzf_fill (bfp) == false)
+  {
+    if (bfp->gfp == NULL) return EOF;
+
+    const int c = gzgetc (bfp->gfp);
+
+    if (c != -1) bfp->offset++;
+
+    return c;
+  }
+
+  bfp->offset++;
+
+  return (int) bfp->blocks[bfp->block_cur].ubuf[bfp->block_pos++];
+}
+
+static bool hc_bgzf_eof (bgzf_t *bfp)
+{
+  if (bfp->block_cur < bfp->blocks_used)
+  {
+    if (bfp->block_pos < bfp->blocks[bfp->block_cur].ulen) return false;
+  }
+
+  // there might be empty blocks ahead, the BGZF end-of-file marker is one of them
+
+  if (hc_bgzf_fill (bfp) == true) return false;
+
+  if (bfp->gfp != NULL) return (gzeof (bfp->gfp) == 1) || (hc_gz_error (bfp->gfp) == true);
+
+  return true;
+}
+
+static bool hc_bgzf_error (bgzf_t *bfp)
+{
+  if (bfp->err == true) return true;
+
+  if (bfp->gfp == NULL) return false;
+
+  return hc_gz_error (bfp->gfp);
+}
+
+static void hc_bgzf_rewind (bgzf_t *bfp)
+{
+  if (bfp->gfp != NULL) gzclose (bfp->gfp);
+
+  bfp->gfp = NULL;
+
+  rewind (bfp->pfp);
+
+  bfp->blocks_used = 0;
+  bfp->block_cur   = 0;
+  bfp->block_pos   = 0;
+  bfp->offset      = 0;
+  bfp->eof         = false;
+  bfp->err         = false;
+}
+
+static int hc_bgzf_seek (bgzf_t *bfp, const u64 offset)
+{
+  if (offset < bfp->offset) hc_bgzf_rewind (bfp);
+
+  while (bfp->offset < offset)
+  {
+    if (hc_bgzf_fill (bfp) == false)
+    {
+      if (bfp->gfp == NULL) return -1;
+
+      if (gzseek (bfp->gfp, (z_off_t) (offset - bfp->offset), SEEK_CUR) == -1) return -1;
+
+      bfp->offset = offset;
+
+      break;
+    }
+
+    const u64 avail = MIN (bfp->blocks[bfp->block_cur].ulen - bfp->block_pos, offset - bfp->offset);
+
+    bfp->block_pos += avail;
+    bfp->offset    += avail;
+  }
+
+  return 0;
+}
+
 bool hc_fopen (HCFILE *fp, const char *path, char *mode)
 {
   if (path == NULL || mode == NULL) return false;
@@ -63,8 +495,12 @@ bool hc_fopen (HCFILE *fp, const char *path, char *mode)
   fp->pfp = NULL;
   fp->is_gzip = false;
   fp->is_zip = false;
+  fp->is_xz = false;
+  fp->is_bgzf = false;
+  fp->is_mmap = false;
+  fp->mmap_buf = NULL;
 
-  unsigned char check[4] = { 0 };
+  unsigned char check[BGZF_HDR_LEN] = { 0 };
 
   int fd_tmp = open (path, O_RDONLY);
 
@@ -72,10 +508,23 @@ bool hc_fopen (HCFILE *fp, const char *path, char *mode)
   {
     lseek (fd_tmp, 0, SEEK_SET);
 
-    if (read (fd_tmp, check, sizeof (check)) > 0)
+    const ssize_t check_len = read (fd_tmp, check, sizeof (check));
+
+    if (check_len > 0)
     {
       if (check[0] == 0x1f && check[1] == 0x8b && check[2] == 0x08) fp->is_gzip = true;
       if (check[0] == 0x50 && check[1] == 0x4b && check[2] == 0x03 && check[3] == 0x04) fp->is_zip = true;
+
+      // decoder only
+
+      if ((strncmp (mode, "r", 1) == 0) && (memcmp (check, XZ_MAGIC, XZ_MAGIC_LEN) == 0)) fp->is_xz = true;
+
+      // the blocks of a BGZF file can be inflated independently, no point in doing so on a single core
+
+      if ((strncmp (mode, "r", 1) == 0) && (fp->is_gzip == true) && (check_len == BGZF_HDR_LEN) && (hc_get_processor_count () > 1))
+      {
+        if ((check[3] & 0x04) && (check[12] == 'B') && (check[13] == 'C') && (check[14] == 2) && (check[15] == 0)) fp->is_bgzf = true;
+      }
     }
 
     close (fd_tmp);
@@ -92,7 +541,15 @@ bool hc_fopen (HCFILE *fp, const char *path, char *mode)
 
   if (fp->fd == -1 && fp->is_zip == false) return false;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    FILE *pfp = fdopen (fp->fd, mode);
+
+    if (pfp == NULL) return false;
+
+    fp->bfp = hc_bgzf_open (pfp);
+  }
+  else if (fp->is_gzip)
   {
     if ((fp->gfp = gzdopen (fp->fd, mode)) == NULL) return false;
   }
@@ -102,6 +559,14 @@ bool hc_fopen (HCFILE *fp, const char *path, char *mode)
 
     if (unzOpenCurrentFile (fp->ufp) != UNZ_OK) return false;
   }
+  else if (fp->is_xz)
+  {
+    FILE *pfp = fdopen (fp->fd, mode);
+
+    if (pfp == NULL) return false;
+
+    fp->xfp = hc_xz_open (pfp);
+  }
   else
   {
     if ((fp->pfp = fdopen (fp->fd, mode)) == NULL)  return false;
@@ -155,6 +620,10 @@ bool hc_fopen_nozip (HCFILE *fp, const char *path, char *mode)
   fp->pfp = NULL;
   fp->is_gzip = false;
   fp->is_zip = false;
+  fp->is_xz = false;
+  fp->is_bgzf = false;
+  fp->is_mmap = false;
+  fp->mmap_buf = NULL;
 
   if (fmode == -1)
   {
@@ -181,7 +650,11 @@ size_t hc_fread (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
 
   if (fp == NULL) return n;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    n = hc_bgzf_read (fp->bfp, ptr, size * nmemb) / size;
+  }
+  else if (fp->is_gzip)
   {
     n = gzfread (ptr, size, nmemb, fp->gfp);
   }
@@ -191,6 +664,20 @@ size_t hc_fread (void *ptr, size_t size, size_t nmemb, HCFILE *fp)
 
     n = unzReadCurrentFile (fp->ufp, ptr, s);
   }
+  else if (fp->is_xz)
+  {
+    n = hc_xz_read (fp->xfp, ptr, size * nmemb) / size;
+  }
+  else if (fp->is_mmap)
+  {
+    const u64 left = fp->mmap_len - fp->mmap_pos;
+
+    n = MIN ((u64) nmemb, left / size);
+
+    memcpy (ptr, fp->mmap_buf + fp->mmap_pos, n * size);
+
+    fp->mmap_pos += n * size;
+  }
   else
   {
     #if defined (_WIN)
@@ -245,13 +732,19 @@ size_t hc_fwrite (const void *ptr, size_t size, size_t nmemb, HCFILE *fp)
 
   if (fp == NULL) return n;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+  }
+  else if (fp->is_gzip)
   {
     n = gzfwrite (ptr, size, nmemb, fp->gfp);
   }
   else if (fp->is_zip)
   {
   }
+  else if (fp->is_xz)
+  {
+  }
   else
   {
     #if defined (_WIN)
@@ -306,7 +799,20 @@ int hc_fseek (HCFILE *fp, off_t offset, int whence)
 
   if (fp == NULL) return r;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    // emulated the same way as for xz
+
+    off_t base = 0;
+
+    if (whence == SEEK_CUR) base = (off_t) fp->bfp->offset;
+    if (whence == SEEK_END) return -1;
+
+    if (base + offset < 0) return -1;
+
+    r = hc_bgzf_seek (fp->bfp, (u64) (base + offset));
+  }
+  else if (fp->is_gzip)
   {
     r = gzseek (fp->gfp, offset, whence);
   }
@@ -331,6 +837,32 @@ int hc_fseek (HCFILE *fp, off_t offset, int whence)
     // r = unzSetOffset (fp->ufp, offset);
     */
   }
+  else if (fp->is_xz)
+  {
+    // emulated, backwards means decompressing from the start again
+
+    off_t base = 0;
+
+    if (whence == SEEK_CUR) base = (off_t) fp->xfp->offset;
+    if (whence == SEEK_END) return -1;
+
+    if (base + offset < 0) return -1;
+
+    r = hc_xz_seek (fp->xfp, (u64) (base + offset));
+  }
+  else if (fp->is_mmap)
+  {
+    off_t base = 0;
+
+    if (whence == SEEK_CUR) base = (off_t) fp->mmap_pos;
+    if (whence == SEEK_END) base = (off_t) fp->mmap_len;
+
+    if ((base + offset < 0) || ((u64) (base + offset) > fp->mmap_len)) return -1;
+
+    fp->mmap_pos = (u64) (base + offset);
+
+    r = 0;
+  }
   else
   {
     r = fseeko (fp->pfp, offset, whence);
@@ -343,7 +875,11 @@ void hc_rewind (HCFILE *fp)
 {
   if (fp == NULL) return;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    hc_bgzf_rewind (fp->bfp);
+  }
+  else if (fp->is_gzip)
   {
     gzrewind (fp->gfp);
   }
@@ -351,6 +887,14 @@ void hc_rewind (HCFILE *fp)
   {
     unzGoToFirstFile (fp->ufp);
   }
+  else if (fp->is_xz)
+  {
+    hc_xz_rewind (fp->xfp);
+  }
+  else if (fp->is_mmap)
+  {
+    fp->mmap_pos = 0;
+  }
   else
   {
     rewind (fp->pfp);
@@ -363,7 +907,11 @@ off_t hc_ftell (HCFILE *fp)
 
   if (fp == NULL) return -1;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    n = (off_t) fp->bfp->offset;
+  }
+  else if (fp->is_gzip)
   {
     n = (off_t) gztell (fp->gfp);
   }
@@ -371,6 +919,14 @@ off_t hc_ftell (HCFILE *fp)
   {
     n = unztell (fp->ufp);
   }
+  else if (fp->is_xz)
+  {
+    n = (off_t) fp->xfp->offset;
+  }
+  else if (fp->is_mmap)
+  {
+    n = (off_t) fp->mmap_pos;
+  }
   else
   {
     n = ftello (fp->pfp);
@@ -385,13 +941,19 @@ int hc_fputc (int c, HCFILE *fp)
 
   if (fp == NULL) return r;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+  }
+  else if (fp->is_gzip)
   {
     r = gzputc (fp->gfp, c);
   }
   else if (fp->is_zip)
   {
   }
+  else if (fp->is_xz)
+  {
+  }
   else
   {
     r = fputc (c, fp->pfp);
@@ -406,7 +968,11 @@ int hc_fgetc (HCFILE *fp)
 
   if (fp == NULL) return r;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    r = hc_bgzf_getc (fp->bfp);
+  }
+  else if (fp->is_gzip)
   {
     r = gzgetc (fp->gfp);
   }
@@ -416,6 +982,14 @@ int hc_fgetc (HCFILE *fp)
 
     if (unzReadCurrentFile (fp->ufp, &c, 1) == 1) r = (int) c;
   }
+  else if (fp->is_xz)
+  {
+    r = hc_xz_getc (fp->xfp);
+  }
+  else if (fp->is_mmap)
+  {
+    if (fp->mmap_pos < fp->mmap_len) r = (int) (unsigned char) fp->mmap_buf[fp->mmap_pos++];
+  }
   else
   {
     r = fgetc (fp->pfp);
@@ -430,7 +1004,29 @@ char *hc_fgets (char *buf, int len, HCFILE *fp)
 
   if (fp == NULL) return r;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    int n = 0;
+
+    while (n < len - 1)
+    {
+      const int c = hc_bgzf_getc (fp->bfp);
+
+      if (c == EOF) break;
+
+      buf[n++] = (char) c;
+
+      if (c == '\n') break;
+    }
+
+    if (n > 0)
+    {
+      buf[n] = 0;
+
+      r = buf;
+    }
+  }
+  else if (fp->is_gzip)
   {
     r = gzgets (fp->gfp, buf, len);
   }
@@ -438,6 +1034,49 @@ char *hc_fgets (char *buf, int len, HCFILE *fp)
   {
     if (unzReadCurrentFile (fp->ufp, buf, len) > 0) r = buf;
   }
+  else if (fp->is_xz)
+  {
+    int n = 0;
+
+    while (n < len - 1)
+    {
+      const int c = hc_xz_getc (fp->xfp);
+
+      if (c == EOF) break;
+
+      buf[n++] = (char) c;
+
+      if (c == '\n') break;
+    }
+
+    if (n > 0)
+    {
+      buf[n] = 0;
+
+      r = buf;
+    }
+  }
+  else if (fp->is_mmap)
+  {
+    if ((len > 0) && (fp->mmap_pos < fp->mmap_len))
+    {
+      const char *src = fp->mmap_buf + fp->mmap_pos;
+
+      const u64 left = MIN (fp->mmap_len - fp->mmap_pos, (u64) len - 1);
+
+      const char *nl = (const char *) memchr (src, '\n', left);
+
+      const u64 n = (nl == NULL) ? left : (u64) (nl - src) + 1;
+
+      memcpy (buf, src, n);
+
+      buf[n] = 0;
+
+      fp->mmap_pos += n;
+
+      r = buf;
+    }
+  }
   else
   {
     r = fgets (buf, len, fp->pfp);
@@ -452,13 +1091,19 @@ int hc_vfprintf (HCFILE *fp, const char *format, va_list ap)
 
   if (fp == NULL) return r;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+  }
+  else if (fp->is_gzip)
   {
     r = gzvprintf (fp->gfp, format, ap);
   }
   else if (fp->is_zip)
   {
   }
+  else if (fp->is_xz)
+  {
+  }
   else
   {
     r = vfprintf (fp->pfp, format, ap);
@@ -477,13 +1122,19 @@ int hc_fprintf (HCFILE *fp, const char *format, ...)
 
   va_start (ap, format);
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+  }
+  else if (fp->is_gzip)
   {
     r = gzvprintf (fp->gfp, format, ap);
   }
   else if (fp->is_zip)
   {
   }
+  else if (fp->is_xz)
+  {
+  }
   else
   {
     r = vfprintf (fp->pfp, format, ap);
@@ -531,14 +1182,28 @@ int hc_feof (HCFILE *fp)
 
   if (fp == NULL) return r;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    r = hc_bgzf_eof (fp->bfp);
+  }
+  else if (fp->is_gzip)
   {
-    r = gzeof (fp->gfp);
+    // zlib never reaches the end of a broken stream
+
+    r = gzeof (fp->gfp) || hc_gz_error (fp->gfp);
   }
   else if (fp->is_zip)
   {
     r = unzeof (fp->ufp);
   }
+  else if (fp->is_xz)
+  {
+    r = hc_xz_eof (fp->xfp);
+  }
+  else if (fp->is_mmap)
+  {
+    r = (fp->mmap_pos >= fp->mmap_len);
+  }
   else
   {
     r = feof (fp->pfp);
@@ -547,17 +1212,57 @@ int hc_feof (HCFILE *fp)
   return r;
 }
 
+int hc_ferror (HCFILE *fp)
+{
+  int r = -1;
+
+  if (fp == NULL) return r;
+
+  if (fp->is_bgzf)
+  {
+    r = hc_bgzf_error (fp->bfp);
+  }
+  else if (fp->is_gzip)
+  {
+    r = hc_gz_error (fp->gfp);
+  }
+  else if (fp->is_zip)
+  {
+    r = 0;
+  }
+  else if (fp->is_xz)
+  {
+    r = fp->xfp->err;
+  }
+  else if (fp->is_mmap)
+  {
+    r = 0;
+  }
+  else
+  {
+    r = ferror (fp->pfp);
+  }
+
+  return r;
+}
+
 void hc_fflush (HCFILE *fp)
 {
   if (fp == NULL) return;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+  }
+  else if (fp->is_gzip)
   {
     gzflush (fp->gfp, Z_SYNC_FLUSH);
   }
   else if (fp->is_zip)
   {
   }
+  else if (fp->is_xz)
+  {
+  }
   else
   {
     fflush (fp->pfp);
@@ -568,7 +1273,11 @@ void hc_fclose (HCFILE *fp)
 {
   if (fp == NULL) return;
 
-  if (fp->is_gzip)
+  if (fp->is_bgzf)
+  {
+    hc_bgzf_close (fp->bfp);
+  }
+  else if (fp->is_gzip)
   {
     gzclose (fp->gfp);
   }
@@ -578,8 +1287,16 @@ void hc_fclose (HCFILE *fp)
 
     unzClose (fp->ufp);
   }
+  else if (fp->is_xz)
+  {
+    hc_xz_close (fp->xfp);
+  }
   else
   {
+    #if defined (_POSIX)
+    if (fp->is_mmap) munmap (fp->mmap_buf, fp->mmap_len);
+    #endif
+
     fclose (fp->pfp);
   }
 
@@ -587,11 +1304,123 @@ void hc_fclose (HCFILE *fp)
   fp->pfp = NULL;
   fp->is_gzip = false;
   fp->is_zip = false;
+  fp->is_xz = false;
+  fp->is_bgzf = false;
+  fp->is_mmap = false;
+  fp->mmap_buf = NULL;
+  fp->xfp = NULL;
+  fp->bfp = NULL;
 
   fp->path = NULL;
   fp->mode = NULL;
 }
 
+bool hc_fmmap (HCFILE *fp)
+{
+  if (fp == NULL) return false;
+
+  if (fp->is_gzip || fp->is_zip || fp->is_xz || fp->is_mmap) return false;
+
+  if (strncmp (fp->mode, "r", 1) != 0) return false;
+
+  #if defined (_POSIX)
+  struct stat st;
+
+  if (fstat (fp->fd, &st) == -1) return false;
+
+  if (S_ISREG (st.st_mode) == 0) return false;
+
+  if (st.st_size <= 0) return false;
+
+  // private and writable, so the wordlist parsers can still modify lines in-place (hex decode, uppercase).
+  // only pages which are actually written get copied, all others are shared with the page cache
+
+  char *buf = (char *) mmap (NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fp->fd, 0);
+
+  if (buf == MAP_FAILED) return false;
+
+  madvise (buf, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+  // continue at the position the stream was at
+
+  const off_t pos = ftello (fp->pfp);
+
+  fp->mmap_buf = buf;
+  fp->mmap_len = (u64) st.st_size;
+  fp->mmap_pos = (pos > 0) ? MIN ((u64) pos, fp->mmap_len) : 0;
+  fp->mmap_seg = fp->mmap_pos;
+  fp->is_mmap  = true;
+
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+size_t hc_fmmap_next (HCFILE *fp, const size_t len, char **ptr)
+{
+  if (fp == NULL) return 0;
+
+  if (fp->is_mmap == false) return 0;
+
+  if (fp->mmap_pos >= fp->mmap_len) return 0;
+
+  if (len == 0) return 0;
+
+  #if defined (_POSIX)
+  // the previous segment is fully parsed by now, drop it from the mapping.
+  // otherwise all pages modified in-place (copy-on-write) would add up to the size of the wordlist
+
+  const u64 page_size = (u64) sysconf (_SC_PAGESIZE);
+
+  const u64 rel_beg = fp->mmap_seg - (fp->mmap_seg % page_size);
+  const u64 rel_end = fp->mmap_pos - (fp->mmap_pos % page_size);
+
+  if (rel_end > rel_beg) madvise (fp->mmap_buf + rel_beg, (size_t) (rel_end - rel_beg), MADV_DONTNEED);
+  #endif
+
+  fp->mmap_seg = fp->mmap_pos;
+
+  char *src = fp->mmap_buf + fp->mmap_pos;
+
+  const u64 left = fp->mmap_len - fp->mmap_pos;
+
+  u64 n = MIN ((u64) len, left);
+
+  // extend to the end of the line, a line never spans two segments
+
+  if ((n < left) && (src[n - 1] != '\n'))
+  {
+    const char *nl = (const char *) memchr (src + n, '\n', left - n);
+
+    n = (nl == NULL) ? left : (u64) (nl - src) + 1;
+  }
+
+  fp->mmap_pos += n;
+
+  *ptr = src;
+
+  return (size_t) n;
+}
+
+void hc_fmmap_release (HCFILE *fp, const u64 beg, const u64 end)
+{
+  if (fp == NULL) return;
+
+  if (fp->is_mmap == false) return;
+
+  #if defined (_POSIX)
+  // only pages entirely inside the range, the ones on the edges may still be in use by someone else
+
+  const u64 page_size = (u64) sysconf (_SC_PAGESIZE);
+
+  const u64 rel_beg = CEILDIV (beg, page_size) * page_size;
+  const u64 rel_end = MIN (end, fp->mmap_len) - (MIN (end, fp->mmap_len) % page_size);
+
+  if (rel_end > rel_beg) madvise (fp->mmap_buf + rel_beg, (size_t) (rel_end - rel_beg), MADV_DONTNEED);
+  #endif
+}
+
 size_t fgetl (HCFILE *fp, char *line_buf, const size_t line_sz)
 {
   size_t line_truncated = 0;
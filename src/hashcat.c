@@ -17,11 +17,13 @@
 // features
 
 #include "affinity.h"
+#include "autodetect.h"
 #include "autotune.h"
 #include "benchmark.h"
 #include "bitmap.h"
 #include "combinator.h"
 #include "cpt.h"
+#include "cracksink.h"
 #include "debugfile.h"
 #include "dictstat.h"
 #include "dispatch.h"
@@ -44,6 +46,7 @@
 #include "selftest.h"
 #include "status.h"
 #include "straight.h"
+#include "tunecache.h"
 #include "tuningdb.h"
 #include "user_options.h"
 #include "wordlist.h"
@@ -139,6 +142,12 @@ static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
     return 0;
   }
 
+  /**
+   * Load the combs file into memory once instead of reading it for each salt in run_cracker ()
+   */
+
+  if (combs_cache_update (hashcat_ctx) == -1) return -1;
+
   // restore stuff
 
   if (status_ctx->words_off > status_ctx->words_base)
@@ -335,6 +344,8 @@ static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
 
   if (user_options->loopback == true)
   {
+    cracksink_flush (hashcat_ctx);
+
     loopback_write_close (hashcat_ctx);
   }
 
@@ -780,6 +791,12 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx)
 
   if (potfile_write_open (hashcat_ctx) == -1) return -1;
 
+  /**
+   * cracked hashes are written to outfile, potfile and loopback file from a separate thread
+   */
+
+  if (cracksink_init (hashcat_ctx) == -1) return -1;
+
   /**
    * status and monitor threads
    */
@@ -860,6 +877,8 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx)
 
   // finalize potfile
 
+  cracksink_destroy (hashcat_ctx);
+
   potfile_write_close (hashcat_ctx);
 
   // finalize backend session
@@ -897,9 +916,12 @@ int hashcat_init (hashcat_ctx_t *hashcat_ctx, void (*event) (const u32, struct h
     hashcat_ctx->event = event;
   }
 
+  hc_xz_init ();
+
   hashcat_ctx->bitmap_ctx         = (bitmap_ctx_t *)          hcmalloc (sizeof (bitmap_ctx_t));
   hashcat_ctx->combinator_ctx     = (combinator_ctx_t *)      hcmalloc (sizeof (combinator_ctx_t));
   hashcat_ctx->cpt_ctx            = (cpt_ctx_t *)             hcmalloc (sizeof (cpt_ctx_t));
+  hashcat_ctx->cracksink_ctx      = (cracksink_ctx_t *)       hcmalloc (sizeof (cracksink_ctx_t));
   hashcat_ctx->debugfile_ctx      = (debugfile_ctx_t *)       hcmalloc (sizeof (debugfile_ctx_t));
   hashcat_ctx->dictstat_ctx       = (dictstat_ctx_t *)        hcmalloc (sizeof (dictstat_ctx_t));
   hashcat_ctx->event_ctx          = (event_ctx_t *)           hcmalloc (sizeof (event_ctx_t));
@@ -922,6 +944,7 @@ int hashcat_init (hashcat_ctx_t *hashcat_ctx, void (*event) (const u32, struct h
   hashcat_ctx->status_ctx         = (status_ctx_t *)          hcmalloc (sizeof (status_ctx_t));
   hashcat_ctx->straight_ctx       = (straight_ctx_t *)        hcmalloc (sizeof (straight_ctx_t));
   hashcat_ctx->tuning_db          = (tuning_db_t *)           hcmalloc (sizeof (tuning_db_t));
+  hashcat_ctx->tunecache_ctx      = (tunecache_ctx_t *)       hcmalloc (sizeof (tunecache_ctx_t));
   hashcat_ctx->user_options_extra = (user_options_extra_t *)  hcmalloc (sizeof (user_options_extra_t));
   hashcat_ctx->user_options       = (user_options_t *)        hcmalloc (sizeof (user_options_t));
   hashcat_ctx->wl_data            = (wl_data_t *)             hcmalloc (sizeof (wl_data_t));
@@ -934,6 +957,7 @@ void hashcat_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (hashcat_ctx->bitmap_ctx);
   hcfree (hashcat_ctx->combinator_ctx);
   hcfree (hashcat_ctx->cpt_ctx);
+  hcfree (hashcat_ctx->cracksink_ctx);
   hcfree (hashcat_ctx->debugfile_ctx);
   hcfree (hashcat_ctx->dictstat_ctx);
   hcfree (hashcat_ctx->event_ctx);
@@ -956,6 +980,7 @@ void hashcat_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (hashcat_ctx->status_ctx);
   hcfree (hashcat_ctx->straight_ctx);
   hcfree (hashcat_ctx->tuning_db);
+  hcfree (hashcat_ctx->tunecache_ctx);
   hcfree (hashcat_ctx->user_options_extra);
   hcfree (hashcat_ctx->user_options);
   hcfree (hashcat_ctx->wl_data);
@@ -1099,6 +1124,12 @@ int hashcat_session_init (hashcat_ctx_t *hashcat_ctx, const char *install_folder
 
   if (dictstat_init (hashcat_ctx) == -1) return -1;
 
+  /**
+   * autotune cache init
+   */
+
+  if (tunecache_init (hashcat_ctx) == -1) return -1;
+
   /**
    * loopback init
    */
@@ -1350,6 +1381,33 @@ bool autodetect_hashmode_test (hashcat_ctx_t *hashcat_ctx)
   return success;
 }
 
+static void autodetect_hashmode_try (hashcat_ctx_t *hashcat_ctx, const u32 hash_mode, usage_sort_t *usage_sort_buf, int *usage_sort_cnt)
+{
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  user_options->hash_mode = hash_mode;
+
+  const int hashconfig_init_rc = hashconfig_init (hashcat_ctx);
+
+  if (hashconfig_init_rc == 0)
+  {
+    const bool test_rc = autodetect_hashmode_test (hashcat_ctx);
+
+    if (test_rc == true)
+    {
+      usage_sort_buf[*usage_sort_cnt].hash_mode     = hashcat_ctx->hashconfig->hash_mode;
+      usage_sort_buf[*usage_sort_cnt].hash_name     = hcstrdup (hashcat_ctx->hashconfig->hash_name);
+      usage_sort_buf[*usage_sort_cnt].hash_category = hashcat_ctx->hashconfig->hash_category;
+
+      *usage_sort_cnt += 1;
+    }
+  }
+
+  // clean up
+
+  hashconfig_destroy (hashcat_ctx);
+}
+
 int autodetect_hashmodes (hashcat_ctx_t *hashcat_ctx, usage_sort_t *usage_sort_buf)
 {
   folder_config_t *folder_config = hashcat_ctx->folder_config;
@@ -1363,46 +1421,69 @@ int autodetect_hashmodes (hashcat_ctx_t *hashcat_ctx, usage_sort_t *usage_sort_b
 
   user_options->quiet = true;
 
-  char *modulefile = (char *) hcmalloc (HCBUFSIZ_TINY);
-
-  if (modulefile == NULL) return -1;
+  autodetect_index_t autodetect_index;
 
-  // brute force all the modes
-
-  for (int i = 0; i < MODULE_HASH_MODES_MAXIMUM; i++)
+  if (autodetect_index_init (hashcat_ctx, &autodetect_index) == 0)
   {
-    user_options->hash_mode = i;
+    // only load the plugins whose tokenizer layout can accept the input
+
+    bool *selected = (bool *) hccalloc (MODULE_HASH_MODES_MAXIMUM, sizeof (bool));
 
-    // this is just to find out of that hash-mode exists or not
+    autodetect_index_select (hashcat_ctx, &autodetect_index, selected);
 
-    module_filename (folder_config, i, modulefile, HCBUFSIZ_TINY);
+    for (u32 i = 0; i < autodetect_index.entries_cnt; i++)
+    {
+      const autodetect_entry_t *entry = autodetect_index.entries + i;
 
-    if (hc_path_exist (modulefile) == false) continue;
+      if (selected[entry->hash_mode] == false) continue;
 
-    // we know it exists, so load the plugin
+      autodetect_hashmode_try (hashcat_ctx, entry->hash_mode, usage_sort_buf, &usage_sort_cnt);
+    }
 
-    const int hashconfig_init_rc = hashconfig_init (hashcat_ctx);
+    // the index knows the one layout a module used for its self-test hash
+    // a few modules switch between layouts depending on the input, give them a chance before giving up
 
-    if (hashconfig_init_rc == 0)
+    if (usage_sort_cnt == 0)
     {
-      const bool test_rc = autodetect_hashmode_test (hashcat_ctx);
-
-      if (test_rc == true)
+      for (u32 i = 0; i < autodetect_index.entries_cnt; i++)
       {
-        usage_sort_buf[usage_sort_cnt].hash_mode     = hashcat_ctx->hashconfig->hash_mode;
-        usage_sort_buf[usage_sort_cnt].hash_name     = hcstrdup (hashcat_ctx->hashconfig->hash_name);
-        usage_sort_buf[usage_sort_cnt].hash_category = hashcat_ctx->hashconfig->hash_category;
+        const autodetect_entry_t *entry = autodetect_index.entries + i;
+
+        if (selected[entry->hash_mode] == true) continue;
+
+        if (entry->flags & AUTODETECT_ENTRY_SKIP) continue;
 
-        usage_sort_cnt++;
+        autodetect_hashmode_try (hashcat_ctx, entry->hash_mode, usage_sort_buf, &usage_sort_cnt);
       }
     }
 
-    // clean up
+    hcfree (selected);
 
-    hashconfig_destroy (hashcat_ctx);
+    autodetect_index_destroy (&autodetect_index);
   }
+  else
+  {
+    char *modulefile = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+    if (modulefile == NULL) return -1;
 
-  hcfree (modulefile);
+    // brute force all the modes
+
+    for (int i = 0; i < MODULE_HASH_MODES_MAXIMUM; i++)
+    {
+      // this is just to find out of that hash-mode exists or not
+
+      module_filename (folder_config, i, modulefile, HCBUFSIZ_TINY);
+
+      if (hc_path_exist (modulefile) == false) continue;
+
+      // we know it exists, so load the plugin
+
+      autodetect_hashmode_try (hashcat_ctx, i, usage_sort_buf, &usage_sort_cnt);
+    }
+
+    hcfree (modulefile);
+  }
 
   qsort (usage_sort_buf, usage_sort_cnt, sizeof (usage_sort_t), sort_by_usage);
 
@@ -1443,6 +1524,10 @@ int hashcat_session_execute (hashcat_ctx_t *hashcat_ctx)
 
   dictstat_read (hashcat_ctx);
 
+  // read autotune results of earlier sessions
+
+  tunecache_read (hashcat_ctx);
+
   // autodetect
 
   if (user_options->autodetect == true)
@@ -1559,6 +1644,10 @@ int hashcat_session_execute (hashcat_ctx_t *hashcat_ctx)
 
   dictstat_write (hashcat_ctx);
 
+  // final update autotune cache
+
+  tunecache_write (hashcat_ctx);
+
   // final logfile entry
 
   const time_t proc_stop = time (NULL);
@@ -1655,6 +1744,7 @@ int hashcat_session_destroy (hashcat_ctx_t *hashcat_ctx)
   potfile_destroy             (hashcat_ctx);
   restore_ctx_destroy         (hashcat_ctx);
   tuning_db_destroy           (hashcat_ctx);
+  tunecache_destroy           (hashcat_ctx);
   user_options_destroy        (hashcat_ctx);
   user_options_extra_destroy  (hashcat_ctx);
   status_ctx_destroy          (hashcat_ctx);
@@ -8,6 +8,7 @@
 #include "memory.h"
 #include "event.h"
 #include "convert.h"
+#include "cracksink.h"
 #include "debugfile.h"
 #include "filehandling.h"
 #include "hlfmt.h"
@@ -307,6 +308,7 @@ void check_hash (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, pl
   const hashconfig_t    *hashconfig    = hashcat_ctx->hashconfig;
   const loopback_ctx_t  *loopback_ctx  = hashcat_ctx->loopback_ctx;
   const module_ctx_t    *module_ctx    = hashcat_ctx->module_ctx;
+  const outfile_ctx_t   *outfile_ctx   = hashcat_ctx->outfile_ctx;
 
   const u32 salt_pos    = plain->salt_pos;
   const u32 digest_pos  = plain->digest_pos;  // relative
@@ -326,6 +328,11 @@ void check_hash (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, pl
     {
       hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, plain->gidvid * hashconfig->tmp_size, hashconfig->tmp_size, tmps, 0, NULL, NULL);
     }
+
+    if (device_param->is_native == true)
+    {
+      memcpy (tmps, (const u8 *) device_param->native_d_tmps + (plain->gidvid * hashconfig->tmp_size), hashconfig->tmp_size);
+    }
   }
 
   // hash
@@ -381,20 +388,24 @@ void check_hash (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, pl
   build_debugdata (hashcat_ctx, device_param, plain, debug_rule_buf, &debug_rule_len, debug_plain_ptr, &debug_plain_len);
 
   // outfile, can be either to file or stdout
-  // if an error occurs opening the file, send to stdout as fallback
-  // the fp gets opened for each cracked hash so that the user can modify (move) the outfile while hashcat runs
-
-  outfile_write_open (hashcat_ctx);
+  // the line is only formatted here, the crack sink writes it to the outfile in batches
 
   u8 *tmp_buf = hashes->tmp_buf;
 
   tmp_buf[0] = 0;
 
-  const int tmp_len = outfile_write (hashcat_ctx, (char *) out_buf, out_len, plain_ptr, plain_len, crackpos, NULL, 0, true, (char *) tmp_buf);
+  int tmp_len = outfile_write (hashcat_ctx, (char *) out_buf, out_len, plain_ptr, plain_len, crackpos, NULL, 0, true, (char *) tmp_buf);
 
   EVENT_DATA (EVENT_CRACKER_HASH_CRACKED, tmp_buf, tmp_len);
 
-  outfile_write_close (hashcat_ctx);
+  if (outfile_ctx->filename != NULL)
+  {
+    memcpy (tmp_buf + tmp_len, EOL, strlen (EOL));
+
+    tmp_len += strlen (EOL);
+
+    cracksink_push (hashcat_ctx, CRACKSINK_OUTFILE, tmp_buf, tmp_len);
+  }
 
   // potfile
   // we can have either used-defined hooks or reuse the same format as input format
@@ -497,6 +508,11 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
     if (CL_rc == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    memcpy (&num_cracked, device_param->native_d_result, sizeof (u32));
+  }
+
   if (user_options->speed_only == true)
   {
     // we want the hc_clEnqueueReadBuffer to run in benchmark mode because it has an influence in performance
@@ -523,6 +539,11 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
       if (CL_rc == -1) return -1;
     }
 
+    if (device_param->is_native == true)
+    {
+      memcpy (cracked, device_param->native_d_plain_bufs, num_cracked * sizeof (plain_t));
+    }
+
     u32 cpt_cracked = 0;
 
     hc_thread_mutex_lock (status_ctx->mux_display);
@@ -579,11 +600,20 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
           if (CL_rc == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          memcpy ((u32 *) device_param->native_d_digests_shown + salt_buf->digests_offset, &hashes->digests_shown_tmp[salt_buf->digests_offset], salt_buf->digests_cnt * sizeof (u32));
+        }
       }
     }
 
     hc_thread_mutex_unlock (status_ctx->mux_display);
 
+    // hand the batch of this check over to the writer thread
+
+    cracksink_commit (hashcat_ctx);
+
     hcfree (cracked);
 
     if (cpt_cracked > 0)
@@ -617,6 +647,11 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
       if (CL_rc == -1) return -1;
     }
+
+    if (device_param->is_native == true)
+    {
+      memcpy (device_param->native_d_result, &num_cracked, sizeof (u32));
+    }
   }
 
   return 0;
@@ -662,21 +697,580 @@ int hashes_init_filename (hashcat_ctx_t *hashcat_ctx)
           return -1;
         }
 
-        hashes->hashfile = user_options_extra->hc_hash;
-      }
+        hashes->hashfile = user_options_extra->hc_hash;
+      }
+    }
+  }
+  else
+  {
+    hashes->hashlist_mode = (hc_path_exist (user_options_extra->hc_hash) == true) ? HL_MODE_FILE_PLAIN : HL_MODE_ARG;
+
+    if (hashes->hashlist_mode == HL_MODE_FILE_PLAIN)
+    {
+      hashes->hashfile = user_options_extra->hc_hash;
+    }
+  }
+
+  return 0;
+}
+
+static int sort_by_hash_key (const void *v1, const void *v2)
+{
+  const hash_key_t *k1 = (const hash_key_t *) v1;
+  const hash_key_t *k2 = (const hash_key_t *) v2;
+
+  for (int i = 0; i < 4; i++)
+  {
+    if (k1->key[i] > k2->key[i]) return  1;
+    if (k1->key[i] < k2->key[i]) return -1;
+  }
+
+  // equal digests keep their hash list order, so the deduplication keeps the first of them
+
+  if (k1->idx > k2->idx) return  1;
+  if (k1->idx < k2->idx) return -1;
+
+  return 0;
+}
+
+static void *thread_hashes_sort (void *p)
+{
+  hashes_sort_thread_param_t *param = (hashes_sort_thread_param_t *) p;
+
+  hashes_sort_t *sort = param->sort;
+
+  for (u32 bucket = param->bucket_beg; bucket < param->bucket_end; bucket++)
+  {
+    const u64 beg = sort->buckets[bucket];
+    const u64 end = sort->buckets[bucket + 1];
+
+    if ((end - beg) < 2) continue;
+
+    if (sort->keys != NULL)
+    {
+      qsort (sort->keys + beg, end - beg, sizeof (hash_key_t), sort_by_hash_key);
+    }
+    else
+    {
+      hc_qsort_r (sort->digests + (beg * sort->dgst_size), end - beg, sort->dgst_size, sort_by_digest_p0p1, (void *) sort->hashconfig);
+    }
+  }
+
+  return NULL;
+}
+
+// sort_by_digest_p0p1 () compares dgst_pos3 .. dgst_pos0, partition by the 16 most significant bits which actually differ
+// key words equal in all hashes do not help, some hash-modes leave parts of the digest zero
+
+static void hashes_sort_partition (hashes_sort_t *sort, const u32 *dgst_pos, const u8 *digests, const u32 dgst_size, const u32 hashes_cnt)
+{
+  const u32 *first = (const u32 *) digests;
+
+  for (sort->word = 0; sort->word < 4; sort->word++)
+  {
+    const u32 pos = dgst_pos[sort->word];
+
+    u32 diff = 0;
+
+    for (u32 i = 1; i < hashes_cnt; i++)
+    {
+      const u32 *digest = (const u32 *) (digests + ((u64) i * dgst_size));
+
+      diff |= digest[pos] ^ first[pos];
+    }
+
+    if (diff == 0) continue;
+
+    const int msb = 31 - __builtin_clz (diff);
+
+    sort->shift = (msb > 15) ? (u32) (msb - 15) : 0;
+
+    return;
+  }
+
+  sort->word  = 3; // all digests are the same
+  sort->shift = 0;
+}
+
+static void hashes_sort_buckets (hashes_sort_t *sort, const u32 hashes_cnt)
+{
+  // buckets are independent of each other, each thread gets about the same number of hashes
+
+  int threads_cnt = MAX (hc_get_processor_count (), 1);
+
+  if (hashes_cnt < HASHES_SORT_THREADED_MIN) threads_cnt = 1;
+
+  hc_thread_t                *threads       = (hc_thread_t *)                hccalloc (threads_cnt, sizeof (hc_thread_t));
+  hashes_sort_thread_param_t *threads_param = (hashes_sort_thread_param_t *) hccalloc (threads_cnt, sizeof (hashes_sort_thread_param_t));
+
+  u32 bucket = 0;
+
+  for (int tid = 0; tid < threads_cnt; tid++)
+  {
+    const u64 limit = ((u64) hashes_cnt * (tid + 1)) / threads_cnt;
+
+    threads_param[tid].sort       = sort;
+    threads_param[tid].bucket_beg = bucket;
+
+    while ((bucket < HASHES_SORT_BUCKETS) && (sort->buckets[bucket] < limit)) bucket++;
+
+    if (tid == (threads_cnt - 1)) bucket = HASHES_SORT_BUCKETS;
+
+    threads_param[tid].bucket_end = bucket;
+  }
+
+  if (threads_cnt > 1)
+  {
+    for (int tid = 0; tid < threads_cnt; tid++)
+    {
+      hc_thread_create (threads[tid], thread_hashes_sort, &threads_param[tid]);
+    }
+
+    hc_thread_wait (threads_cnt, threads);
+  }
+  else
+  {
+    thread_hashes_sort (&threads_param[0]);
+  }
+
+  hcfree (threads_param);
+  hcfree (threads);
+}
+
+static void hashes_sort_no_salt (hashcat_ctx_t *hashcat_ctx, hash_t *hashes_buf, const u32 hashes_cnt)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+
+  // same order as sort_by_hash_no_salt (), but the digest words get copied into a flat array first,
+  // so neither the partitioning nor the comparisons have to follow the digest pointers of hash_t
+
+  const u32 dgst_pos[4] = { hashconfig->dgst_pos3, hashconfig->dgst_pos2, hashconfig->dgst_pos1, hashconfig->dgst_pos0 };
+
+  hashes_sort_t sort;
+
+  memset (&sort, 0, sizeof (hashes_sort_t));
+
+  hash_key_t *keys = (hash_key_t *) hcmalloc ((size_t) hashes_cnt * sizeof (hash_key_t));
+
+  for (u32 i = 0; i < hashes_cnt; i++)
+  {
+    const u32 *digest = (const u32 *) hashes_buf[i].digest;
+
+    keys[i].key[0] = digest[dgst_pos[0]];
+    keys[i].key[1] = digest[dgst_pos[1]];
+    keys[i].key[2] = digest[dgst_pos[2]];
+    keys[i].key[3] = digest[dgst_pos[3]];
+    keys[i].idx    = i;
+  }
+
+  const u32 key_pos[4] = { 0, 1, 2, 3 };
+
+  hashes_sort_partition (&sort, key_pos, (const u8 *) keys, sizeof (hash_key_t), hashes_cnt);
+
+  sort.buckets = (u64 *) hccalloc (HASHES_SORT_BUCKETS + 1, sizeof (u64));
+
+  for (u32 i = 0; i < hashes_cnt; i++)
+  {
+    const u32 bucket = (keys[i].key[sort.word] >> sort.shift) & (HASHES_SORT_BUCKETS - 1);
+
+    sort.buckets[bucket + 1]++;
+  }
+
+  for (u32 bucket = 0; bucket < HASHES_SORT_BUCKETS; bucket++)
+  {
+    sort.buckets[bucket + 1] += sort.buckets[bucket];
+  }
+
+  u64 *fill = (u64 *) hcmalloc (HASHES_SORT_BUCKETS * sizeof (u64));
+
+  memcpy (fill, sort.buckets, HASHES_SORT_BUCKETS * sizeof (u64));
+
+  sort.keys = (hash_key_t *) hcmalloc ((size_t) hashes_cnt * sizeof (hash_key_t));
+
+  for (u32 i = 0; i < hashes_cnt; i++)
+  {
+    const u32 bucket = (keys[i].key[sort.word] >> sort.shift) & (HASHES_SORT_BUCKETS - 1);
+
+    sort.keys[fill[bucket]++] = keys[i];
+  }
+
+  hcfree (fill);
+  hcfree (keys);
+
+  hashes_sort_buckets (&sort, hashes_cnt);
+
+  // apply the permutation in place by following its cycles, a second hash_t array would cost more than the keys
+
+  for (u32 i = 0; i < hashes_cnt; i++)
+  {
+    if (sort.keys[i].idx == i) continue;
+
+    const hash_t tmp = hashes_buf[i];
+
+    u32 dst = i;
+
+    while (true)
+    {
+      const u32 src = sort.keys[dst].idx;
+
+      sort.keys[dst].idx = dst;
+
+      if (src == i)
+      {
+        hashes_buf[dst] = tmp;
+
+        break;
+      }
+
+      hashes_buf[dst] = hashes_buf[src];
+
+      dst = src;
+    }
+  }
+
+  hcfree (sort.keys);
+  hcfree (sort.buckets);
+}
+
+static u8 *hashes_sort_digests (hashcat_ctx_t *hashcat_ctx, u8 *digests_buf, const u32 hashes_cnt)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+
+  // lean mode, the packed digests are the only copy, they are partitioned into a new array and sorted in there
+  // the old array is returned to the caller
+
+  const u32 dgst_pos[4] = { hashconfig->dgst_pos3, hashconfig->dgst_pos2, hashconfig->dgst_pos1, hashconfig->dgst_pos0 };
+
+  const u32 dgst_size = hashconfig->dgst_size;
+
+  hashes_sort_t sort;
+
+  memset (&sort, 0, sizeof (hashes_sort_t));
+
+  sort.dgst_size  = dgst_size;
+  sort.hashconfig = hashconfig;
+
+  hashes_sort_partition (&sort, dgst_pos, digests_buf, dgst_size, hashes_cnt);
+
+  const u32 pos = dgst_pos[sort.word];
+
+  sort.buckets = (u64 *) hccalloc (HASHES_SORT_BUCKETS + 1, sizeof (u64));
+
+  for (u32 i = 0; i < hashes_cnt; i++)
+  {
+    const u32 *digest = (const u32 *) (digests_buf + ((u64) i * dgst_size));
+
+    const u32 bucket = (digest[pos] >> sort.shift) & (HASHES_SORT_BUCKETS - 1);
+
+    sort.buckets[bucket + 1]++;
+  }
+
+  for (u32 bucket = 0; bucket < HASHES_SORT_BUCKETS; bucket++)
+  {
+    sort.buckets[bucket + 1] += sort.buckets[bucket];
+  }
+
+  u64 *fill = (u64 *) hcmalloc (HASHES_SORT_BUCKETS * sizeof (u64));
+
+  memcpy (fill, sort.buckets, HASHES_SORT_BUCKETS * sizeof (u64));
+
+  sort.digests = (u8 *) hcmalloc ((size_t) hashes_cnt * dgst_size);
+
+  for (u32 i = 0; i < hashes_cnt; i++)
+  {
+    const u32 *digest = (const u32 *) (digests_buf + ((u64) i * dgst_size));
+
+    const u32 bucket = (digest[pos] >> sort.shift) & (HASHES_SORT_BUCKETS - 1);
+
+    memcpy (sort.digests + (fill[bucket]++ * dgst_size), digest, dgst_size);
+  }
+
+  hcfree (fill);
+
+  hashes_sort_buckets (&sort, hashes_cnt);
+
+  hcfree (sort.buckets);
+
+  return sort.digests;
+}
+
+static hash_t *hashlist_parse_slot (const hashes_t *hashes, const hashlist_parse_batch_t *batch, const u32 hashes_pos)
+{
+  // in lean mode there is no hashes_buf, the batch brings its own hash_t views onto digests_buf
+
+  if (hashes->lean == true) return &batch->views[hashes_pos - batch->views_base];
+
+  return &hashes->hashes_buf[hashes_pos];
+}
+
+static void hashlist_parse_line (hashcat_ctx_t *hashcat_ctx, hashlist_parse_batch_t *batch, hashlist_parse_line_t *line)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const hashes_t       *hashes       = hashcat_ctx->hashes;
+  const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  line->hash_buf      = NULL;
+  line->hash_len      = 0;
+  line->user_buf      = NULL;
+  line->user_len      = 0;
+  line->hashes_parsed = 0;
+  line->parser_status = PARSER_OK;
+  line->fmt_error     = false;
+  line->split_origin  = SPLIT_ORIGIN_NONE;
+
+  hlfmt_hash (hashcat_ctx, batch->hashlist_format, line->line_buf, line->line_len, &line->hash_buf, &line->hash_len);
+
+  if ((line->hash_len < 1) || (line->hash_buf == NULL))
+  {
+    line->fmt_error = true;
+
+    return;
+  }
+
+  if (user_options->username == true)
+  {
+    hlfmt_user (hashcat_ctx, batch->hashlist_format, line->line_buf, line->line_len, &line->user_buf, &line->user_len);
+  }
+
+  // the pwdump format carries both halves of a split hash in one line
+
+  int slices = 1;
+
+  if ((hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) && (line->hash_len == 32))
+  {
+    slices = 2;
+
+    line->split_origin = SPLIT_ORIGIN_LEFT;
+  }
+
+  for (int slice = 0; slice < slices; slice++)
+  {
+    hash_t *hash = hashlist_parse_slot (hashes, batch, line->hashes_pos + slice);
+
+    if (hashconfig->is_salted == true)
+    {
+      const u32 orig_pos = hash->salt->orig_pos;
+
+      memset (hash->salt, 0, sizeof (salt_t));
+
+      hash->salt->orig_pos = orig_pos;
+    }
+
+    if (hashconfig->esalt_size > 0)
+    {
+      memset (hash->esalt, 0, hashconfig->esalt_size);
+    }
+
+    if (hashconfig->hook_salt_size > 0)
+    {
+      memset (hash->hook_salt, 0, hashconfig->hook_salt_size);
+    }
+
+    const char *hash_buf = (slices == 2) ? line->hash_buf + (slice * 16) : line->hash_buf;
+    const int   hash_len = (slices == 2) ? 16 : line->hash_len;
+
+    const int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
+
+    if (parser_status < PARSER_GLOBAL_ZERO)
+    {
+      line->parser_status = parser_status;
+
+      break;
+    }
+
+    line->hashes_parsed++;
+  }
+}
+
+static void *thread_hashlist_parse (void *p)
+{
+  hashlist_parse_thread_param_t *param = (hashlist_parse_thread_param_t *) p;
+
+  hashlist_parse_batch_t *batch = param->batch;
+
+  // contiguous ranges, neighbouring lines share cache lines in the slot arrays
+
+  const u32 line_beg = (u32) (((u64) batch->lines_cnt * (param->tid + 0)) / batch->threads_used);
+  const u32 line_end = (u32) (((u64) batch->lines_cnt * (param->tid + 1)) / batch->threads_used);
+
+  for (u32 line_idx = line_beg; line_idx < line_end; line_idx++)
+  {
+    hashlist_parse_line (param->hashcat_ctx, batch, &batch->lines[line_idx]);
+  }
+
+  return NULL;
+}
+
+static void hashlist_parse_warning (hashcat_ctx_t *hashcat_ctx, const hashlist_parse_line_t *line)
+{
+  const hashes_t       *hashes       = hashcat_ctx->hashes;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  char *tmp_line_buf;
+
+  hc_asprintf (&tmp_line_buf, "%s", line->line_buf);
+
+  compress_terminal_line_length (tmp_line_buf, 38, 32);
+
+  if (user_options->machine_readable == true)
+  {
+    event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line->line_num, tmp_line_buf, strparser (line->parser_status));
+  }
+  else
+  {
+    event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line->line_num, tmp_line_buf, strparser (line->parser_status));
+  }
+
+  hcfree (tmp_line_buf);
+}
+
+static u32 hashlist_parse_commit (hashcat_ctx_t *hashcat_ctx, const hashlist_parse_line_t *line, u32 hashes_cnt)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+        hashes_t       *hashes       = hashcat_ctx->hashes;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  hash_t *hashes_buf = hashes->hashes_buf;
+
+  if (line->fmt_error == true)
+  {
+    event_log_warning (hashcat_ctx, "Failed to parse hashes using the '%s' format.", strhlfmt (hashes->hashlist_format));
+
+    return hashes_cnt;
+  }
+
+  if (hashes->lean == true)
+  {
+    // only the digest exists, lean mode rules out split formats, so there is at most one
+
+    if (line->hashes_parsed == 1)
+    {
+      if (line->hashes_pos != hashes_cnt)
+      {
+        u8 *digests_buf = (u8 *) hashes->digests_buf;
+
+        memcpy (digests_buf + ((u64) hashes_cnt * hashconfig->dgst_size), digests_buf + ((u64) line->hashes_pos * hashconfig->dgst_size), hashconfig->dgst_size);
+      }
+
+      hashes_cnt++;
+    }
+
+    if (line->parser_status < PARSER_GLOBAL_ZERO)
+    {
+      hashlist_parse_warning (hashcat_ctx, line);
+    }
+
+    return hashes_cnt;
+  }
+
+  // the user name is stored once per line, both halves of a split hash point to it
+
+  char *user_name = NULL;
+
+  if ((user_options->username == true) && (line->hashes_parsed > 0))
+  {
+    if (line->user_buf != NULL)
+    {
+      user_name = hcarena_strndup (&hashes->hash_info_arena, line->user_buf, line->user_len);
+    }
+    else
+    {
+      user_name = hcarena_strdup (&hashes->hash_info_arena, "");
+    }
+  }
+
+  for (int slice = 0; slice < line->hashes_parsed; slice++)
+  {
+    const u32 src = line->hashes_pos + slice;
+    const u32 dst = hashes_cnt;
+
+    // slots always move down, everything in front of src either got committed already or failed to parse
+
+    if (src != dst)
+    {
+      hash_t tmp = hashes_buf[dst];
+
+      hashes_buf[dst] = hashes_buf[src];
+      hashes_buf[src] = tmp;
+
+      hashes_buf[src].orig_line_pos = src;
+      hashes_buf[dst].orig_line_pos = dst;
+
+      if (hashconfig->is_salted == true)
+      {
+        const u32 orig_pos = hashes_buf[src].salt->orig_pos;
+
+        hashes_buf[src].salt->orig_pos = hashes_buf[dst].salt->orig_pos;
+        hashes_buf[dst].salt->orig_pos = orig_pos;
+      }
+    }
+
+    hashinfo_t *hash_info = hashes_buf[dst].hash_info;
+
+    if (user_options->username == true)
+    {
+      hash_info->user->user_name = user_name;
+      hash_info->user->user_len  = (u32) line->user_len;
+    }
+
+    if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
+    {
+      hash_info->orighash = hcarena_strdup (&hashes->hash_info_arena, line->hash_buf);
     }
-  }
-  else
-  {
-    hashes->hashlist_mode = (hc_path_exist (user_options_extra->hc_hash) == true) ? HL_MODE_FILE_PLAIN : HL_MODE_ARG;
 
-    if (hashes->hashlist_mode == HL_MODE_FILE_PLAIN)
+    if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
     {
-      hashes->hashfile = user_options_extra->hc_hash;
+      hash_info->split->split_group  = line->line_num;
+      hash_info->split->split_origin = (line->split_origin == SPLIT_ORIGIN_NONE) ? SPLIT_ORIGIN_NONE : ((slice == 0) ? SPLIT_ORIGIN_LEFT : SPLIT_ORIGIN_RIGHT);
     }
+
+    hashes_cnt++;
   }
 
-  return 0;
+  if (line->parser_status < PARSER_GLOBAL_ZERO)
+  {
+    hashlist_parse_warning (hashcat_ctx, line);
+  }
+
+  return hashes_cnt;
+}
+
+static bool hashes_lean_possible (hashcat_ctx_t *hashcat_ctx)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const hashes_t       *hashes       = hashcat_ctx->hashes;
+  const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  // plain unsalted hash lists need nothing but the digests, everything else still needs a hash_t per hash
+
+  if (hashes->hashlist_mode != HL_MODE_FILE_PLAIN) return false;
+
+  if (hashconfig->is_salted == true) return false;
+
+  if (hashconfig->esalt_size     > 0) return false;
+  if (hashconfig->hook_salt_size > 0) return false;
+
+  if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)  return false;
+  if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) return false;
+
+  if (hashconfig->potfile_keep_all_hashes == true) return false;
+
+  if (module_ctx->module_hash_decode_potfile  != MODULE_DEFAULT) return false;
+  if (module_ctx->module_potfile_custom_check != MODULE_DEFAULT) return false;
+
+  if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION) return false;
+
+  if (user_options->benchmark   == true) return false;
+  if (user_options->hash_info   == true) return false;
+  if (user_options->keyspace    == true) return false;
+  if (user_options->left        == true) return false;
+  if (user_options->show        == true) return false;
+  if (user_options->stdout_flag == true) return false;
+  if (user_options->username    == true) return false;
+
+  return true;
 }
 
 int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
@@ -796,42 +1390,56 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
 
   hashes->hashlist_format = hashlist_format;
 
+  hashes->lean = hashes_lean_possible (hashcat_ctx);
+
   /**
    * load hashes, part II: allocate required memory, set pointers
    */
 
-  hash_t *hashes_buf     = (hash_t *) hccalloc (hashes_avail, sizeof (hash_t));
+  hash_t *hashes_buf     = (hashes->lean == true) ? NULL : (hash_t *) hccalloc (hashes_avail, sizeof (hash_t));
   void   *digests_buf    =            hccalloc (hashes_avail, hashconfig->dgst_size);
   salt_t *salts_buf      = NULL;
   void   *esalts_buf     = NULL;
   void   *hook_salts_buf = NULL;
 
+  // all per-hash metadata and the strings it points to are released together in hashes_destroy ()
+
+  arena_t *hash_info_arena = &hashes->hash_info_arena;
+
+  hcarena_init (hash_info_arena, 4 * 1024 * 1024);
+
   if ((user_options->username == true) || (hashconfig->opts_type & OPTS_TYPE_HASH_COPY) || (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT))
   {
+    // hashes which are not parsed (yet) still need a valid orighash
+
+    char *orighash_empty = NULL;
+
+    if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
+    {
+      if (user_options->benchmark == false)
+      {
+        orighash_empty = hcarena_strdup (hash_info_arena, "");
+      }
+    }
+
     u64 hash_pos;
 
     for (hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
     {
-      hashinfo_t *hash_info = (hashinfo_t *) hcmalloc (sizeof (hashinfo_t));
+      hashinfo_t *hash_info = (hashinfo_t *) hcarena_alloc (hash_info_arena, sizeof (hashinfo_t));
 
       hashes_buf[hash_pos].hash_info = hash_info;
 
       if (user_options->username == true)
       {
-        hash_info->user = (user_t *) hcmalloc (sizeof (user_t));
+        hash_info->user = (user_t *) hcarena_alloc (hash_info_arena, sizeof (user_t));
       }
 
-      if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
-      {
-        if (user_options->benchmark == false)
-        {
-          hash_info->orighash = (char *) hcmalloc (256);
-        }
-      }
+      hash_info->orighash = orighash_empty;
 
       if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
       {
-        hash_info->split = (split_t *) hcmalloc (sizeof (split_t));
+        hash_info->split = (split_t *) hcarena_alloc (hash_info_arena, sizeof (split_t));
       }
     }
   }
@@ -872,7 +1480,11 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
     salts_buf = (salt_t *) hccalloc (1, sizeof (salt_t));
   }
 
-  for (u64 hash_pos = 0; hash_pos < hashes_avail; hash_pos++)
+  // in lean mode there is no hashes_buf to initialize, see hashlist_parse_slot ()
+
+  const u64 hashes_init = (hashes->lean == true) ? 0 : hashes_avail;
+
+  for (u64 hash_pos = 0; hash_pos < hashes_init; hash_pos++)
   {
     /**
      * Initialize some values for later use
@@ -960,7 +1572,7 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
         {
           hashinfo_t *hash_info_tmp = hashes_buf[hashes_cnt].hash_info;
 
-          hash_info_tmp->orighash = hcstrdup (hash_buf);
+          hash_info_tmp->orighash = hcarena_strdup (hash_info_arena, hash_buf);
         }
 
         if (hashconfig->is_salted == true)
@@ -1065,245 +1677,117 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
         return -1;
       }
 
-      u32 line_num = 0;
+      // lines are read in batches, decoded in parallel into slots reserved per line and then moved together in line order
 
-      char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+      hashlist_parse_batch_t batch;
 
-      time_t prev = 0;
-      time_t now  = 0;
+      memset (&batch, 0, sizeof (hashlist_parse_batch_t));
 
-      while (!hc_feof (&fp))
-      {
-        line_num++;
+      batch.hashlist_format = hashlist_format;
+      batch.slots_per_line  = (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT) ? 2 : 1;
 
-        const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_LARGE);
+      batch.buf   = (char *) hcmalloc (HASHLIST_PARSE_BUFSIZ);
+      batch.lines = (hashlist_parse_line_t *) hccalloc (HASHLIST_PARSE_LINES, sizeof (hashlist_parse_line_t));
 
-        if (line_len == 0) continue;
+      if (hashes->lean == true)
+      {
+        batch.views = (hash_t *) hccalloc (HASHLIST_PARSE_LINES, sizeof (hash_t));
+      }
 
-        if (hashes_avail == hashes_cnt)
-        {
-          event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u: File changed during runtime. Skipping new data.", hashes->hashfile, line_num);
+      batch.threads_cnt = MAX (hc_get_processor_count (), 1);
 
-          break;
-        }
+      batch.threads       = (hc_thread_t *)                    hccalloc (batch.threads_cnt, sizeof (hc_thread_t));
+      batch.threads_param = (hashlist_parse_thread_param_t *) hccalloc (batch.threads_cnt, sizeof (hashlist_parse_thread_param_t));
 
-        char *hash_buf = NULL;
-        int   hash_len = 0;
+      for (int tid = 0; tid < batch.threads_cnt; tid++)
+      {
+        batch.threads_param[tid].hashcat_ctx = hashcat_ctx;
+        batch.threads_param[tid].batch       = &batch;
+        batch.threads_param[tid].tid         = tid;
+      }
 
-        hlfmt_hash (hashcat_ctx, hashlist_format, line_buf, line_len, &hash_buf, &hash_len);
+      u32 line_num = 0;
 
-        bool hash_fmt_error = false;
+      time_t prev = 0;
+      time_t now  = 0;
 
-        if (hash_len < 1)     hash_fmt_error = true;
-        if (hash_buf == NULL) hash_fmt_error = true;
+      while (!hc_feof (&fp))
+      {
+        const u64 lines_max = MIN ((u64) HASHLIST_PARSE_LINES, (hashes_avail - hashes_cnt) / batch.slots_per_line);
 
-        if (hash_fmt_error)
+        if (lines_max == 0)
         {
-          event_log_warning (hashcat_ctx, "Failed to parse hashes using the '%s' format.", strhlfmt (hashlist_format));
+          line_num++;
 
-          continue;
-        }
+          const size_t line_len = fgetl (&fp, batch.buf, HCBUFSIZ_LARGE);
 
-        if (user_options->username == true)
-        {
-          char *user_buf = NULL;
-          int   user_len = 0;
+          if (line_len == 0) continue;
 
-          hlfmt_user (hashcat_ctx, hashlist_format, line_buf, line_len, &user_buf, &user_len);
+          event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u: File changed during runtime. Skipping new data.", hashes->hashfile, line_num);
 
-          // special case:
-          // both hash_t need to have the username info if the pwdump format is used (i.e. we have 2 hashes for 3000, both with same user)
+          break;
+        }
 
-          u32 hashes_per_user = 1;
+        size_t buf_used = 0;
 
-          if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
-          {
-            // the following conditions should be true if (hashlist_format == HLFMT_PWDUMP)
+        batch.lines_cnt = 0;
 
-            if (hash_len == 32)
-            {
-              hashes_per_user = 2;
-            }
-          }
+        while ((batch.lines_cnt < lines_max) && ((buf_used + HCBUFSIZ_LARGE + 1) <= HASHLIST_PARSE_BUFSIZ) && (!hc_feof (&fp)))
+        {
+          line_num++;
 
-          for (u32 i = 0; i < hashes_per_user; i++)
-          {
-            user_t **user = &hashes_buf[hashes_cnt + i].hash_info->user;
+          char *line_buf = batch.buf + buf_used;
 
-            *user = (user_t *) hcmalloc (sizeof (user_t));
+          const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_LARGE);
 
-            user_t *user_ptr = *user;
+          if (line_len == 0) continue;
 
-            if (user_buf != NULL)
-            {
-              user_ptr->user_name = hcstrdup (user_buf);
-            }
-            else
-            {
-              user_ptr->user_name = hcstrdup ("");
-            }
+          hashlist_parse_line_t *line = &batch.lines[batch.lines_cnt];
 
-            user_ptr->user_len = (u32) user_len;
-          }
-        }
+          line->line_buf   = line_buf;
+          line->line_len   = (int) line_len;
+          line->line_num   = line_num;
+          line->hashes_pos = hashes_cnt + (batch.lines_cnt * batch.slots_per_line);
 
-        if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
-        {
-          hashinfo_t *hash_info_tmp = hashes_buf[hashes_cnt].hash_info;
+          batch.lines_cnt++;
 
-          hash_info_tmp->orighash = hcstrdup (hash_buf);
+          buf_used += line_len + 1;
         }
 
-        if (hashconfig->is_salted == true)
+        if (hashes->lean == true)
         {
-          const u32 orig_pos = hashes_buf[hashes_cnt].salt->orig_pos;
+          // lines decode straight into their final digests_buf slots, compacted in hashlist_parse_commit ()
 
-          memset (hashes_buf[hashes_cnt].salt, 0, sizeof (salt_t));
+          batch.views_base = hashes_cnt;
 
-          hashes_buf[hashes_cnt].salt->orig_pos = orig_pos;
-        }
+          for (u32 line_idx = 0; line_idx < batch.lines_cnt; line_idx++)
+          {
+            hash_t *view = &batch.views[line_idx];
 
-        if (hashconfig->esalt_size > 0)
-        {
-          memset (hashes_buf[hashes_cnt].esalt, 0, hashconfig->esalt_size);
+            view->digest = ((char *) digests_buf) + ((u64) (hashes_cnt + line_idx) * hashconfig->dgst_size);
+            view->salt   = &salts_buf[0];
+          }
         }
 
-        if (hashconfig->hook_salt_size > 0)
-        {
-          memset (hashes_buf[hashes_cnt].hook_salt, 0, hashconfig->hook_salt_size);
-        }
+        batch.threads_used = MIN (batch.threads_cnt, (int) batch.lines_cnt);
 
-        if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
+        if (batch.threads_used > 1)
         {
-          if (hash_len == 32)
+          for (int tid = 0; tid < batch.threads_used; tid++)
           {
-            hash_t *hash;
-
-            hash = &hashes_buf[hashes_cnt];
-
-            int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf +  0, 16);
-
-            if (parser_status < PARSER_GLOBAL_ZERO)
-            {
-              char *tmp_line_buf;
-
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
-
-              if (user_options->machine_readable == true)
-              {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-              else
-              {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-
-              hcfree (tmp_line_buf);
-
-              continue;
-            }
-
-            hashes_buf[hashes_cnt].hash_info->split->split_group  = line_num;
-            hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_LEFT;
-
-            hashes_cnt++;
-
-            hash = &hashes_buf[hashes_cnt];
-
-            parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf + 16, 16);
-
-            if (parser_status < PARSER_GLOBAL_ZERO)
-            {
-              char *tmp_line_buf;
-
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
-
-              if (user_options->machine_readable == true)
-              {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-              else
-              {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-
-              hcfree (tmp_line_buf);
-
-              continue;
-            }
-
-            hashes_buf[hashes_cnt].hash_info->split->split_group  = line_num;
-            hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_RIGHT;
-
-            hashes_cnt++;
+            hc_thread_create (batch.threads[tid], thread_hashlist_parse, &batch.threads_param[tid]);
           }
-          else
-          {
-            hash_t *hash = &hashes_buf[hashes_cnt];
-
-            int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
-
-            if (parser_status < PARSER_GLOBAL_ZERO)
-            {
-              char *tmp_line_buf;
-
-              hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-              compress_terminal_line_length (tmp_line_buf, 38, 32);
-
-              if (user_options->machine_readable == true)
-              {
-                event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-              else
-              {
-                event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-              }
-
-              hcfree (tmp_line_buf);
-
-              continue;
-            }
-
-            hashes_buf[hashes_cnt].hash_info->split->split_group  = line_num;
-            hashes_buf[hashes_cnt].hash_info->split->split_origin = SPLIT_ORIGIN_NONE;
 
-            hashes_cnt++;
-          }
+          hc_thread_wait (batch.threads_used, batch.threads);
         }
-        else
+        else if (batch.threads_used == 1)
         {
-          hash_t *hash = &hashes_buf[hashes_cnt];
-
-          int parser_status = module_ctx->module_hash_decode (hashconfig, hash->digest, hash->salt, hash->esalt, hash->hook_salt, hash->hash_info, hash_buf, hash_len);
-
-          if (parser_status < PARSER_GLOBAL_ZERO)
-          {
-            char *tmp_line_buf;
-
-            hc_asprintf (&tmp_line_buf, "%s", line_buf);
-
-            compress_terminal_line_length (tmp_line_buf, 38, 32);
-
-            if (user_options->machine_readable == true)
-            {
-              event_log_warning (hashcat_ctx, "%s:%u:%s:%s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-            }
-            else
-            {
-              event_log_warning (hashcat_ctx, "Hashfile '%s' on line %u (%s): %s", hashes->hashfile, line_num, tmp_line_buf, strparser (parser_status));
-            }
-
-            hcfree (tmp_line_buf);
-
-            continue;
-          }
+          thread_hashlist_parse (&batch.threads_param[0]);
+        }
 
-          hashes_cnt++;
+        for (u32 line_idx = 0; line_idx < batch.lines_cnt; line_idx++)
+        {
+          hashes_cnt = hashlist_parse_commit (hashcat_ctx, &batch.lines[line_idx], hashes_cnt);
         }
 
         time (&now);
@@ -1327,7 +1811,11 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
 
       EVENT_DATA (EVENT_HASHLIST_PARSE_HASH, &hashlist_parse, sizeof (hashlist_parse_t));
 
-      hcfree (line_buf);
+      hcfree (batch.threads_param);
+      hcfree (batch.threads);
+      hcfree (batch.views);
+      hcfree (batch.lines);
+      hcfree (batch.buf);
 
       hc_fclose (&fp);
     }
@@ -1341,7 +1829,7 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
       {
         hashinfo_t *hash_info_tmp = hashes_buf[hashes_cnt].hash_info;
 
-        hash_info_tmp->orighash = hcstrdup (input_buf);
+        hash_info_tmp->orighash = hcarena_strdup (hash_info_arena, input_buf);
       }
 
       if (hashconfig->is_salted == true)
@@ -1404,13 +1892,21 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
   {
     EVENT (EVENT_HASHLIST_SORT_HASH_PRE);
 
-    if (hashconfig->is_salted == true)
+    if (hashes->lean == true)
+    {
+      u8 *digests_sorted = hashes_sort_digests (hashcat_ctx, (u8 *) hashes->digests_buf, hashes_cnt);
+
+      hcfree (hashes->digests_buf);
+
+      hashes->digests_buf = digests_sorted;
+    }
+    else if (hashconfig->is_salted == true)
     {
       hc_qsort_r (hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash, (void *) hashconfig);
     }
     else
     {
-      hc_qsort_r (hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash_no_salt, (void *) hashconfig);
+      hashes_sort_no_salt (hashcat_ctx, hashes_buf, hashes_cnt);
     }
 
     EVENT (EVENT_HASHLIST_SORT_HASH_POST);
@@ -1446,12 +1942,88 @@ int hashes_init_stage1 (hashcat_ctx_t *hashcat_ctx)
   return 0;
 }
 
+static int hashes_init_stage2_lean (hashcat_ctx_t *hashcat_ctx)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+        hashes_t     *hashes     = hashcat_ctx->hashes;
+
+  const u32 dgst_size = hashconfig->dgst_size;
+
+  u8  *digests_buf = (u8 *) hashes->digests_buf;
+  u32  hashes_cnt  = hashes->hashes_cnt;
+
+  /**
+   * Remove duplicates, the digests are sorted already so each one only has to be compared to the last one kept
+   */
+
+  EVENT (EVENT_HASHLIST_UNIQUE_HASH_PRE);
+
+  u32 hashes_cnt_new = (hashes_cnt > 0) ? 1 : 0;
+
+  for (u32 hashes_pos = 1; hashes_pos < hashes_cnt; hashes_pos++)
+  {
+    u8 *digest = digests_buf + ((u64) hashes_pos * dgst_size);
+
+    u8 *digest_last = digests_buf + ((u64) (hashes_cnt_new - 1) * dgst_size);
+
+    if (sort_by_digest_p0p1 (digest, digest_last, (void *) hashconfig) == 0) continue;
+
+    if (hashes_pos != hashes_cnt_new)
+    {
+      memcpy (digests_buf + ((u64) hashes_cnt_new * dgst_size), digest, dgst_size);
+    }
+
+    hashes_cnt_new++;
+  }
+
+  hashes_cnt = hashes_cnt_new;
+
+  hashes->hashes_cnt = hashes_cnt;
+
+  EVENT (EVENT_HASHLIST_UNIQUE_HASH_POST);
+
+  /**
+   * No copy needed, the sorted digests already are the final layout, only the unused tail is released
+   */
+
+  EVENT (EVENT_HASHLIST_SORT_SALT_PRE);
+
+  digests_buf = (u8 *) hcrealloc (digests_buf, (size_t) MAX (hashes_cnt, 1) * dgst_size, 0);
+
+  salt_t *salts_buf = hashes->salts_buf;
+
+  salts_buf[0].digests_cnt    = hashes_cnt;
+  salts_buf[0].digests_done   = 0;
+  salts_buf[0].digests_offset = 0;
+
+  EVENT (EVENT_HASHLIST_SORT_SALT_POST);
+
+  hashes->digests_cnt       = hashes_cnt;
+  hashes->digests_done      = 0;
+  hashes->digests_buf       = digests_buf;
+  hashes->digests_shown     = (u32 *) hccalloc (hashes_cnt, sizeof (u32));
+  hashes->digests_shown_tmp = (u32 *) hccalloc (hashes_cnt, sizeof (u32));
+
+  hashes->salts_cnt         = 1;
+  hashes->salts_done        = 0;
+  hashes->salts_shown       = (u32 *) hccalloc (1, sizeof (u32));
+
+  hashes->esalts_buf        = NULL;
+  hashes->hook_salts_buf    = NULL;
+
+  hashes->hash_info         = NULL;
+
+  return 0;
+}
+
 int hashes_init_stage2 (hashcat_ctx_t *hashcat_ctx)
 {
   const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
         hashes_t       *hashes       = hashcat_ctx->hashes;
   const user_options_t *user_options = hashcat_ctx->user_options;
 
+  if (hashes->lean == true) return hashes_init_stage2_lean (hashcat_ctx);
+
   hash_t *hashes_buf = hashes->hashes_buf;
   u32     hashes_cnt = hashes->hashes_cnt;
 
@@ -1712,7 +2284,11 @@ int hashes_init_stage3 (hashcat_ctx_t *hashcat_ctx)
     {
       const u32 hashes_idx = salt_buf->digests_offset + digest_idx;
 
-      if (hashes_buf[hashes_idx].cracked == 1)
+      // in lean mode potfile and zero hash matches have set digests_shown directly
+
+      const bool cracked = (hashes->lean == true) ? (digests_shown[hashes_idx] == 1) : (hashes_buf[hashes_idx].cracked == 1);
+
+      if (cracked == true)
       {
         digests_shown[hashes_idx] = 1;
 
@@ -2045,6 +2621,7 @@ int hashes_init_zerohash (hashcat_ctx_t *hashcat_ctx)
   const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
   const hashes_t       *hashes       = hashcat_ctx->hashes;
   const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  const outfile_ctx_t  *outfile_ctx  = hashcat_ctx->outfile_ctx;
 
   // do not use this unless really needed, for example as in LM
 
@@ -2083,6 +2660,24 @@ int hashes_init_zerohash (hashcat_ctx_t *hashcat_ctx)
 
   module_ctx->module_hash_decode_zero_hash (hashconfig, hash_buf.digest, hash_buf.salt, hash_buf.esalt, hash_buf.hook_salt, hash_buf.hash_info);
 
+  if (hashes->lean == true)
+  {
+    // no hash_t to mark, the digest position is all hashes_init_stage3 () needs
+
+    const u8 *digest = (const u8 *) hc_bsearch_r (hash_buf.digest, hashes->digests_buf, hashes_cnt, hashconfig->dgst_size, sort_by_digest_p0p1, (void *) hashconfig);
+
+    if (digest != NULL)
+    {
+      const u32 digest_pos = (digest - (const u8 *) hashes->digests_buf) / hashconfig->dgst_size;
+
+      hashes->digests_shown[digest_pos] = 1;
+    }
+
+    hcfree (hash_buf.digest);
+
+    return 0;
+  }
+
   hash_t *found = (hash_t *) hc_bsearch_r (&hash_buf, hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash_no_salt, (void *) hashconfig);
 
   if (found != NULL)
@@ -2109,10 +2704,6 @@ int hashes_init_zerohash (hashcat_ctx_t *hashcat_ctx)
       out_buf[out_len] = 0;
 
       // outfile, can be either to file or stdout
-      // if an error occurs opening the file, send to stdout as fallback
-      // the fp gets opened for each cracked hash so that the user can modify (move) the outfile while hashcat runs
-
-      outfile_write_open (hashcat_ctx);
 
       const u8 *plain = (const u8 *) "";
 
@@ -2120,11 +2711,18 @@ int hashes_init_zerohash (hashcat_ctx_t *hashcat_ctx)
 
       tmp_buf[0] = 0;
 
-      const int tmp_len = outfile_write (hashcat_ctx, (char *) out_buf, out_len, plain, 0, 0, NULL, 0, true, (char *) tmp_buf);
+      int tmp_len = outfile_write (hashcat_ctx, (char *) out_buf, out_len, plain, 0, 0, NULL, 0, true, (char *) tmp_buf);
 
       EVENT_DATA (EVENT_CRACKER_HASH_CRACKED, tmp_buf, tmp_len);
 
-      outfile_write_close (hashcat_ctx);
+      if (outfile_ctx->filename != NULL)
+      {
+        memcpy (tmp_buf + tmp_len, EOL, strlen (EOL));
+
+        tmp_len += strlen (EOL);
+
+        cracksink_push (hashcat_ctx, CRACKSINK_OUTFILE, tmp_buf, tmp_len);
+      }
 
       hcfree (tmp_buf);
       hcfree (out_buf);
@@ -2153,9 +2751,7 @@ int hashes_init_zerohash (hashcat_ctx_t *hashcat_ctx)
 
 void hashes_destroy (hashcat_ctx_t *hashcat_ctx)
 {
-  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  hashes_t       *hashes       = hashcat_ctx->hashes;
-  user_options_t *user_options = hashcat_ctx->user_options;
+  hashes_t *hashes = hashcat_ctx->hashes;
 
   hcfree (hashes->digests_buf);
   hcfree (hashes->digests_shown);
@@ -2164,29 +2760,10 @@ void hashes_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (hashes->salts_buf);
   hcfree (hashes->salts_shown);
 
-  if ((user_options->username == true) || (hashconfig->opts_type & OPTS_TYPE_HASH_COPY))
-  {
-    for (u32 hash_pos = 0; hash_pos < hashes->hashes_cnt; hash_pos++)
-    {
-      if (user_options->username == true)
-      {
-        hcfree (hashes->hash_info[hash_pos]->user);
-      }
-
-      if (hashconfig->opts_type & OPTS_TYPE_HASH_COPY)
-      {
-        hcfree (hashes->hash_info[hash_pos]->orighash);
-      }
-
-      if (hashconfig->opts_type & OPTS_TYPE_HASH_SPLIT)
-      {
-        hcfree (hashes->hash_info[hash_pos]->split);
-      }
-    }
-  }
-
   hcfree (hashes->hash_info);
 
+  hcarena_destroy (&hashes->hash_info_arena);
+
   hcfree (hashes->esalts_buf);
   hcfree (hashes->hook_salts_buf);
 
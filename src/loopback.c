@@ -6,17 +6,15 @@
 #include "common.h"
 #include "types.h"
 #include "memory.h"
+#include "convert.h"
 #include "event.h"
 #include "shared.h"
 #include "locking.h"
+#include "cracksink.h"
 #include "loopback.h"
 
-static void loopback_format_plain (hashcat_ctx_t *hashcat_ctx, const u8 *plain_ptr, const unsigned int plain_len)
+static int loopback_format_plain (const u8 *plain_ptr, const unsigned int plain_len, u8 *out_buf)
 {
-  loopback_ctx_t *loopback_ctx = hashcat_ctx->loopback_ctx;
-
-  if (loopback_ctx->enabled == false) return;
-
   int needs_hexify = 0;
 
   for (u32 i = 0; i < plain_len; i++)
@@ -36,21 +34,32 @@ static void loopback_format_plain (hashcat_ctx_t *hashcat_ctx, const u8 *plain_p
     }
   }
 
+  int out_len = 0;
+
   if (needs_hexify == 1)
   {
-    hc_fprintf (&loopback_ctx->fp, "$HEX[");
+    memcpy (out_buf + out_len, "$HEX[", 5);
 
-    for (u32 i = 0; i < plain_len; i++)
-    {
-      hc_fprintf (&loopback_ctx->fp, "%02x", plain_ptr[i]);
-    }
+    out_len += 5;
 
-    hc_fprintf (&loopback_ctx->fp, "]");
+    exec_hexify (plain_ptr, plain_len, out_buf + out_len);
+
+    out_len += plain_len * 2;
+
+    out_buf[out_len++] = ']';
   }
   else
   {
-    hc_fwrite ((void *)plain_ptr, plain_len, 1, &loopback_ctx->fp);
+    memcpy (out_buf + out_len, plain_ptr, plain_len);
+
+    out_len += plain_len;
   }
+
+  memcpy (out_buf + out_len, EOL, strlen (EOL));
+
+  out_len += strlen (EOL);
+
+  return out_len;
 }
 
 int loopback_init (hashcat_ctx_t *hashcat_ctx)
@@ -150,15 +159,13 @@ void loopback_write_append (hashcat_ctx_t *hashcat_ctx, const u8 *plain_ptr, con
 
   if (loopback_ctx->enabled == false) return;
 
-  loopback_format_plain (hashcat_ctx, plain_ptr, plain_len);
-
-  hc_lockfile (&loopback_ctx->fp);
+  u8 *out_buf = (u8 *) hcmalloc (5 + (plain_len * 2) + 1 + strlen (EOL));
 
-  hc_fwrite (EOL, strlen (EOL), 1, &loopback_ctx->fp);
+  const int out_len = loopback_format_plain (plain_ptr, plain_len, out_buf);
 
-  hc_fflush (&loopback_ctx->fp);
+  cracksink_push (hashcat_ctx, CRACKSINK_LOOPBACK, out_buf, out_len);
 
-  hc_unlockfile (&loopback_ctx->fp);
+  hcfree (out_buf);
 
   loopback_ctx->unused = false;
 }
@@ -66,3 +66,100 @@ void hcfree (void *ptr)
 
   free (ptr);
 }
+
+/**
+ * arena, for many small allocations which share the same lifetime
+ * there is no per-allocation header and everything is released at once with hcarena_destroy ()
+ */
+
+#define ARENA_ALIGN 8
+
+void hcarena_init (arena_t *arena, const size_t block_size)
+{
+  arena->head       = NULL;
+  arena->block_size = block_size;
+}
+
+static void *hcarena_alloc_aligned (arena_t *arena, const size_t sz, const size_t align)
+{
+  arena_block_t *head = arena->head;
+
+  if (head != NULL)
+  {
+    const size_t pos = (head->used + (align - 1)) & ~(align - 1);
+
+    if ((pos + sz) <= head->size)
+    {
+      head->used = pos + sz;
+
+      return ((char *) (head + 1)) + pos;
+    }
+  }
+
+  // allocations too big for a regular block get their own one, which goes behind the head so that the free space in the head is not lost
+
+  const bool big = (sz > (arena->block_size / 4));
+
+  const size_t size = (big == true) ? sz : arena->block_size;
+
+  arena_block_t *block = (arena_block_t *) hcmalloc (sizeof (arena_block_t) + size);
+
+  if (block == NULL) return (NULL);
+
+  block->used = sz;
+  block->size = size;
+
+  if ((big == true) && (head != NULL))
+  {
+    block->next = head->next;
+    head->next  = block;
+  }
+  else
+  {
+    block->next = head;
+    arena->head = block;
+  }
+
+  return (block + 1);
+}
+
+void *hcarena_alloc (arena_t *arena, const size_t sz)
+{
+  // memory is zeroed, as with hcmalloc ()
+
+  return hcarena_alloc_aligned (arena, sz, ARENA_ALIGN);
+}
+
+char *hcarena_strndup (arena_t *arena, const char *s, const size_t len)
+{
+  char *b = (char *) hcarena_alloc_aligned (arena, len + 1, 1);
+
+  if (b == NULL) return (NULL);
+
+  memcpy (b, s, len);
+
+  b[len] = 0;
+
+  return (b);
+}
+
+char *hcarena_strdup (arena_t *arena, const char *s)
+{
+  return hcarena_strndup (arena, s, strlen (s));
+}
+
+void hcarena_destroy (arena_t *arena)
+{
+  arena_block_t *block = arena->head;
+
+  while (block != NULL)
+  {
+    arena_block_t *next = block->next;
+
+    hcfree (block);
+
+    block = next;
+  }
+
+  arena->head = NULL;
+}
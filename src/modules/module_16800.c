@@ -159,6 +159,12 @@ int module_hash_decode_potfile (MAYBE_UNUSED const hashconfig_t *hashconfig, MAY
 
   wpa_pmkid->essid_len = hex_decode ((const u8 *) essid_pos, essid_len, (u8 *) wpa_pmkid->essid_buf);
 
+  // salt, same as in module_hash_decode (), lets the potfile code skip the hashes of all other networks
+
+  memcpy (salt->salt_buf, wpa_pmkid->essid_buf, wpa_pmkid->essid_len);
+
+  salt->salt_len = wpa_pmkid->essid_len;
+
   return PARSER_OK;
 }
 
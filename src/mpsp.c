@@ -16,6 +16,10 @@
 #include "ext_lzma.h"
 #include "mpsp.h"
 
+#if defined (_POSIX)
+#include <sys/mman.h>
+#endif
+
 static const char *DEF_MASK = "?1?2?2?2?2?2?2?3?3?3?3?d?d?d?d";
 
 #define MAX_MFS 5 // 4*charset, 1*mask
@@ -648,101 +652,146 @@ static void mp_reset_usr (cs_t *mp_usr, const u32 userindex)
   memset (mp_usr[userindex].cs_buf, 0, sizeof (mp_usr[userindex].cs_buf));
 }
 
-static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
+static u64 sp_cache_key (const u8 *buf, const size_t len, const u32 disable, const u32 classic)
 {
-  folder_config_t *folder_config = hashcat_ctx->folder_config;
-  mask_ctx_t      *mask_ctx      = hashcat_ctx->mask_ctx;
-  user_options_t  *user_options  = hashcat_ctx->user_options;
+  u64 key = 0xcbf29ce484222325;
 
-  char *shared_dir = folder_config->shared_dir;
+  for (size_t i = 0; i < len; i++)
+  {
+    key ^= buf[i];
+    key *= 0x100000001b3;
+  }
 
-  char *hcstat  = user_options->markov_hcstat2;
-  u32   disable = user_options->markov_disable;
-  u32   classic = user_options->markov_classic;
+  key ^= disable; key *= 0x100000001b3;
+  key ^= classic; key *= 0x100000001b3;
 
-  hcstat_table_t *root_table_buf   = mask_ctx->root_table_buf;
-  hcstat_table_t *markov_table_buf = mask_ctx->markov_table_buf;
+  return key;
+}
 
-  /**
-   * Initialize hcstats
-   */
+static void sp_cache_unload (mask_ctx_t *mask_ctx)
+{
+  if (mask_ctx->sp_tbl_buf == NULL) return;
+
+  #if defined (_POSIX)
+  if (mask_ctx->sp_tbl_mapped == true)
+  {
+    munmap (mask_ctx->sp_tbl_buf, SP_CACHE_FILESZ);
+  }
+  else
+  #endif
+  {
+    hcfree (mask_ctx->sp_tbl_buf);
+  }
 
-  u64 *root_stats_buf = (u64 *) hccalloc (SP_ROOT_CNT, sizeof (u64));
+  mask_ctx->sp_tbl_buf       = NULL;
+  mask_ctx->sp_tbl_mapped    = false;
+  mask_ctx->root_table_buf   = NULL;
+  mask_ctx->markov_table_buf = NULL;
+}
 
-  u64 *root_stats_ptr = root_stats_buf;
+static bool sp_cache_load (mask_ctx_t *mask_ctx, const char *cache_file, const u64 key)
+{
+  // the cache is mapped read-only and shared, so all processes using the same hcstat2 file share one copy in the page cache
 
-  u64 *root_stats_buf_by_pos[SP_PW_MAX];
+  #if defined (_POSIX)
 
-  for (int i = 0; i < SP_PW_MAX; i++)
+  const int fd = open (cache_file, O_RDONLY);
+
+  if (fd == -1) return false;
+
+  struct stat st;
+
+  if ((fstat (fd, &st) == -1) || ((u64) st.st_size != (u64) SP_CACHE_FILESZ))
   {
-    root_stats_buf_by_pos[i] = root_stats_ptr;
+    close (fd);
 
-    root_stats_ptr += CHARSIZ;
+    return false;
   }
 
-  u64 *markov_stats_buf = (u64 *) hccalloc (SP_MARKOV_CNT, sizeof (u64));
+  void *buf = mmap (NULL, SP_CACHE_FILESZ, PROT_READ, MAP_SHARED, fd, 0);
 
-  u64 *markov_stats_ptr = markov_stats_buf;
+  close (fd);
 
-  u64 *markov_stats_buf_by_key[SP_PW_MAX][CHARSIZ];
+  if (buf == MAP_FAILED) return false;
 
-  for (int i = 0; i < SP_PW_MAX; i++)
-  {
-    for (int j = 0; j < CHARSIZ; j++)
-    {
-      markov_stats_buf_by_key[i][j] = markov_stats_ptr;
+  mask_ctx->sp_tbl_mapped = true;
 
-      markov_stats_ptr += CHARSIZ;
-    }
-  }
+  #else
 
-  /**
-   * Load hcstats File
-   */
+  HCFILE fp;
 
-  char hcstat_tmp[256];
+  if (hc_fopen (&fp, cache_file, "rb") == false) return false;
 
-  if (hcstat == NULL)
+  u8 *buf = (u8 *) hcmalloc (SP_CACHE_FILESZ);
+
+  const size_t nread = hc_fread (buf, 1, SP_CACHE_FILESZ, &fp);
+
+  hc_fclose (&fp);
+
+  if (nread != SP_CACHE_FILESZ)
   {
-    snprintf (hcstat_tmp, sizeof (hcstat_tmp), "%s/%s", shared_dir, SP_HCSTAT);
+    hcfree (buf);
 
-    hcstat = hcstat_tmp;
+    return false;
   }
 
-  struct stat s;
+  mask_ctx->sp_tbl_mapped = false;
 
-  if (stat (hcstat, &s) == -1)
+  #endif
+
+  mask_ctx->sp_tbl_buf = (u8 *) buf;
+
+  const u64 *hdr = (const u64 *) mask_ctx->sp_tbl_buf;
+
+  if ((byte_swap_64 (hdr[0]) != SP_CACHE_VERSION) || (byte_swap_64 (hdr[1]) != key))
   {
-    event_log_error (hashcat_ctx, "%s: %s", hcstat, strerror (errno));
+    sp_cache_unload (mask_ctx);
 
-    return -1;
+    return false;
   }
 
+  mask_ctx->root_table_buf   = mask_ctx->sp_tbl_buf + SP_CACHE_HDRSZ;
+  mask_ctx->markov_table_buf = mask_ctx->root_table_buf + SP_ROOT_CNT;
+
+  return true;
+}
+
+static void sp_cache_write (const char *cache_file, const u8 *tbl_buf)
+{
+  // write to a private file first, concurrent sessions must never map a partially written cache
+  // not being able to store the cache only costs time on the next run
+
+  char *tmp_file;
+
+  hc_asprintf (&tmp_file, "%s.%d.tmp", cache_file, (int) getpid ());
+
   HCFILE fp;
 
-  if (hc_fopen (&fp, hcstat, "rb") == false)
+  if (hc_fopen (&fp, tmp_file, "wb") == false)
   {
-    event_log_error (hashcat_ctx, "%s: %s", hcstat, strerror (errno));
+    hcfree (tmp_file);
 
-    return -1;
+    return;
   }
 
-  u8 *inbuf = (u8 *) hcmalloc (s.st_size);
+  const size_t nwritten = hc_fwrite ((void *) tbl_buf, 1, SP_CACHE_FILESZ, &fp);
 
-  SizeT inlen = (SizeT) hc_fread (inbuf, 1, s.st_size, &fp);
+  hc_fclose (&fp);
 
-  if (inlen != (SizeT) s.st_size)
+  if ((nwritten != SP_CACHE_FILESZ) || (rename (tmp_file, cache_file) == -1))
   {
-    event_log_error (hashcat_ctx, "%s: Could not read data.", hcstat);
-
-    hc_fclose (&fp);
+    unlink (tmp_file);
+  }
 
-    hcfree (inbuf);
+  hcfree (tmp_file);
+}
 
-    return -1;
-  }
+static int sp_setup_tbl_build (hashcat_ctx_t *hashcat_ctx, const char *hcstat, u8 *inbuf, SizeT inlen, u8 *tbl_buf, const u64 key)
+{
+  user_options_t *user_options = hashcat_ctx->user_options;
 
-  hc_fclose (&fp);
+  u32 disable = user_options->markov_disable;
+  u32 classic = user_options->markov_classic;
 
   u8 *outbuf = (u8 *) hcmalloc (SP_FILESZ);
 
@@ -756,7 +805,6 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   {
     event_log_error (hashcat_ctx, "%s: Could not uncompress data.", hcstat);
 
-    hcfree (inbuf);
     hcfree (outbuf);
 
     return -1;
@@ -766,22 +814,47 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   {
     event_log_error (hashcat_ctx, "%s: Could not uncompress data.", hcstat);
 
-    hcfree (inbuf);
     hcfree (outbuf);
 
     return -1;
   }
 
+  /**
+   * Initialize hcstats
+   */
+
   u64 *ptr = (u64 *) outbuf;
 
   u64 v = *ptr++;
   u64 z = *ptr++;
 
-  memcpy (root_stats_buf,   ptr, sizeof (u64) * SP_ROOT_CNT);   ptr += SP_ROOT_CNT;
-  memcpy (markov_stats_buf, ptr, sizeof (u64) * SP_MARKOV_CNT); // ptr += SP_MARKOV_CNT;
+  u64 *root_stats_buf   = ptr; ptr += SP_ROOT_CNT;
+  u64 *markov_stats_buf = ptr; // ptr += SP_MARKOV_CNT;
 
-  hcfree (inbuf);
-  hcfree (outbuf);
+  u64 *root_stats_ptr = root_stats_buf;
+
+  u64 *root_stats_buf_by_pos[SP_PW_MAX];
+
+  for (int i = 0; i < SP_PW_MAX; i++)
+  {
+    root_stats_buf_by_pos[i] = root_stats_ptr;
+
+    root_stats_ptr += CHARSIZ;
+  }
+
+  u64 *markov_stats_ptr = markov_stats_buf;
+
+  u64 *markov_stats_buf_by_key[SP_PW_MAX][CHARSIZ];
+
+  for (int i = 0; i < SP_PW_MAX; i++)
+  {
+    for (int j = 0; j < CHARSIZ; j++)
+    {
+      markov_stats_buf_by_key[i][j] = markov_stats_ptr;
+
+      markov_stats_ptr += CHARSIZ;
+    }
+  }
 
   /**
    * switch endianess
@@ -801,6 +874,8 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   {
     event_log_error (hashcat_ctx, "%s: Invalid header", hcstat);
 
+    hcfree (outbuf);
+
     return -1;
   }
 
@@ -808,6 +883,8 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   {
     event_log_error (hashcat_ctx, "%s: Invalid header", hcstat);
 
+    hcfree (outbuf);
+
     return -1;
   }
 
@@ -864,74 +941,165 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   }
 
   /**
-   * Initialize tables
+   * Convert hcstat to tables and sort them, one table of CHARSIZ entries at a time
    */
 
-  hcstat_table_t *root_table_ptr = root_table_buf;
+  u64 *hdr = (u64 *) tbl_buf;
 
-  hcstat_table_t *root_table_buf_by_pos[SP_PW_MAX];
+  hdr[0] = byte_swap_64 (SP_CACHE_VERSION);
+  hdr[1] = byte_swap_64 (key);
 
-  for (int i = 0; i < SP_PW_MAX; i++)
-  {
-    root_table_buf_by_pos[i] = root_table_ptr;
+  u8 *root_keys   = tbl_buf + SP_CACHE_HDRSZ;
+  u8 *markov_keys = root_keys + SP_ROOT_CNT;
 
-    root_table_ptr += CHARSIZ;
-  }
+  hcstat_table_t *table_buf = (hcstat_table_t *) hccalloc (CHARSIZ, sizeof (hcstat_table_t));
 
-  hcstat_table_t *markov_table_ptr = markov_table_buf;
+  for (int i = 0; i < SP_ROOT_CNT; i += CHARSIZ)
+  {
+    for (int j = 0; j < CHARSIZ; j++)
+    {
+      table_buf[j].key = j;
+      table_buf[j].val = root_stats_buf[i + j];
+    }
 
-  hcstat_table_t *markov_table_buf_by_key[SP_PW_MAX][CHARSIZ];
+    qsort (table_buf, CHARSIZ, sizeof (hcstat_table_t), sp_comp_val);
 
-  for (int i = 0; i < SP_PW_MAX; i++)
+    for (int j = 0; j < CHARSIZ; j++) root_keys[i + j] = (u8) table_buf[j].key;
+  }
+
+  for (int i = 0; i < SP_MARKOV_CNT; i += CHARSIZ)
   {
     for (int j = 0; j < CHARSIZ; j++)
     {
-      markov_table_buf_by_key[i][j] = markov_table_ptr;
-
-      markov_table_ptr += CHARSIZ;
+      table_buf[j].key = j;
+      table_buf[j].val = markov_stats_buf[i + j];
     }
+
+    qsort (table_buf, CHARSIZ, sizeof (hcstat_table_t), sp_comp_val);
+
+    for (int j = 0; j < CHARSIZ; j++) markov_keys[i + j] = (u8) table_buf[j].key;
   }
 
+  hcfree (table_buf);
+
+  hcfree (outbuf);
+
+  return 0;
+}
+
+static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
+{
+  folder_config_t *folder_config = hashcat_ctx->folder_config;
+  mask_ctx_t      *mask_ctx      = hashcat_ctx->mask_ctx;
+  user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  char *shared_dir = folder_config->shared_dir;
+
+  char *hcstat  = user_options->markov_hcstat2;
+  u32   disable = user_options->markov_disable;
+  u32   classic = user_options->markov_classic;
+
   /**
-   * Convert hcstat to tables
+   * Load hcstats File
    */
 
-  for (int i = 0; i < SP_ROOT_CNT; i++)
+  char hcstat_tmp[256];
+
+  if (hcstat == NULL)
   {
-    u32 key = i % CHARSIZ;
+    snprintf (hcstat_tmp, sizeof (hcstat_tmp), "%s/%s", shared_dir, SP_HCSTAT);
 
-    root_table_buf[i].key = key;
-    root_table_buf[i].val = root_stats_buf[i];
+    hcstat = hcstat_tmp;
   }
 
-  for (int i = 0; i < SP_MARKOV_CNT; i++)
+  struct stat s;
+
+  if (stat (hcstat, &s) == -1)
   {
-    u32 key = i % CHARSIZ;
+    event_log_error (hashcat_ctx, "%s: %s", hcstat, strerror (errno));
 
-    markov_table_buf[i].key = key;
-    markov_table_buf[i].val = markov_stats_buf[i];
+    return -1;
   }
 
-  hcfree (root_stats_buf);
-  hcfree (markov_stats_buf);
+  HCFILE fp;
+
+  if (hc_fopen (&fp, hcstat, "rb") == false)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", hcstat, strerror (errno));
+
+    return -1;
+  }
+
+  u8 *inbuf = (u8 *) hcmalloc (s.st_size);
+
+  SizeT inlen = (SizeT) hc_fread (inbuf, 1, s.st_size, &fp);
+
+  if (inlen != (SizeT) s.st_size)
+  {
+    event_log_error (hashcat_ctx, "%s: Could not read data.", hcstat);
+
+    hc_fclose (&fp);
+
+    hcfree (inbuf);
+
+    return -1;
+  }
+
+  hc_fclose (&fp);
 
   /**
-   * Finally sort them
+   * The sorted tables only depend on the hcstat2 contents and the modifiers,
+   * so they are derived once and kept in the cache folder
    */
 
-  for (int i = 0; i < SP_PW_MAX; i++)
+  const u64 key = sp_cache_key (inbuf, inlen, disable, classic);
+
+  char *cache_file;
+
+  hc_asprintf (&cache_file, "%s/%s.%016" PRIx64, folder_config->cache_dir, SP_CACHE, key);
+
+  if (sp_cache_load (mask_ctx, cache_file, key) == true)
   {
-    qsort (root_table_buf_by_pos[i], CHARSIZ, sizeof (hcstat_table_t), sp_comp_val);
+    hcfree (cache_file);
+
+    hcfree (inbuf);
+
+    return 0;
   }
 
-  for (int i = 0; i < SP_PW_MAX; i++)
+  u8 *tbl_buf = (u8 *) hcmalloc (SP_CACHE_FILESZ);
+
+  if (sp_setup_tbl_build (hashcat_ctx, hcstat, inbuf, inlen, tbl_buf, key) == -1)
   {
-    for (int j = 0; j < CHARSIZ; j++)
-    {
-      qsort (markov_table_buf_by_key[i][j], CHARSIZ, sizeof (hcstat_table_t), sp_comp_val);
-    }
+    hcfree (tbl_buf);
+
+    hcfree (cache_file);
+
+    hcfree (inbuf);
+
+    return -1;
   }
 
+  hcfree (inbuf);
+
+  sp_cache_write (cache_file, tbl_buf);
+
+  // prefer the shared mapping of the file which was just written
+
+  if (sp_cache_load (mask_ctx, cache_file, key) == true)
+  {
+    hcfree (tbl_buf);
+  }
+  else
+  {
+    mask_ctx->sp_tbl_buf       = tbl_buf;
+    mask_ctx->sp_tbl_mapped    = false;
+    mask_ctx->root_table_buf   = tbl_buf + SP_CACHE_HDRSZ;
+    mask_ctx->markov_table_buf = mask_ctx->root_table_buf + SP_ROOT_CNT;
+  }
+
+  hcfree (cache_file);
+
   return 0;
 }
 
@@ -953,7 +1121,7 @@ static int sp_get_sum (u32 start, u32 stop, cs_t *root_css_buf, u64 *result)
   return 0;
 }
 
-static void sp_tbl_to_css (hcstat_table_t *root_table_buf, hcstat_table_t *markov_table_buf, cs_t *root_css_buf, cs_t *markov_css_buf, u32 threshold, u32 uniq_tbls[SP_PW_MAX][CHARSIZ])
+static void sp_tbl_to_css (const u8 *root_table_buf, const u8 *markov_table_buf, cs_t *root_css_buf, cs_t *markov_css_buf, u32 threshold, u32 uniq_tbls[SP_PW_MAX][CHARSIZ])
 {
   memset (root_css_buf,   0, SP_PW_MAX *           sizeof (cs_t));
   memset (markov_css_buf, 0, SP_PW_MAX * CHARSIZ * sizeof (cs_t));
@@ -970,7 +1138,7 @@ static void sp_tbl_to_css (hcstat_table_t *root_table_buf, hcstat_table_t *marko
 
     if (cs->cs_len == threshold) continue;
 
-    u32 key = root_table_buf[i].key;
+    u32 key = root_table_buf[i];
 
     if (uniq_tbls[pw_pos][key] == 0) continue;
 
@@ -993,7 +1161,7 @@ static void sp_tbl_to_css (hcstat_table_t *root_table_buf, hcstat_table_t *marko
 
     u32 pw_pos = c / CHARSIZ;
 
-    u32 key = markov_table_buf[i].key;
+    u32 key = markov_table_buf[i];
 
     if ((pw_pos + 1) < SP_PW_MAX) if (uniq_tbls[pw_pos + 1][key] == 0) continue;
 
@@ -1410,9 +1578,6 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
   mask_ctx->css_buf = (cs_t *) hccalloc (256, sizeof (cs_t));
   mask_ctx->css_cnt = 0;
 
-  mask_ctx->root_table_buf   = (hcstat_table_t *) hccalloc (SP_ROOT_CNT,   sizeof (hcstat_table_t));
-  mask_ctx->markov_table_buf = (hcstat_table_t *) hccalloc (SP_MARKOV_CNT, sizeof (hcstat_table_t));
-
   if (sp_setup_tbl (hashcat_ctx) == -1) return -1;
 
   mask_ctx->root_css_buf   = (cs_t *) hccalloc (SP_PW_MAX,           sizeof (cs_t));
@@ -1689,8 +1854,7 @@ void mask_ctx_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (mask_ctx->root_css_buf);
   hcfree (mask_ctx->markov_css_buf);
 
-  hcfree (mask_ctx->root_table_buf);
-  hcfree (mask_ctx->markov_table_buf);
+  sp_cache_unload (mask_ctx);
 
   for (u32 mask_pos = 0; mask_pos < mask_ctx->masks_cnt; mask_pos++)
   {
@@ -0,0 +1,658 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "event.h"
+#include "thread.h"
+#include "shared.h"
+#include "dynloader.h"
+#include "emu_inc_hash_md5.h"
+#include "native.h"
+
+// the native backend has no device runtime, the kernels are regular C functions of a shared object
+// built by the host compiler. every KERN_ATTR layout is described by a small signature string:
+// P = buffer (pointer), I = u32, L = u64
+
+static const char *native_kernel_args_layout (const native_kernel_args_t kernel_args)
+{
+  switch (kernel_args)
+  {
+    case NATIVE_KERNEL_ARGS_MAIN:       return "PPPPPPPPPPPPPPPPPPPPPPPPIIIIIIIIIIILL";
+    case NATIVE_KERNEL_ARGS_MEMSET:     return "PIL";
+    case NATIVE_KERNEL_ARGS_BUF:        return "PL";
+    case NATIVE_KERNEL_ARGS_DECOMPRESS: return "PPPL";
+    case NATIVE_KERNEL_ARGS_MP:         return "PPPLIIIIL";
+    case NATIVE_KERNEL_ARGS_MP_L:       return "PPPLIIIIIL";
+    case NATIVE_KERNEL_ARGS_AMP:        return "PPPPPIL";
+    case NATIVE_KERNEL_ARGS_TM:         return "PP";
+  }
+
+  return NULL;
+}
+
+typedef void (*NATIVE_KERNEL_MAIN)       (void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, u32, u32, u32, u32, u32, u32, u32, u32, u32, u32, u32, u64, u64);
+typedef void (*NATIVE_KERNEL_MEMSET)     (void *, u32, u64);
+typedef void (*NATIVE_KERNEL_BUF)        (void *, u64);
+typedef void (*NATIVE_KERNEL_DECOMPRESS) (void *, void *, void *, u64);
+typedef void (*NATIVE_KERNEL_MP)         (void *, void *, void *, u64, u32, u32, u32, u32, u64);
+typedef void (*NATIVE_KERNEL_MP_L)       (void *, void *, void *, u64, u32, u32, u32, u32, u32, u64);
+typedef void (*NATIVE_KERNEL_AMP)        (void *, void *, void *, void *, void *, u32, u64);
+typedef void (*NATIVE_KERNEL_TM)         (void *, void *);
+
+static void native_run_range (const native_pool_t *pool, size_t *gid, const u64 gid_start, const u64 gid_end)
+{
+  const native_arg_t *a = pool->args;
+
+  switch (pool->kernel_args)
+  {
+    case NATIVE_KERNEL_ARGS_MAIN:
+    {
+      NATIVE_KERNEL_MAIN kernel = (NATIVE_KERNEL_MAIN) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++)
+      {
+        *gid = i;
+
+        kernel (a[ 0].ptr, a[ 1].ptr, a[ 2].ptr, a[ 3].ptr, a[ 4].ptr, a[ 5].ptr, a[ 6].ptr, a[ 7].ptr,
+                a[ 8].ptr, a[ 9].ptr, a[10].ptr, a[11].ptr, a[12].ptr, a[13].ptr, a[14].ptr, a[15].ptr,
+                a[16].ptr, a[17].ptr, a[18].ptr, a[19].ptr, a[20].ptr, a[21].ptr, a[22].ptr, a[23].ptr,
+                a[24].u32, a[25].u32, a[26].u32, a[27].u32, a[28].u32, a[29].u32, a[30].u32, a[31].u32,
+                a[32].u32, a[33].u32, a[34].u32,
+                a[35].u64, a[36].u64);
+      }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_MEMSET:
+    {
+      NATIVE_KERNEL_MEMSET kernel = (NATIVE_KERNEL_MEMSET) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].u32, a[2].u64); }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_BUF:
+    {
+      NATIVE_KERNEL_BUF kernel = (NATIVE_KERNEL_BUF) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].u64); }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_DECOMPRESS:
+    {
+      NATIVE_KERNEL_DECOMPRESS kernel = (NATIVE_KERNEL_DECOMPRESS) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].ptr, a[2].ptr, a[3].u64); }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_MP:
+    {
+      NATIVE_KERNEL_MP kernel = (NATIVE_KERNEL_MP) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].ptr, a[2].ptr, a[3].u64, a[4].u32, a[5].u32, a[6].u32, a[7].u32, a[8].u64); }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_MP_L:
+    {
+      NATIVE_KERNEL_MP_L kernel = (NATIVE_KERNEL_MP_L) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].ptr, a[2].ptr, a[3].u64, a[4].u32, a[5].u32, a[6].u32, a[7].u32, a[8].u32, a[9].u64); }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_AMP:
+    {
+      NATIVE_KERNEL_AMP kernel = (NATIVE_KERNEL_AMP) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].ptr, a[2].ptr, a[3].ptr, a[4].ptr, a[5].u32, a[6].u64); }
+
+      break;
+    }
+
+    case NATIVE_KERNEL_ARGS_TM:
+    {
+      NATIVE_KERNEL_TM kernel = (NATIVE_KERNEL_TM) pool->function.kernel;
+
+      for (u64 i = gid_start; i < gid_end; i++) { *gid = i; kernel (a[0].ptr, a[1].ptr); }
+
+      break;
+    }
+  }
+}
+
+static void *native_pool_worker (void *p)
+{
+  native_pool_t *pool = (native_pool_t *) p;
+
+  while (true)
+  {
+    hc_thread_sem_wait (pool->sem_start);
+
+    if (pool->shutdown == true) break;
+
+    // the work-item id lives in thread-local storage of the kernel shared object
+
+    size_t *gid = pool->function.gid_ptr ();
+
+    while (true)
+    {
+      const u64 gid_start = __atomic_fetch_add (&pool->gid_next, pool->gid_chunk, __ATOMIC_RELAXED);
+
+      if (gid_start >= pool->gid_max) break;
+
+      const u64 gid_end = MIN (gid_start + pool->gid_chunk, pool->gid_max);
+
+      native_run_range (pool, gid, gid_start, gid_end);
+    }
+
+    hc_thread_sem_post (pool->sem_done);
+  }
+
+  return NULL;
+}
+
+int native_init (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  backend_ctx->native = false;
+
+  const char *cc = getenv ("CC");
+
+  if ((cc == NULL) || (cc[0] == 0)) cc = "cc";
+
+  char *cmd = NULL;
+
+  hc_asprintf (&cmd, "%s -dumpversion 2>&1", cc);
+
+  FILE *fp = popen (cmd, "r");
+
+  hcfree (cmd);
+
+  if (fp == NULL) return -1;
+
+  char version[64] = { 0 };
+
+  const bool have_version = (fgets (version, sizeof (version), fp) != NULL);
+
+  if (pclose (fp) != 0) return -1;
+
+  if (have_version == false) return -1;
+
+  hc_string_trim_trailing (version);
+
+  // the kernels are built with -march=native, a shared object from another CPU can die with SIGILL
+  // the macros predefined for -march=native are exactly the instruction sets the compiler may use on this host
+
+  hc_asprintf (&cmd, "%s -march=native -dM -E -x c - < /dev/null 2>&1", cc);
+
+  fp = popen (cmd, "r");
+
+  hcfree (cmd);
+
+  if (fp == NULL) return -1;
+
+  size_t macros_len   = 0;
+  size_t macros_avail = 0;
+
+  char *macros_buf = NULL;
+
+  while (true)
+  {
+    if (macros_len == macros_avail)
+    {
+      macros_buf = (char *) hcrealloc (macros_buf, macros_avail, HCBUFSIZ_LARGE);
+
+      macros_avail += HCBUFSIZ_LARGE;
+    }
+
+    const size_t nread = fread (macros_buf + macros_len, 1, macros_avail - macros_len, fp);
+
+    if (nread == 0) break;
+
+    macros_len += nread;
+  }
+
+  if ((pclose (fp) != 0) || (macros_len == 0))
+  {
+    hcfree (macros_buf);
+
+    return -1;
+  }
+
+  md5_ctx_t md5_ctx;
+
+  md5_init   (&md5_ctx);
+  md5_update (&md5_ctx, (u32 *) macros_buf, macros_len);
+  md5_final  (&md5_ctx);
+
+  hcfree (macros_buf);
+
+  char host_chksum[16] = { 0 };
+
+  snprintf (host_chksum, sizeof (host_chksum), "%08x", md5_ctx.h[0]);
+
+  backend_ctx->native_compiler         = hcstrdup (cc);
+  backend_ctx->native_compiler_version = hcstrdup (version);
+  backend_ctx->native_host_chksum      = hcstrdup (host_chksum);
+
+  backend_ctx->native = true;
+
+  return 0;
+}
+
+void native_close (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  if (backend_ctx->native == false) return;
+
+  hcfree (backend_ctx->native_compiler);
+  hcfree (backend_ctx->native_compiler_version);
+  hcfree (backend_ctx->native_host_chksum);
+
+  backend_ctx->native_compiler         = NULL;
+  backend_ctx->native_compiler_version = NULL;
+  backend_ctx->native_host_chksum      = NULL;
+
+  backend_ctx->native = false;
+}
+
+int hc_nativeDeviceInit (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  // device_name, use the cpu model if the os tells us
+
+  char *device_name = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  snprintf (device_name, HCBUFSIZ_TINY, "Native host CPU");
+
+  #if defined (__linux__)
+  FILE *fp = fopen ("/proc/cpuinfo", "rb");
+
+  if (fp)
+  {
+    char *line_buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+    while (fgets (line_buf, HCBUFSIZ_TINY, fp) != NULL)
+    {
+      if (strncmp (line_buf, "model name", 10) != 0) continue;
+
+      char *sep = strchr (line_buf, ':');
+
+      if (sep == NULL) continue;
+
+      snprintf (device_name, HCBUFSIZ_TINY, "%s", sep + 1);
+
+      break;
+    }
+
+    hcfree (line_buf);
+
+    fclose (fp);
+  }
+  #endif
+
+  hc_string_trim_leading  (device_name);
+  hc_string_trim_trailing (device_name);
+
+  device_param->device_name = device_name;
+
+  // device_processors, one worker thread each
+
+  device_param->device_processors = hc_get_processor_count ();
+
+  // device_global_mem, device_maxmem_alloc, device_available_mem
+
+  u64 mem_total = 0;
+  u64 mem_avail = 0;
+
+  #if defined (_WIN)
+  MEMORYSTATUSEX memory_status;
+
+  memory_status.dwLength = sizeof (memory_status);
+
+  if (GlobalMemoryStatusEx (&memory_status))
+  {
+    mem_total = (u64) memory_status.ullTotalPhys;
+    mem_avail = (u64) memory_status.ullAvailPhys;
+  }
+  #else
+  const long page_size = sysconf (_SC_PAGESIZE);
+  const long pages     = sysconf (_SC_PHYS_PAGES);
+
+  if ((page_size > 0) && (pages > 0)) mem_total = (u64) page_size * (u64) pages;
+
+  #if defined (__linux__)
+  // free pages alone would ignore the page cache, which the kernel gives back on demand
+
+  FILE *fp_mem = fopen ("/proc/meminfo", "rb");
+
+  if (fp_mem)
+  {
+    char *line_buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+    while (fgets (line_buf, HCBUFSIZ_TINY, fp_mem) != NULL)
+    {
+      unsigned long long kb = 0;
+
+      if (sscanf (line_buf, "MemAvailable: %llu kB", &kb) != 1) continue;
+
+      mem_avail = (u64) kb * 1024;
+
+      break;
+    }
+
+    hcfree (line_buf);
+
+    fclose (fp_mem);
+  }
+  #elif defined (_SC_AVPHYS_PAGES)
+  const long pages_avail = sysconf (_SC_AVPHYS_PAGES);
+
+  if ((page_size > 0) && (pages_avail > 0)) mem_avail = (u64) page_size * (u64) pages_avail;
+  #endif
+  #endif
+
+  if (mem_total == 0) return -1;
+
+  if ((mem_avail == 0) || (mem_avail > mem_total)) mem_avail = mem_total / 2;
+
+  device_param->device_global_mem    = mem_total;
+  device_param->device_maxmem_alloc  = mem_total / 4;
+  device_param->device_available_mem = mem_avail;
+
+  return 0;
+}
+
+int hc_nativeCompileProgram (hashcat_ctx_t *hashcat_ctx, const char *source_file, const char *binary_file, const char *build_options)
+{
+  backend_ctx_t  *backend_ctx   = hashcat_ctx->backend_ctx;
+  folder_config_t *folder_config = hashcat_ctx->folder_config;
+
+  // build into a temporary file first, a concurrent or aborted build must never leave a truncated shared object in the cache
+
+  char *tmp_file = NULL;
+
+  hc_asprintf (&tmp_file, "%s.%d.tmp", binary_file, (int) getpid ());
+
+  char *cmd = NULL;
+
+  hc_asprintf (&cmd, "%s -std=gnu99 -x c -O2 -march=native -fno-strict-aliasing -fPIC -shared -include \"%s/inc_native.h\" %s -o \"%s\" \"%s\" 2>&1", backend_ctx->native_compiler, folder_config->cpath_real, build_options, tmp_file, source_file);
+
+  FILE *fp = popen (cmd, "r");
+
+  hcfree (cmd);
+
+  if (fp == NULL)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", backend_ctx->native_compiler, strerror (errno));
+
+    hcfree (tmp_file);
+
+    return -1;
+  }
+
+  char *build_log = (char *) hcmalloc (HCBUFSIZ_LARGE);
+
+  size_t build_log_len = 0;
+
+  while (build_log_len < HCBUFSIZ_LARGE - 1)
+  {
+    const size_t nread = fread (build_log + build_log_len, 1, HCBUFSIZ_LARGE - 1 - build_log_len, fp);
+
+    if (nread == 0) break;
+
+    build_log_len += nread;
+  }
+
+  build_log[build_log_len] = 0;
+
+  const int rc_pclose = pclose (fp);
+
+  #if defined (DEBUG)
+  if ((build_log_len > 0) || (rc_pclose != 0))
+  #else
+  if (rc_pclose != 0)
+  #endif
+  {
+    puts (build_log);
+  }
+
+  hcfree (build_log);
+
+  if (rc_pclose != 0)
+  {
+    unlink (tmp_file);
+
+    hcfree (tmp_file);
+
+    return -1;
+  }
+
+  if (rename (tmp_file, binary_file) == -1)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", binary_file, strerror (errno));
+
+    unlink (tmp_file);
+
+    hcfree (tmp_file);
+
+    return -1;
+  }
+
+  hcfree (tmp_file);
+
+  return 0;
+}
+
+int hc_nativeProgramLoad (hashcat_ctx_t *hashcat_ctx, hc_native_program_t *program, const char *binary_file)
+{
+  // dlopen() needs a path, otherwise it would search the library path
+
+  char *path = NULL;
+
+  if (strchr (binary_file, '/') == NULL)
+  {
+    hc_asprintf (&path, "./%s", binary_file);
+  }
+  else
+  {
+    path = hcstrdup (binary_file);
+  }
+
+  program->lib = hc_dlopen (path);
+
+  hcfree (path);
+
+  if (program->lib == NULL)
+  {
+    #if defined (_WIN)
+    event_log_error (hashcat_ctx, "%s: failed to load native kernel.", binary_file);
+    #else
+    event_log_error (hashcat_ctx, "%s: %s", binary_file, dlerror ());
+    #endif
+
+    return -1;
+  }
+
+  program->gid_ptr = (NATIVE_GID_PTR) hc_dlsym (program->lib, "hc_native_gid_ptr");
+
+  if (program->gid_ptr == NULL)
+  {
+    event_log_error (hashcat_ctx, "%s: hc_native_gid_ptr is missing from native kernel.", binary_file);
+
+    hc_dlclose (program->lib);
+
+    program->lib = NULL;
+
+    return -1;
+  }
+
+  return 0;
+}
+
+int hc_nativeProgramUnload (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, hc_native_program_t *program)
+{
+  if (program->lib) hc_dlclose (program->lib);
+
+  program->lib     = NULL;
+  program->gid_ptr = NULL;
+
+  return 0;
+}
+
+int hc_nativeProgramGetFunction (hashcat_ctx_t *hashcat_ctx, hc_native_function_t *function, const hc_native_program_t *program, const char *name)
+{
+  function->kernel  = hc_dlsym (program->lib, name);
+  function->gid_ptr = program->gid_ptr;
+
+  if (function->kernel == NULL)
+  {
+    event_log_error (hashcat_ctx, "hc_nativeProgramGetFunction(): %s is missing from native kernel.", name);
+
+    return -1;
+  }
+
+  return 0;
+}
+
+int hc_nativeMemAlloc (hashcat_ctx_t *hashcat_ctx, void **ptr, const size_t size)
+{
+  // device memory of the native backend is host memory, keep it zero-initialized like hcmalloc() does
+
+  *ptr = hccalloc (1, size);
+
+  if (*ptr == NULL)
+  {
+    event_log_error (hashcat_ctx, "hc_nativeMemAlloc(): %s", MSG_ENOMEM);
+
+    return -1;
+  }
+
+  return 0;
+}
+
+int hc_nativeMemFree (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, void *ptr)
+{
+  hcfree (ptr);
+
+  return 0;
+}
+
+int hc_nativePoolCreate (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  native_pool_t *pool = (native_pool_t *) hcmalloc (sizeof (native_pool_t));
+
+  pool->threads_cnt = device_param->device_processors;
+
+  pool->threads = (hc_thread_t *) hccalloc (pool->threads_cnt, sizeof (hc_thread_t));
+
+  hc_thread_sem_init (pool->sem_start);
+  hc_thread_sem_init (pool->sem_done);
+
+  pool->shutdown = false;
+
+  for (int thread_idx = 0; thread_idx < pool->threads_cnt; thread_idx++)
+  {
+    hc_thread_create (pool->threads[thread_idx], native_pool_worker, pool);
+  }
+
+  device_param->native_pool = pool;
+
+  return 0;
+}
+
+int hc_nativePoolDestroy (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  native_pool_t *pool = device_param->native_pool;
+
+  if (pool == NULL) return 0;
+
+  pool->shutdown = true;
+
+  for (int thread_idx = 0; thread_idx < pool->threads_cnt; thread_idx++)
+  {
+    hc_thread_sem_post (pool->sem_start);
+  }
+
+  hc_thread_wait (pool->threads_cnt, pool->threads);
+
+  hc_thread_sem_close (pool->sem_start);
+  hc_thread_sem_close (pool->sem_done);
+
+  hcfree (pool->threads);
+  hcfree (pool);
+
+  device_param->native_pool = NULL;
+
+  return 0;
+}
+
+int hc_nativeLaunchKernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const hc_native_function_t *function, const native_kernel_args_t kernel_args, void **kernel_params, const u64 gid_max)
+{
+  native_pool_t *pool = device_param->native_pool;
+
+  if ((pool == NULL) || (function->kernel == NULL))
+  {
+    event_log_error (hashcat_ctx, "hc_nativeLaunchKernel(): kernel not loaded.");
+
+    return -1;
+  }
+
+  if (gid_max == 0) return 0;
+
+  // unpack the kernel_params pointer table once, the workers only see plain values
+
+  const char *layout = native_kernel_args_layout (kernel_args);
+
+  for (int i = 0; layout[i]; i++)
+  {
+    if (kernel_params[i] == NULL)
+    {
+      pool->args[i].u64 = 0;
+
+      continue;
+    }
+
+    switch (layout[i])
+    {
+      case 'P': pool->args[i].ptr = *(void **) kernel_params[i]; break;
+      case 'I': pool->args[i].u32 = *(u32 *)   kernel_params[i]; break;
+      case 'L': pool->args[i].u64 = *(u64 *)   kernel_params[i]; break;
+    }
+  }
+
+  pool->function    = *function;
+  pool->kernel_args = kernel_args;
+
+  // small chunks keep all threads busy even if the runtime per work-item varies, e.g. with different salt iterations
+
+  pool->gid_max   = gid_max;
+  pool->gid_chunk = MAX (gid_max / ((u64) pool->threads_cnt * 8), 1);
+  pool->gid_next  = 0;
+
+  for (int thread_idx = 0; thread_idx < pool->threads_cnt; thread_idx++)
+  {
+    hc_thread_sem_post (pool->sem_start);
+  }
+
+  for (int thread_idx = 0; thread_idx < pool->threads_cnt; thread_idx++)
+  {
+    hc_thread_sem_wait (pool->sem_done);
+  }
+
+  return 0;
+}
@@ -434,6 +434,10 @@ int build_debugdata (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
 
   if (debug_mode == 0) return 0;
 
+  // the rules before canonicalization, as the user wrote them
+
+  kernel_rule_t *kernel_rules = (straight_ctx->kernel_rules_orig != NULL) ? straight_ctx->kernel_rules_orig : straight_ctx->kernel_rules_buf;
+
   if (user_options->slow_candidates == true)
   {
     pw_pre_t *pw_base = device_param->pws_base_buf + gidvid;
@@ -441,7 +445,7 @@ int build_debugdata (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     // save rule
     if ((debug_mode == 1) || (debug_mode == 3) || (debug_mode == 4))
     {
-      const int len = kernel_rule_to_cpu_rule ((char *) debug_rule_buf, &straight_ctx->kernel_rules_buf[pw_base->rule_idx]);
+      const int len = kernel_rule_to_cpu_rule ((char *) debug_rule_buf, &kernel_rules[pw_base->rule_idx]);
 
       debug_rule_buf[len] = 0;
 
@@ -473,7 +477,7 @@ int build_debugdata (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     // save rule
     if ((debug_mode == 1) || (debug_mode == 3) || (debug_mode == 4))
     {
-      const int len = kernel_rule_to_cpu_rule ((char *) debug_rule_buf, &straight_ctx->kernel_rules_buf[off]);
+      const int len = kernel_rule_to_cpu_rule ((char *) debug_rule_buf, &kernel_rules[off]);
 
       debug_rule_buf[len] = 0;
 
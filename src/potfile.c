@@ -14,6 +14,8 @@
 #include "outfile.h"
 #include "locking.h"
 #include "shared.h"
+#include "thread.h"
+#include "cracksink.h"
 #include "potfile.h"
 
 static const char MASKED_PLAIN[] = "[notfound]";
@@ -58,47 +60,166 @@ static int sort_by_hash_t_salt (const void *v1, const void *v2)
 }
 */
 
-// this function is special and only used whenever --username and --show are used together:
-// it will sort all tree entries according to the settings stored in hashconfig
+// this function is used to reproduce the hash ordering based on the original input hash file
 
-int sort_pot_tree_by_hash (const void *v1, const void *v2)
+int sort_pot_orig_line (const void *v1, const void *v2)
 {
-  const pot_tree_entry_t *t1 = (const pot_tree_entry_t *) v1;
-  const pot_tree_entry_t *t2 = (const pot_tree_entry_t *) v2;
+  const pot_orig_line_entry_t *t1 = (const pot_orig_line_entry_t *) v1;
+  const pot_orig_line_entry_t *t2 = (const pot_orig_line_entry_t *) v2;
 
-  const hash_t *h1 = (const hash_t *) t1->nodes->hash_buf;
-  const hash_t *h2 = (const hash_t *) t2->nodes->hash_buf;
+  return t1->line_pos > t2->line_pos;
+}
 
-  hashconfig_t *hc = t1->hashconfig; // is same as t2->hashconfig
+static u32 pot_index_mix (u32 h, const u32 v)
+{
+  h ^= v;
+  h *= 0x9e3779b1;
+  h ^= h >> 15;
 
-  return sort_by_hash (h1, h2, hc);
+  return h;
 }
 
-// this function is used to reproduce the hash ordering based on the original input hash file
+// must be consistent with pot_index_equal (): equal keys need to produce the same hash, a subset of the key is fine
 
-int sort_pot_orig_line (const void *v1, const void *v2)
+static u32 pot_index_key (const hashconfig_t *hashconfig, const pot_index_t *pot_index, const hash_t *hash)
 {
-  const pot_orig_line_entry_t *t1 = (const pot_orig_line_entry_t *) v1;
-  const pot_orig_line_entry_t *t2 = (const pot_orig_line_entry_t *) v2;
+  u32 h = 0;
 
-  return t1->line_pos > t2->line_pos;
+  const salt_t *salt = hash->salt;
+
+  if (pot_index->salt_only == true)
+  {
+    const u8 *salt_ptr = (const u8 *) salt->salt_buf;
+
+    const u32 salt_len = MIN (salt->salt_len, sizeof (salt->salt_buf));
+
+    h = pot_index_mix (h, salt_len);
+
+    for (u32 i = 0; i < salt_len; i++)
+    {
+      h = pot_index_mix (h, salt_ptr[i]);
+    }
+
+    return h;
+  }
+
+  if (hashconfig->is_salted == true)
+  {
+    h = pot_index_mix (h, salt->orig_pos);
+    h = pot_index_mix (h, salt->salt_len);
+    h = pot_index_mix (h, salt->salt_iter);
+
+    for (int i = 0; i < 16; i++)
+    {
+      h = pot_index_mix (h, salt->salt_buf[i]);
+    }
+  }
+
+  const u32 *digest = (const u32 *) hash->digest;
+
+  h = pot_index_mix (h, digest[hashconfig->dgst_pos0]);
+  h = pot_index_mix (h, digest[hashconfig->dgst_pos1]);
+  h = pot_index_mix (h, digest[hashconfig->dgst_pos2]);
+  h = pot_index_mix (h, digest[hashconfig->dgst_pos3]);
+
+  return h;
+}
+
+static bool pot_index_equal (const hashconfig_t *hashconfig, const pot_index_t *pot_index, const hash_t *h1, const hash_t *h2)
+{
+  if (pot_index->salt_only == true)
+  {
+    const salt_t *s1 = h1->salt;
+    const salt_t *s2 = h2->salt;
+
+    if (s1->salt_len != s2->salt_len) return false;
+
+    return (memcmp (s1->salt_buf, s2->salt_buf, MIN (s1->salt_len, sizeof (s1->salt_buf))) == 0);
+  }
+
+  return (sort_by_hash (h1, h2, (void *) hashconfig) == 0);
 }
 
-// the problem with the GNU tdestroy () function is that it doesn't work with mingw etc
-// there are 2 alternatives:
-// 1. recursively delete the entries with entry->left and entry->right
-// 2. use tdelete () <- this is what we currently use, but this could be slower!
+int pot_index_init (hashcat_ctx_t *hashcat_ctx, pot_index_t *pot_index, const bool salt_only)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const hashes_t     *hashes     = hashcat_ctx->hashes;
+
+  hash_t *hashes_buf = hashes->hashes_buf;
+  u32     hashes_cnt = hashes->hashes_cnt;
+
+  // in lean mode the sorted digests_buf is searched directly, see potfile_parse_line ()
+
+  if (hashes->lean == true)
+  {
+    memset (pot_index, 0, sizeof (pot_index_t));
+
+    pot_index->salt_only = salt_only;
+
+    return 0;
+  }
+
+  // load factor of at most 50%
+
+  u64 slots_cnt = 16;
 
-void pot_tree_destroy (pot_tree_entry_t *tree)
+  while (slots_cnt < (u64) hashes_cnt * 2) slots_cnt *= 2;
+
+  if (slots_cnt > 0x80000000)
+  {
+    event_log_error (hashcat_ctx, "Too many hashes for the potfile index.");
+
+    return -1;
+  }
+
+  pot_index->slots     = (u32 *) hccalloc (slots_cnt, sizeof (u32));
+  pot_index->keys      = (u32 *) hccalloc (slots_cnt, sizeof (u32));
+  pot_index->mask      = (u32) (slots_cnt - 1);
+  pot_index->salt_only = salt_only;
+
+  for (u32 hash_pos = 0; hash_pos < hashes_cnt; hash_pos++)
+  {
+    const u32 key = pot_index_key (hashconfig, pot_index, &hashes_buf[hash_pos]);
+
+    u32 slot = key & pot_index->mask;
+
+    while (pot_index->slots[slot] != 0) slot = (slot + 1) & pot_index->mask;
+
+    pot_index->slots[slot] = hash_pos + 1;
+    pot_index->keys[slot]  = key;
+  }
+
+  return 0;
+}
+
+void pot_index_destroy (pot_index_t *pot_index)
 {
-  pot_tree_entry_t *entry = tree;
+  hcfree (pot_index->slots);
+  hcfree (pot_index->keys);
+
+  pot_index->slots = NULL;
+  pot_index->keys  = NULL;
+  pot_index->mask  = 0;
+}
+
+// returns the next entry of hashes_buf matching hash_buf, start with *slot = pot_index_key () & pot_index->mask
 
-  while (tree != NULL)
+static hash_t *pot_index_find (const hashconfig_t *hashconfig, const pot_index_t *pot_index, hash_t *hashes_buf, const hash_t *hash_buf, const u32 key, u32 *slot)
+{
+  while (pot_index->slots[*slot] != 0)
   {
-    entry = *(pot_tree_entry_t **) tree;
+    const u32 cur = *slot;
+
+    *slot = (*slot + 1) & pot_index->mask;
+
+    if (pot_index->keys[cur] != key) continue;
 
-    tdelete (entry, (void **) &tree, sort_pot_tree_by_hash);
+    hash_t *hash = &hashes_buf[pot_index->slots[cur] - 1];
+
+    if (pot_index_equal (hashconfig, pot_index, hash, hash_buf) == true) return hash;
   }
+
+  return NULL;
 }
 
 int potfile_init (hashcat_ctx_t *hashcat_ctx)
@@ -294,18 +415,11 @@ void potfile_write_append (hashcat_ctx_t *hashcat_ctx, const char *out_buf, cons
     }
   }
 
-  tmp_buf[tmp_len] = 0;
-
-  hc_lockfile (&potfile_ctx->fp);
-
-  hc_fprintf (&potfile_ctx->fp, "%s" EOL, tmp_buf);
+  memcpy (tmp_buf + tmp_len, EOL, strlen (EOL));
 
-  hc_fflush (&potfile_ctx->fp);
+  tmp_len += strlen (EOL);
 
-  if (hc_unlockfile (&potfile_ctx->fp))
-  {
-    event_log_error (hashcat_ctx, "%s: Failed to unlock file.", potfile_ctx->filename);
-  }
+  cracksink_push (hashcat_ctx, CRACKSINK_POTFILE, tmp_buf, tmp_len);
 }
 
 void potfile_update_hash (hashcat_ctx_t *hashcat_ctx, hash_t *found, char *line_pw_buf, int line_pw_len)
@@ -337,294 +451,451 @@ void potfile_update_hash (hashcat_ctx_t *hashcat_ctx, hash_t *found, char *line_
   }
 }
 
-void potfile_update_hashes (hashcat_ctx_t *hashcat_ctx, hash_t *hash_buf, char *line_pw_buf, int line_pw_len, pot_tree_entry_t *tree)
+static void potfile_update_digest (hashcat_ctx_t *hashcat_ctx, const u32 digest_pos, const char *pw_buf, const u32 pw_len)
 {
-  hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const hashes_t       *hashes       = hashcat_ctx->hashes;
+  const loopback_ctx_t *loopback_ctx = hashcat_ctx->loopback_ctx;
 
-  // the linked list node:
+  // lean mode counterpart of potfile_update_hash (), there is no hash_t to store the plain in
 
-  pot_hash_node_t search_node;
+  hashes->digests_shown[digest_pos] = 1;
 
-  search_node.hash_buf = hash_buf;
-  search_node.next     = NULL;
+  if (loopback_ctx->fp.pfp != NULL)
+  {
+    loopback_write_append (hashcat_ctx, (const u8 *) pw_buf, (unsigned int) pw_len);
+  }
+}
 
-  // the search entry:
+static void pot_chunk_add (pot_chunk_t *chunk, hash_t *hash, const u32 digest_pos, const char *pw_buf, const u32 pw_len)
+{
+  if (chunk->matches_cnt == chunk->matches_avail)
+  {
+    chunk->matches = (pot_match_t *) hcrealloc (chunk->matches, chunk->matches_avail * sizeof (pot_match_t), INCR_POT * sizeof (pot_match_t));
 
-  pot_tree_entry_t search_entry;
+    chunk->matches_avail += INCR_POT;
+  }
 
-  search_entry.nodes      = &search_node;
-  search_entry.hashconfig = hashconfig;
+  pot_match_t *match = &chunk->matches[chunk->matches_cnt];
 
-  // the main search function is this:
+  match->hash       = hash;
+  match->digest_pos = digest_pos;
+  match->pw_buf     = pw_buf;
+  match->pw_len     = pw_len;
 
-  void **found = (void **) tfind (&search_entry, (void **) &tree, sort_pot_tree_by_hash);
+  chunk->matches_cnt++;
+}
 
-  if (found)
+static void pot_chunk_apply (hashcat_ctx_t *hashcat_ctx, pot_chunk_t *chunk)
+{
+  for (u64 i = 0; i < chunk->matches_cnt; i++)
   {
-    pot_tree_entry_t *found_entry = (pot_tree_entry_t *) *found;
+    const pot_match_t *match = &chunk->matches[i];
 
-    pot_hash_node_t *node = found_entry->nodes;
-
-    while (node)
+    if (match->hash == NULL)
     {
-      potfile_update_hash (hashcat_ctx, node->hash_buf, line_pw_buf, line_pw_len);
+      potfile_update_digest (hashcat_ctx, match->digest_pos, match->pw_buf, match->pw_len);
 
-      node = node->next;
+      continue;
     }
+
+    potfile_update_hash (hashcat_ctx, match->hash, (char *) match->pw_buf, (int) match->pw_len);
   }
+
+  chunk->matches_cnt = 0;
 }
 
-int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
+static void pot_thread_param_init (hashcat_ctx_t *hashcat_ctx, pot_thread_param_t *param, const pot_index_t *pot_index)
 {
-  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  const hashes_t       *hashes       = hashcat_ctx->hashes;
-  const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
-  potfile_ctx_t        *potfile_ctx  = hashcat_ctx->potfile_ctx;
-
-  if (potfile_ctx->enabled == false) return 0;
-
-  if (hashconfig->potfile_disable == true) return 0;
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
 
-  if (hashconfig->opts_type & OPTS_TYPE_PT_NEVERCRACK) return 0;
-
-  // if no potfile exists yet we don't need to do anything here
-
-  if (hc_path_exist (potfile_ctx->filename) == false) return 0;
-
-  hash_t *hashes_buf = hashes->hashes_buf;
-  u32     hashes_cnt = hashes->hashes_cnt;
+  param->hashcat_ctx = hashcat_ctx;
+  param->pot_index   = pot_index;
 
   // no solution for these special hash types (for instane because they use hashfile in output etc)
 
-  hash_t hash_buf;
+  hash_t *hash_buf = &param->hash_buf;
 
-  hash_buf.digest    = hcmalloc (hashconfig->dgst_size);
-  hash_buf.salt      = NULL;
-  hash_buf.esalt     = NULL;
-  hash_buf.hook_salt = NULL;
-  hash_buf.cracked   = 0;
-  hash_buf.hash_info = NULL;
-  hash_buf.pw_buf    = NULL;
-  hash_buf.pw_len    = 0;
+  hash_buf->digest    = hcmalloc (hashconfig->dgst_size);
+  hash_buf->salt      = NULL;
+  hash_buf->esalt     = NULL;
+  hash_buf->hook_salt = NULL;
+  hash_buf->cracked   = 0;
+  hash_buf->hash_info = NULL;
+  hash_buf->pw_buf    = NULL;
+  hash_buf->pw_len    = 0;
 
   if (hashconfig->is_salted == true)
   {
-    hash_buf.salt = (salt_t *) hcmalloc (sizeof (salt_t));
+    hash_buf->salt = (salt_t *) hcmalloc (sizeof (salt_t));
   }
 
   if (hashconfig->esalt_size > 0)
   {
-    hash_buf.esalt = hcmalloc (hashconfig->esalt_size);
+    hash_buf->esalt = hcmalloc (hashconfig->esalt_size);
   }
 
   if (hashconfig->hook_salt_size > 0)
   {
-    hash_buf.hook_salt = hcmalloc (hashconfig->hook_salt_size);
+    hash_buf->hook_salt = hcmalloc (hashconfig->hook_salt_size);
   }
 
-  // we only need this variable in a very specific situation:
-  // whenever we use --username and --show together we want to keep all hashes sorted within a nice structure
-
-  pot_tree_entry_t *all_hashes_tree  = NULL;
-  pot_tree_entry_t *tree_entry_cache = NULL;
-  pot_hash_node_t  *tree_nodes_cache = NULL;
+  param->tmps = NULL;
 
-  if (hashconfig->potfile_keep_all_hashes == true)
+  if (hashconfig->tmp_size > 0)
   {
-    // we need *at most* one entry for every hash
-    // (if there are no hashes with the same keys (hash + salt), a counter example would be: same hash but different user name)
-    tree_entry_cache = (pot_tree_entry_t *) hccalloc (hashes_cnt, sizeof (pot_tree_entry_t));
+    param->tmps = hcmalloc (hashconfig->tmp_size);
+  }
 
-    // we need *always exactly* one linked list for every hash
-    tree_nodes_cache = (pot_hash_node_t  *) hccalloc (hashes_cnt, sizeof (pot_hash_node_t));
+  param->line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+}
 
-    for (u32 hash_pos = 0; hash_pos < hashes_cnt; hash_pos++)
-    {
-      // initialize the linked list node:
-      // we always need to create a new one and add it, because we want to keep and later update all hashes:
+static void pot_thread_param_destroy (pot_thread_param_t *param)
+{
+  hcfree (param->line_buf);
+  hcfree (param->tmps);
+
+  hcfree (param->hash_buf.esalt);
+  hcfree (param->hash_buf.hook_salt);
+  hcfree (param->hash_buf.salt);
+  hcfree (param->hash_buf.digest);
+}
+
+// decodes a single potfile line and records every hash it cracks in chunk
+// line_src is where the line came from, the recorded plains point there instead of into the (reused) line_buf
 
-      pot_hash_node_t *new_node = &tree_nodes_cache[hash_pos];
+static void potfile_parse_line (pot_thread_param_t *param, pot_chunk_t *chunk, char *line_buf, const size_t line_len, const char *line_src)
+{
+  hashcat_ctx_t *hashcat_ctx = param->hashcat_ctx;
 
-      new_node->hash_buf = &hashes_buf[hash_pos];
-      new_node->next     = NULL;
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const hashes_t     *hashes     = hashcat_ctx->hashes;
+  const module_ctx_t *module_ctx = hashcat_ctx->module_ctx;
+  const pot_index_t  *pot_index  = param->pot_index;
 
-      // initialize the entry:
+  hash_t *hashes_buf = hashes->hashes_buf;
+  u32     hashes_cnt = hashes->hashes_cnt;
 
-      pot_tree_entry_t *new_entry = &tree_entry_cache[hash_pos];
+  hash_t *hash_buf = &param->hash_buf;
+  void   *tmps     = param->tmps;
 
-      // note: the "key" (hash + salt) is indirectly accessible via the first nodes "hash_buf"
+  char *last_separator = strrchr (line_buf, hashconfig->separator);
 
-      new_entry->nodes      = new_node;
-      // the hashconfig is needed here because we need to be able to check within the sort function if we also need
-      // to sort by salt and we also need to have the correct order of dgst_pos0...dgst_pos3:
-      new_entry->hashconfig = (hashconfig_t *) hashconfig; // "const hashconfig_t" gives a warning
+  if (last_separator == NULL) return; // ??
 
-      // the following function searches if the "key" is already present and if not inserts the new entry:
+  char *line_pw_buf = last_separator + 1;
 
-      void **found = (void **) tsearch (new_entry, (void **) &all_hashes_tree, sort_pot_tree_by_hash);
+  size_t line_pw_len = line_buf + line_len - line_pw_buf;
 
-      pot_tree_entry_t *found_entry = (pot_tree_entry_t *) *found;
+  const char *pw_buf = line_src + (line_pw_buf - line_buf);
 
-      // we now need to check these cases; tsearch () could return:
-      // 1. NULL : if we have a memory allocation problem (not enough memory for the tree structure)
-      // 2. found_entry == new_entry: if we successfully insert a new key (which was not present yet)
-      // 3. found_entry != new_entry: if the key was already present
+  char *line_hash_buf = line_buf;
 
-      // case 1: memory allocation error
+  int line_hash_len = last_separator - line_buf;
 
-      if (found_entry == NULL)
-      {
-        fprintf (stderr, "Error while allocating memory for the potfile search: %s\n", MSG_ENOMEM);
+  line_hash_buf[line_hash_len] = 0;
 
-        return -1;
-      }
+  if (line_hash_len == 0) return;
+
+  if (hash_buf->salt)
+  {
+    memset (hash_buf->salt, 0, sizeof (salt_t));
+  }
+
+  if (hash_buf->esalt)
+  {
+    memset (hash_buf->esalt, 0, hashconfig->esalt_size);
+  }
+
+  if (hash_buf->hook_salt)
+  {
+    memset (hash_buf->hook_salt, 0, hashconfig->hook_salt_size);
+  }
+
+  if (module_ctx->module_hash_decode_potfile != MODULE_DEFAULT)
+  {
+    if (module_ctx->module_potfile_custom_check != MODULE_DEFAULT)
+    {
+      const int parser_status = module_ctx->module_hash_decode_potfile (hashconfig, hash_buf->digest, hash_buf->salt, hash_buf->esalt, hash_buf->hook_salt, hash_buf->hash_info, line_hash_buf, line_hash_len, tmps);
 
-      // case 2: this means it was a new insert (and the insert was successful)
+      if (parser_status != PARSER_OK) return;
 
-      if (found_entry == new_entry)
+      // modules which do not decode the salt from the potfile line need to check every hash
+
+      if ((hash_buf->salt != NULL) && (hash_buf->salt->salt_len > 0))
       {
-        // no updates to the linked list required (since it is the first one!)
+        const u32 key = pot_index_key (hashconfig, pot_index, hash_buf);
+
+        u32 slot = key & pot_index->mask;
+
+        hash_t *found;
+
+        while ((found = pot_index_find (hashconfig, pot_index, hashes_buf, hash_buf, key, &slot)) != NULL)
+        {
+          const bool cracked = module_ctx->module_potfile_custom_check (hashconfig, found, hash_buf, tmps);
+
+          if (cracked == true)
+          {
+            pot_chunk_add (chunk, found, 0, pw_buf, (u32) line_pw_len);
+          }
+        }
+
+        return;
       }
-      // case 3: if we have found an already existing entry
-      else
+
+      for (u32 hashes_pos = 0; hashes_pos < hashes_cnt; hashes_pos++)
       {
-        new_node->next = found_entry->nodes;
+        const bool cracked = module_ctx->module_potfile_custom_check (hashconfig, &hashes_buf[hashes_pos], hash_buf, tmps);
+
+        if (cracked == true)
+        {
+          pot_chunk_add (chunk, &hashes_buf[hashes_pos], 0, pw_buf, (u32) line_pw_len);
+        }
       }
 
-      // we always insert the new node at the very beginning
-      // (or in other words: the head of the linked list always points to *this* new inserted node)
+      return;
+    }
+
+    // should be rejected?
+    //const int parser_status = module_ctx->module_hash_decode_potfile (hashconfig, hash_buf->digest, hash_buf->salt, hash_buf->esalt, hash_buf->hook_salt, hash_buf->hash_info, line_hash_buf, line_hash_len, NULL);
+    //if (parser_status != PARSER_OK) return;
+  }
+  else
+  {
+    const int parser_status = module_ctx->module_hash_decode (hashconfig, hash_buf->digest, hash_buf->salt, hash_buf->esalt, hash_buf->hook_salt, hash_buf->hash_info, line_hash_buf, line_hash_len);
+
+    if (parser_status != PARSER_OK) return;
+
+    if (hashes->lean == true)
+    {
+      const u32 dgst_size = hashconfig->dgst_size;
+
+      const u8 *digest = (const u8 *) hc_bsearch_r (hash_buf->digest, hashes->digests_buf, hashes_cnt, dgst_size, sort_by_digest_p0p1, (void *) hashconfig);
+
+      if (digest == NULL) return;
+
+      pot_chunk_add (chunk, NULL, (u32) ((digest - (const u8 *) hashes->digests_buf) / dgst_size), pw_buf, (u32) line_pw_len);
+
+      return;
+    }
+
+    const u32 key = pot_index_key (hashconfig, pot_index, hash_buf);
+
+    u32 slot = key & pot_index->mask;
+
+    hash_t *found;
+
+    while ((found = pot_index_find (hashconfig, pot_index, hashes_buf, hash_buf, key, &slot)) != NULL)
+    {
+      pot_chunk_add (chunk, found, 0, pw_buf, (u32) line_pw_len);
+
+      // only with --show and --username there can be more than one hash with the same key, we want to update all of them
 
-      found_entry->nodes = new_node;
+      if (hashconfig->potfile_keep_all_hashes == false) break;
     }
   }
+}
 
-  const int rc = potfile_read_open (hashcat_ctx);
+static void potfile_parse_chunk (pot_thread_param_t *param, pot_chunk_t *chunk)
+{
+  const potfile_ctx_t *potfile_ctx = param->hashcat_ctx->potfile_ctx;
 
-  if (rc == -1) return -1;
+  const char *buf = potfile_ctx->fp.mmap_buf;
 
-  void *tmps = NULL;
+  u64 pos = chunk->beg;
 
-  if (hashconfig->tmp_size > 0)
+  while (pos < chunk->end)
   {
-    tmps = hcmalloc (hashconfig->tmp_size);
+    const char *line_src = buf + pos;
+
+    const char *nl = (const char *) memchr (line_src, '\n', chunk->end - pos);
+
+    size_t line_len = (nl == NULL) ? (size_t) (chunk->end - pos) : (size_t) (nl - line_src);
+
+    pos += line_len + 1;
+
+    // same as fgetl ()
+
+    while ((line_len > 0) && (line_src[line_len - 1] == '\r')) line_len--;
+
+    if (line_len == 0) continue;
+
+    if (line_len >= HCBUFSIZ_LARGE)
+    {
+      fprintf (stderr, "\nOversized line detected! Truncated %" PRIu64 " bytes\n", (u64) (line_len - (HCBUFSIZ_LARGE - 1)));
+
+      line_len = HCBUFSIZ_LARGE - 1;
+    }
+
+    memcpy (param->line_buf, line_src, line_len);
+
+    param->line_buf[line_len] = 0;
+
+    potfile_parse_line (param, chunk, param->line_buf, line_len, line_src);
   }
+}
 
-  char *line_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+static void *potfile_parse_thread (void *p)
+{
+  pot_thread_param_t *param = (pot_thread_param_t *) p;
 
-  while (!hc_feof (&potfile_ctx->fp))
+  for (u32 i = param->tid; i < param->chunks_cnt; i += param->tsz)
   {
-    size_t line_len = fgetl (&potfile_ctx->fp, line_buf, HCBUFSIZ_LARGE);
+    potfile_parse_chunk (param, param->chunks + i);
+  }
 
-    if (line_len == 0) continue;
+  return NULL;
+}
 
-    char *last_separator = strrchr (line_buf, hashconfig->separator);
+int potfile_remove_parse (hashcat_ctx_t *hashcat_ctx)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  potfile_ctx_t        *potfile_ctx  = hashcat_ctx->potfile_ctx;
 
-    if (last_separator == NULL) continue; // ??
+  if (potfile_ctx->enabled == false) return 0;
 
-    char *line_pw_buf = last_separator + 1;
+  if (hashconfig->potfile_disable == true) return 0;
 
-    size_t line_pw_len = line_buf + line_len - line_pw_buf;
+  if (hashconfig->opts_type & OPTS_TYPE_PT_NEVERCRACK) return 0;
 
-    char *line_hash_buf = line_buf;
+  // if no potfile exists yet we don't need to do anything here
 
-    int line_hash_len = last_separator - line_buf;
+  if (hc_path_exist (potfile_ctx->filename) == false) return 0;
 
-    line_hash_buf[line_hash_len] = 0;
+  // all lookups go through the index, module_potfile_custom_check () users can only use the salt to skip hashes
+  // of course the index is also used whenever --username and --show are used together to update all hashes with the same key
 
-    if (line_hash_len == 0) continue;
+  const bool salt_only = (module_ctx->module_hash_decode_potfile != MODULE_DEFAULT) && (module_ctx->module_potfile_custom_check != MODULE_DEFAULT);
 
-    if (hash_buf.salt)
-    {
-      memset (hash_buf.salt, 0, sizeof (salt_t));
-    }
+  pot_index_t pot_index;
 
-    if (hash_buf.esalt)
-    {
-      memset (hash_buf.esalt, 0, hashconfig->esalt_size);
-    }
+  if (pot_index_init (hashcat_ctx, &pot_index, salt_only) == -1) return -1;
 
-    if (hash_buf.hook_salt)
-    {
-      memset (hash_buf.hook_salt, 0, hashconfig->hook_salt_size);
-    }
+  const int rc = potfile_read_open (hashcat_ctx);
+
+  if (rc == -1)
+  {
+    pot_index_destroy (&pot_index);
+
+    return -1;
+  }
+
+  hc_fmmap (&potfile_ctx->fp);
+
+  // a mapped potfile can be split into chunks on line boundaries, these are decoded in parallel
+  // only potfile_update_hash () is left to the calling thread, in file order so the result is the same as a sequential run
+
+  const int processor_count = hc_get_processor_count ();
+
+  const bool parallel = (potfile_ctx->fp.is_mmap == true) && (potfile_ctx->fp.mmap_len > POT_CHUNK_SIZE) && (processor_count > 1);
+
+  if (parallel == true)
+  {
+    const u64 size = potfile_ctx->fp.mmap_len;
 
-    if (module_ctx->module_hash_decode_potfile != MODULE_DEFAULT)
+    const char *buf = potfile_ctx->fp.mmap_buf;
+
+    pot_chunk_t *chunks = (pot_chunk_t *) hccalloc (CEILDIV (size, POT_CHUNK_SIZE), sizeof (pot_chunk_t));
+
+    u32 chunks_cnt = 0;
+
+    u64 beg = 0;
+
+    while (beg < size)
     {
-      if (module_ctx->module_potfile_custom_check != MODULE_DEFAULT)
+      u64 end = MIN (beg + POT_CHUNK_SIZE, size);
+
+      if (end < size)
       {
-        const int parser_status = module_ctx->module_hash_decode_potfile (hashconfig, hash_buf.digest, hash_buf.salt, hash_buf.esalt, hash_buf.hook_salt, hash_buf.hash_info, line_hash_buf, line_hash_len, tmps);
+        const char *nl = (const char *) memchr (buf + end - 1, '\n', size - end + 1);
 
-        if (parser_status != PARSER_OK) continue;
+        end = (nl == NULL) ? size : (u64) (nl - buf) + 1;
+      }
 
-        for (u32 hashes_pos = 0; hashes_pos < hashes_cnt; hashes_pos++)
-        {
-          const bool cracked = module_ctx->module_potfile_custom_check (hashconfig, &hashes_buf[hashes_pos], &hash_buf, tmps);
+      chunks[chunks_cnt].beg = beg;
+      chunks[chunks_cnt].end = end;
 
-          if (cracked == true)
-          {
-            potfile_update_hash (hashcat_ctx, &hashes_buf[hashes_pos], line_pw_buf, (u32) line_pw_len);
-          }
-        }
+      chunks_cnt++;
 
-        continue;
-      }
+      beg = end;
+    }
+
+    const int tsz = MIN (processor_count, (int) chunks_cnt);
+
+    hc_thread_t *p_threads = (hc_thread_t *) hccalloc (tsz, sizeof (hc_thread_t));
+
+    pot_thread_param_t *params = (pot_thread_param_t *) hccalloc (tsz, sizeof (pot_thread_param_t));
+
+    for (int tid = 0; tid < tsz; tid++)
+    {
+      pot_thread_param_t *param = params + tid;
+
+      pot_thread_param_init (hashcat_ctx, param, &pot_index);
 
-      // should be rejected?
-      //const int parser_status = module_ctx->module_hash_decode_potfile (hashconfig, hash_buf.digest, hash_buf.salt, hash_buf.esalt, hash_buf.hook_salt, hash_buf.hash_info, line_hash_buf, line_hash_len, NULL);
-      //if (parser_status != PARSER_OK) continue;
+      param->tid        = tid;
+      param->tsz        = tsz;
+      param->chunks     = chunks;
+      param->chunks_cnt = chunks_cnt;
     }
-    else
+
+    for (int tid = 1; tid < tsz; tid++)
     {
-      const int parser_status = module_ctx->module_hash_decode (hashconfig, hash_buf.digest, hash_buf.salt, hash_buf.esalt, hash_buf.hook_salt, hash_buf.hash_info, line_hash_buf, line_hash_len);
+      hc_thread_create (p_threads[tid], potfile_parse_thread, params + tid);
+    }
 
-      if (parser_status != PARSER_OK) continue;
+    potfile_parse_thread (params);
 
-      if (hashconfig->potfile_keep_all_hashes == true)
-      {
-        potfile_update_hashes (hashcat_ctx, &hash_buf, line_pw_buf, (u32) line_pw_len, all_hashes_tree);
+    hc_thread_wait (tsz - 1, p_threads + 1);
 
-        continue;
-      }
+    for (u32 i = 0; i < chunks_cnt; i++)
+    {
+      pot_chunk_apply (hashcat_ctx, chunks + i);
 
-      hash_t *found = (hash_t *) hc_bsearch_r (&hash_buf, hashes_buf, hashes_cnt, sizeof (hash_t), sort_by_hash, (void *) hashconfig);
+      hcfree (chunks[i].matches);
+    }
 
-      potfile_update_hash (hashcat_ctx, found, line_pw_buf, (u32) line_pw_len);
+    for (int tid = 0; tid < tsz; tid++)
+    {
+      pot_thread_param_destroy (params + tid);
     }
+
+    hcfree (params);
+    hcfree (p_threads);
+    hcfree (chunks);
   }
+  else
+  {
+    pot_thread_param_t param;
 
-  hcfree (line_buf);
+    memset (&param, 0, sizeof (param));
 
-  if (hashconfig->tmp_size > 0)
-  {
-    hcfree (tmps);
-  }
+    pot_thread_param_init (hashcat_ctx, &param, &pot_index);
 
-  potfile_read_close (hashcat_ctx);
+    pot_chunk_t chunk;
 
-  if (hashconfig->potfile_keep_all_hashes == true)
-  {
-    pot_tree_destroy (all_hashes_tree); // this could be slow (should we just skip it?)
+    memset (&chunk, 0, sizeof (chunk));
 
-    hcfree (tree_nodes_cache);
-    hcfree (tree_entry_cache);
-  }
+    while (!hc_feof (&potfile_ctx->fp))
+    {
+      size_t line_len = fgetl (&potfile_ctx->fp, param.line_buf, HCBUFSIZ_LARGE);
 
-  if (hashconfig->esalt_size > 0)
-  {
-    hcfree (hash_buf.esalt);
-  }
+      if (line_len == 0) continue;
 
-  if (hashconfig->hook_salt_size > 0)
-  {
-    hcfree (hash_buf.hook_salt);
-  }
+      potfile_parse_line (&param, &chunk, param.line_buf, line_len, param.line_buf);
 
-  if (hashconfig->is_salted == true)
-  {
-    hcfree (hash_buf.salt);
+      // the recorded plains point into line_buf, which is overwritten by the next line
+
+      pot_chunk_apply (hashcat_ctx, &chunk);
+    }
+
+    hcfree (chunk.matches);
+
+    pot_thread_param_destroy (&param);
   }
 
-  hcfree (hash_buf.digest);
+  potfile_read_close (hashcat_ctx);
+
+  pot_index_destroy (&pot_index);
 
   return 0;
 }
@@ -11,6 +11,7 @@
 #include "shared.h"
 #include "pidfile.h"
 #include "folder.h"
+#include "cracksink.h"
 #include "restore.h"
 
 #if defined (_WIN)
@@ -249,6 +250,10 @@ int cycle_restore (hashcat_ctx_t *hashcat_ctx)
 
   if (restore_ctx->enabled == false) return 0;
 
+  // cracks found up to the checkpoint must be on disk before the restore point moves past them
+
+  cracksink_flush (hashcat_ctx);
+
   const char *eff_restore_file = restore_ctx->eff_restore_file;
   const char *new_restore_file = restore_ctx->new_restore_file;
 
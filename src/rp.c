@@ -700,23 +700,125 @@ bool kernel_rules_has_noop (const kernel_rule_t *kernel_rules_buf, const u32 ker
   return false;
 }
 
-int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32 *out_cnt)
+// drop the no-op functions, a rule that consists of no-ops only becomes a single ':' again
+
+static void kernel_rule_canonicalize (kernel_rule_t *rule)
+{
+  u32 out_pos = 0;
+
+  for (u32 in_pos = 0; in_pos < RULES_MAX; in_pos++)
+  {
+    const u32 cmd = rule->cmds[in_pos];
+
+    if (cmd == 0) break;
+
+    if ((cmd & 0xff) == RULE_OP_MANGLE_NOOP) continue;
+
+    rule->cmds[out_pos++] = cmd;
+  }
+
+  if (out_pos == 0) rule->cmds[out_pos++] = RULE_OP_MANGLE_NOOP;
+
+  memset (rule->cmds + out_pos, 0, (RULES_MAX - out_pos) * sizeof (u32));
+}
+
+static u32 kernel_rule_hash (const kernel_rule_t *rule)
+{
+  u32 hash = 0x811c9dc5;
+
+  for (u32 pos = 0; pos < RULES_MAX; pos++)
+  {
+    const u32 cmd = rule->cmds[pos];
+
+    if (cmd == 0) break;
+
+    hash = (hash ^ cmd) * 0x01000193;
+  }
+
+  return hash ^ (hash >> 16);
+}
+
+// canonicalizes the rules in-place and removes the duplicates, the first occurrence of a rule keeps its position
+// kernel_rules_orig is optional, it holds the same rules before canonicalization and is compacted alongside
+
+static u32 kernel_rules_dedup (kernel_rule_t *kernel_rules_buf, kernel_rule_t *kernel_rules_orig, const u32 kernel_rules_cnt)
+{
+  if (kernel_rules_cnt == 0) return 0;
+
+  u32 slots_cnt = 1;
+
+  while (slots_cnt < (kernel_rules_cnt * 2ULL)) slots_cnt <<= 1;
+
+  const u32 slots_mask = slots_cnt - 1;
+
+  u32 *slots = (u32 *) hccalloc (slots_cnt, sizeof (u32)); // index + 1, 0 means free
+
+  u32 out_cnt = 0;
+
+  for (u32 in_idx = 0; in_idx < kernel_rules_cnt; in_idx++)
+  {
+    kernel_rule_t *rule = &kernel_rules_buf[in_idx];
+
+    kernel_rule_canonicalize (rule);
+
+    u32 slot = kernel_rule_hash (rule) & slots_mask;
+
+    bool dupe = false;
+
+    while (slots[slot] != 0)
+    {
+      if (memcmp (&kernel_rules_buf[slots[slot] - 1], rule, sizeof (kernel_rule_t)) == 0)
+      {
+        dupe = true;
+
+        break;
+      }
+
+      slot = (slot + 1) & slots_mask;
+    }
+
+    if (dupe == true) continue;
+
+    if (out_cnt != in_idx)
+    {
+      memcpy (&kernel_rules_buf[out_cnt], rule, sizeof (kernel_rule_t));
+
+      if (kernel_rules_orig) memcpy (&kernel_rules_orig[out_cnt], &kernel_rules_orig[in_idx], sizeof (kernel_rule_t));
+    }
+
+    slots[slot] = out_cnt + 1;
+
+    out_cnt++;
+  }
+
+  hcfree (slots);
+
+  return out_cnt;
+}
+
+int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, kernel_rule_t **out_orig, u32 *out_cnt)
 {
   const user_options_t *user_options = hashcat_ctx->user_options;
 
+  // the debug output shows the rules as the user wrote them, not in their canonical form
+
+  const bool keep_orig = (user_options->debug_mode == 1) || (user_options->debug_mode == 3) || (user_options->debug_mode == 4);
+
   /**
    * load rules
    */
 
   u32 *all_kernel_rules_cnt = NULL;
 
-  kernel_rule_t **all_kernel_rules_buf = NULL;
+  kernel_rule_t **all_kernel_rules_buf  = NULL;
+  kernel_rule_t **all_kernel_rules_orig = NULL;
 
   if (user_options->rp_files_cnt)
   {
     all_kernel_rules_cnt = (u32 *) hccalloc (user_options->rp_files_cnt, sizeof (u32));
 
-    all_kernel_rules_buf = (kernel_rule_t **) hccalloc (user_options->rp_files_cnt, sizeof (kernel_rule_t *));
+    all_kernel_rules_buf  = (kernel_rule_t **) hccalloc (user_options->rp_files_cnt, sizeof (kernel_rule_t *));
+    all_kernel_rules_orig = (kernel_rule_t **) hccalloc (user_options->rp_files_cnt, sizeof (kernel_rule_t *));
   }
 
   char *rule_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
@@ -741,8 +843,15 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
     {
       event_log_error (hashcat_ctx, "%s: %s", rp_file, strerror (errno));
 
+      for (u32 j = 0; j < i; j++)
+      {
+        hcfree (all_kernel_rules_buf[j]);
+        hcfree (all_kernel_rules_orig[j]);
+      }
+
       hcfree (all_kernel_rules_cnt);
       hcfree (all_kernel_rules_buf);
+      hcfree (all_kernel_rules_orig);
 
       hcfree (rule_buf);
 
@@ -795,8 +904,22 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
 
     hc_fclose (&fp);
 
-    all_kernel_rules_cnt[i] = kernel_rules_cnt;
-    all_kernel_rules_buf[i] = kernel_rules_buf;
+    kernel_rule_t *kernel_rules_orig = NULL;
+
+    if ((keep_orig == true) && (kernel_rules_cnt > 0))
+    {
+      kernel_rules_orig = (kernel_rule_t *) hcmalloc (kernel_rules_cnt * sizeof (kernel_rule_t));
+
+      memcpy (kernel_rules_orig, kernel_rules_buf, kernel_rules_cnt * sizeof (kernel_rule_t));
+    }
+
+    // rules which are textually different but do the same (for instance because of ':' or spaces) are only kept once
+
+    kernel_rules_cnt = kernel_rules_dedup (kernel_rules_buf, kernel_rules_orig, kernel_rules_cnt);
+
+    all_kernel_rules_cnt[i]  = kernel_rules_cnt;
+    all_kernel_rules_buf[i]  = kernel_rules_buf;
+    all_kernel_rules_orig[i] = kernel_rules_orig;
   }
 
   hcfree (rule_buf);
@@ -805,6 +928,30 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
    * merge rules
    */
 
+  u64 kernel_rules_cnt_chained = 1;
+
+  for (u32 i = 0; i < user_options->rp_files_cnt; i++)
+  {
+    kernel_rules_cnt_chained *= all_kernel_rules_cnt[i];
+
+    if (kernel_rules_cnt_chained > 0xffffffff)
+    {
+      event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of chained rule files.");
+
+      for (u32 j = 0; j < user_options->rp_files_cnt; j++)
+      {
+        hcfree (all_kernel_rules_buf[j]);
+        hcfree (all_kernel_rules_orig[j]);
+      }
+
+      hcfree (all_kernel_rules_cnt);
+      hcfree (all_kernel_rules_buf);
+      hcfree (all_kernel_rules_orig);
+
+      return -1;
+    }
+  }
+
   u32 kernel_rules_cnt = 1;
 
   u32 *repeats = (u32 *) hccalloc (user_options->rp_files_cnt + 1, sizeof (u32));
@@ -818,7 +965,10 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
     repeats[i + 1] = kernel_rules_cnt;
   }
 
-  kernel_rule_t *kernel_rules_buf = (kernel_rule_t *) hccalloc (kernel_rules_cnt, sizeof (kernel_rule_t));
+  kernel_rule_t *kernel_rules_buf  = (kernel_rule_t *) hccalloc (kernel_rules_cnt, sizeof (kernel_rule_t));
+  kernel_rule_t *kernel_rules_orig = NULL;
+
+  if (keep_orig == true) kernel_rules_orig = (kernel_rule_t *) hccalloc (kernel_rules_cnt, sizeof (kernel_rule_t));
 
   for (u32 i = 0; i < kernel_rules_cnt; i++)
   {
@@ -845,24 +995,61 @@ int kernel_rules_load (hashcat_ctx_t *hashcat_ctx, kernel_rule_t **out_buf, u32
         out->cmds[out_pos] = in->cmds[in_pos];
       }
     }
+
+    if (kernel_rules_orig == NULL) continue;
+
+    out_pos = 0;
+
+    out = &kernel_rules_orig[i];
+
+    for (u32 j = 0; j < user_options->rp_files_cnt; j++)
+    {
+      u32 in_off = (i / repeats[j]) % all_kernel_rules_cnt[j];
+      u32 in_pos;
+
+      kernel_rule_t *in = &all_kernel_rules_orig[j][in_off];
+
+      for (in_pos = 0; in->cmds[in_pos]; in_pos++, out_pos++)
+      {
+        if (out_pos == RULES_MAX - 1) break;
+
+        out->cmds[out_pos] = in->cmds[in_pos];
+      }
+    }
   }
 
   hcfree (repeats);
 
+  for (u32 i = 0; i < user_options->rp_files_cnt; i++)
+  {
+    hcfree (all_kernel_rules_buf[i]);
+    hcfree (all_kernel_rules_orig[i]);
+  }
+
   hcfree (all_kernel_rules_cnt);
   hcfree (all_kernel_rules_buf);
+  hcfree (all_kernel_rules_orig);
+
+  // chaining can produce the same rule from different combinations, for instance ':' + '$1' and '$1' + ':'
+
+  if (user_options->rp_files_cnt > 1)
+  {
+    kernel_rules_cnt = kernel_rules_dedup (kernel_rules_buf, kernel_rules_orig, kernel_rules_cnt);
+  }
 
   if (kernel_rules_cnt == 0)
   {
     event_log_error (hashcat_ctx, "No valid rules left.");
 
     hcfree (kernel_rules_buf);
+    hcfree (kernel_rules_orig);
 
     return -1;
   }
 
-  *out_cnt = kernel_rules_cnt;
-  *out_buf = kernel_rules_buf;
+  *out_cnt  = kernel_rules_cnt;
+  *out_buf  = kernel_rules_buf;
+  *out_orig = kernel_rules_orig;
 
   return 0;
 }
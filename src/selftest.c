@@ -39,6 +39,13 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     device_param->kernel_params[18] = &device_param->opencl_d_st_esalts_buf;
   }
 
+  if (device_param->is_native == true)
+  {
+    device_param->kernel_params[15] = &device_param->native_d_st_digests_buf;
+    device_param->kernel_params[17] = &device_param->native_d_st_salts_buf;
+    device_param->kernel_params[18] = &device_param->native_d_st_esalts_buf;
+  }
+
   device_param->kernel_params_buf32[31] = 1;
   device_param->kernel_params_buf32[32] = 0;
 
@@ -95,6 +102,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     {
       if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, 1 * sizeof (pw_t), &pw, 0, NULL, NULL) == -1) return -1;
     }
+
+    if (device_param->is_native == true)
+    {
+      memcpy (device_param->native_d_pws_buf, &pw, 1 * sizeof (pw_t));
+    }
   }
   else
   {
@@ -130,6 +142,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
         {
           if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, 1 * sizeof (pw_t), &pw, 0, NULL, NULL) == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          memcpy (device_param->native_d_pws_buf, &pw, 1 * sizeof (pw_t));
+        }
       }
       else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
@@ -196,6 +213,13 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
 
           if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, 1 * sizeof (pw_t), &pw, 0, NULL, NULL) == -1) return -1;
         }
+
+        if (device_param->is_native == true)
+        {
+          memcpy (device_param->native_d_combs_c, &comb, 1 * sizeof (pw_t));
+
+          memcpy (device_param->native_d_pws_buf, &pw, 1 * sizeof (pw_t));
+        }
       }
       else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
@@ -229,6 +253,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
           {
             if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, 1 * sizeof (pw_t), &pw, 0, NULL, NULL) == -1) return -1;
           }
+
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_pws_buf, &pw, 1 * sizeof (pw_t));
+          }
         }
         else
         {
@@ -281,6 +310,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
             if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bfs_c, CL_TRUE, 0, 1 * sizeof (bf_t), &bf, 0, NULL, NULL) == -1) return -1;
           }
 
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_bfs_c, &bf, 1 * sizeof (bf_t));
+          }
+
           pw_t pw;
 
           memset (&pw, 0, sizeof (pw));
@@ -377,6 +411,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
             if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, 1 * sizeof (pw_t), &pw, 0, NULL, NULL) == -1) return -1;
           }
 
+          if (device_param->is_native == true)
+          {
+            memcpy (device_param->native_d_pws_buf, &pw, 1 * sizeof (pw_t));
+          }
+
           highest_pw_len = pw.pw_len;
         }
       }
@@ -404,6 +443,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, 1 * sizeof (pw_t), &pw, 0, NULL, NULL) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->native_d_pws_buf, &pw, 1 * sizeof (pw_t));
+      }
     }
   }
 
@@ -450,6 +494,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (run_opencl_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->opencl_d_pws_buf, 1) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        if (run_native_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->native_d_pws_buf, 1) == -1) return -1;
+      }
     }
 
     if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, 0, 1, false, 0) == -1) return -1;
@@ -468,6 +517,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
         if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, device_param->size_hooks, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
       }
 
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->hooks_buf, device_param->native_d_hooks, device_param->size_hooks);
+      }
+
       module_ctx->module_hook12 (device_param, module_ctx->hook_extra_params[0], hashes->st_hook_salts_buf, 0, 0);
 
       if (device_param->is_cuda == true)
@@ -479,6 +533,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, device_param->size_hooks, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->native_d_hooks, device_param->hooks_buf, device_param->size_hooks);
+      }
     }
 
     const u32 salt_pos = 0;
@@ -520,6 +579,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
         if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, device_param->size_hooks, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
       }
 
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->hooks_buf, device_param->native_d_hooks, device_param->size_hooks);
+      }
+
       module_ctx->module_hook23 (device_param, module_ctx->hook_extra_params[0], hashes->st_hook_salts_buf, 0, 0);
 
       if (device_param->is_cuda == true)
@@ -531,6 +595,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, device_param->size_hooks, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        memcpy (device_param->native_d_hooks, device_param->hooks_buf, device_param->size_hooks);
+      }
     }
 
     if (hashconfig->opts_type & OPTS_TYPE_INIT2)
@@ -600,6 +669,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_result, CL_TRUE, 0, sizeof (u32), &num_cracked, 0, NULL, NULL) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    memcpy (&num_cracked, device_param->native_d_result, sizeof (u32));
+  }
+
   // finish : cleanup and restore
 
   device_param->kernel_params_buf32[27] = 0;
@@ -639,6 +713,20 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_result,        device_param->size_results) == -1) return -1;
   }
 
+  if (device_param->is_native == true)
+  {
+    device_param->kernel_params[15] = &device_param->native_d_digests_buf;
+    device_param->kernel_params[17] = &device_param->native_d_salt_bufs;
+    device_param->kernel_params[18] = &device_param->native_d_esalt_bufs;
+
+    if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_pws_buf,       device_param->size_pws)     == -1) return -1;
+    if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_tmps,          device_param->size_tmps)    == -1) return -1;
+    if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_hooks,         device_param->size_hooks)   == -1) return -1;
+    if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
+    if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_digests_shown, device_param->size_shown)   == -1) return -1;
+    if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_result,        device_param->size_results) == -1) return -1;
+  }
+
   if (user_options->slow_candidates == true)
   {
     if (device_param->is_cuda == true)
@@ -650,6 +738,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     {
       if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_rules_c, device_param->size_rules_c) == -1) return -1;
     }
+
+    if (device_param->is_native == true)
+    {
+      if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_rules_c, device_param->size_rules_c) == -1) return -1;
+    }
   }
   else
   {
@@ -664,6 +757,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_rules_c, device_param->size_rules_c) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_rules_c, device_param->size_rules_c) == -1) return -1;
+      }
     }
     else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
     {
@@ -676,6 +774,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_combs_c, device_param->size_combs) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_combs_c, device_param->size_combs) == -1) return -1;
+      }
     }
     else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
     {
@@ -688,6 +791,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
       {
         if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_bfs_c, device_param->size_bfs) == -1) return -1;
       }
+
+      if (device_param->is_native == true)
+      {
+        if (run_native_kernel_bzero (hashcat_ctx, device_param, device_param->native_d_bfs_c, device_param->size_bfs) == -1) return -1;
+      }
     }
   }
 
@@ -701,6 +809,11 @@ static int selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     {
       event_log_error (hashcat_ctx, "* Device #%u: ATTENTION! OpenCL kernel self-test failed.", device_param->device_id + 1);
     }
+
+    if (device_param->is_native == true)
+    {
+      event_log_error (hashcat_ctx, "* Device #%u: ATTENTION! Native kernel self-test failed.", device_param->device_id + 1);
+    }
     if (device_param->is_cuda == true)
     {
       event_log_error (hashcat_ctx, "* Device #%u: ATTENTION! CUDA kernel self-test failed.", device_param->device_id + 1);
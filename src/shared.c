@@ -1090,8 +1090,31 @@ const u8 *hc_strchr_last (const u8 *input_buf, const int input_len, const u8 sep
   return NULL;
 }
 
+// the autodetect index records the token layout a module passes to the tokenizer
+// modules are linked against their own copy of this file, so this is set through the module handle
+
+static token_trace_t *tokenizer_trace = NULL;
+
+void input_tokenizer_trace (token_trace_t *trace)
+{
+  tokenizer_trace = trace;
+}
+
 int input_tokenizer (const u8 *input_buf, const int input_len, token_t *token)
 {
+  if (tokenizer_trace != NULL)
+  {
+    if (tokenizer_trace->calls == 0)
+    {
+      tokenizer_trace->input_buf = input_buf;
+      tokenizer_trace->input_len = input_len;
+
+      memcpy (&tokenizer_trace->token, token, sizeof (token_t));
+    }
+
+    tokenizer_trace->calls++;
+  }
+
   int len_left = input_len;
 
   token->buf[0] = input_buf;
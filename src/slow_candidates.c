@@ -28,9 +28,23 @@ void slow_candidates_seek (hashcat_ctx_t *hashcat_ctx, void *extra_info, const u
   {
     extra_info_straight_t *extra_info_straight = (extra_info_straight_t *) extra_info;
 
-    for (u64 i = cur; i < end; i++)
+    // jump close to the last base word required, using the line index of the wordlist if there is one
+
+    const u64 kernel_rules_cnt = straight_ctx->kernel_rules_cnt;
+
+    u64 pos = cur;
+
+    if (end > cur)
+    {
+      const u64 words_cur = (cur + kernel_rules_cnt - 1) / kernel_rules_cnt;
+      const u64 words_new = wl_data_seek (hashcat_ctx, &extra_info_straight->fp, words_cur, (end - 1) / kernel_rules_cnt);
+
+      if (words_new > words_cur) pos = words_new * kernel_rules_cnt;
+    }
+
+    for (u64 i = pos; i < end; i++)
     {
-      if ((i % straight_ctx->kernel_rules_cnt) == 0)
+      if ((i % kernel_rules_cnt) == 0)
       {
         char *line_buf = NULL;
         u32   line_len = 0;
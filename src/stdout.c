@@ -84,6 +84,9 @@ int process_stdout (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
   else
   {
     out.fp.is_gzip = false;
+    out.fp.is_zip = false;
+    out.fp.is_xz = false;
+    out.fp.is_bgzf = false;
     out.fp.pfp = stdout;
     out.fp.fd = fileno (stdout);
   }
@@ -86,8 +86,6 @@ int straight_ctx_update_loop (hashcat_ctx_t *hashcat_ctx)
 
       if (rc == -1)
       {
-        event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", straight_ctx->dict);
-
         return -1;
       }
 
@@ -121,8 +119,6 @@ int straight_ctx_update_loop (hashcat_ctx_t *hashcat_ctx)
 
       if (rc == -1)
       {
-        event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", combinator_ctx->dict1);
-
         return -1;
       }
     }
@@ -143,8 +139,6 @@ int straight_ctx_update_loop (hashcat_ctx_t *hashcat_ctx)
 
       if (rc == -1)
       {
-        event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", combinator_ctx->dict2);
-
         return -1;
       }
     }
@@ -189,8 +183,6 @@ int straight_ctx_update_loop (hashcat_ctx_t *hashcat_ctx)
 
     if (rc == -1)
     {
-      event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", straight_ctx->dict);
-
       return -1;
     }
 
@@ -229,8 +221,6 @@ int straight_ctx_update_loop (hashcat_ctx_t *hashcat_ctx)
 
       if (rc == -1)
       {
-        event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", straight_ctx->dict);
-
         return -1;
       }
 
@@ -289,7 +279,7 @@ int straight_ctx_init (hashcat_ctx_t *hashcat_ctx)
   {
     if (user_options->rp_files_cnt)
     {
-      if (kernel_rules_load (hashcat_ctx, &straight_ctx->kernel_rules_buf, &straight_ctx->kernel_rules_cnt) == -1) return -1;
+      if (kernel_rules_load (hashcat_ctx, &straight_ctx->kernel_rules_buf, &straight_ctx->kernel_rules_orig, &straight_ctx->kernel_rules_cnt) == -1) return -1;
     }
     else if (user_options->rp_gen)
     {
@@ -504,6 +494,7 @@ void straight_ctx_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (straight_ctx->dicts);
 
   hcfree (straight_ctx->kernel_rules_buf);
+  hcfree (straight_ctx->kernel_rules_orig);
 
   memset (straight_ctx, 0, sizeof (straight_ctx_t));
 }
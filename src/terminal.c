@@ -817,6 +817,38 @@ void backend_info (hashcat_ctx_t *hashcat_ctx)
       }
     }
   }
+
+  if (backend_ctx->native)
+  {
+    event_log_info (hashcat_ctx, "Native Info:");
+    event_log_info (hashcat_ctx, "============");
+    event_log_info (hashcat_ctx, NULL);
+
+    event_log_info (hashcat_ctx, "Compiler.....: %s %s", backend_ctx->native_compiler, backend_ctx->native_compiler_version);
+    event_log_info (hashcat_ctx, NULL);
+
+    for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+    {
+      const hc_device_param_t *device_param = backend_ctx->devices_param + backend_devices_idx;
+
+      if (device_param->is_native == false) continue;
+
+      int   device_id            = device_param->device_id;
+      char *device_name          = device_param->device_name;
+      u32   device_processors    = device_param->device_processors;
+      u64   device_maxmem_alloc  = device_param->device_maxmem_alloc;
+      u64   device_available_mem = device_param->device_available_mem;
+      u64   device_global_mem    = device_param->device_global_mem;
+
+      event_log_info (hashcat_ctx, "Backend Device ID #%d", device_id + 1);
+      event_log_info (hashcat_ctx, "  Type...........: CPU");
+      event_log_info (hashcat_ctx, "  Name...........: %s", device_name);
+      event_log_info (hashcat_ctx, "  Processor(s)...: %u", device_processors);
+      event_log_info (hashcat_ctx, "  Memory.Total...: %" PRIu64 " MB (limited to %" PRIu64 " MB allocatable in one block)", device_global_mem / 1024 / 1024, device_maxmem_alloc / 1024 / 1024);
+      event_log_info (hashcat_ctx, "  Memory.Free....: %" PRIu64 " MB", device_available_mem / 1024 / 1024);
+      event_log_info (hashcat_ctx, NULL);
+    }
+  }
 }
 
 void backend_info_compact (hashcat_ctx_t *hashcat_ctx)
@@ -932,6 +964,52 @@ void backend_info_compact (hashcat_ctx_t *hashcat_ctx)
       event_log_info (hashcat_ctx, NULL);
     }
   }
+
+  if (backend_ctx->native)
+  {
+    const size_t len = event_log_info (hashcat_ctx, "Native API (%s %s)", backend_ctx->native_compiler, backend_ctx->native_compiler_version);
+
+    char line[HCBUFSIZ_TINY] = { 0 };
+
+    memset (line, '=', len);
+
+    line[len] = 0;
+
+    event_log_info (hashcat_ctx, "%s", line);
+
+    for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+    {
+      const hc_device_param_t *device_param = backend_ctx->devices_param + backend_devices_idx;
+
+      if (device_param->is_native == false) continue;
+
+      int   device_id            = device_param->device_id;
+      char *device_name          = device_param->device_name;
+      u32   device_processors    = device_param->device_processors;
+      u64   device_maxmem_alloc  = device_param->device_maxmem_alloc;
+      u64   device_global_mem    = device_param->device_global_mem;
+      u64   device_available_mem = device_param->device_available_mem;
+
+      if ((device_param->skipped == false) && (device_param->skipped_warning == false))
+      {
+        event_log_info (hashcat_ctx, "* Device #%u: %s, %" PRIu64 "/%" PRIu64 " MB (%" PRIu64 " MB allocatable), %uMCU",
+                  device_id + 1,
+                  device_name,
+                  device_available_mem / 1024 / 1024,
+                  device_global_mem    / 1024 / 1024,
+                  device_maxmem_alloc  / 1024 / 1024,
+                  device_processors);
+      }
+      else
+      {
+        event_log_info (hashcat_ctx, "* Device #%u: %s, skipped",
+                  device_id + 1,
+                  device_name);
+      }
+    }
+
+    event_log_info (hashcat_ctx, NULL);
+  }
 }
 
 void status_display_machine_readable (hashcat_ctx_t *hashcat_ctx)
@@ -0,0 +1,316 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "bitops.h"
+#include "event.h"
+#include "locking.h"
+#include "shared.h"
+#include "thread.h"
+#include "filehandling.h"
+#include "emu_inc_hash_md5.h"
+#include "tunecache.h"
+
+static tunecache_entry_t *tunecache_lookup (tunecache_ctx_t *tunecache_ctx, const u32 key[4])
+{
+  for (u32 i = 0; i < tunecache_ctx->cnt; i++)
+  {
+    tunecache_entry_t *entry = tunecache_ctx->base + i;
+
+    if (memcmp (entry->key, key, sizeof (entry->key)) == 0) return entry;
+  }
+
+  return NULL;
+}
+
+static bool tunecache_entry_valid (const tunecache_entry_t *entry)
+{
+  if (entry->kernel_accel == 0) return false;
+  if (entry->kernel_loops == 0) return false;
+
+  if (!(entry->exec_msec > 0)) return false;
+
+  return true;
+}
+
+static void tunecache_load (hashcat_ctx_t *hashcat_ctx, tunecache_entry_t *base, u32 *cnt, const bool verbose)
+{
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+
+  *cnt = 0;
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, tunecache_ctx->filename, "rb") == false)
+  {
+    // first run, file does not exist, do not error out
+
+    return;
+  }
+
+  u64 v;
+  u64 z;
+
+  const size_t nread1 = hc_fread (&v, sizeof (u64), 1, &fp);
+  const size_t nread2 = hc_fread (&z, sizeof (u64), 1, &fp);
+
+  v = byte_swap_64 (v);
+  z = byte_swap_64 (z);
+
+  if ((nread1 != 1) || (nread2 != 1) || (v != TUNECACHE_VERSION) || (z != 0))
+  {
+    if (verbose == true) event_log_warning (hashcat_ctx, "%s: Invalid or outdated header, ignoring content", tunecache_ctx->filename);
+
+    hc_fclose (&fp);
+
+    return;
+  }
+
+  while (*cnt < MAX_TUNECACHE)
+  {
+    tunecache_entry_t *entry = base + *cnt;
+
+    if (hc_fread (entry, sizeof (tunecache_entry_t), 1, &fp) != 1) break;
+
+    if (tunecache_entry_valid (entry) == false)
+    {
+      if (verbose == true) event_log_warning (hashcat_ctx, "%s: Invalid content, ignoring remaining entries", tunecache_ctx->filename);
+
+      break;
+    }
+
+    *cnt += 1;
+  }
+
+  hc_fclose (&fp);
+}
+
+int tunecache_init (hashcat_ctx_t *hashcat_ctx)
+{
+  folder_config_t *folder_config = hashcat_ctx->folder_config;
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+  user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  tunecache_ctx->enabled = false;
+
+  if (user_options->hash_info      == true) return 0;
+  if (user_options->keyspace       == true) return 0;
+  if (user_options->left           == true) return 0;
+  if (user_options->backend_info   == true) return 0;
+  if (user_options->show           == true) return 0;
+  if (user_options->stdout_flag    == true) return 0;
+  if (user_options->usage          == true) return 0;
+  if (user_options->version        == true) return 0;
+
+  tunecache_ctx->enabled = true;
+  tunecache_ctx->dirty   = false;
+  tunecache_ctx->base    = (tunecache_entry_t *) hccalloc (MAX_TUNECACHE, sizeof (tunecache_entry_t));
+  tunecache_ctx->cnt     = 0;
+
+  hc_asprintf (&tunecache_ctx->filename, "%s/%s", folder_config->profile_dir, TUNECACHE_FILENAME);
+
+  hc_thread_mutex_init (tunecache_ctx->mux);
+
+  return 0;
+}
+
+void tunecache_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+
+  if (tunecache_ctx->enabled == false) return;
+
+  hc_thread_mutex_delete (tunecache_ctx->mux);
+
+  hcfree (tunecache_ctx->filename);
+  hcfree (tunecache_ctx->base);
+
+  memset (tunecache_ctx, 0, sizeof (tunecache_ctx_t));
+}
+
+void tunecache_read (hashcat_ctx_t *hashcat_ctx)
+{
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+
+  if (tunecache_ctx->enabled == false) return;
+
+  tunecache_load (hashcat_ctx, tunecache_ctx->base, &tunecache_ctx->cnt, true);
+}
+
+int tunecache_write (hashcat_ctx_t *hashcat_ctx)
+{
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+
+  if (tunecache_ctx->enabled == false) return 0;
+
+  if (tunecache_ctx->dirty == false) return 0;
+
+  // other sessions may have stored their results since we read the file, keep those which we did not tune ourselves
+
+  tunecache_entry_t *disk_base = (tunecache_entry_t *) hccalloc (MAX_TUNECACHE, sizeof (tunecache_entry_t));
+
+  u32 disk_cnt = 0;
+
+  tunecache_load (hashcat_ctx, disk_base, &disk_cnt, false);
+
+  for (u32 i = 0; i < disk_cnt; i++)
+  {
+    if (tunecache_ctx->cnt == MAX_TUNECACHE) break;
+
+    const tunecache_entry_t *entry = disk_base + i;
+
+    if (tunecache_lookup (tunecache_ctx, entry->key) != NULL) continue;
+
+    memcpy (tunecache_ctx->base + tunecache_ctx->cnt, entry, sizeof (tunecache_entry_t));
+
+    tunecache_ctx->cnt++;
+  }
+
+  hcfree (disk_base);
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, tunecache_ctx->filename, "wb") == false)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", tunecache_ctx->filename, strerror (errno));
+
+    return -1;
+  }
+
+  if (hc_lockfile (&fp) == -1)
+  {
+    hc_fclose (&fp);
+
+    event_log_error (hashcat_ctx, "%s: %s", tunecache_ctx->filename, strerror (errno));
+
+    return -1;
+  }
+
+  u64 v = TUNECACHE_VERSION;
+  u64 z = 0;
+
+  v = byte_swap_64 (v);
+  z = byte_swap_64 (z);
+
+  hc_fwrite (&v, sizeof (u64), 1, &fp);
+  hc_fwrite (&z, sizeof (u64), 1, &fp);
+
+  hc_fwrite (tunecache_ctx->base, sizeof (tunecache_entry_t), tunecache_ctx->cnt, &fp);
+
+  if (hc_unlockfile (&fp) == -1)
+  {
+    hc_fclose (&fp);
+
+    event_log_error (hashcat_ctx, "%s: %s", tunecache_ctx->filename, strerror (errno));
+
+    return -1;
+  }
+
+  hc_fclose (&fp);
+
+  tunecache_ctx->dirty = false;
+
+  return 0;
+}
+
+void tunecache_key (hashcat_ctx_t *hashcat_ctx, const hc_device_param_t *device_param, u32 key[4])
+{
+  const backend_ctx_t        *backend_ctx        = hashcat_ctx->backend_ctx;
+  const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  const user_options_t       *user_options       = hashcat_ctx->user_options;
+
+  // device and driver, the same way the kernel cache checksum does it
+  // plus the kernel variant and the search space autotune works in, which already covers -n, -u, -w, the rule count and the iteration count
+
+  char *buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  const int len = snprintf (buf, HCBUFSIZ_TINY, "%d-%d-%d-%d-%d-%u-%s-%s-%s-%u-%u-%u-%u-%u-%u-%d-%" PRIu64 "-%u-%u-%u-%u-%u-%.3f",
+    backend_ctx->comptime,
+    backend_ctx->cuda_driver_version,
+    device_param->is_cuda,
+    device_param->is_opencl,
+    device_param->is_native,
+    device_param->opencl_platform_vendor_id,
+    device_param->device_name,
+    device_param->opencl_device_version,
+    device_param->opencl_driver_version,
+    hashconfig->hash_mode,
+    hashconfig->kern_type,
+    hashconfig->attack_exec,
+    user_options_extra->attack_kern,
+    (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) ? 1U : 0U,
+    device_param->vector_width,
+    user_options->slow_candidates,
+    device_param->hardware_power,
+    device_param->kernel_threads,
+    device_param->kernel_accel_min,
+    device_param->kernel_accel_max,
+    device_param->kernel_loops_min,
+    device_param->kernel_loops_max,
+    backend_ctx->target_msec);
+
+  md5_ctx_t md5_ctx;
+
+  md5_init   (&md5_ctx);
+  md5_update (&md5_ctx, (u32 *) buf, MIN (len, HCBUFSIZ_TINY - 64));
+  md5_final  (&md5_ctx);
+
+  key[0] = md5_ctx.h[0];
+  key[1] = md5_ctx.h[1];
+  key[2] = md5_ctx.h[2];
+  key[3] = md5_ctx.h[3];
+
+  hcfree (buf);
+}
+
+bool tunecache_find (hashcat_ctx_t *hashcat_ctx, const u32 key[4], tunecache_entry_t *entry)
+{
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+
+  if (tunecache_ctx->enabled == false) return false;
+
+  hc_thread_mutex_lock (tunecache_ctx->mux);
+
+  const tunecache_entry_t *found = tunecache_lookup (tunecache_ctx, key);
+
+  if (found != NULL) memcpy (entry, found, sizeof (tunecache_entry_t));
+
+  hc_thread_mutex_unlock (tunecache_ctx->mux);
+
+  return (found != NULL);
+}
+
+void tunecache_update (hashcat_ctx_t *hashcat_ctx, const tunecache_entry_t *entry)
+{
+  tunecache_ctx_t *tunecache_ctx = hashcat_ctx->tunecache_ctx;
+
+  if (tunecache_ctx->enabled == false) return;
+
+  if (tunecache_entry_valid (entry) == false) return;
+
+  hc_thread_mutex_lock (tunecache_ctx->mux);
+
+  tunecache_entry_t *found = tunecache_lookup (tunecache_ctx, entry->key);
+
+  if (found != NULL)
+  {
+    memcpy (found, entry, sizeof (tunecache_entry_t));
+
+    tunecache_ctx->dirty = true;
+  }
+  else if (tunecache_ctx->cnt < MAX_TUNECACHE)
+  {
+    memcpy (tunecache_ctx->base + tunecache_ctx->cnt, entry, sizeof (tunecache_entry_t));
+
+    tunecache_ctx->cnt++;
+
+    tunecache_ctx->dirty = true;
+  }
+
+  hc_thread_mutex_unlock (tunecache_ctx->mux);
+}
@@ -93,6 +93,7 @@ static const char *const USAGE_BIG_PRE_HASHMODES[] =
   "     --example-hashes           |      | Alias of --hash-info                                 |",
   "     --backend-ignore-cuda      |      | Do not try to open CUDA interface on startup         |",
   "     --backend-ignore-opencl    |      | Do not try to open OpenCL interface on startup       |",
+  "     --backend-ignore-native    |      | Do not try to use the host C compiler on startup     |",
   " -I, --backend-info             |      | Show info about detected backend API devices         | -I",
   " -d, --backend-devices          | Str  | Backend devices to use, separated with commas        | -d 1",
   " -D, --opencl-device-types      | Str  | OpenCL device-types to use, separated with commas    | -D 1",
@@ -12,9 +12,18 @@
 #include "rp.h"
 #include "rp_cpu.h"
 #include "shared.h"
+#include "thread.h"
 #include "wordlist.h"
 #include "emu_inc_hash_sha1.h"
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined (__AVX2__)
+#include <immintrin.h>
+#endif
+
 size_t convert_from_hex (hashcat_ctx_t *hashcat_ctx, char *line_buf, const size_t line_len)
 {
   const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
@@ -49,54 +58,233 @@ size_t convert_from_hex (hashcat_ctx_t *hashcat_ctx, char *line_buf, const size_
   return (line_len);
 }
 
-int load_segment (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
+static void load_segment_buf (HCFILE *fp, char **buf, u64 *avail, const u64 incr, u64 *cnt)
 {
-  wl_data_t *wl_data = hashcat_ctx->wl_data;
+  // NOTE: use (never changing) incr here instead of avail otherwise the buffer gets bigger and bigger
 
-  // NOTE: use (never changing) ->incr here instead of ->avail otherwise the buffer gets bigger and bigger
+  *cnt = hc_fread (*buf, 1, incr - 1000, fp);
 
-  wl_data->pos = 0;
-
-  wl_data->cnt = hc_fread (wl_data->buf, 1, wl_data->incr - 1000, fp);
+  (*buf)[*cnt] = 0;
 
-  wl_data->buf[wl_data->cnt] = 0;
+  if (*cnt == 0) return;
 
-  if (wl_data->cnt == 0) return 0;
-
-  if (wl_data->buf[wl_data->cnt - 1] == '\n') return 0;
+  if ((*buf)[*cnt - 1] == '\n') return;
 
   while (!hc_feof (fp))
   {
-    if (wl_data->cnt == wl_data->avail)
+    if (*cnt == *avail)
     {
-      wl_data->buf = (char *) hcrealloc (wl_data->buf, wl_data->avail, wl_data->incr);
+      *buf = (char *) hcrealloc (*buf, *avail, incr);
 
-      wl_data->avail += wl_data->incr;
+      *avail += incr;
     }
 
     const int c = hc_fgetc (fp);
 
     if (c == EOF) break;
 
-    wl_data->buf[wl_data->cnt] = (char) c;
+    (*buf)[*cnt] = (char) c;
 
-    wl_data->cnt++;
+    (*cnt)++;
 
     if (c == '\n') break;
   }
 
   // ensure stream ends with a newline
 
-  if (wl_data->buf[wl_data->cnt - 1] != '\n')
+  if ((*buf)[*cnt - 1] != '\n')
   {
-    wl_data->cnt++;
+    (*cnt)++;
+
+    (*buf)[*cnt - 1] = '\n';
+  }
+}
+
+static void *wl_data_async_thread (void *p)
+{
+  wl_data_t *wl_data = (wl_data_t *) p;
+
+  while (true)
+  {
+    hc_thread_sem_wait (wl_data->async_sem_free);
+
+    if (wl_data->async_shutdown == true) break;
 
-    wl_data->buf[wl_data->cnt - 1] = '\n';
+    wl_segment_t *slot = &wl_data->async_slots[wl_data->async_slot_wr];
+
+    load_segment_buf (wl_data->async_fp, &slot->buf, &slot->avail, wl_data->incr, &slot->cnt);
+
+    slot->eof = hc_feof (wl_data->async_fp);
+
+    wl_data->async_slot_wr = (wl_data->async_slot_wr + 1) % WL_ASYNC_SLOTS;
+
+    const bool eof = slot->eof;
+
+    hc_thread_sem_post (wl_data->async_sem_filled);
+
+    if (eof == true) break;
+  }
+
+  return NULL;
+}
+
+int load_segment (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
+{
+  wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  wl_data->pos = 0;
+
+  if (fp->is_mmap == true)
+  {
+    // zero-copy, the segment is parsed directly inside the mapping
+
+    wl_data->cnt = hc_fmmap_next (fp, wl_data->incr - 1000, &wl_data->seg);
+
+    return 0;
+  }
+
+  if (wl_data->async_enabled == false)
+  {
+    load_segment_buf (fp, &wl_data->buf, &wl_data->avail, wl_data->incr, &wl_data->cnt);
+
+    wl_data->seg = wl_data->buf;
+
+    return 0;
+  }
+
+  if (wl_data->async_done == true)
+  {
+    wl_data->cnt = 0;
+
+    return 0;
+  }
+
+  // take over the oldest segment the reader thread has prepared and hand it our (fully parsed) buffer in exchange
+
+  hc_thread_sem_wait (wl_data->async_sem_filled);
+
+  wl_segment_t *slot = &wl_data->async_slots[wl_data->async_slot_rd];
+
+  wl_data->async_slot_rd = (wl_data->async_slot_rd + 1) % WL_ASYNC_SLOTS;
+
+  char *buf   = wl_data->buf;
+  u64   avail = wl_data->avail;
+
+  wl_data->buf   = slot->buf;
+  wl_data->avail = slot->avail;
+  wl_data->cnt   = slot->cnt;
+  wl_data->seg   = wl_data->buf;
+
+  slot->buf   = buf;
+  slot->avail = avail;
+
+  if (slot->eof == true)
+  {
+    wl_data->async_done = true;
+  }
+  else
+  {
+    hc_thread_sem_post (wl_data->async_sem_free);
   }
 
   return 0;
 }
 
+bool wl_data_eof (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
+{
+  const wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  if (wl_data->async_enabled == true) return wl_data->async_done;
+
+  return hc_feof (fp);
+}
+
+bool wl_data_error (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
+{
+  const wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  // the reader thread is done with fp once it delivered the last segment
+
+  if ((wl_data->async_enabled == true) && (wl_data->async_done == false)) return false;
+
+  return (hc_ferror (fp) != 0);
+}
+
+int wl_data_async_start (hashcat_ctx_t *hashcat_ctx, HCFILE *fp)
+{
+  wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  if (wl_data->enabled == false) return 0;
+
+  if (wl_data->async_enabled == true) return 0;
+
+  // nothing to prefetch, the kernel does the read-ahead on a mapping
+
+  if (fp->is_mmap == true) return 0;
+
+  wl_data->async_slots = (wl_segment_t *) hccalloc (WL_ASYNC_SLOTS, sizeof (wl_segment_t));
+
+  for (int i = 0; i < WL_ASYNC_SLOTS; i++)
+  {
+    wl_data->async_slots[i].buf   = (char *) hcmalloc (wl_data->incr);
+    wl_data->async_slots[i].avail = wl_data->incr;
+  }
+
+  wl_data->async_slot_rd  = 0;
+  wl_data->async_slot_wr  = 0;
+  wl_data->async_done     = false;
+  wl_data->async_shutdown = false;
+  wl_data->async_fp       = fp;
+
+  hc_thread_sem_init (wl_data->async_sem_filled);
+  hc_thread_sem_init (wl_data->async_sem_free);
+
+  // from now on only the reader thread touches fp
+
+  wl_data->cnt = 0;
+  wl_data->pos = 0;
+
+  wl_data->async_enabled = true;
+
+  hc_thread_create (wl_data->async_thread, wl_data_async_thread, wl_data);
+
+  for (int i = 0; i < WL_ASYNC_SLOTS; i++)
+  {
+    hc_thread_sem_post (wl_data->async_sem_free);
+  }
+
+  return 0;
+}
+
+void wl_data_async_stop (hashcat_ctx_t *hashcat_ctx)
+{
+  wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  if (wl_data->async_enabled == false) return;
+
+  // the reader thread is either parked in sem_wait (free), about to enter it, or already gone after it delivered the last segment
+
+  wl_data->async_shutdown = true;
+
+  hc_thread_sem_post (wl_data->async_sem_free);
+
+  hc_thread_wait (1, &wl_data->async_thread);
+
+  hc_thread_sem_close (wl_data->async_sem_filled);
+  hc_thread_sem_close (wl_data->async_sem_free);
+
+  for (int i = 0; i < WL_ASYNC_SLOTS; i++)
+  {
+    hcfree (wl_data->async_slots[i].buf);
+  }
+
+  hcfree (wl_data->async_slots);
+
+  wl_data->async_slots   = NULL;
+  wl_data->async_fp      = NULL;
+  wl_data->async_enabled = false;
+}
+
 void get_next_word_lm (char *buf, u64 sz, u64 *len, u64 *off)
 {
   char *ptr = buf;
@@ -128,48 +316,127 @@ void get_next_word_lm (char *buf, u64 sz, u64 *len, u64 *off)
   *len = sz;
 }
 
-void get_next_word_uc (char *buf, u64 sz, u64 *len, u64 *off)
+// position of the first '\n' in buf, or sz if there is none
+// compares 32 (AVX2) or 16 (SSE2) bytes at once, the scalar loop handles the tail and other architectures
+
+static u64 find_newline (const char *buf, const u64 sz)
 {
-  char *ptr = buf;
+  u64 i = 0;
 
-  for (u64 i = 0; i < sz; i++, ptr++)
+  #if defined (__AVX2__)
+  const __m256i nl32 = _mm256_set1_epi8 ('\n');
+
+  for (; i + 32 <= sz; i += 32)
   {
-    if (*ptr >= 'a' && *ptr <= 'z') *ptr -= 0x20;
+    const __m256i v = _mm256_loadu_si256 ((const __m256i *) (buf + i));
 
-    if (*ptr != '\n') continue;
+    const u32 mask = (u32) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, nl32));
 
-    *off = i + 1;
+    if (mask) return i + __builtin_ctz (mask);
+  }
+  #endif
 
-    if ((i > 0) && (buf[i - 1] == '\r')) i--;
+  #if defined (__SSE2__)
+  const __m128i nl16 = _mm_set1_epi8 ('\n');
 
-    *len = i;
+  for (; i + 16 <= sz; i += 16)
+  {
+    const __m128i v = _mm_loadu_si128 ((const __m128i *) (buf + i));
 
-    return;
+    const u32 mask = (u32) _mm_movemask_epi8 (_mm_cmpeq_epi8 (v, nl16));
+
+    if (mask) return i + __builtin_ctz (mask);
   }
+  #endif
 
-  *off = sz;
-  *len = sz;
+  for (; i < sz; i++)
+  {
+    if (buf[i] == '\n') return i;
+  }
+
+  return sz;
 }
 
-void get_next_word_std (char *buf, u64 sz, u64 *len, u64 *off)
+static void uppercase_buf (char *buf, const u64 sz)
 {
-  char *ptr = buf;
+  u64 i = 0;
 
-  for (u64 i = 0; i < sz; i++, ptr++)
+  // signed compares: bytes >= 0x80 are negative and never end up in the 'a' - 'z' range
+
+  #if defined (__AVX2__)
+  const __m256i a32 = _mm256_set1_epi8 ('a' - 1);
+  const __m256i z32 = _mm256_set1_epi8 ('z' + 1);
+  const __m256i d32 = _mm256_set1_epi8 (0x20);
+
+  for (; i + 32 <= sz; i += 32)
   {
-    if (*ptr != '\n') continue;
+    const __m256i v = _mm256_loadu_si256 ((const __m256i *) (buf + i));
 
-    *off = i + 1;
+    const __m256i m = _mm256_and_si256 (_mm256_cmpgt_epi8 (v, a32), _mm256_cmpgt_epi8 (z32, v));
 
-    if ((i > 0) && (buf[i - 1] == '\r')) i--;
+    _mm256_storeu_si256 ((__m256i *) (buf + i), _mm256_sub_epi8 (v, _mm256_and_si256 (m, d32)));
+  }
+  #endif
 
-    *len = i;
+  #if defined (__SSE2__)
+  const __m128i a16 = _mm_set1_epi8 ('a' - 1);
+  const __m128i z16 = _mm_set1_epi8 ('z' + 1);
+  const __m128i d16 = _mm_set1_epi8 (0x20);
+
+  for (; i + 16 <= sz; i += 16)
+  {
+    const __m128i v = _mm_loadu_si128 ((const __m128i *) (buf + i));
+
+    const __m128i m = _mm_and_si128 (_mm_cmpgt_epi8 (v, a16), _mm_cmplt_epi8 (v, z16));
+
+    _mm_storeu_si128 ((__m128i *) (buf + i), _mm_sub_epi8 (v, _mm_and_si128 (m, d16)));
+  }
+  #endif
+
+  for (; i < sz; i++)
+  {
+    if (buf[i] >= 'a' && buf[i] <= 'z') buf[i] -= 0x20;
+  }
+}
+
+void get_next_word_uc (char *buf, u64 sz, u64 *len, u64 *off)
+{
+  u64 i = find_newline (buf, sz);
+
+  uppercase_buf (buf, i);
+
+  if (i == sz)
+  {
+    *off = sz;
+    *len = sz;
 
     return;
   }
 
-  *off = sz;
-  *len = sz;
+  *off = i + 1;
+
+  if ((i > 0) && (buf[i - 1] == '\r')) i--;
+
+  *len = i;
+}
+
+void get_next_word_std (char *buf, u64 sz, u64 *len, u64 *off)
+{
+  u64 i = find_newline (buf, sz);
+
+  if (i == sz)
+  {
+    *off = sz;
+    *len = sz;
+
+    return;
+  }
+
+  *off = i + 1;
+
+  if ((i > 0) && (buf[i - 1] == '\r')) i--;
+
+  *len = i;
 }
 
 void get_next_word (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, char **out_buf, u32 *out_len)
@@ -183,7 +450,7 @@ void get_next_word (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, char **out_buf, u32
     u64 off;
     u64 len;
 
-    char *ptr = wl_data->buf + wl_data->pos;
+    char *ptr = wl_data->seg + wl_data->pos;
 
     wl_data->func (ptr, wl_data->cnt - wl_data->pos, &len, &off);
 
@@ -235,9 +502,11 @@ void get_next_word (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, char **out_buf, u32
     return;
   }
 
-  if (hc_feof (fp))
+  if (wl_data_eof (hashcat_ctx, fp))
   {
-    fprintf (stderr, "BUG feof()!!\n");
+    // a read error is reported by the caller
+
+    if (wl_data_error (hashcat_ctx, fp) == false) fprintf (stderr, "BUG feof()!!\n");
 
     return;
   }
@@ -327,6 +596,243 @@ void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len
   }
 }
 
+static int dictstat_key (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, dictstat_t *d)
+{
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  memset (d, 0, sizeof (dictstat_t));
+
+  if (fstat (hc_fileno (fp), &d->stat)) return -1;
+
+  d->stat.st_mode    = 0;
+  d->stat.st_nlink   = 0;
+  d->stat.st_uid     = 0;
+  d->stat.st_gid     = 0;
+  d->stat.st_rdev    = 0;
+  d->stat.st_atime   = 0;
+
+  #if defined (STAT_NANOSECONDS_ACCESS_TIME)
+  d->stat.STAT_NANOSECONDS_ACCESS_TIME = 0;
+  #endif
+
+  #if defined (_POSIX)
+  d->stat.st_blksize = 0;
+  d->stat.st_blocks  = 0;
+  #endif
+
+  strncpy (d->encoding_from, user_options->encoding_from, sizeof (d->encoding_from) - 1);
+  strncpy (d->encoding_to,   user_options->encoding_to,   sizeof (d->encoding_to)   - 1);
+
+  const size_t dictfile_len = strlen (dictfile);
+
+  u32 *dictfile_padded = (u32 *) hcmalloc (dictfile_len + 64); // padding required for sha1_update()
+
+  memcpy (dictfile_padded, dictfile, dictfile_len);
+
+  sha1_ctx_t sha1_ctx;
+  sha1_init   (&sha1_ctx);
+  sha1_update (&sha1_ctx, dictfile_padded, dictfile_len);
+  sha1_final  (&sha1_ctx);
+
+  hcfree (dictfile_padded);
+
+  memcpy (d->hash_filename, sha1_ctx.h, 16);
+
+  return 0;
+}
+
+// the line index stores byte offsets, these are only meaningful if a seek lands exactly where sequential reading would be
+
+static bool wl_data_index_usable (hashcat_ctx_t *hashcat_ctx, const HCFILE *fp)
+{
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  wl_data_t            *wl_data            = hashcat_ctx->wl_data;
+
+  if (fp->is_gzip || fp->is_zip || fp->is_xz) return false;
+
+  if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l)) return false;
+
+  if (wl_data->func == get_next_word_lm) return false;
+
+  return true;
+}
+
+void wl_data_index_load (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile)
+{
+  wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  wl_data->idx = NULL;
+
+  if (wl_data->enabled == false) return;
+
+  if (wl_data_index_usable (hashcat_ctx, fp) == false) return;
+
+  dictstat_t d;
+
+  if (dictstat_key (hashcat_ctx, fp, dictfile, &d) == -1) return;
+
+  wl_data->idx = dictidx_find (hashcat_ctx, &d);
+}
+
+u64 wl_data_seek (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const u64 cur, const u64 end)
+{
+  wl_data_t *wl_data = hashcat_ctx->wl_data;
+
+  const dictidx_t *idx = wl_data->idx;
+
+  if (idx == NULL) return cur;
+
+  // last entry at or before end
+
+  u64 lo = 0;
+  u64 hi = idx->cnt;
+
+  while ((hi - lo) > 1)
+  {
+    const u64 mid = (lo + hi) / 2;
+
+    if (idx->entries[mid].word <= end)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  const dictidx_entry_t *entry = idx->entries + lo;
+
+  if (entry->word > end) return cur;
+
+  const u64 tgt = entry->word;
+
+  if (tgt <= cur) return cur;
+
+  // the prefetched segments belong to the old position
+
+  const bool async_enabled = wl_data->async_enabled;
+
+  if (async_enabled == true) wl_data_async_stop (hashcat_ctx);
+
+  hc_fseek (fp, (off_t) entry->off, SEEK_SET);
+
+  wl_data->cnt = 0;
+  wl_data->pos = 0;
+
+  if (async_enabled == true) wl_data_async_start (hashcat_ctx, fp);
+
+  return tgt;
+}
+
+// counts the accepted words of a buffer holding complete lines, off is the position of buf inside the wordlist
+
+static void count_words_buf (wl_count_thread_param_t *param, wl_count_t *chunk, char *buf, const u64 sz, const u64 off)
+{
+  hashcat_ctx_t        *hashcat_ctx        = param->hashcat_ctx;
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+  wl_data_t            *wl_data            = hashcat_ctx->wl_data;
+
+  u64 i = 0;
+
+  while (i < sz)
+  {
+    u64 len;
+    u64 skip;
+
+    char *ptr = buf + i;
+
+    const u64 line_off = off + i;
+
+    wl_data->func (ptr, sz - i, &len, &skip);
+
+    i += skip;
+
+    // do the on-the-fly hex decode using original buffer
+    // this is safe as length only decreases in size
+
+    len = (u32) convert_from_hex (hashcat_ctx, ptr, len);
+
+    // do the on-the-fly encoding
+
+    if (wl_data->iconv_enabled == true)
+    {
+      char  *iconv_ptr = param->iconv_tmp;
+      size_t iconv_sz  = HCBUFSIZ_TINY;
+
+      size_t ptr_len = len;
+
+      const size_t iconv_rc = iconv (param->iconv_ctx, &ptr, &ptr_len, &iconv_ptr, &iconv_sz);
+
+      if (iconv_rc == (size_t) -1) continue;
+
+      ptr = param->iconv_tmp;
+      len = HCBUFSIZ_TINY - iconv_sz;
+    }
+
+    if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l))
+    {
+      if (len >= RP_PASSWORD_SIZE) continue;
+
+      char rule_buf_out[RP_PASSWORD_SIZE];
+
+      memset (rule_buf_out, 0, sizeof (rule_buf_out));
+
+      const int rule_len_out = _old_apply_rule (user_options->rule_buf_l, user_options_extra->rule_len_l, ptr, (u32) len, rule_buf_out);
+
+      if (rule_len_out < 0) continue;
+    }
+
+    chunk->cnt2++;
+
+    if (len > PW_MAX) continue;
+
+    // sparse line index, offset of every DICTIDX_STEP'th accepted word
+
+    if ((param->idx_build == true) && ((chunk->words % DICTIDX_STEP) == 0))
+    {
+      if (chunk->idx_cnt == chunk->idx_avail)
+      {
+        chunk->idx = (dictidx_entry_t *) hcrealloc (chunk->idx, chunk->idx_avail * sizeof (dictidx_entry_t), 1024 * sizeof (dictidx_entry_t));
+
+        chunk->idx_avail += 1024;
+      }
+
+      chunk->idx[chunk->idx_cnt].word = chunk->words;
+      chunk->idx[chunk->idx_cnt].off  = line_off;
+
+      chunk->idx_cnt++;
+    }
+
+    chunk->words++;
+  }
+}
+
+static void count_words_chunk (wl_count_thread_param_t *param, wl_count_t *chunk)
+{
+  HCFILE *fp = param->fp;
+
+  count_words_buf (param, chunk, fp->mmap_buf + chunk->beg, chunk->end - chunk->beg, chunk->beg);
+
+  // pages modified in-place are private copies now, do not let them add up to the size of the wordlist
+
+  hc_fmmap_release (fp, chunk->beg, chunk->end);
+}
+
+static void *count_words_thread (void *p)
+{
+  wl_count_thread_param_t *param = (wl_count_thread_param_t *) p;
+
+  for (u32 i = param->tid; i < param->chunks_cnt; i += param->tsz)
+  {
+    count_words_chunk (param, param->chunks + i);
+  }
+
+  return NULL;
+}
+
 int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u64 *result)
 {
   combinator_ctx_t     *combinator_ctx     = hashcat_ctx->combinator_ctx;
@@ -341,37 +847,13 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
 
   dictstat_t d;
 
-  memset (&d, 0, sizeof (d));
-
-  if (fstat (hc_fileno (fp), &d.stat))
+  if (dictstat_key (hashcat_ctx, fp, dictfile, &d) == -1)
   {
     *result = 0;
 
     return 0;
   }
 
-  d.stat.st_mode    = 0;
-  d.stat.st_nlink   = 0;
-  d.stat.st_uid     = 0;
-  d.stat.st_gid     = 0;
-  d.stat.st_rdev    = 0;
-  d.stat.st_atime   = 0;
-
-  #if defined (STAT_NANOSECONDS_ACCESS_TIME)
-  d.stat.STAT_NANOSECONDS_ACCESS_TIME = 0;
-  #endif
-
-  #if defined (_POSIX)
-  d.stat.st_blksize = 0;
-  d.stat.st_blocks  = 0;
-  #endif
-
-  memset (d.encoding_from, 0, sizeof (d.encoding_from));
-  memset (d.encoding_to,   0, sizeof (d.encoding_to));
-
-  strncpy (d.encoding_from, user_options->encoding_from, sizeof (d.encoding_from) - 1);
-  strncpy (d.encoding_to,   user_options->encoding_to,   sizeof (d.encoding_to)   - 1);
-
   if (d.stat.st_size == 0)
   {
     *result = 0;
@@ -379,32 +861,26 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
     return 0;
   }
 
-  const size_t dictfile_len = strlen (dictfile);
-
-  u32 *dictfile_padded = (u32 *) hcmalloc (dictfile_len + 64); // padding required for sha1_update()
-
-  memcpy (dictfile_padded, dictfile, dictfile_len);
-
-  sha1_ctx_t sha1_ctx;
-  sha1_init   (&sha1_ctx);
-  sha1_update (&sha1_ctx, dictfile_padded, dictfile_len);
-  sha1_final  (&sha1_ctx);
-
-  hcfree (dictfile_padded);
+  const u64 cached_cnt = dictstat_find (hashcat_ctx, &d);
 
-  memcpy (d.hash_filename, sha1_ctx.h, 16);
+  // entries cached before the line index existed have none yet, count them once more to build it
 
-  const u64 cached_cnt = dictstat_find (hashcat_ctx, &d);
+  const bool idx_missing = (cached_cnt > DICTIDX_STEP) && (wl_data_index_usable (hashcat_ctx, fp) == true) && (dictidx_find (hashcat_ctx, &d) == NULL);
 
   if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l) == 0)
   {
-    if (cached_cnt)
+    if ((cached_cnt) && (idx_missing == false))
     {
       u64 keyspace = cached_cnt;
 
       if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
       {
-        if (overflow_check_u64_mul (keyspace, straight_ctx->kernel_rules_cnt) == false) return -1;
+        if (overflow_check_u64_mul (keyspace, straight_ctx->kernel_rules_cnt) == false)
+        {
+          event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile);
+
+          return -1;
+        }
 
         keyspace *= straight_ctx->kernel_rules_cnt;
       }
@@ -412,13 +888,23 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
       {
         if (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2))
         {
-          if (overflow_check_u64_mul (keyspace, mask_ctx->bfs_cnt) == false) return -1;
+          if (overflow_check_u64_mul (keyspace, mask_ctx->bfs_cnt) == false)
+          {
+            event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile);
+
+            return -1;
+          }
 
           keyspace *= mask_ctx->bfs_cnt;
         }
         else
         {
-          if (overflow_check_u64_mul (keyspace, combinator_ctx->combs_cnt) == false) return -1;
+          if (overflow_check_u64_mul (keyspace, combinator_ctx->combs_cnt) == false)
+          {
+            event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile);
+
+            return -1;
+          }
 
           keyspace *= combinator_ctx->combs_cnt;
         }
@@ -447,112 +933,274 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
   time_t prev = 0;
 
   u64 comp = 0;
-  u64 cnt  = 0;
   u64 cnt2 = 0;
 
-  while (!hc_feof (fp))
+  hc_fmmap (fp);
+
+  const bool idx_build = wl_data_index_usable (hashcat_ctx, fp);
+
+  // a mapped file can be split into chunks on line boundaries, these are counted in parallel
+
+  const u64 chunk_size = user_options->segment_size;
+
+  const int processor_count = hc_get_processor_count ();
+
+  const bool parallel = (fp->is_mmap == true) && ((u64) d.stat.st_size > chunk_size) && (processor_count > 1);
+
+  wl_count_t *chunks     = NULL;
+  u32         chunks_cnt = 0;
+
+  if (parallel == true)
   {
-    load_segment (hashcat_ctx, fp);
+    const u64 size = fp->mmap_len;
 
-    comp += wl_data->cnt;
+    chunks = (wl_count_t *) hccalloc (CEILDIV (size, chunk_size), sizeof (wl_count_t));
 
-    u64 i = 0;
+    u64 beg = fp->mmap_pos;
 
-    while (i < wl_data->cnt)
+    while (beg < size)
     {
-      u64 len;
-      u64 off;
+      u64 end = MIN (beg + chunk_size, size);
+
+      if (end < size)
+      {
+        const char *nl = (const char *) memchr (fp->mmap_buf + end - 1, '\n', size - end + 1);
+
+        end = (nl == NULL) ? size : (u64) (nl - fp->mmap_buf) + 1;
+      }
+
+      chunks[chunks_cnt].beg = beg;
+      chunks[chunks_cnt].end = end;
 
-      char *ptr = wl_data->buf + i;
+      chunks_cnt++;
 
-      wl_data->func (ptr, wl_data->cnt - i, &len, &off);
+      beg = end;
+    }
+
+    const int tsz = MIN (processor_count, (int) chunks_cnt);
 
-      i += off;
+    hc_thread_t *c_threads = (hc_thread_t *) hccalloc (tsz, sizeof (hc_thread_t));
 
-      // do the on-the-fly hex decode using original buffer
-      // this is safe as length only decreases in size
+    wl_count_thread_param_t *params = (wl_count_thread_param_t *) hccalloc (tsz, sizeof (wl_count_thread_param_t));
 
-      len = (u32) convert_from_hex (hashcat_ctx, ptr, len);
+    for (int tid = 0; tid < tsz; tid++)
+    {
+      wl_count_thread_param_t *param = params + tid;
 
-      // do the on-the-fly encoding
+      param->tid         = tid;
+      param->tsz         = tsz;
+      param->hashcat_ctx = hashcat_ctx;
+      param->fp          = fp;
+      param->chunks      = chunks;
+      param->chunks_cnt  = chunks_cnt;
+      param->idx_build   = idx_build;
 
       if (wl_data->iconv_enabled == true)
       {
-        char  *iconv_ptr = wl_data->iconv_tmp;
-        size_t iconv_sz  = HCBUFSIZ_TINY;
+        // iconv descriptors keep a conversion state, they can not be shared between threads
+
+        param->iconv_ctx = iconv_open (user_options->encoding_to, user_options->encoding_from);
+
+        if (param->iconv_ctx == (iconv_t) -1)
+        {
+          event_log_error (hashcat_ctx, "%s: %s", dictfile, strerror (errno));
+
+          for (int i = 0; i < tid; i++)
+          {
+            iconv_close (params[i].iconv_ctx);
 
-        size_t ptr_len = len;
+            hcfree (params[i].iconv_tmp);
+          }
 
-        const size_t iconv_rc = iconv (wl_data->iconv_ctx, &ptr, &ptr_len, &iconv_ptr, &iconv_sz);
+          hcfree (params);
+          hcfree (c_threads);
+          hcfree (chunks);
 
-        if (iconv_rc == (size_t) -1) continue;
+          return -1;
+        }
 
-        ptr = wl_data->iconv_tmp;
-        len = HCBUFSIZ_TINY - iconv_sz;
+        param->iconv_tmp = (char *) hcmalloc (HCBUFSIZ_TINY);
       }
+    }
 
-      if (run_rule_engine (user_options_extra->rule_len_l, user_options->rule_buf_l))
-      {
-        if (len >= RP_PASSWORD_SIZE) continue;
+    for (int tid = 1; tid < tsz; tid++)
+    {
+      hc_thread_create (c_threads[tid], count_words_thread, params + tid);
+    }
 
-        char rule_buf_out[RP_PASSWORD_SIZE];
+    // the calling thread takes the first share and reports the progress meanwhile
 
-        memset (rule_buf_out, 0, sizeof (rule_buf_out));
+    for (u32 i = 0; i < chunks_cnt; i += tsz)
+    {
+      count_words_chunk (params, chunks + i);
 
-        const int rule_len_out = _old_apply_rule (user_options->rule_buf_l, user_options_extra->rule_len_l, ptr, (u32) len, rule_buf_out);
+      comp = MIN ((u64) (i + tsz) * chunk_size, size);
 
-        if (rule_len_out < 0) continue;
-      }
+      time (&now);
 
-      cnt2++;
+      if ((now - prev) == 0) continue;
 
-      if (len > PW_MAX) continue;
+      time (&prev);
 
-      d.cnt++;
+      cache_generate_t cache_generate;
 
-      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+      cache_generate.dictfile    = dictfile;
+      cache_generate.comp        = comp;
+      cache_generate.percent     = ((double) comp / (double) d.stat.st_size) * 100;
+      cache_generate.cnt         = 0;
+      cache_generate.cnt2        = 0;
+
+      if (cache_generate.percent < 100) EVENT_DATA (EVENT_WORDLIST_CACHE_GENERATE, &cache_generate, sizeof (cache_generate));
+    }
+
+    hc_thread_wait (tsz - 1, c_threads + 1);
+
+    for (int tid = 0; tid < tsz; tid++)
+    {
+      if (params[tid].iconv_tmp == NULL) continue;
+
+      iconv_close (params[tid].iconv_ctx);
+
+      hcfree (params[tid].iconv_tmp);
+    }
+
+    hcfree (params);
+    hcfree (c_threads);
+
+    hc_fseek (fp, 0, SEEK_END);
+
+    comp = size;
+  }
+  else
+  {
+    chunks = (wl_count_t *) hccalloc (1, sizeof (wl_count_t));
+
+    chunks_cnt = 1;
+
+    wl_count_t *chunk = chunks;
+
+    wl_count_thread_param_t param;
+
+    memset (&param, 0, sizeof (param));
+
+    param.tid         = 0;
+    param.tsz         = 1;
+    param.hashcat_ctx = hashcat_ctx;
+    param.fp          = fp;
+    param.chunks      = chunks;
+    param.chunks_cnt  = chunks_cnt;
+    param.idx_build   = idx_build;
+    param.iconv_ctx   = wl_data->iconv_ctx;
+    param.iconv_tmp   = wl_data->iconv_tmp;
+
+    while (!hc_feof (fp))
+    {
+      const u64 seg_off = (u64) hc_ftell (fp);
+
+      load_segment (hashcat_ctx, fp);
+
+      comp += wl_data->cnt;
+
+      count_words_buf (&param, chunk, wl_data->seg, wl_data->cnt, seg_off);
+
+      time (&now);
+
+      if ((now - prev) == 0) continue;
+
+      time (&prev);
+
+      double percent = ((double) comp / (double) d.stat.st_size) * 100;
+
+      if (percent < 100)
       {
-        if (overflow_check_u64_add (cnt, straight_ctx->kernel_rules_cnt) == false) return -1;
+        cache_generate_t cache_generate;
+
+        cache_generate.dictfile    = dictfile;
+        cache_generate.comp        = comp;
+        cache_generate.percent     = percent;
+        cache_generate.cnt         = chunk->words;
+        cache_generate.cnt2        = chunk->cnt2;
 
-        cnt += straight_ctx->kernel_rules_cnt;
+        EVENT_DATA (EVENT_WORDLIST_CACHE_GENERATE, &cache_generate, sizeof (cache_generate));
       }
-      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-      {
-        if (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          if (overflow_check_u64_add (cnt, mask_ctx->bfs_cnt) == false) return -1;
+    }
 
-          cnt += mask_ctx->bfs_cnt;
-        }
-        else
-        {
-          if (overflow_check_u64_add (cnt, combinator_ctx->combs_cnt) == false) return -1;
+    // do not cache the count of a broken file, it would look like a shorter one
 
-          cnt += combinator_ctx->combs_cnt;
-        }
+    if (hc_ferror (fp))
+    {
+      event_log_error (hashcat_ctx, "%s: Read error.", dictfile);
+
+      hcfree (chunk->idx);
+      hcfree (chunks);
+
+      return -1;
+    }
+  }
+
+  // merge, the line index entries of a chunk are relative to its first word
+
+  dictidx_entry_t *idx     = NULL;
+  u64              idx_cnt = 0;
+
+  for (u32 i = 0; i < chunks_cnt; i++)
+  {
+    wl_count_t *chunk = chunks + i;
+
+    if ((idx_build == true) && (chunk->idx_cnt > 0))
+    {
+      idx = (dictidx_entry_t *) hcrealloc (idx, idx_cnt * sizeof (dictidx_entry_t), chunk->idx_cnt * sizeof (dictidx_entry_t));
+
+      for (u64 j = 0; j < chunk->idx_cnt; j++)
+      {
+        idx[idx_cnt].word = d.cnt + chunk->idx[j].word;
+        idx[idx_cnt].off  = chunk->idx[j].off;
+
+        idx_cnt++;
       }
     }
 
-    time (&now);
+    hcfree (chunk->idx);
 
-    if ((now - prev) == 0) continue;
+    d.cnt += chunk->words;
+    cnt2  += chunk->cnt2;
+  }
 
-    time (&prev);
+  hcfree (chunks);
 
-    double percent = ((double) comp / (double) d.stat.st_size) * 100;
+  u64 cnt = 0;
 
-    if (percent < 100)
+  if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+  {
+    cnt = d.cnt;
+
+    if (overflow_check_u64_mul (cnt, straight_ctx->kernel_rules_cnt) == false)
     {
-      cache_generate_t cache_generate;
+      event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile);
 
-      cache_generate.dictfile    = dictfile;
-      cache_generate.comp        = comp;
-      cache_generate.percent     = percent;
-      cache_generate.cnt         = cnt;
-      cache_generate.cnt2        = cnt2;
+      hcfree (idx);
 
-      EVENT_DATA (EVENT_WORDLIST_CACHE_GENERATE, &cache_generate, sizeof (cache_generate));
+      return -1;
     }
+
+    cnt *= straight_ctx->kernel_rules_cnt;
+  }
+  else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+  {
+    cnt = d.cnt;
+
+    const u64 mul = (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2)) ? mask_ctx->bfs_cnt : combinator_ctx->combs_cnt;
+
+    if (overflow_check_u64_mul (cnt, mul) == false)
+    {
+      event_log_error (hashcat_ctx, "Integer overflow detected in keyspace of wordlist: %s", dictfile);
+
+      hcfree (idx);
+
+      return -1;
+    }
+
+    cnt *= mul;
   }
 
   time_t rt_stop;
@@ -572,6 +1220,15 @@ int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u
 
   dictstat_append (hashcat_ctx, &d);
 
+  if (idx_cnt > 1)
+  {
+    dictidx_append (hashcat_ctx, &d, idx, idx_cnt);
+  }
+  else
+  {
+    hcfree (idx);
+  }
+
   //hc_signal (sigHandler_default);
 
   *result = cnt;
@@ -597,10 +1254,12 @@ int wl_data_init (hashcat_ctx_t *hashcat_ctx)
   wl_data->enabled = true;
 
   wl_data->buf   = (char *) hcmalloc (user_options->segment_size);
+  wl_data->seg   = wl_data->buf;
   wl_data->avail = user_options->segment_size;
   wl_data->incr  = user_options->segment_size;
   wl_data->cnt   = 0;
   wl_data->pos   = 0;
+  wl_data->idx   = NULL;
 
   /**
    * choose dictionary parser
@@ -642,6 +1301,8 @@ void wl_data_destroy (hashcat_ctx_t *hashcat_ctx)
 
   if (wl_data->enabled == false) return;
 
+  wl_data_async_stop (hashcat_ctx);
+
   hcfree (wl_data->buf);
 
   if (wl_data->iconv_enabled == true)
@@ -0,0 +1,195 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+use strict;
+use warnings;
+use Compress::Zlib            qw (crc32);
+use Digest::MD5               qw (md5_hex);
+use File::Basename            qw (dirname);
+use IO::Compress::Gzip        qw (gzip $GzipError);
+use IO::Compress::RawDeflate  qw (rawdeflate $RawDeflateError);
+use Test::More;
+
+# Checks that BGZF wordlists (bgzip, samtools), alone or concatenated with regular gzip members, produce the
+# same candidates as the plain wordlist and that a broken block is reported instead of ending the wordlist.
+# hashcat only inflates BGZF blocks in parallel on hosts with more than one core, otherwise zlib reads them.
+
+my $hashcat     = "./hashcat";
+my $OPTS        = "--stdout --force";
+my $CURRENT_DIR = dirname (__FILE__);
+my $OUT_DIR     = $CURRENT_DIR . "/" . "bgzf-test";
+
+my $BLOCK_SIZE  = 60000;
+
+mkdir $OUT_DIR || die $! unless -d $OUT_DIR;
+
+# Make sure to cleanup on forced exit
+$SIG{INT} = \&cleanup_and_exit;
+
+if (scalar @ARGV > 0)
+{
+  usage_die ();
+}
+
+my $words1 = join ("", map { sprintf ("bgzf%06d\n",  $_) } (0 .. 99999));
+my $words2 = join ("", map { sprintf ("plain%06d\n", $_) } (0 .. 9999));
+
+my @cases =
+(
+  {
+    name     => "bgzf",
+    data     => bgzf ($words1),
+    expected => $words1,
+  },
+  {
+    name     => "bgzf followed by a plain gzip member",
+    data     => bgzf ($words1) . gz ($words2),
+    expected => $words1 . $words2,
+  },
+  {
+    name     => "bgzf followed by a plain gzip member and bgzf again",
+    data     => bgzf ($words1) . gz ($words2) . bgzf ($words1),
+    expected => $words1 . $words2 . $words1,
+  },
+  {
+    name     => "plain gzip member followed by bgzf",
+    data     => gz ($words2) . bgzf ($words1),
+    expected => $words2 . $words1,
+  },
+);
+
+for my $case (@cases)
+{
+  run_case ($case);
+}
+
+run_skip_case ();
+
+run_broken_case ();
+
+cleanup ();
+
+done_testing ();
+
+
+sub run_case
+{
+  my $case = shift;
+
+  my $file_name = write_file ("gz", $case->{data});
+
+  my $actual_output = qx($hashcat $OPTS $file_name);
+
+  is (md5_hex ($actual_output), md5_hex ($case->{expected}), $case->{name});
+}
+
+# skip and limit across the end of the BGZF part
+
+sub run_skip_case
+{
+  my $file_name = write_file ("gz", bgzf ($words1) . gz ($words2));
+
+  my $actual_output = qx($hashcat $OPTS -s 99998 -l 4 $file_name);
+
+  is ($actual_output, "bgzf099998\nbgzf099999\nplain000000\nplain000001\n", "skip and limit across the member boundary");
+}
+
+sub run_broken_case
+{
+  my $data = bgzf ($words1);
+
+  # inside the deflate data of the second block
+
+  substr ($data, length ($data) / 2, 8) = "\xff" x 8;
+
+  my $file_name = write_file ("gz", $data);
+
+  my $actual_output = qx($hashcat $OPTS $file_name 2>&1);
+
+  my $rc = $? >> 8;
+
+  isnt ($rc, 0, "broken block - exit code");
+  like ($actual_output, qr/Read error/, "broken block - reported as a read error");
+}
+
+# BSIZE in the extra field is the size of the whole member minus one
+
+sub bgzf_block
+{
+  my $data = shift;
+
+  my $deflated;
+
+  rawdeflate (\$data => \$deflated) || die $RawDeflateError;
+
+  my $bsize = 18 + length ($deflated) + 8;
+
+  my $header = pack ("C4 V C2 v a2 v v", 0x1f, 0x8b, 8, 4, 0, 0, 0xff, 6, "BC", 2, $bsize - 1);
+
+  return $header . $deflated . pack ("V V", crc32 ($data), length ($data));
+}
+
+# the empty block is the BGZF end-of-file marker
+
+sub bgzf
+{
+  my $data = shift;
+
+  my $out = "";
+
+  for (my $i = 0; $i < length ($data); $i += $BLOCK_SIZE)
+  {
+    $out .= bgzf_block (substr ($data, $i, $BLOCK_SIZE));
+  }
+
+  return $out . bgzf_block ("");
+}
+
+sub gz
+{
+  my $data = shift;
+
+  my $out;
+
+  gzip (\$data => \$out) || die $GzipError;
+
+  return $out;
+}
+
+sub write_file
+{
+  my $ext     = shift;
+  my $content = shift;
+
+  my $file_name = sprintf ("%s/%s.%s", $OUT_DIR, md5_hex ($content), $ext);
+  open my $fh, ">", $file_name || die $!;
+  binmode $fh;
+  print $fh $content;
+  close $fh;
+
+  return $file_name;
+}
+
+sub usage_die
+{
+  die ("usage: $0 \n" .
+       "       runs all BGZF test cases \n" .
+       "       run it from the hashcat install folder \n");
+}
+
+sub cleanup
+{
+  unlink <$OUT_DIR/*.gz>;
+  rmdir $OUT_DIR;
+}
+
+sub cleanup_and_exit
+{
+  cleanup ();
+  done_testing ();
+  exit 0;
+}
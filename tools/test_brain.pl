@@ -0,0 +1,616 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+use strict;
+use warnings;
+use Digest::MD5    qw (md5_hex);
+use File::Basename qw (dirname);
+use File::Spec;
+use IO::Socket::INET;
+use POSIX          qw (:sys_wait_h);
+use Test::More;
+
+# Starts a brain server on localhost and checks what it remembers through the Rejected counter of brain clients.
+# Each test case gets a fresh server and folder for its dumps.
+
+my $hashcat     = File::Spec->rel2abs ("./hashcat");
+my $CURRENT_DIR = dirname (File::Spec->rel2abs (__FILE__));
+my $OUT_DIR     = $CURRENT_DIR . "/" . "brain-test";
+
+my $PORT        = 16863;
+my $PASSWORD    = "brain-test";
+
+my $WORDS_CNT   = 20000;
+
+mkdir $OUT_DIR || die $! unless -d $OUT_DIR;
+
+# Make sure to cleanup on forced exit
+$SIG{INT} = \&cleanup_and_exit;
+
+my %cases =
+(
+  runs      => \&run_case_runs,
+  intervals => \&run_case_intervals,
+  journal   => \&run_case_journal,
+  packing   => \&run_case_packing,
+);
+
+my $server_pid = 0;
+
+if (scalar @ARGV > 1 || defined $ARGV[0] && $ARGV[0] eq '--help')
+{
+  usage_die ();
+}
+elsif (scalar @ARGV == 1)
+{
+  my $case = $ARGV[0];
+
+  die ("No test case was found with name: $case") unless exists $cases{$case};
+
+  $cases{$case}->();
+}
+else
+{
+  $cases{$_}->() for (sort keys %cases);
+}
+
+cleanup ();
+
+done_testing ();
+
+# do not leave a server behind if a test dies
+
+END
+{
+  stop_server ("KILL");
+}
+
+
+# the long-term memory is a list of sorted runs, commits add runs and merges must not lose or duplicate hashes
+
+sub run_case_runs
+{
+  my $dir = case_dir ("runs");
+
+  my $hash_file = write_file ($dir, "hash", md5_hex ("not in any wordlist") . "\n");
+
+  my $w1 = write_file ($dir, "w1", join ("\n", map { sprintf ("a%07d", $_) } (0 .. $WORDS_CNT - 1)) . "\n");
+  my $w2 = write_file ($dir, "w2", join ("\n", map { sprintf ("b%07d", $_) } (0 .. $WORDS_CNT - 1)) . "\n");
+
+  # every 4th word of the first two lists and as many new ones
+
+  my @w3 = ();
+
+  for (my $i = 0; $i < $WORDS_CNT; $i += 4)
+  {
+    push @w3, sprintf ("a%07d", $i), sprintf ("b%07d", $i), sprintf ("c%07d", $i), sprintf ("c%07d", $i + 1);
+  }
+
+  my $w3 = write_file ($dir, "w3", join ("\n", @w3) . "\n");
+
+  # duplicates inside of a single lookup
+
+  my $w4 = write_file ($dir, "w4", join ("\n", map { sprintf ("d%07d", $_ % 1000) } (0 .. 1999)) . "\n");
+
+  start_server ($dir);
+
+  is (brain_client ($hash_file, 1, $w1), "0/$WORDS_CNT", "runs - new words are not rejected");
+  is (brain_client ($hash_file, 1, $w2), "0/$WORDS_CNT", "runs - second run");
+  is (brain_client ($hash_file, 1, $w1), "$WORDS_CNT/$WORDS_CNT", "runs - all words of the first run are rejected");
+  is (brain_client ($hash_file, 1, $w3), ($WORDS_CNT / 2) . "/$WORDS_CNT", "runs - words from both runs are rejected");
+  is (brain_client ($hash_file, 1, $w4), "1000/2000", "runs - duplicates of a lookup are rejected");
+  is (brain_client ($hash_file, 1, $w2), "$WORDS_CNT/$WORDS_CNT", "runs - all words of the second run are rejected");
+
+  stop_server ("INT");
+
+  # the dump is all runs merged into one, without duplicates
+
+  my $unique_cnt = $WORDS_CNT + $WORDS_CNT + ($WORDS_CNT / 2) + 1000;
+
+  my @dumps = glob ("$dir/brain.*.ldmp");
+
+  is (scalar @dumps, 1, "runs - one session dumped");
+  is ((-s $dumps[0]), $unique_cnt * 8, "runs - the dump holds every hash once");
+
+  start_server ($dir);
+
+  is (brain_client ($hash_file, 1, $w3), "$WORDS_CNT/$WORDS_CNT", "runs - all words are rejected after a restart");
+
+  stop_server ("INT");
+}
+
+# finished attack ranges are kept sorted and coalesced, the chunks of a whole keyspace end up as a single range
+
+sub run_case_intervals
+{
+  my $dir = case_dir ("intervals");
+
+  my $hash_file = write_file ($dir, "hash", md5_hex ("not in any keyspace") . "\n");
+
+  my $w1 = write_file ($dir, "w1", join ("\n", map { sprintf ("a%07d", $_) } (0 .. $WORDS_CNT - 1)) . "\n");
+
+  start_server ($dir);
+
+  is (brain_client ($hash_file, 2, "-a 3 ?d?d?d?d?d?d"), "0/1000000", "intervals - new attack is not rejected");
+  is (brain_client ($hash_file, 2, "-a 3 ?d?d?d?d?d?d"), "1000000/1000000", "intervals - finished attack is rejected");
+  is (brain_client ($hash_file, 2, $w1), "0/$WORDS_CNT", "intervals - other attack is not rejected");
+  is (brain_client ($hash_file, 2, $w1), "$WORDS_CNT/$WORDS_CNT", "intervals - other attack is rejected");
+
+  stop_server ("INT");
+
+  # each dump is a list of offset/length pairs
+
+  my @dumps = glob ("$dir/brain.*.admp");
+
+  is (scalar @dumps, 2, "intervals - two attacks dumped");
+  is (join (",", map { -s $_ } @dumps), "16,16", "intervals - each attack is a single range");
+
+  start_server ($dir);
+
+  is (brain_client ($hash_file, 2, "-a 3 ?d?d?d?d?d?d"), "1000000/1000000", "intervals - finished attack is rejected after a restart");
+
+  stop_server ("INT");
+}
+
+# commits go to a journal first, a server which gets killed before writing its dumps replays it on the next start
+
+sub run_case_journal
+{
+  my $dir = case_dir ("journal");
+
+  my $hash_file = write_file ($dir, "hash", md5_hex ("not in any wordlist") . "\n");
+
+  my $w1 = write_file ($dir, "w1", join ("\n", map { sprintf ("a%07d", $_) } (0 .. $WORDS_CNT - 1)) . "\n");
+
+  start_server ($dir);
+
+  is (brain_client ($hash_file, 3, $w1), "0/$WORDS_CNT", "journal - new words are not rejected");
+
+  # the journal thread writes once per second
+
+  sleep (2);
+
+  stop_server ("KILL");
+
+  my @ldmp = glob ("$dir/brain.*.ldmp");
+  my @ljnl = glob ("$dir/brain.*.ljnl");
+  my @ajnl = glob ("$dir/brain.*.ajnl");
+
+  is (scalar @ldmp, 0, "journal - no dump written before the kill");
+
+  is ((@ljnl) ? -s $ljnl[0] : 0, $WORDS_CNT * 8, "journal - hashes journaled");
+  ok ((@ajnl) && (-s $ajnl[0]), "journal - attack ranges journaled");
+
+  # a hash cut off by the kill is dropped on replay
+
+  open my $fh, ">>", $ljnl[0] or die $!;
+  print $fh "cut";
+  close $fh;
+
+  start_server ($dir);
+
+  my @dumps = glob ("$dir/brain.*.ldmp");
+
+  is ((@dumps) ? -s $dumps[0] : 0, $WORDS_CNT * 8, "journal - replayed into a snapshot on start");
+
+  is (brain_client ($hash_file, 1, $w1), "$WORDS_CNT/$WORDS_CNT", "journal - replayed hashes are rejected");
+  is (brain_client ($hash_file, 2, $w1), "$WORDS_CNT/$WORDS_CNT", "journal - replayed attack ranges are rejected");
+
+  stop_server ("INT");
+}
+
+# lookups of link version 2 are rice coded gaps between the sorted hashes, the reply is one bit per hash
+
+sub run_case_packing
+{
+  no warnings 'portable';
+
+  my $dir = case_dir ("packing");
+
+  start_server ($dir);
+
+  is (handshake_version (1), 1, "packing - version 1 clients are answered with version 1");
+  is (handshake_version (3), 2, "packing - newer clients are answered with version 2");
+
+  my $sock = brain_connect ();
+
+  is (brain_lookup ($sock, 8, rice_deltas (10, 1000, 5000)), "\x00", "packing - new hashes");
+  is (brain_lookup ($sock, 8, rice_deltas (1000, 2000, 5000, 7000)), "\x05", "packing - known hashes are rejected");
+
+  my @big = (0x1000000000000000, 0x8000000000000000, 0xfffffffffffffff0);
+
+  is (brain_lookup ($sock, 60, rice_deltas (@big)), "\x00", "packing - large gaps");
+  is (brain_lookup ($sock, 60, rice_deltas (@big)), "\x07", "packing - large gaps round-trip");
+
+  my @even = map { 100000 + $_ * 100 } (1 .. 20);
+  my @all  = map { 100000 + $_ *  50 } (2 .. 40);
+
+  is (brain_lookup ($sock, 6, rice_deltas (@even)), "\x00" x 3, "packing - reply of more than one byte");
+  is (brain_lookup ($sock, 6, rice_deltas (@all)), "\x55" x 5, "packing - reply bits in the order of the hashes");
+
+  close $sock;
+
+  # each malformed stream makes the server drop the connection
+
+  my @malformed =
+  (
+    [ "repeated hash",       4, 3, rice_pack (4, 10, 0, 10)                           ],
+    [ "stream too short",    4, 5, rice_pack (4, 10, 10, 10)                          ],
+    [ "hash wraps around",  56, 2, rice_pack (56, 0xff00000000000000, 0x0200000000000000) ],
+    [ "rice parameter",     64, 1, rice_pack (8, 10)                                  ],
+  );
+
+  for my $case (@malformed)
+  {
+    my ($name, $k, $cnt, $buf) = @{$case};
+
+    my $sock = brain_connect ();
+
+    brain_send_lookup ($sock, $k, $cnt, $buf);
+
+    is (brain_recv ($sock, 4), undef, "packing - $name is rejected");
+
+    close $sock;
+  }
+
+  # the server is still serving other clients
+
+  $sock = brain_connect ();
+
+  is (brain_lookup ($sock, 8, rice_deltas (10, 20)), "\x00", "packing - server still answers");
+
+  close $sock;
+
+  stop_server ("INT");
+
+  open my $fh, "<", "$dir/server.log" or die $!;
+  my $log = do { local $/; <$fh> };
+  close $fh;
+
+  my $invalid_cnt = () = $log =~ /Invalid packed hashes/g;
+
+  is ($invalid_cnt, 3, "packing - malformed streams are logged");
+}
+
+# client side of the brain link, see brain_client_connect () and brain_server_handle_client ()
+
+sub handshake_version
+{
+  my $version = shift;
+
+  my $sock = IO::Socket::INET->new (PeerAddr => "127.0.0.1", PeerPort => $PORT, Proto => "tcp") or die $!;
+
+  print $sock pack ("V", $version);
+
+  my $buf = brain_recv ($sock, 4);
+
+  close $sock;
+
+  return (defined $buf) ? unpack ("V", $buf) : undef;
+}
+
+sub brain_connect
+{
+  my $sock = IO::Socket::INET->new (PeerAddr => "127.0.0.1", PeerPort => $PORT, Proto => "tcp") or die $!;
+
+  $sock->autoflush (1);
+
+  print $sock pack ("V", 2);
+
+  die ("brain link version") unless (unpack ("V", brain_recv ($sock, 4)) == 2);
+
+  my $challenge = unpack ("V", brain_recv ($sock, 4));
+
+  print $sock brain_auth_hash ($challenge, $PASSWORD);
+
+  die ("brain password") unless (unpack ("V", brain_recv ($sock, 4)) == 1);
+
+  # session, attack, passwords_max
+
+  print $sock pack ("VVq<", 0x12345678, 0x9abcdef0, 1000);
+
+  brain_recv ($sock, 8);
+
+  return $sock;
+}
+
+sub brain_lookup
+{
+  my $sock = shift;
+  my $k    = shift;
+  my @gaps = @_;
+
+  brain_send_lookup ($sock, $k, scalar @gaps, rice_pack ($k, @gaps));
+
+  my $size = brain_recv ($sock, 4);
+
+  return undef unless defined $size;
+
+  return brain_recv ($sock, unpack ("l<", $size));
+}
+
+sub brain_send_lookup
+{
+  my $sock = shift;
+  my $k    = shift;
+  my $cnt  = shift;
+  my $buf  = shift;
+
+  # BRAIN_OPERATION_HASH_LOOKUP, hashes_cnt, pack_k, in_size
+
+  print $sock pack ("Cl<l<l<", 2, $cnt, $k, length ($buf)) . $buf;
+}
+
+sub brain_recv
+{
+  my $sock = shift;
+  my $len  = shift;
+
+  my $buf = "";
+
+  local $SIG{ALRM} = sub { die ("brain_recv timeout") };
+
+  alarm (10);
+
+  while (length ($buf) < $len)
+  {
+    my $rc = sysread ($sock, $buf, $len - length ($buf), length ($buf));
+
+    last unless $rc;
+  }
+
+  alarm (0);
+
+  return (length ($buf) == $len) ? $buf : undef;
+}
+
+sub rice_deltas
+{
+  my @hashes = @_;
+
+  my @gaps = ();
+
+  my $prev = 0;
+
+  for my $hash (@hashes)
+  {
+    push @gaps, $hash - $prev;
+
+    $prev = $hash;
+  }
+
+  return @gaps;
+}
+
+# the quotient in unary, then the k low bits, all of it lsb first
+
+sub rice_pack
+{
+  my $k    = shift;
+  my @gaps = @_;
+
+  my $bits = "";
+
+  for my $gap (@gaps)
+  {
+    $bits .= "1" x ($gap >> $k) . "0";
+
+    $bits .= ($gap >> $_) & 1 for (0 .. $k - 1);
+  }
+
+  return pack ("b*", $bits);
+}
+
+sub brain_auth_hash
+{
+  my $challenge = shift;
+  my $password  = shift;
+
+  my $response = xxh64 ($password, $challenge);
+
+  for (1 .. 100000)
+  {
+    $response = xxh64 ($response, 0);
+  }
+
+  return $response;
+}
+
+# XXH64 () for inputs shorter than 32 bytes, returned as 8 little-endian bytes
+
+sub xxh64
+{
+  my $data = shift;
+  my $seed = shift;
+
+  no warnings 'portable';
+  use integer;
+
+  my $P1 = 0x9E3779B185EBCA87;
+  my $P2 = 0xC2B2AE3D27D4EB4F;
+  my $P3 = 0x165667B19E3779F9;
+  my $P4 = 0x85EBCA77C2B2AE63;
+  my $P5 = 0x27D4EB2F165667C5;
+
+  my $len = length ($data);
+
+  my $h = $seed + $P5 + $len;
+
+  my $pos = 0;
+
+  for (; $pos + 8 <= $len; $pos += 8)
+  {
+    my $k1 = unpack ("q<", substr ($data, $pos, 8));
+
+    $k1 = rotl64 ($k1 * $P2, 31) * $P1;
+
+    $h = rotl64 ($h ^ $k1, 27) * $P1 + $P4;
+  }
+
+  for (; $pos + 4 <= $len; $pos += 4)
+  {
+    $h = rotl64 ($h ^ (unpack ("V", substr ($data, $pos, 4)) * $P1), 23) * $P2 + $P3;
+  }
+
+  for (; $pos < $len; $pos++)
+  {
+    $h = rotl64 ($h ^ (ord (substr ($data, $pos, 1)) * $P5), 11) * $P1;
+  }
+
+  $h ^= shr64 ($h, 33);
+  $h *= $P2;
+  $h ^= shr64 ($h, 29);
+  $h *= $P3;
+  $h ^= shr64 ($h, 32);
+
+  return pack ("q<", $h);
+}
+
+sub rotl64
+{
+  my $x = shift;
+  my $r = shift;
+
+  use integer;
+
+  return ($x << $r) | shr64 ($x, 64 - $r);
+}
+
+sub shr64
+{
+  my $x = shift;
+  my $n = shift;
+
+  use integer;
+
+  return ($x >> $n) & ((1 << (64 - $n)) - 1);
+}
+
+sub brain_client
+{
+  my $hash_file = shift;
+  my $features  = shift;
+  my @args      = @_;
+
+  my $cmd = "$hashcat -m 0 -z --brain-port $PORT --brain-password $PASSWORD --brain-client-features $features --potfile-path $hash_file.pot --status --status-timer 100 --restore-disable --logfile-disable $hash_file @args";
+
+  my $output = qx($cmd 2>&1);
+
+  # the server takes the commit of a finished client on its own time
+
+  sleep (1);
+
+  return ($output =~ /^Rejected\.+: (\d+\/\d+)/m) ? $1 : "failed";
+}
+
+sub start_server
+{
+  my $dir = shift;
+
+  $server_pid = fork ();
+
+  die ("fork: $!") unless defined $server_pid;
+
+  if ($server_pid == 0)
+  {
+    chdir ($dir) || die $!;
+
+    open (STDOUT, ">>", "server.log") || die $!;
+    open (STDERR, ">&", \*STDOUT)     || die $!;
+
+    exec ($hashcat, "--brain-server", "--brain-port", $PORT, "--brain-password", $PASSWORD);
+
+    exit (1);
+  }
+
+  for (1 .. 100)
+  {
+    select (undef, undef, undef, 0.1);
+
+    my $sock = IO::Socket::INET->new (PeerAddr => "127.0.0.1", PeerPort => $PORT, Proto => "tcp");
+
+    next unless defined $sock;
+
+    close $sock;
+
+    return;
+  }
+
+  die ("Brain server did not start, see $dir/server.log");
+}
+
+sub stop_server
+{
+  my $signal = shift;
+
+  return if ($server_pid == 0);
+
+  kill ($signal, $server_pid);
+
+  waitpid ($server_pid, 0);
+
+  $server_pid = 0;
+}
+
+sub case_dir
+{
+  my $name = shift;
+
+  my $dir = $OUT_DIR . "/" . $name;
+
+  remove_dir ($dir);
+
+  mkdir $dir || die $!;
+
+  return $dir;
+}
+
+sub write_file
+{
+  my $dir     = shift;
+  my $name    = shift;
+  my $content = shift;
+
+  my $file_name = $dir . "/" . $name;
+  open my $fh, ">", $file_name || die $!;
+  print $fh $content;
+  close $fh;
+
+  return $file_name;
+}
+
+sub remove_dir
+{
+  my $dir = shift;
+
+  return unless -d $dir;
+
+  unlink glob ("$dir/*");
+  rmdir $dir;
+}
+
+sub usage_die
+{
+  die ("usage: $0 [case] \n" .
+       "       run all test cases if [case] was not specified \n" .
+       "       available cases: " . join (", ", sort keys %cases) . " \n");
+}
+
+sub cleanup
+{
+  stop_server ("KILL");
+
+  remove_dir ($_) for (glob ("$OUT_DIR/*"));
+  rmdir $OUT_DIR;
+}
+
+sub cleanup_and_exit
+{
+  cleanup ();
+  done_testing ();
+  exit 0;
+}
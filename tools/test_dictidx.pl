@@ -0,0 +1,157 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+use strict;
+use warnings;
+use File::Basename     qw (dirname);
+use File::Copy         qw (move);
+use IO::Compress::Gzip qw (gzip $GzipError);
+use Test::More;
+
+# Checks that --skip/--limit on a wordlist, which seeks through the sparse line index in hashcat.dictidx,
+# produces the same candidates as the linear scan hashcat does for a compressed copy of the same wordlist.
+# Run it from the hashcat install folder, it uses the hashcat.dictidx of that folder.
+
+my $hashcat     = "./hashcat";
+my $OPTS        = "--stdout --force";
+my $CURRENT_DIR = dirname (__FILE__);
+my $OUT_DIR     = $CURRENT_DIR . "/" . "dictidx-test";
+my $DICTIDX     = "hashcat.dictidx";
+
+my $WORDS_CNT   = 200000;
+
+mkdir $OUT_DIR || die $! unless -d $OUT_DIR;
+
+# Make sure to cleanup on forced exit
+$SIG{INT} = \&cleanup_and_exit;
+
+if (scalar @ARGV > 0)
+{
+  usage_die ();
+}
+
+my $wordlist    = $OUT_DIR . "/" . "words.txt";
+my $wordlist_gz = $OUT_DIR . "/" . "words.txt.gz";
+
+write_wordlist ($wordlist, $wordlist_gz);
+
+# index entries are DICTIDX_STEP (65536) words apart, test right at and around them
+
+my @ranges =
+(
+  [     0,    10 ],
+  [     1,    10 ],
+  [ 65535,     3 ],
+  [ 65536,     3 ],
+  [ 65537,     3 ],
+  [131071,     5 ],
+  [131072,     5 ],
+  [150000,  1000 ],
+  [196600, 10000 ],
+);
+
+# the first pass builds the index, the second one reads it back from disk
+
+for my $pass (1 .. 2)
+{
+  run_ranges ($pass);
+}
+
+# a wordlist known to hashcat.dictstat2 but missing from hashcat.dictidx gets its index built on the next run
+
+ok (has_dictidx (), "index written");
+
+my $dictidx_backup = $OUT_DIR . "/" . "dictidx.backup";
+
+move ($DICTIDX, $dictidx_backup) || die $! if (-e $DICTIDX);
+
+run_ranges (3);
+
+ok (has_dictidx (), "index rebuilt on a dictstat hit");
+
+move ($dictidx_backup, $DICTIDX) || die $! if (-e $dictidx_backup);
+
+cleanup ();
+
+done_testing ();
+
+
+sub run_ranges
+{
+  my $pass = shift;
+
+  for my $range (@ranges)
+  {
+    my ($skip, $limit) = @{$range};
+
+    my $expected = qx($hashcat $OPTS -s $skip -l $limit $wordlist_gz);
+    my $actual   = qx($hashcat $OPTS -s $skip -l $limit $wordlist);
+
+    is ($actual, $expected, "pass $pass - skip $skip limit $limit");
+  }
+}
+
+sub has_dictidx
+{
+  return (-s $DICTIDX) ? 1 : 0;
+}
+
+# the mix of lines which are too long, empty and CRLF terminated makes the word count differ from the line count
+
+sub write_wordlist
+{
+  my $file_name    = shift;
+  my $file_name_gz = shift;
+
+  open my $fh, ">", $file_name || die $!;
+
+  for my $i (0 .. $WORDS_CNT - 1)
+  {
+    if (($i % 1009) == 0)
+    {
+      print $fh "x" x 300, "\n";
+    }
+    elsif (($i % 997) == 0)
+    {
+      print $fh "\n";
+    }
+    elsif (($i % 991) == 0)
+    {
+      printf $fh "crlf%07d\r\n", $i;
+    }
+    else
+    {
+      printf $fh "word%07d\n", $i;
+    }
+  }
+
+  close $fh;
+
+  gzip ($file_name => $file_name_gz) || die $GzipError;
+}
+
+sub usage_die
+{
+  die ("usage: $0 \n" .
+       "       compares indexed wordlist seeks with a linear scan \n" .
+       "       run it from the hashcat install folder \n");
+}
+
+sub cleanup
+{
+  unlink <$OUT_DIR/*.txt $OUT_DIR/*.gz>;
+  rmdir $OUT_DIR;
+}
+
+sub cleanup_and_exit
+{
+  move ($dictidx_backup, $DICTIDX) if ((defined $dictidx_backup) && (-e $dictidx_backup));
+
+  cleanup ();
+  done_testing ();
+  exit 0;
+}
@@ -0,0 +1,166 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+use strict;
+use warnings;
+use Digest::MD5    qw (md5_hex);
+use Digest::SHA    qw (sha1_hex sha256_hex sha512_hex);
+use File::Basename qw (dirname);
+use List::Util     qw (shuffle);
+use Test::More;
+
+# Plain hash lists of unsalted hash-modes are loaded into the sorted digest array directly, other lists go
+# through hash_t and qsort. Both have to end up in the same order, otherwise the device side binary search
+# misses hashes. This cracks the same list both ways and compares the results.
+
+my $hashcat     = "./hashcat";
+my $OPTS        = "--force --quiet --potfile-disable -a 0";
+my $CURRENT_DIR = dirname (__FILE__);
+my $OUT_DIR     = $CURRENT_DIR . "/" . "hashes-test";
+
+my $WORDS_CNT   = 3000;
+my $DUPES_CNT   = 500;
+my $LEFT_CNT    = 200;
+
+mkdir $OUT_DIR || die $! unless -d $OUT_DIR;
+
+# Make sure to cleanup on forced exit
+$SIG{INT} = \&cleanup_and_exit;
+
+my %modes =
+(
+  0    => \&md5_hex,
+  100  => \&sha1_hex,
+  1400 => \&sha256_hex,
+  1700 => \&sha512_hex,
+);
+
+if (scalar @ARGV > 1 || defined $ARGV[0] && $ARGV[0] eq '--help')
+{
+  usage_die ();
+}
+elsif (scalar @ARGV == 1)
+{
+  my $mode = $ARGV[0];
+
+  die ("No test case was found for hash-mode: $mode") unless exists $modes{$mode};
+
+  run_case ($mode);
+}
+else
+{
+  run_case ($_) for (sort { $a <=> $b } keys %modes);
+}
+
+cleanup ();
+
+done_testing ();
+
+
+sub run_case
+{
+  my $mode = shift;
+
+  my $func = $modes{$mode};
+
+  srand ($mode);
+
+  my @words = map { sprintf ("pw%05d", $_) } (0 .. $WORDS_CNT - 1);
+
+  my @hashes = map { $func->($_) } @words;
+
+  # some hashes twice and some which are not in the wordlist
+
+  my @left_words = map { sprintf ("left%05d", $_) } (0 .. $LEFT_CNT - 1);
+
+  my @left = map { $func->($_) } @left_words;
+
+  my @list = shuffle (@hashes, @hashes[0 .. $DUPES_CNT - 1], @left);
+
+  my $word_file = write_file ("$mode.words", join ("\n", @words) . "\n");
+  my $hash_file = write_file ("$mode.hashes", join ("\n", @list) . "\n");
+  my $user_file = write_file ("$mode.users", join ("\n", map { "user:$_" } @list) . "\n");
+
+  my $out_packed = $OUT_DIR . "/" . "$mode.packed.out";
+  my $out_hash_t = $OUT_DIR . "/" . "$mode.hash_t.out";
+
+  unlink $out_packed, $out_hash_t;
+
+  qx($hashcat $OPTS -m $mode -o $out_packed --outfile-format 1,2 $hash_file $word_file);
+
+  # --username keeps the per hash metadata, so this list goes through hash_t
+
+  qx($hashcat $OPTS -m $mode -o $out_hash_t --outfile-format 1,2 --username $user_file $word_file);
+
+  my @expected = sort map { "$hashes[$_]:$words[$_]" } (0 .. $WORDS_CNT - 1);
+
+  is_deeply ([ read_sorted ($out_packed) ], \@expected, "$mode - all unique hashes cracked from the packed digests");
+  is_deeply ([ read_sorted ($out_hash_t) ], \@expected, "$mode - all unique hashes cracked through hash_t");
+
+  # the potfile check marks the hashes in the sorted digests, only the others are cracked again
+
+  my $all_file = write_file ("$mode.all", join ("\n", @words, @left_words) . "\n");
+  my $pot_file = write_file ("$mode.pot", join ("\n", @expected) . "\n");
+
+  my $out_pot = $OUT_DIR . "/" . "$mode.pot.out";
+
+  unlink $out_pot;
+
+  qx($hashcat --force --quiet -a 0 -m $mode -o $out_pot --outfile-format 1,2 --potfile-path $pot_file $hash_file $all_file);
+
+  my @expected_left = sort map { "$left[$_]:$left_words[$_]" } (0 .. $LEFT_CNT - 1);
+
+  is_deeply ([ read_sorted ($out_pot) ], \@expected_left, "$mode - hashes found in the potfile are not cracked again");
+}
+
+sub read_sorted
+{
+  my $file_name = shift;
+
+  return () unless -e $file_name;
+
+  open my $fh, "<", $file_name || die $!;
+  my @lines = <$fh>;
+  close $fh;
+
+  chomp @lines;
+
+  return sort @lines;
+}
+
+sub write_file
+{
+  my $name    = shift;
+  my $content = shift;
+
+  my $file_name = $OUT_DIR . "/" . $name;
+  open my $fh, ">", $file_name || die $!;
+  print $fh $content;
+  close $fh;
+
+  return $file_name;
+}
+
+sub usage_die
+{
+  die ("usage: $0 [hash-mode] \n" .
+       "       run all test cases if [hash-mode] was not specified \n" .
+       "       available hash-modes: " . join (", ", sort { $a <=> $b } keys %modes) . " \n");
+}
+
+sub cleanup
+{
+  unlink <$OUT_DIR/*>;
+  rmdir $OUT_DIR;
+}
+
+sub cleanup_and_exit
+{
+  cleanup ();
+  done_testing ();
+  exit 0;
+}
@@ -0,0 +1,153 @@
+#!/usr/bin/env perl
+
+##
+## Author......: See docs/credits.txt
+## License.....: MIT
+##
+
+use strict;
+use warnings;
+use Digest::MD5    qw (md5_hex);
+use File::Basename qw (dirname);
+use Test::More;
+
+# Checks that rules which only differ in no-op functions are loaded once, in the position of their first
+# occurrence, for single and chained rule files, and that --debug-mode still prints the rule as written.
+
+my $hashcat     = "./hashcat";
+my $OPTS        = "--stdout --force";
+my $CURRENT_DIR = dirname (__FILE__);
+my $OUT_DIR     = $CURRENT_DIR . "/" . "rules-dedup-test";
+
+mkdir $OUT_DIR || die $! unless -d $OUT_DIR;
+
+# Make sure to cleanup on forced exit
+$SIG{INT} = \&cleanup_and_exit;
+
+if (scalar @ARGV > 0)
+{
+  usage_die ();
+}
+
+my @cases =
+(
+  {
+    name     => "no-op functions and spaces",
+    rules    => [ [ ':$1', '$1', ' $1', '$1 :', '::$1::' ] ],
+    input    => "a\nb\n",
+    expected => "a1\nb1\n",
+  },
+  {
+    name     => "rules of no-ops only",
+    rules    => [ [ ':', '::', ' : ', '$1', ':' ] ],
+    input    => "a\n",
+    expected => "a\na1\n",
+  },
+  {
+    name     => "first occurrence keeps its position",
+    rules    => [ [ '$2', '$1', ':$2', '$3', '$1:' ] ],
+    input    => "a\n",
+    expected => "a2\na1\na3\n",
+  },
+  {
+    name     => "different rules are kept",
+    rules    => [ [ '$1$2', '$2$1', '$1 $2', 'u', 'l', 'u:' ] ],
+    input    => "a\n",
+    expected => "a12\na21\nA\na\n",
+  },
+  {
+    name     => "chained rule files",
+    rules    => [ [ ':', '$1' ], [ '$1', ':' ] ],
+    input    => "a\n",
+    expected => "a1\na11\na\n",
+  },
+  {
+    name     => "chained rule files with duplicates in each",
+    rules    => [ [ ':', '$1', ' ' ], [ '$2', '$2:' ] ],
+    input    => "a\n",
+    expected => "a2\na12\n",
+  },
+);
+
+for my $case (@cases)
+{
+  run_case ($case);
+}
+
+run_debug_case ();
+
+cleanup ();
+
+done_testing ();
+
+
+sub run_case
+{
+  my $case = shift;
+
+  my $input_file = write_file ("in", $case->{input});
+
+  my $rule_opts = "";
+
+  for my $rules (@{$case->{rules}})
+  {
+    $rule_opts .= " -r " . write_file ("rule", join ("\n", @{$rules}) . "\n");
+  }
+
+  my $actual_output = qx($hashcat $OPTS $rule_opts $input_file);
+
+  is ($actual_output, $case->{expected}, $case->{name});
+}
+
+# the canonical form of ': $1' is '$1', the debug output has to show the first occurrence as it was written
+
+sub run_debug_case
+{
+  my $input_file = write_file ("in",   "abc\n");
+  my $rule_file  = write_file ("rule", ": \$1\n\$1\n");
+  my $hash_file  = write_file ("hash", md5_hex ("abc1") . "\n");
+
+  my $debug_file = $OUT_DIR . "/" . "debug.out";
+
+  unlink $debug_file;
+
+  qx($hashcat -m 0 -a 0 --force --potfile-disable --quiet -o /dev/null --debug-mode 4 --debug-file $debug_file -r $rule_file $hash_file $input_file);
+
+  open my $fh, "<", $debug_file || die $!;
+  my $actual_output = do { local $/; <$fh> };
+  close $fh;
+
+  is ($actual_output, "abc:: \$1:abc1\n", "debug mode prints the rule as written");
+}
+
+sub write_file
+{
+  my $ext     = shift;
+  my $content = shift;
+
+  my $file_name = sprintf ("%s/%s.%s", $OUT_DIR, md5_hex ($content), $ext);
+  open my $fh, ">", $file_name || die $!;
+  print $fh $content;
+  close $fh;
+
+  return $file_name;
+}
+
+sub usage_die
+{
+  die ("usage: $0 \n" .
+       "       runs all rule deduplication test cases \n");
+}
+
+sub cleanup
+{
+  unlink <$OUT_DIR/*.in $OUT_DIR/*.rule $OUT_DIR/*.hash $OUT_DIR/*.out>;
+  rmdir $OUT_DIR;
+}
+
+sub cleanup_and_exit
+{
+  cleanup ();
+  done_testing ();
+  exit 0;
+}